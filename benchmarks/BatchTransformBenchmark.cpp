@@ -0,0 +1,115 @@
+#include "pch.h"
+#include "Benchmark.h"
+#include "BatchTransform.h"
+#include "Matrix.h"
+#include <cstring>
+#include <random>
+#include <string>
+
+using namespace dae;
+
+namespace
+{
+	struct Arrays
+	{
+		std::vector<Vector3> source{};
+		std::vector<Vector3> destination{};
+		Vector3Array sourceArray{};
+		Vector3Array destinationArray{};
+	};
+
+	Arrays CreateArrays(size_t count)
+	{
+		std::mt19937 random{ 15 };
+		std::uniform_real_distribution<float> value{ -10.f, 10.f };
+
+		Arrays arrays{};
+		arrays.source.resize(count);
+		arrays.destination.resize(count);
+		arrays.sourceArray.Resize(count);
+		arrays.destinationArray.Resize(count);
+		for (size_t i{ 0 }; i < count; ++i)
+		{
+			arrays.source[i] = { value(random), value(random), value(random) };
+			arrays.sourceArray.Set(i, arrays.source[i]);
+		}
+
+		return arrays;
+	}
+
+	//The kernels promise the results of the single transforms, a benchmark of wrong results would be meaningless
+	bool AreEqual(const std::vector<Vector3>& expected, const std::vector<Vector3>& actual, const Vector3Array& actualArray)
+	{
+		for (size_t i{ 0 }; i < expected.size(); ++i)
+		{
+			const Vector3 fromArray{ actualArray.Get(i) };
+			if (std::memcmp(&expected[i], &actual[i], sizeof(Vector3)) != 0 || std::memcmp(&expected[i], &fromArray, sizeof(Vector3)) != 0)
+				return false;
+		}
+
+		return true;
+	}
+
+	//The single transform in a loop, then the kernels on an array of Vector3 (AoS) and on a Vector3Array (SoA), per element
+	template<typename Single, typename Batch, typename BatchArray>
+	void Compare(const char* name, Arrays& arrays, uint32_t repetitionCount, Single&& single, Batch&& batch, BatchArray&& batchArray)
+	{
+		const double count{ static_cast<double>(arrays.source.size()) };
+		std::vector<Vector3> expected(arrays.source.size());
+
+		const Benchmarks::Timing singleTiming{ Benchmarks::Measure(repetitionCount, [&]()
+			{
+				for (size_t i{ 0 }; i < arrays.source.size(); ++i)
+					expected[i] = single(arrays.source[i]);
+
+				Benchmarks::g_Sink = expected.back().x;
+			}) };
+		const Benchmarks::Timing batchTiming{ Benchmarks::Measure(repetitionCount, [&]()
+			{
+				batch(arrays.source.data(), arrays.source.size(), arrays.destination.data());
+				Benchmarks::g_Sink = arrays.destination.back().x;
+			}) };
+		const Benchmarks::Timing batchArrayTiming{ Benchmarks::Measure(repetitionCount, [&]()
+			{
+				batchArray(arrays.sourceArray, arrays.destinationArray);
+				Benchmarks::g_Sink = arrays.destinationArray.x.back();
+			}) };
+
+		const std::string prefix{ name };
+		Benchmarks::Report((prefix + " loop").c_str(), singleTiming, count);
+		Benchmarks::Report((prefix + "s AoS").c_str(), batchTiming, count);
+		Benchmarks::Report((prefix + "s SoA").c_str(), batchArrayTiming, count);
+		std::cout << "    speedup " << std::fixed << std::setprecision(2) << singleTiming.fastest / batchTiming.fastest << " and "
+			<< singleTiming.fastest / batchArrayTiming.fastest << std::defaultfloat << "\n";
+
+		if (!AreEqual(expected, arrays.destination, arrays.destinationArray))
+			std::cout << RED_TEXT("    The batches differ from the single transforms\n");
+	}
+}
+
+//BatchTransform against a loop of Matrix::TransformPoint and TransformVector, from arrays that fit the L1 cache to ones that only fit memory.
+//The kernels follow the Matrix backend, SSE by default and AVX with DAE_AVX2.
+int main()
+{
+	const Matrix matrix{ Matrix::CreateScale(1.5f, 0.7f, 2.f) * Matrix::CreateRotation(0.3f, 1.2f, -0.4f) * Matrix::CreateTranslation(4.f, -2.f, 10.f) };
+
+	std::cout << "Batch transform benchmark\n";
+	const std::pair<size_t, uint32_t> sizes[]{ { 1024, 2000 }, { 64 * 1024, 100 }, { 4 * 1024 * 1024, 5 } };
+	for (const auto& [count, repetitionCount] : sizes)
+	{
+		Arrays arrays{ CreateArrays(count) };
+		std::cout << "\n  " << count << " elements\n";
+
+		Compare("TransformPoint", arrays, repetitionCount,
+			[&](const Vector3& point) { return matrix.TransformPoint(point); },
+			[&](const Vector3* pPoints, size_t pointCount, Vector3* pDestination) { BatchTransform::TransformPoints(matrix, pPoints, pointCount, pDestination); },
+			[&](const Vector3Array& points, Vector3Array& destination) { BatchTransform::TransformPoints(matrix, points, destination); });
+
+		Compare("TransformVector", arrays, repetitionCount,
+			[&](const Vector3& vector) { return matrix.TransformVector(vector); },
+			[&](const Vector3* pVectors, size_t vectorCount, Vector3* pDestination) { BatchTransform::TransformVectors(matrix, pVectors, vectorCount, pDestination); },
+			[&](const Vector3Array& vectors, Vector3Array& destination) { BatchTransform::TransformVectors(matrix, vectors, destination); });
+	}
+
+	return 0;
+}
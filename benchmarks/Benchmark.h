@@ -0,0 +1,53 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace dae
+{
+	//Timing helpers shared by the benchmark executables. The fastest run is what the code can do, the median shows how noisy the machine was.
+	namespace Benchmarks
+	{
+		struct Timing
+		{
+			double fastest{};	//Milliseconds
+			double median{};
+		};
+
+		//Runs function repetitionCount times after one warm up run
+		template<typename Function>
+		Timing Measure(uint32_t repetitionCount, Function&& function)
+		{
+			function();
+
+			std::vector<double> times(std::max(repetitionCount, 1u));
+			for (double& time : times)
+			{
+				const auto startTime{ std::chrono::steady_clock::now() };
+				function();
+				time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+			}
+
+			std::sort(times.begin(), times.end());
+			return { times.front(), times[times.size() / 2] };
+		}
+
+		//Per run, or per operation when a run does operationCount of them
+		inline void Report(const char* name, const Timing& timing, double operationCount = 0.0)
+		{
+			std::cout << "  " << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2);
+			if (operationCount > 0.0)
+				std::cout << std::setw(10) << timing.fastest * 1e6 / operationCount << " ns/op (median " << timing.median * 1e6 / operationCount << ")\n";
+			else
+				std::cout << std::setw(10) << timing.fastest << " ms (median " << timing.median << ")\n";
+
+			std::cout << std::defaultfloat;
+		}
+
+		//Keeps results alive, so the optimizer cannot drop the work that produced them
+		inline volatile float g_Sink{};
+	}
+}
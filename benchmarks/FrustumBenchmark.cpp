@@ -0,0 +1,107 @@
+#include "pch.h"
+#include "Benchmark.h"
+#include "Camera.h"
+#include "DataTypes.h"
+#include "Frustum.h"
+#include <cstdlib>
+#include <random>
+
+using namespace dae;
+
+namespace
+{
+	//What culling a scene is allowed to take per frame
+	constexpr double g_BudgetTime{ 1.0 };
+
+	//Bounds spread all around a camera, so about a fifth of them is visible, like an open world scene
+	void CreateBounds(size_t count, CullingBounds& bounds, std::vector<BoundingSphere>& spheres, std::vector<BoundingBox>& boxes)
+	{
+		std::mt19937 random{ 7 };
+		std::uniform_real_distribution<float> position{ -500.f, 500.f };
+		std::uniform_real_distribution<float> size{ 0.5f, 10.f };
+
+		bounds.Resize(count);
+		spheres.resize(count);
+		boxes.resize(count);
+		for (size_t i{ 0 }; i < count; ++i)
+		{
+			const Vector3 center{ position(random), position(random) * 0.1f, position(random) };
+			const Vector3 extent{ size(random), size(random), size(random) };
+			boxes[i] = { center - extent, center + extent };
+			spheres[i] = { center, extent.Magnitude() };
+
+			bounds.SetSphere(i, spheres[i]);
+			bounds.SetBox(i, boxes[i]);
+		}
+	}
+
+	void ReportCulling(const char* name, const Benchmarks::Timing& timing, size_t count, size_t visibleCount)
+	{
+		Benchmarks::Report(name, timing, static_cast<double>(count));
+		std::cout << "    " << std::fixed << std::setprecision(3) << timing.fastest << " ms per frame, " << visibleCount << " visible";
+		if (timing.fastest > g_BudgetTime)
+			std::cout << RED_TEXT(", over the 1 ms budget");
+
+		std::cout << std::defaultfloat << "\n";
+	}
+}
+
+//Frustum culling of [count] bounds, 100k by default, vectorized against the single sphere and box tests it has to agree with.
+//The vector width follows the build: SSE by default, AVX with DAE_AVX2 and none in the scalar matrix backend.
+int main(int argc, char* args[])
+{
+	const size_t count{ argc > 1 ? static_cast<size_t>(std::strtoull(args[1], nullptr, 10)) : 100'000 };
+
+	CullingBounds bounds{};
+	std::vector<BoundingSphere> spheres{};
+	std::vector<BoundingBox> boxes{};
+	CreateBounds(count, bounds, spheres, boxes);
+
+	Camera camera{};
+	camera.Initialize(45.f, { 0.f, 10.f, 0.f }, 16.f / 9.f);
+	camera.CalculateViewMatrix();
+	const Frustum frustum{ Frustum::FromMatrix(camera.viewMatrix * camera.projectionMatrix) };
+
+	std::vector<uint32_t> visibleIndices(count);
+	size_t visibleCount{};
+
+	std::cout << "Frustum culling benchmark, " << count << " bounds\n";
+
+	//Reports after the runs, so the visible count is the one of the kernel that was measured
+	const auto measure = [&](const char* name, auto&& cull)
+		{
+			const Benchmarks::Timing timing{ Benchmarks::Measure(100, [&]()
+				{
+					visibleCount = cull();
+					Benchmarks::g_Sink = static_cast<float>(visibleCount);
+				}) };
+			ReportCulling(name, timing, count, visibleCount);
+		};
+
+	measure("IsSphereOutside loop", [&]()
+		{
+			size_t visible{ 0 };
+			for (uint32_t i{ 0 }; i < count; ++i)
+			{
+				if (!frustum.IsSphereOutside(spheres[i].center, spheres[i].radius))
+					visibleIndices[visible++] = i;
+			}
+			return visible;
+		});
+	measure("CullSpheres", [&]() { return frustum.CullSpheres(bounds, visibleIndices.data()); });
+
+	measure("IsBoxOutside loop", [&]()
+		{
+			size_t visible{ 0 };
+			for (uint32_t i{ 0 }; i < count; ++i)
+			{
+				if (!frustum.IsBoxOutside(boxes[i]))
+					visibleIndices[visible++] = i;
+			}
+			return visible;
+		});
+	measure("CullBoxes", [&]() { return frustum.CullBoxes(bounds, visibleIndices.data()); });
+
+	measure("Cull (sphere and box)", [&]() { return frustum.Cull(bounds, visibleIndices.data()); });
+	return 0;
+}
@@ -0,0 +1,86 @@
+#include "pch.h"
+#include "Benchmark.h"
+#include "OutOfLineMath.h"
+#include <random>
+
+using namespace dae;
+
+//Microbenchmarks of the Matrix operations the renderer runs per mesh and frame.
+//Built twice, as DirectXMatrixBenchmark with the SSE backend and DirectXMatrixBenchmarkScalar with DAE_MATRIX_SCALAR.
+//Comparing the two shows what SSE wins, the "out of line" case in either shows what inlining wins.
+int main()
+{
+	constexpr uint32_t matrixCount{ 4096 };
+	constexpr uint32_t repetitionCount{ 200 };
+
+	std::mt19937 random{ 7 };
+	std::uniform_real_distribution<float> value{ -3.f, 3.f };
+
+	//InverseRigid only takes the rotation and translation, the rest get the scale of a Transform as well
+	std::vector<Matrix> rigidMatrices(matrixCount);
+	std::vector<Matrix> matrices(matrixCount);
+	for (uint32_t i{ 0 }; i < matrixCount; ++i)
+	{
+		rigidMatrices[i] = Matrix::CreateRotation(value(random), value(random), value(random)) * Matrix::CreateTranslation(value(random), value(random), value(random));
+		matrices[i] = Matrix::CreateScale(1.5f, 0.7f, 2.f) * rigidMatrices[i];
+	}
+
+	const Matrix viewMatrix{ Matrix::Inverse(Matrix::CreateTranslation(0.f, 0.f, -50.f)) };
+	const Matrix projectionMatrix{ Matrix::CreatePerspectiveFovLH(0.8f, 1.33f, 0.1f, 100.f) };
+	const Vector3 cameraPosition{ 0.f, 0.f, -50.f };
+
+#ifdef DAE_MATRIX_SSE
+	std::cout << "Matrix benchmark, SSE backend\n";
+#else
+	std::cout << "Matrix benchmark, scalar backend\n";
+#endif
+
+	const auto runOn = [&](const char* name, const std::vector<Matrix>& inputs, auto&& operation)
+		{
+			const Benchmarks::Timing timing{ Benchmarks::Measure(repetitionCount, [&]()
+				{
+					float sum{ 0.f };
+					for (uint32_t i{ 0 }; i < matrixCount; ++i)
+						sum += operation(inputs[i], inputs[(i + 1) % matrixCount]);
+
+					Benchmarks::g_Sink = sum;
+				}) };
+
+			Benchmarks::Report(name, timing, matrixCount);
+		};
+	const auto run = [&](const char* name, auto&& operation) { runOn(name, matrices, operation); };
+
+	run("operator*", [](const Matrix& a, const Matrix& b) { return (a * b)[3][3]; });
+	run("operator*=", [](const Matrix& a, const Matrix& b) { Matrix m{ a }; m *= b; return m[3][3]; });
+	run("operator*= itself", [](const Matrix& a, const Matrix&) { Matrix m{ a }; m *= m; return m[3][3]; });
+	run("Transpose", [](const Matrix& a, const Matrix&) { return Matrix::Transpose(a)[3][0]; });
+	run("Inverse", [](const Matrix& a, const Matrix&) { return Matrix::Inverse(a)[3][0]; });
+	run("InverseAffine", [](const Matrix& a, const Matrix&) { return Matrix::InverseAffine(a)[3][0]; });
+	runOn("InverseRigid", rigidMatrices, [](const Matrix& a, const Matrix&) { return Matrix::InverseRigid(a)[3][0]; });
+	run("CreateNormalMatrix", [](const Matrix& a, const Matrix&) { return Matrix::CreateNormalMatrix(a)[2][0]; });
+	run("TransformPoint", [](const Matrix& a, const Matrix& b) { return a.TransformPoint(b.GetTranslation()).x; });
+	run("TransformVector", [](const Matrix& a, const Matrix& b) { return a.TransformVector(b.GetTranslation()).x; });
+	run("TransformPoint Vector4", [](const Matrix& a, const Matrix& b) { return a.TransformPoint(Vector4{ b.GetTranslation(), 1.f }).w; });
+
+	//What Mesh::SetMatrix and Mesh::SelectLod do per mesh, inlined, then with every math call made through OutOfLineMath.cpp
+	//like before the math types were header-only. The arithmetic is the same, the difference is what inlining wins.
+	run("Mesh::SetMatrix", [&](const Matrix& worldMatrix, const Matrix&)
+		{
+			const Matrix worldViewProjectionMatrix{ worldMatrix * (viewMatrix * projectionMatrix) };
+			const Vector3 localCameraPosition{ Matrix::InverseAffine(worldMatrix).TransformPoint(cameraPosition) };
+			const float worldScale{ std::max({ worldMatrix.GetAxisX().Magnitude(), worldMatrix.GetAxisY().Magnitude(), worldMatrix.GetAxisZ().Magnitude() }) };
+			const Vector3 center{ worldMatrix.TransformPoint(Vector3{ 0.5f, 0.5f, 0.5f }) };
+			return worldViewProjectionMatrix[3][3] + localCameraPosition.x + worldScale + (center - cameraPosition).Magnitude();
+		});
+	run("Mesh::SetMatrix out of line", [&](const Matrix& worldMatrix, const Matrix&)
+		{
+			const Matrix worldViewProjectionMatrix{ OutOfLine::Multiply(worldMatrix, OutOfLine::Multiply(viewMatrix, projectionMatrix)) };
+			const Vector3 localCameraPosition{ OutOfLine::TransformPoint(OutOfLine::InverseAffine(worldMatrix), cameraPosition) };
+			const float worldScale{ std::max({ OutOfLine::Magnitude(OutOfLine::GetAxisX(worldMatrix)), OutOfLine::Magnitude(OutOfLine::GetAxisY(worldMatrix)),
+				OutOfLine::Magnitude(OutOfLine::GetAxisZ(worldMatrix)) }) };
+			const Vector3 center{ OutOfLine::TransformPoint(worldMatrix, Vector3{ 0.5f, 0.5f, 0.5f }) };
+			return worldViewProjectionMatrix[3][3] + localCameraPosition.x + worldScale + OutOfLine::Magnitude(OutOfLine::Subtract(center, cameraPosition));
+		});
+
+	return 0;
+}
@@ -0,0 +1,100 @@
+#include "pch.h"
+#include "Benchmark.h"
+#include "MeshOptimizer.h"
+#include "Utils.h"
+#include <algorithm>
+#include <filesystem>
+#include <string>
+
+using namespace dae;
+
+namespace
+{
+	void PrintVertexCache(const char* name, const MeshOptimizer::VertexCacheStatistics& statistics)
+	{
+		std::cout << "    " << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(3)
+			<< "ACMR " << statistics.ACMR << ", ATVR " << statistics.ATVR << ", " << statistics.transformedVertexCount << " transformed vertices" << std::defaultfloat << "\n";
+	}
+
+	void PrintOverdraw(const char* name, const MeshOptimizer::OverdrawStatistics& statistics)
+	{
+		std::cout << "    " << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(3)
+			<< "overdraw " << statistics.overdraw << ", " << statistics.shadedPixelCount << " shaded of " << statistics.coveredPixelCount << " covered pixels" << std::defaultfloat << "\n";
+	}
+
+	//The welded mesh in file order, then the vertex cache optimization on it, timed and measured before and after
+	std::vector<uint32_t> MeasureVertexCache(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& fileOrderIndices)
+	{
+		std::vector<uint32_t> indices{};
+		const Benchmarks::Timing timing{ Benchmarks::Measure(10, [&]()
+			{
+				indices = fileOrderIndices;
+				MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), vertices.size());
+			}) };
+
+		Benchmarks::Report("OptimizeVertexCache", timing, static_cast<double>(indices.size() / 3));
+		PrintVertexCache("file order", MeshOptimizer::AnalyzeVertexCache(fileOrderIndices.data(), fileOrderIndices.size(), vertices.size()));
+		PrintVertexCache("optimized", MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertices.size()));
+		return indices;
+	}
+
+	//The overdraw optimization on the vertex cache optimized order, like ParseOBJ runs them, with the overdraw of all three orders.
+	//What splitting into clusters costs the vertex cache is printed as well.
+	void MeasureOverdraw(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& fileOrderIndices, const std::vector<uint32_t>& cacheOrderIndices)
+	{
+		std::vector<uint32_t> indices{};
+		const Benchmarks::Timing timing{ Benchmarks::Measure(10, [&]()
+			{
+				indices = cacheOrderIndices;
+				MeshOptimizer::OptimizeOverdraw(indices.data(), indices.size(), vertices.data(), vertices.size());
+			}) };
+
+		Benchmarks::Report("OptimizeOverdraw", timing, static_cast<double>(indices.size() / 3));
+		PrintOverdraw("file order", MeshOptimizer::AnalyzeOverdraw(fileOrderIndices.data(), fileOrderIndices.size(), vertices.data(), vertices.size()));
+		PrintOverdraw("cache order", MeshOptimizer::AnalyzeOverdraw(cacheOrderIndices.data(), cacheOrderIndices.size(), vertices.data(), vertices.size()));
+		PrintOverdraw("optimized", MeshOptimizer::AnalyzeOverdraw(indices.data(), indices.size(), vertices.data(), vertices.size()));
+		PrintVertexCache("optimized", MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertices.size()));
+	}
+}
+
+//The mesh optimizations on every OBJ in Resources, with the metrics of the index buffer before and after them.
+//Run from the source directory so Resources is found.
+int main()
+{
+	if (!std::filesystem::is_directory("Resources"))
+	{
+		std::cout << RED_TEXT("Could not find ") << "Resources, run from the source directory\n";
+		return 1;
+	}
+
+	std::vector<std::filesystem::path> paths{};
+	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator{ "Resources" })
+	{
+		if (entry.path().extension() == ".obj")
+			paths.push_back(entry.path());
+	}
+	std::sort(paths.begin(), paths.end());
+
+	//Welded like the meshes the renderer loads, but left in file order so the optimizations can be measured on their own
+	Utils::OBJParseSettings settings{};
+	settings.optimizeVertexCache = false;
+	settings.optimizeOverdraw = false;
+
+	std::cout << "Mesh optimizer benchmark, " << MeshOptimizer::SimulatedCacheSize << " entry FIFO cache\n";
+	for (const std::filesystem::path& path : paths)
+	{
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+		if (!Utils::ParseOBJ(path.string(), vertices, indices, settings))
+		{
+			std::cout << RED_TEXT("Could not load ") << path.string() << "\n";
+			return 1;
+		}
+
+		std::cout << "\n" << path.generic_string() << ", " << indices.size() / 3 << " triangles, " << vertices.size() << " vertices\n";
+		const std::vector<uint32_t> cacheOrderIndices{ MeasureVertexCache(vertices, indices) };
+		MeasureOverdraw(vertices, indices, cacheOrderIndices);
+	}
+
+	return 0;
+}
@@ -0,0 +1,112 @@
+#include "pch.h"
+#include "Benchmark.h"
+#include "Camera.h"
+#include "Frustum.h"
+#include "Meshlet.h"
+#include "Utils.h"
+#include <filesystem>
+
+using namespace dae;
+
+namespace
+{
+	constexpr int g_OrbitStepCount{ 72 };
+
+	struct OrbitStatistics
+	{
+		Meshlets::CullingStatistics frustum{};
+		Meshlets::CullingStatistics cone{};
+		double frustumTime{};	//Milliseconds for the whole orbit, fastest of the repetitions
+		double coneTime{};
+	};
+
+	void Cull(const MeshletData& meshletData, const Frustum& frustum, const Vector3& cameraPosition, bool cullBackFaces, Meshlets::CullingStatistics& statistics)
+	{
+		for (const Meshlet& meshlet : meshletData.meshlets)
+		{
+			++statistics.meshletCount;
+			statistics.triangleCount += meshlet.triangleCount;
+
+			if (Meshlets::IsCulled(meshlet, frustum, cameraPosition, cullBackFaces))
+			{
+				++statistics.culledMeshletCount;
+				statistics.culledTriangleCount += meshlet.triangleCount;
+			}
+		}
+	}
+
+	//The camera circles the vehicle at distance and height, always looking at its center, the way Mesh culls it with an identity world matrix
+	OrbitStatistics Orbit(const MeshletData& meshletData, const Vector3& target, float distance, float height)
+	{
+		Camera camera{};
+		camera.Initialize(45.f, {}, 16.f / 9.f);
+
+		OrbitStatistics orbit{};
+		const auto measure = [&](bool cullBackFaces, Meshlets::CullingStatistics& statistics)
+			{
+				return Benchmarks::Measure(10, [&]()
+					{
+						statistics = {};
+						for (int step{ 0 }; step < g_OrbitStepCount; ++step)
+						{
+							//Yaw 0 looks down +z from -z, like the Renderer's camera
+							const float angle{ step * 2.f * PI / g_OrbitStepCount };
+							camera.origin = target + Vector3{ -std::sin(angle) * distance, height, -std::cos(angle) * distance };
+							camera.totalYaw = angle;
+							camera.totalPitch = -std::atan2(height, distance);
+							camera.CalculateViewMatrix();
+							Cull(meshletData, Frustum::FromMatrix(camera.viewMatrix * camera.projectionMatrix), camera.origin, cullBackFaces, statistics);
+						}
+						Benchmarks::g_Sink = static_cast<float>(statistics.culledTriangleCount);
+					}).fastest;
+			};
+
+		orbit.frustumTime = measure(false, orbit.frustum);
+		orbit.coneTime = measure(true, orbit.cone);
+		return orbit;
+	}
+
+	void PrintCulling(const char* name, const Meshlets::CullingStatistics& statistics, double time)
+	{
+		std::cout << "    " << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(1)
+			<< 100.0 * statistics.culledMeshletCount / statistics.meshletCount << "% of the meshlets and "
+			<< 100.0 * statistics.culledTriangleCount / statistics.triangleCount << "% of the triangles culled, "
+			<< std::setprecision(2) << time * 1e6 / statistics.meshletCount << " ns per meshlet" << std::defaultfloat << "\n";
+	}
+}
+
+//Meshlet culling on Resources/vehicle.obj, with the frustum alone and with the normal cones as well, averaged over a camera orbiting the vehicle.
+//Run from the source directory so Resources is found.
+int main()
+{
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+	if (!Utils::ParseOBJ("Resources/vehicle.obj", vertices, indices, Utils::OBJParseSettings{}))
+	{
+		std::cout << RED_TEXT("Could not load ") << "Resources/vehicle.obj, run from the source directory\n";
+		return 1;
+	}
+
+	MeshletData meshletData{};
+	Meshlets::Build(vertices.data(), vertices.size(), indices.data(), indices.size(), meshletData);
+
+	BoundingBox bounds{};
+	for (const Vertex& vertex : vertices)
+		bounds.Grow(vertex.position);
+	const Vector3 center{ (bounds.min + bounds.max) * 0.5f };
+
+	std::cout << "Meshlet culling benchmark, vehicle.obj, " << meshletData.meshlets.size() << " meshlets for " << indices.size() / 3
+		<< " triangles, " << g_OrbitStepCount << " views per orbit\n";
+
+	//The distance of the Renderer's camera, then close enough that most of the vehicle is out of view, level and from above
+	const float orbits[][2]{ { 50.f, 0.f }, { 50.f, 30.f }, { 12.f, 0.f }, { 12.f, 8.f } };
+	for (const auto& [distance, height] : orbits)
+	{
+		const OrbitStatistics orbit{ Orbit(meshletData, center, distance, height) };
+		std::cout << "\n  orbit at distance " << distance << ", height " << height << "\n";
+		PrintCulling("frustum", orbit.frustum, orbit.frustumTime);
+		PrintCulling("frustum + cone", orbit.cone, orbit.coneTime);
+	}
+
+	return 0;
+}
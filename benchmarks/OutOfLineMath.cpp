@@ -0,0 +1,48 @@
+#include "pch.h"
+#include "OutOfLineMath.h"
+
+namespace dae
+{
+	namespace OutOfLine
+	{
+		Matrix Multiply(const Matrix& a, const Matrix& b)
+		{
+			return a * b;
+		}
+
+		Matrix InverseAffine(const Matrix& m)
+		{
+			return Matrix::InverseAffine(m);
+		}
+
+		Vector3 TransformPoint(const Matrix& m, const Vector3& p)
+		{
+			return m.TransformPoint(p);
+		}
+
+		Vector3 GetAxisX(const Matrix& m)
+		{
+			return m.GetAxisX();
+		}
+
+		Vector3 GetAxisY(const Matrix& m)
+		{
+			return m.GetAxisY();
+		}
+
+		Vector3 GetAxisZ(const Matrix& m)
+		{
+			return m.GetAxisZ();
+		}
+
+		Vector3 Subtract(const Vector3& a, const Vector3& b)
+		{
+			return a - b;
+		}
+
+		float Magnitude(const Vector3& v)
+		{
+			return v.Magnitude();
+		}
+	}
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include "Matrix.h"
+
+namespace dae
+{
+	//The math operations of the Mesh::SetMatrix benchmark compiled in their own translation unit, so every call stays a call
+	//like it was before the math types became header-only. Only the inlining differs from the Matrix functions they forward to.
+	namespace OutOfLine
+	{
+		Matrix Multiply(const Matrix& a, const Matrix& b);
+		Matrix InverseAffine(const Matrix& m);
+		Vector3 TransformPoint(const Matrix& m, const Vector3& p);
+		Vector3 GetAxisX(const Matrix& m);
+		Vector3 GetAxisY(const Matrix& m);
+		Vector3 GetAxisZ(const Matrix& m);
+
+		Vector3 Subtract(const Vector3& a, const Vector3& b);
+		float Magnitude(const Vector3& v);
+	}
+}
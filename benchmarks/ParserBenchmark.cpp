@@ -0,0 +1,252 @@
+#include "pch.h"
+#include "Benchmark.h"
+#include "ObjStream.h"
+#include "Parallel.h"
+#include "Utils.h"
+#include <charconv>
+#include <cstring>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+using namespace dae;
+
+namespace
+{
+	//The std::ifstream loop ParseOBJ replaced, without its tangents: the benchmark adds the same CalculateTangents as ParseOBJ,
+	//so the difference between the two is the reading and tokenizing of the file. It stops on a failed read instead of on eof,
+	//which repeated the last face of files that end in a newline.
+	bool ParseOBJStream(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding)
+	{
+		std::ifstream file(filename);
+		if (!file)
+			return false;
+
+		std::vector<Vector3> positions{};
+		std::vector<Vector3> normals{};
+		std::vector<Vector2> UVs{};
+
+		vertices.clear();
+		indices.clear();
+
+		std::string sCommand;
+		while (file >> sCommand)
+		{
+			if (sCommand == "v")
+			{
+				float x, y, z;
+				file >> x >> y >> z;
+				positions.emplace_back(x, y, z);
+			}
+			else if (sCommand == "vt")
+			{
+				float u, v;
+				file >> u >> v;
+				UVs.emplace_back(u, 1 - v);
+			}
+			else if (sCommand == "vn")
+			{
+				float x, y, z;
+				file >> x >> y >> z;
+				normals.emplace_back(x, y, z);
+			}
+			else if (sCommand == "f")
+			{
+				Vertex vertex{};
+				size_t iPosition, iTexCoord, iNormal;
+
+				uint32_t tempIndices[3];
+				for (size_t iFace = 0; iFace < 3; iFace++)
+				{
+					file >> iPosition;
+					vertex.position = positions[iPosition - 1];
+
+					if ('/' == file.peek())
+					{
+						file.ignore();
+
+						if ('/' != file.peek())
+						{
+							file >> iTexCoord;
+							vertex.uv = UVs[iTexCoord - 1];
+						}
+
+						if ('/' == file.peek())
+						{
+							file.ignore();
+							file >> iNormal;
+							vertex.normal = normals[iNormal - 1];
+						}
+					}
+
+					vertices.push_back(vertex);
+					tempIndices[iFace] = uint32_t(vertices.size()) - 1;
+				}
+
+				indices.push_back(tempIndices[0]);
+				indices.push_back(tempIndices[flipAxisAndWinding ? 2 : 1]);
+				indices.push_back(tempIndices[flipAxisAndWinding ? 1 : 2]);
+			}
+			file.ignore(1000, '\n');
+		}
+
+		Utils::CalculateTangents(vertices, indices, flipAxisAndWinding, 1);
+		return true;
+	}
+
+	//Rows of a height field with a uv and normal per vertex and two triangles per quad, written until it has at least faceCount faces
+	void WriteSyntheticOBJ(const std::filesystem::path& path, uint64_t faceCount)
+	{
+		constexpr uint32_t gridWidth{ 1024 };
+		constexpr int quadTriangles[2][3]{ { 0, 1, 2 }, { 0, 2, 3 } };
+
+		std::ofstream file{ path, std::ios::binary };
+		std::string text{};
+		const auto append = [&text](auto value)
+			{
+				char digits[32];
+				text.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr);
+			};
+
+		uint64_t writtenFaceCount{ 0 };
+		for (uint64_t row{ 0 }; writtenFaceCount < faceCount; ++row)
+		{
+			for (uint32_t column{ 0 }; column < gridWidth; ++column)
+			{
+				const float x{ static_cast<float>(column) };
+				const float z{ static_cast<float>(row) };
+				text += "v "; append(x); text += ' '; append(std::sin(x * 0.1f) * std::cos(z * 0.1f)); text += ' '; append(z); text += '\n';
+				text += "vt "; append(x / gridWidth); text += ' '; append(static_cast<float>(row % 1024) / 1024.f); text += '\n';
+				text += "vn 0 1 0\n";
+			}
+
+			if (row > 0)
+			{
+				//1-based, faces between this row and the one above it
+				const uint64_t firstVertex{ row * gridWidth + 1 };
+				const uint64_t firstVertexAbove{ firstVertex - gridWidth };
+				for (uint32_t column{ 0 }; column + 1 < gridWidth && writtenFaceCount < faceCount; ++column)
+				{
+					const uint64_t quad[4]{ firstVertexAbove + column, firstVertexAbove + column + 1, firstVertex + column + 1, firstVertex + column };
+					for (const auto& triangle : quadTriangles)
+					{
+						text += 'f';
+						for (const int corner : triangle)
+						{
+							const uint64_t index{ quad[corner] };
+							text += ' '; append(index); text += '/'; append(index); text += '/'; append(index);
+						}
+						text += '\n';
+					}
+
+					writtenFaceCount += 2;
+				}
+			}
+
+			file.write(text.data(), text.size());
+			text.clear();
+		}
+	}
+
+	//The std::ifstream loop, ParseOBJ on one thread without welding or optimizations, which gives the same output, and StreamOBJ
+	void CompareParsers(const std::string& filename, uint32_t repetitionCount)
+	{
+		Utils::OBJParseSettings settings{};
+		settings.weldVertices = false;
+		settings.optimizeVertexCache = false;
+		settings.optimizeOverdraw = false;
+
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+
+		Benchmarks::Report("std::ifstream", Benchmarks::Measure(repetitionCount, [&]()
+			{
+				ParseOBJStream(filename, vertices, indices, true);
+				Benchmarks::g_Sink = vertices.back().tangent.x;
+			}));
+		const std::vector<Vertex> streamVertices{ vertices };
+		const std::vector<uint32_t> streamIndices{ indices };
+
+		Benchmarks::Report("ParseOBJ mapped", Benchmarks::Measure(repetitionCount, [&]()
+			{
+				Utils::ParseOBJ(filename, vertices, indices, settings);
+				Benchmarks::g_Sink = vertices.back().tangent.x;
+			}));
+
+		//Without welding and optimizations ParseOBJ keeps every corner in file order, so anything but the same bytes is a parser difference
+		const bool areVerticesEqual{ vertices.size() == streamVertices.size()
+			&& std::memcmp(vertices.data(), streamVertices.data(), vertices.size() * sizeof(Vertex)) == 0 };
+		if (!areVerticesEqual || indices != streamIndices)
+			std::cout << RED_TEXT("  ParseOBJ differs from std::ifstream: ") << vertices.size() << " of " << streamVertices.size() << " vertices, "
+				<< indices.size() << " of " << streamIndices.size() << " indices, " << (areVerticesEqual ? "equal" : "different") << " vertex bytes\n";
+
+		//Drops the output before the streaming run, which never holds more than a batch of it
+		vertices = {};
+		indices = {};
+
+		Benchmarks::Report("StreamOBJ", Benchmarks::Measure(repetitionCount, [&]()
+			{
+				float sum{ 0.f };
+				Utils::StreamOBJ(filename, {}, [&sum](const Utils::OBJBatch& batch) { sum += batch.pVertices[0].tangent.x; });
+				Benchmarks::g_Sink = sum;
+			}));
+	}
+
+	//The same parse as CompareParsers with 1 to maxThreadCount threads
+	void MeasureScaling(const std::string& filename, uint32_t maxThreadCount, uint32_t repetitionCount)
+	{
+		Utils::OBJParseSettings settings{};
+		settings.weldVertices = false;
+		settings.optimizeVertexCache = false;
+		settings.optimizeOverdraw = false;
+
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+
+		double singleThreadTime{};
+		for (uint32_t threadCount{ 1 }; threadCount <= maxThreadCount; ++threadCount)
+		{
+			settings.threadCount = threadCount;
+			const Benchmarks::Timing timing{ Benchmarks::Measure(repetitionCount, [&]()
+				{
+					Utils::ParseOBJ(filename, vertices, indices, settings);
+					Benchmarks::g_Sink = vertices.back().tangent.x;
+				}) };
+
+			if (threadCount == 1)
+				singleThreadTime = timing.fastest;
+
+			const std::string name{ "ParseOBJ " + std::to_string(threadCount) + (threadCount == 1 ? " thread" : " threads") };
+			Benchmarks::Report(name.c_str(), timing);
+			std::cout << "    speedup " << std::fixed << std::setprecision(2) << singleThreadTime / timing.fastest << std::defaultfloat << "\n";
+		}
+	}
+}
+
+//The OBJ parsers on Resources/vehicle.obj and a generated mesh, then ParseOBJ per thread count.
+//[faceCount] [maxThreadCount], by default a 10M face mesh and every hardware thread. Run from the source directory so Resources is found.
+int main(int argc, char* args[])
+{
+	const uint64_t faceCount{ argc > 1 ? std::strtoull(args[1], nullptr, 10) : 10'000'000ull };
+	const uint32_t maxThreadCount{ Parallel::ResolveThreadCount(argc > 2 ? static_cast<uint32_t>(std::atoi(args[2])) : 0) };
+
+	const std::string vehicleFilename{ "Resources/vehicle.obj" };
+	if (!std::filesystem::exists(vehicleFilename))
+	{
+		std::cout << RED_TEXT("Could not find ") << vehicleFilename << ", run from the source directory\n";
+		return 1;
+	}
+
+	std::cout << "OBJ parser benchmark, " << vehicleFilename << "\n";
+	CompareParsers(vehicleFilename, 20);
+	MeasureScaling(vehicleFilename, maxThreadCount, 20);
+
+	const std::filesystem::path syntheticPath{ std::filesystem::temp_directory_path() / "dae_parser_benchmark.obj" };
+	WriteSyntheticOBJ(syntheticPath, faceCount);
+	std::cout << "\nOBJ parser benchmark, " << faceCount << " generated faces (" << std::filesystem::file_size(syntheticPath) / (1024 * 1024) << " MB)\n";
+	CompareParsers(syntheticPath.string(), 1);
+	MeasureScaling(syntheticPath.string(), maxThreadCount, 1);
+
+	std::filesystem::remove(syntheticPath);
+	return 0;
+}
@@ -0,0 +1,202 @@
+#include "pch.h"
+#include "Benchmark.h"
+#include "Camera.h"
+#include "Parallel.h"
+#include "SoftwareRasterizer.h"
+#include "SoftwareTexture.h"
+#include "Utils.h"
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <utility>
+
+using namespace dae;
+
+namespace
+{
+	//vehicle.obj with its maps and the camera of Renderer, like RenderSoftware draws it
+	struct VehicleScene
+	{
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+		SoftwareTexture diffuseMap{ "Resources/vehicle_diffuse.png" };
+		SoftwareTexture normalMap{ "Resources/vehicle_normal.png" };
+		SoftwareTexture specularMap{ "Resources/vehicle_specular.png" };
+		SoftwareTexture glossinessMap{ "Resources/vehicle_gloss.png" };
+		PhongShader::Material material{};
+
+		bool Load()
+		{
+			Utils::OBJParseSettings parseSettings{};
+			parseSettings.threadCount = 0;
+			if (!Utils::ParseOBJ("Resources/vehicle.obj", vertices, indices, parseSettings))
+				return false;
+
+			material.pDiffuseMap = diffuseMap.IsValid() ? &diffuseMap : nullptr;
+			material.pNormalMap = normalMap.IsValid() ? &normalMap : nullptr;
+			material.pSpecularMap = specularMap.IsValid() ? &specularMap : nullptr;
+			material.pGlossinessMap = glossinessMap.IsValid() ? &glossinessMap : nullptr;
+			return true;
+		}
+
+		//Clears, draws the vehicle and flushes, one frame of RenderSoftware
+		void Render(SoftwareRasterizer& rasterizer) const
+		{
+			const Framebuffer& framebuffer{ rasterizer.GetFramebuffer() };
+			Camera camera{ Vector3(0.0f, 0.0f, -50.0f), 45.0f };
+			camera.Initialize(45.0f, Vector3(0.0f, 0.0f, -50.0f), float(framebuffer.width) / float(framebuffer.height));
+			camera.CalculateViewMatrix();
+
+			rasterizer.SetMaterial(material);
+			rasterizer.SetCameraPosition(camera.origin);
+			rasterizer.Clear({ 0.39f, 0.59f, 0.93f });
+			rasterizer.Draw(vertices.data(), vertices.size(), indices.data(), indices.size(), PrimitiveTopology::TriangleList,
+				Matrix::Identity, camera.viewMatrix * camera.projectionMatrix);
+			rasterizer.Flush();
+		}
+	};
+
+	//A width x height grid of cellSize squares split into two triangles each, drawn straight in clip space
+	void CreateTriangleGrid(uint32_t width, uint32_t height, float cellSize, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		const uint32_t columnCount{ static_cast<uint32_t>(width / cellSize) };
+		const uint32_t rowCount{ static_cast<uint32_t>(height / cellSize) };
+
+		vertices.clear();
+		indices.clear();
+		for (uint32_t row{ 0 }; row <= rowCount; ++row)
+		{
+			for (uint32_t column{ 0 }; column <= columnCount; ++column)
+			{
+				Vertex vertex{};
+				vertex.position = { column * cellSize / width * 2.f - 1.f, 1.f - row * cellSize / height * 2.f, 0.5f };
+				vertex.uv = { column * cellSize / width, row * cellSize / height };
+				vertex.normal = Vector3{ 0.3f, 0.4f, -1.f }.Normalized();
+				vertex.tangent = Vector4{ Vector3::UnitX, 1.f };
+				vertices.push_back(vertex);
+			}
+		}
+
+		for (uint32_t row{ 0 }; row < rowCount; ++row)
+		{
+			for (uint32_t column{ 0 }; column < columnCount; ++column)
+			{
+				const uint32_t i0{ row * (columnCount + 1) + column };
+				const uint32_t i1{ i0 + 1 };
+				const uint32_t i2{ i0 + columnCount + 1 };
+				const uint32_t i3{ i2 + 1 };
+				indices.insert(indices.end(), { i0, i1, i2, i1, i3, i2 });
+			}
+		}
+	}
+
+	//Pixels per second on one core for small, medium and large triangles, where setup, the 8x8 blocks and the shading dominate in turn
+	void MeasureTriangleSizes(const VehicleScene& scene)
+	{
+		constexpr uint32_t width{ 1024 };
+		constexpr uint32_t height{ 1024 };
+		std::cout << "\nFilled " << width << "x" << height << " on 1 thread, the vehicle's material, per triangle size\n";
+
+		SoftwareRasterizer rasterizer{ width, height, 1 };
+		rasterizer.SetMaterial(scene.material);
+
+		const std::pair<const char*, float> cellSizes[]{ { "small (8 pixels)", 4.f }, { "medium (128 pixels)", 16.f }, { "large (8192 pixels)", 128.f } };
+		for (const auto& [name, cellSize] : cellSizes)
+		{
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			CreateTriangleGrid(width, height, cellSize, vertices, indices);
+
+			const Benchmarks::Timing timing{ Benchmarks::Measure(10, [&]()
+				{
+					rasterizer.Clear({ 0.39f, 0.59f, 0.93f });
+					rasterizer.Draw(vertices.data(), vertices.size(), indices.data(), indices.size(), PrimitiveTopology::TriangleList, Matrix::Identity, Matrix::Identity);
+					rasterizer.Flush();
+				}) };
+
+			const double pixelCount{ static_cast<double>(rasterizer.GetStatistics().shadedPixelCount) };
+			Benchmarks::Report(name, timing, pixelCount);
+			std::cout << "    " << std::fixed << std::setprecision(1) << pixelCount / (timing.fastest * 1e3) << " Mpixels/s, "
+				<< indices.size() / 3 << " triangles" << std::defaultfloat << "\n";
+		}
+	}
+
+	//Frames of the vehicle in every shading mode at common resolutions, with the shader lanes each one spends
+	void MeasureShadingModes(const VehicleScene& scene, uint32_t threadCount)
+	{
+		std::cout << "\nvehicle.obj per shading mode on " << threadCount << (threadCount == 1 ? " thread\n" : " threads\n");
+
+		const std::pair<const char*, SoftwareRasterizer::ShadingMode> shadingModes[]{ { "forward", SoftwareRasterizer::ShadingMode::Forward },
+			{ "depth pre-pass", SoftwareRasterizer::ShadingMode::DepthPrePass }, { "visibility buffer", SoftwareRasterizer::ShadingMode::VisibilityBuffer } };
+		const uint32_t resolutions[][2]{ { 640, 480 }, { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 } };
+
+		for (const auto& resolution : resolutions)
+		{
+			std::cout << "  " << resolution[0] << "x" << resolution[1] << "\n";
+			SoftwareRasterizer rasterizer{ resolution[0], resolution[1], threadCount };
+
+			double forwardTime{};
+			for (const auto& [name, shadingMode] : shadingModes)
+			{
+				rasterizer.SetShadingMode(shadingMode);
+				const Benchmarks::Timing timing{ Benchmarks::Measure(10, [&]() { scene.Render(rasterizer); }) };
+				if (shadingMode == SoftwareRasterizer::ShadingMode::Forward)
+					forwardTime = timing.fastest;
+
+				const SoftwareRasterizer::Statistics& statistics{ rasterizer.GetStatistics() };
+				Benchmarks::Report(name, timing);
+				std::cout << "    " << std::fixed << std::setprecision(2) << forwardTime / timing.fastest << "x forward, "
+					<< statistics.shadedLaneCount << " shader lanes for " << statistics.shadedPixelCount << " shaded pixels" << std::defaultfloat << "\n";
+			}
+		}
+	}
+
+	//Frames of the vehicle with 1 to maxThreadCount threads, the tiles are spread over the workers of Parallel::ThreadPool
+	void MeasureThreadScaling(const VehicleScene& scene, uint32_t width, uint32_t height, uint32_t maxThreadCount)
+	{
+		std::cout << "\nvehicle.obj at " << width << "x" << height << " per thread count\n";
+
+		SoftwareRasterizer rasterizer{ width, height };
+		double singleThreadTime{};
+		for (uint32_t threadCount{ 1 }; threadCount <= maxThreadCount; ++threadCount)
+		{
+			rasterizer.SetThreadCount(threadCount);
+			const Benchmarks::Timing timing{ Benchmarks::Measure(20, [&]() { scene.Render(rasterizer); }) };
+
+			if (threadCount == 1)
+				singleThreadTime = timing.fastest;
+
+			const std::string name{ std::to_string(threadCount) + (threadCount == 1 ? " thread" : " threads") };
+			Benchmarks::Report(name.c_str(), timing);
+			std::cout << "    speedup " << std::fixed << std::setprecision(2) << singleThreadTime / timing.fastest << std::defaultfloat << "\n";
+		}
+	}
+}
+
+//The software rasterizer per triangle size, and on Resources/vehicle.obj per shading mode and thread count.
+//[width] [height] [maxThreadCount], by default 1920x1080 and every hardware thread. Run from the source directory so Resources is found.
+int main(int argc, char* args[])
+{
+	const uint32_t width{ argc > 1 ? static_cast<uint32_t>(std::atoi(args[1])) : 1920u };
+	const uint32_t height{ argc > 2 ? static_cast<uint32_t>(std::atoi(args[2])) : 1080u };
+	const uint32_t maxThreadCount{ Parallel::ResolveThreadCount(argc > 3 ? static_cast<uint32_t>(std::atoi(args[3])) : 0) };
+
+	if (!std::filesystem::exists("Resources/vehicle.obj"))
+	{
+		std::cout << RED_TEXT("Could not find ") << "Resources/vehicle.obj, run from the source directory\n";
+		return 1;
+	}
+
+	VehicleScene scene{};
+	if (!scene.Load())
+	{
+		std::cout << RED_TEXT("Could not load ") << "Resources/vehicle.obj\n";
+		return 1;
+	}
+
+	std::cout << "Software rasterizer benchmark\n";
+	MeasureTriangleSizes(scene);
+	MeasureShadingModes(scene, maxThreadCount);
+	MeasureThreadScaling(scene, width, height, maxThreadCount);
+	return 0;
+}
@@ -0,0 +1,12 @@
+#include "pch.h"
+#include "SoftwareRender.h"
+
+using namespace dae;
+
+//The --software path of the DirectX build on its own, for machines without Windows, a window or a GPU.
+//[--software] [output.png|output.ppm] [width] [height] [threads] [forward|prepass|visibility], run from the source directory so Resources is found
+int main(int argc, char* args[])
+{
+	const int firstArgument{ argc > 1 && std::string{ args[1] } == "--software" ? 2 : 1 };
+	return RenderSoftware(argc, args, firstArgument);
+}
@@ -0,0 +1,422 @@
+#include "pch.h"
+#include "BatchTransform.h"
+#include "Matrix.h"
+
+//Follows the Matrix backend, AVX is used when the compiler is allowed to emit it (/arch:AVX2)
+#ifdef DAE_MATRIX_SSE
+#define DAE_BATCH_SSE
+#if defined(__AVX__)
+#define DAE_BATCH_AVX
+#include <immintrin.h>
+#endif
+#endif
+
+namespace dae
+{
+	namespace
+	{
+		//Elements converted to structure of arrays at a time, small enough to stay on the stack and in L1
+		constexpr size_t g_BlockSize{ 256 };
+
+#ifdef DAE_BATCH_SSE
+		struct Sse
+		{
+			using Register = __m128;
+			static constexpr size_t Width{ 4 };
+
+			static Register Load(const float* p) { return _mm_loadu_ps(p); }
+			static void Store(float* p, Register value) { _mm_storeu_ps(p, value); }
+			static Register Set(float value) { return _mm_set1_ps(value); }
+			static Register Add(Register a, Register b) { return _mm_add_ps(a, b); }
+			static Register Mul(Register a, Register b) { return _mm_mul_ps(a, b); }
+			static Register Sqrt(Register value) { return _mm_sqrt_ps(value); }
+			static Register Div(Register a, Register b) { return _mm_div_ps(a, b); }
+			//Zero where value is zero, so degenerate directions stay zero instead of turning into NaN
+			static Register MaskNonZero(Register result, Register value) { return _mm_and_ps(result, _mm_cmpneq_ps(value, _mm_setzero_ps())); }
+			template<int Selector>
+			static Register Shuffle(Register a, Register b) { return _mm_shuffle_ps(a, b, Selector); }
+			static Register UnpackLow(Register a, Register b) { return _mm_unpacklo_ps(a, b); }
+			static Register UnpackHigh(Register a, Register b) { return _mm_unpackhi_ps(a, b); }
+
+			//Width packed Vector3s as three registers
+			static void LoadPacked(const float* p, Register& a, Register& b, Register& c) { a = Load(p); b = Load(p + 4); c = Load(p + 8); }
+			static void StorePacked(float* p, Register a, Register b, Register c) { Store(p, a); Store(p + 4, b); Store(p + 8, c); }
+		};
+#endif
+
+#ifdef DAE_BATCH_AVX
+		//Shuffles and unpacks work within each 128 bit half, so the low half holds the first four Vector3s and the high half the next four
+		struct Avx
+		{
+			using Register = __m256;
+			static constexpr size_t Width{ 8 };
+
+			static Register Load(const float* p) { return _mm256_loadu_ps(p); }
+			static void Store(float* p, Register value) { _mm256_storeu_ps(p, value); }
+			static Register Set(float value) { return _mm256_set1_ps(value); }
+			static Register Add(Register a, Register b) { return _mm256_add_ps(a, b); }
+			static Register Mul(Register a, Register b) { return _mm256_mul_ps(a, b); }
+			static Register Sqrt(Register value) { return _mm256_sqrt_ps(value); }
+			static Register Div(Register a, Register b) { return _mm256_div_ps(a, b); }
+			static Register MaskNonZero(Register result, Register value) { return _mm256_and_ps(result, _mm256_cmp_ps(value, _mm256_setzero_ps(), _CMP_NEQ_OQ)); }
+			template<int Selector>
+			static Register Shuffle(Register a, Register b) { return _mm256_shuffle_ps(a, b, Selector); }
+			static Register UnpackLow(Register a, Register b) { return _mm256_unpacklo_ps(a, b); }
+			static Register UnpackHigh(Register a, Register b) { return _mm256_unpackhi_ps(a, b); }
+
+			static Register Combine(const float* pLow, const float* pHigh) { return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(pLow)), _mm_loadu_ps(pHigh), 1); }
+			static void Split(float* pLow, float* pHigh, Register value) { _mm_storeu_ps(pLow, _mm256_castps256_ps128(value)); _mm_storeu_ps(pHigh, _mm256_extractf128_ps(value, 1)); }
+
+			static void LoadPacked(const float* p, Register& a, Register& b, Register& c) { a = Combine(p, p + 12); b = Combine(p + 4, p + 16); c = Combine(p + 8, p + 20); }
+			static void StorePacked(float* p, Register a, Register b, Register c) { Split(p, p + 12, a); Split(p + 4, p + 16, b); Split(p + 8, p + 20, c); }
+		};
+#endif
+
+#ifdef DAE_BATCH_SSE
+		//The matrix elements a kernel needs, broadcast once per call
+		template<typename Simd, int ColumnCount>
+		struct Columns
+		{
+			typename Simd::Register m[4][ColumnCount];
+
+			explicit Columns(const Matrix& matrix)
+			{
+				for (int row{ 0 }; row < 4; ++row)
+				{
+					for (int column{ 0 }; column < ColumnCount; ++column)
+						m[row][column] = Simd::Set(matrix[row][column]);
+				}
+			}
+		};
+
+		//x * m[0][c] + y * m[1][c] + z * m[2][c] (+ m[3][c] for points), in the order Matrix::TransformPoint adds them
+		template<typename Simd, bool IsPoint, int ColumnCount>
+		typename Simd::Register Combine(const Columns<Simd, ColumnCount>& columns, int column, typename Simd::Register x, typename Simd::Register y, typename Simd::Register z)
+		{
+			typename Simd::Register result{ Simd::Mul(x, columns.m[0][column]) };
+			result = Simd::Add(result, Simd::Mul(y, columns.m[1][column]));
+			result = Simd::Add(result, Simd::Mul(z, columns.m[2][column]));
+			if constexpr (IsPoint)
+				result = Simd::Add(result, columns.m[3][column]);
+
+			return result;
+		}
+
+		//x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3 to x0 x1 x2 x3 | y0 y1 y2 y3 | z0 z1 z2 z3, and back
+		template<typename Simd>
+		void Deinterleave(typename Simd::Register a, typename Simd::Register b, typename Simd::Register c,
+			typename Simd::Register& x, typename Simd::Register& y, typename Simd::Register& z)
+		{
+			x = Simd::template Shuffle<_MM_SHUFFLE(2, 0, 3, 0)>(a, Simd::template Shuffle<_MM_SHUFFLE(1, 1, 2, 2)>(b, c));
+			y = Simd::template Shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(Simd::template Shuffle<_MM_SHUFFLE(0, 0, 1, 1)>(a, b), Simd::template Shuffle<_MM_SHUFFLE(2, 2, 3, 3)>(b, c));
+			z = Simd::template Shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(Simd::template Shuffle<_MM_SHUFFLE(1, 1, 2, 2)>(a, b), Simd::template Shuffle<_MM_SHUFFLE(3, 3, 0, 0)>(c, c));
+		}
+
+		template<typename Simd>
+		void Interleave(typename Simd::Register x, typename Simd::Register y, typename Simd::Register z,
+			typename Simd::Register& a, typename Simd::Register& b, typename Simd::Register& c)
+		{
+			a = Simd::template Shuffle<_MM_SHUFFLE(2, 0, 1, 0)>(Simd::UnpackLow(x, y), Simd::template Shuffle<_MM_SHUFFLE(1, 1, 0, 0)>(z, x));
+			b = Simd::template Shuffle<_MM_SHUFFLE(1, 0, 2, 0)>(Simd::template Shuffle<_MM_SHUFFLE(1, 1, 1, 1)>(y, z), Simd::UnpackHigh(x, y));
+			c = Simd::template Shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(Simd::template Shuffle<_MM_SHUFFLE(3, 3, 2, 2)>(z, x), Simd::template Shuffle<_MM_SHUFFLE(3, 3, 3, 3)>(y, z));
+		}
+
+		//Each kernel handles whole registers from index i on and returns where it stopped, the next narrower one continues from there.
+		//All inputs of a group are loaded before its results are stored, so the destination may be the source.
+		template<typename Simd, bool IsPoint, int ColumnCount>
+		size_t TransformComponents(const Matrix& matrix, const float* const* ppSource, size_t i, size_t count, float* const* ppDestination)
+		{
+			const Columns<Simd, ColumnCount> columns{ matrix };
+			for (; i + Simd::Width <= count; i += Simd::Width)
+			{
+				const typename Simd::Register x{ Simd::Load(ppSource[0] + i) };
+				const typename Simd::Register y{ Simd::Load(ppSource[1] + i) };
+				const typename Simd::Register z{ Simd::Load(ppSource[2] + i) };
+
+				typename Simd::Register results[ColumnCount];
+				for (int column{ 0 }; column < ColumnCount; ++column)
+					results[column] = Combine<Simd, IsPoint>(columns, column, x, y, z);
+
+				for (int column{ 0 }; column < ColumnCount; ++column)
+					Simd::Store(ppDestination[column] + i, results[column]);
+			}
+
+			return i;
+		}
+
+		template<typename Simd, bool IsPoint>
+		size_t TransformPacked(const Matrix& matrix, const Vector3* pSource, size_t i, size_t count, Vector3* pDestination)
+		{
+			const Columns<Simd, 3> columns{ matrix };
+			for (; i + Simd::Width <= count; i += Simd::Width)
+			{
+				typename Simd::Register a, b, c, x, y, z;
+				Simd::LoadPacked(&pSource[i].x, a, b, c);
+				Deinterleave<Simd>(a, b, c, x, y, z);
+
+				Interleave<Simd>(
+					Combine<Simd, IsPoint>(columns, 0, x, y, z),
+					Combine<Simd, IsPoint>(columns, 1, x, y, z),
+					Combine<Simd, IsPoint>(columns, 2, x, y, z), a, b, c);
+				Simd::StorePacked(&pDestination[i].x, a, b, c);
+			}
+
+			return i;
+		}
+
+		template<typename Simd>
+		size_t NormalizeComponents(float* pX, float* pY, float* pZ, size_t i, size_t count)
+		{
+			for (; i + Simd::Width <= count; i += Simd::Width)
+			{
+				const typename Simd::Register x{ Simd::Load(pX + i) };
+				const typename Simd::Register y{ Simd::Load(pY + i) };
+				const typename Simd::Register z{ Simd::Load(pZ + i) };
+
+				const typename Simd::Register length{ Simd::Sqrt(Simd::Add(Simd::Add(Simd::Mul(x, x), Simd::Mul(y, y)), Simd::Mul(z, z))) };
+				Simd::Store(pX + i, Simd::MaskNonZero(Simd::Div(x, length), length));
+				Simd::Store(pY + i, Simd::MaskNonZero(Simd::Div(y, length), length));
+				Simd::Store(pZ + i, Simd::MaskNonZero(Simd::Div(z, length), length));
+			}
+
+			return i;
+		}
+#endif
+
+		template<bool IsPoint, int ColumnCount>
+		void TransformComponents(const Matrix& matrix, const float* const* ppSource, size_t count, float* const* ppDestination)
+		{
+			size_t i{ 0 };
+#ifdef DAE_BATCH_AVX
+			i = TransformComponents<Avx, IsPoint, ColumnCount>(matrix, ppSource, i, count, ppDestination);
+#endif
+#ifdef DAE_BATCH_SSE
+			i = TransformComponents<Sse, IsPoint, ColumnCount>(matrix, ppSource, i, count, ppDestination);
+#endif
+
+			float m[4][ColumnCount]{};
+			for (int row{ 0 }; row < 4; ++row)
+			{
+				for (int column{ 0 }; column < ColumnCount; ++column)
+					m[row][column] = matrix[row][column];
+			}
+
+			for (; i < count; ++i)
+			{
+				const float x{ ppSource[0][i] };
+				const float y{ ppSource[1][i] };
+				const float z{ ppSource[2][i] };
+
+				float results[ColumnCount]{};
+				for (int column{ 0 }; column < ColumnCount; ++column)
+				{
+					results[column] = x * m[0][column] + y * m[1][column] + z * m[2][column];
+					if constexpr (IsPoint)
+						results[column] += m[3][column];
+				}
+
+				for (int column{ 0 }; column < ColumnCount; ++column)
+					ppDestination[column][i] = results[column];
+			}
+		}
+
+		template<bool IsPoint>
+		void TransformPacked(const Matrix& matrix, const Vector3* pSource, size_t count, Vector3* pDestination)
+		{
+			size_t i{ 0 };
+#ifdef DAE_BATCH_AVX
+			i = TransformPacked<Avx, IsPoint>(matrix, pSource, i, count, pDestination);
+#endif
+#ifdef DAE_BATCH_SSE
+			i = TransformPacked<Sse, IsPoint>(matrix, pSource, i, count, pDestination);
+#endif
+
+			for (; i < count; ++i)
+			{
+				if constexpr (IsPoint)
+					pDestination[i] = matrix.TransformPoint(pSource[i]);
+				else
+					pDestination[i] = matrix.TransformVector(pSource[i]);
+			}
+		}
+
+		void NormalizeComponents(float* pX, float* pY, float* pZ, size_t count)
+		{
+			size_t i{ 0 };
+#ifdef DAE_BATCH_AVX
+			i = NormalizeComponents<Avx>(pX, pY, pZ, i, count);
+#endif
+#ifdef DAE_BATCH_SSE
+			i = NormalizeComponents<Sse>(pX, pY, pZ, i, count);
+#endif
+
+			for (; i < count; ++i)
+			{
+				const float length{ std::sqrt(pX[i] * pX[i] + pY[i] * pY[i] + pZ[i] * pZ[i]) };
+				if (length > 0.f)
+				{
+					pX[i] /= length;
+					pY[i] /= length;
+					pZ[i] /= length;
+				}
+				else
+				{
+					pX[i] = pY[i] = pZ[i] = 0.f;
+				}
+			}
+		}
+
+		template<bool IsPoint>
+		void TransformArray(const Matrix& matrix, const Vector3Array& source, Vector3Array& destination)
+		{
+			destination.Resize(source.GetSize());
+
+			const float* const ppSource[3]{ source.x.data(), source.y.data(), source.z.data() };
+			float* const ppDestination[3]{ destination.x.data(), destination.y.data(), destination.z.data() };
+			TransformComponents<IsPoint, 3>(matrix, ppSource, source.GetSize(), ppDestination);
+		}
+	}
+
+	void Vector3Array::Resize(size_t size)
+	{
+		x.resize(size);
+		y.resize(size);
+		z.resize(size);
+	}
+
+	Vector3Array Vector3Array::FromVertices(const Vertex* pVertices, size_t vertexCount, Vector3 Vertex::* pAttribute)
+	{
+		Vector3Array values{};
+		values.Resize(vertexCount);
+
+		for (size_t i{ 0 }; i < vertexCount; ++i)
+			values.Set(i, pVertices[i].*pAttribute);
+
+		return values;
+	}
+
+	namespace BatchTransform
+	{
+		void TransformPoints(const Matrix& matrix, const Vector3* pPoints, size_t count, Vector3* pDestination)
+		{
+			TransformPacked<true>(matrix, pPoints, count, pDestination);
+		}
+
+		void TransformVectors(const Matrix& matrix, const Vector3* pVectors, size_t count, Vector3* pDestination)
+		{
+			TransformPacked<false>(matrix, pVectors, count, pDestination);
+		}
+
+		void TransformPoints(const Matrix& matrix, const Vector3Array& points, Vector3Array& destination)
+		{
+			TransformArray<true>(matrix, points, destination);
+		}
+
+		void TransformVectors(const Matrix& matrix, const Vector3Array& vectors, Vector3Array& destination)
+		{
+			TransformArray<false>(matrix, vectors, destination);
+		}
+
+		void ProjectPoints(const Matrix& matrix, const Vector3* pPoints, size_t count, Vector4* pDestination)
+		{
+			float x[g_BlockSize], y[g_BlockSize], z[g_BlockSize], w[g_BlockSize];
+			const float* const ppSource[3]{ x, y, z };
+			float* const ppDestination[4]{ x, y, z, w };
+
+			for (size_t first{ 0 }; first < count; first += g_BlockSize)
+			{
+				const size_t blockCount{ std::min(g_BlockSize, count - first) };
+
+				for (size_t i{ 0 }; i < blockCount; ++i)
+				{
+					x[i] = pPoints[first + i].x;
+					y[i] = pPoints[first + i].y;
+					z[i] = pPoints[first + i].z;
+				}
+
+				TransformComponents<true, 4>(matrix, ppSource, blockCount, ppDestination);
+
+				for (size_t i{ 0 }; i < blockCount; ++i)
+					pDestination[first + i] = { x[i], y[i], z[i], w[i] };
+			}
+		}
+
+		void TransformVertices(const Matrix& matrix, const Matrix& normalMatrix, const Vertex* pVertices, size_t vertexCount, Vertex* pDestination)
+		{
+			float x[g_BlockSize], y[g_BlockSize], z[g_BlockSize];
+			const float* const ppSource[3]{ x, y, z };
+			float* const ppDestination[3]{ x, y, z };
+
+			//The first three floats of each attribute, tangent is a Vector4 whose w is left alone
+			struct Attribute
+			{
+				size_t offset;
+				const Matrix& matrix;
+				bool isPoint;
+			};
+			const Attribute attributes[3]{
+				{ offsetof(Vertex, position), matrix, true },
+				{ offsetof(Vertex, normal), normalMatrix, false },
+				{ offsetof(Vertex, tangent), matrix, false } };
+
+			for (size_t first{ 0 }; first < vertexCount; first += g_BlockSize)
+			{
+				const size_t blockCount{ std::min(g_BlockSize, vertexCount - first) };
+
+				//uv and the handedness are not touched below
+				if (pDestination != pVertices)
+					std::copy(pVertices + first, pVertices + first + blockCount, pDestination + first);
+
+				for (const Attribute& attribute : attributes)
+				{
+					for (size_t i{ 0 }; i < blockCount; ++i)
+					{
+						const float* pValue{ reinterpret_cast<const float*>(reinterpret_cast<const char*>(pVertices + first + i) + attribute.offset) };
+						x[i] = pValue[0];
+						y[i] = pValue[1];
+						z[i] = pValue[2];
+					}
+
+					if (attribute.isPoint)
+					{
+						TransformComponents<true, 3>(attribute.matrix, ppSource, blockCount, ppDestination);
+					}
+					else
+					{
+						TransformComponents<false, 3>(attribute.matrix, ppSource, blockCount, ppDestination);
+						NormalizeComponents(x, y, z, blockCount);
+					}
+
+					for (size_t i{ 0 }; i < blockCount; ++i)
+					{
+						float* pValue{ reinterpret_cast<float*>(reinterpret_cast<char*>(pDestination + first + i) + attribute.offset) };
+						pValue[0] = x[i];
+						pValue[1] = y[i];
+						pValue[2] = z[i];
+					}
+				}
+			}
+		}
+
+		BoundingBox TransformBounds(const Matrix& matrix, const BoundingBox& bounds)
+		{
+			if (bounds.min.x > bounds.max.x)
+				return bounds;
+
+			//Arvo: the new half extent along an axis is the sum of the old ones weighted by how much they turn into that axis
+			const Vector3 center{ matrix.TransformPoint((bounds.min + bounds.max) * 0.5f) };
+			const Vector3 extent{ (bounds.max - bounds.min) * 0.5f };
+
+			Vector3 newExtent{};
+			for (int column{ 0 }; column < 3; ++column)
+			{
+				newExtent[column] =
+					std::abs(matrix[0][column]) * extent.x +
+					std::abs(matrix[1][column]) * extent.y +
+					std::abs(matrix[2][column]) * extent.z;
+			}
+
+			return { center - newExtent, center + newExtent };
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+#include "DataTypes.h"
+
+namespace dae
+{
+	struct Matrix;
+
+	//Structure of arrays, every component is contiguous so one register holds the same component of several elements
+	struct Vector3Array
+	{
+		std::vector<float> x{};
+		std::vector<float> y{};
+		std::vector<float> z{};
+
+		inline size_t GetSize() const { return x.size(); }
+		void Resize(size_t size);
+
+		inline Vector3 Get(size_t index) const { return { x[index], y[index], z[index] }; }
+		inline void Set(size_t index, const Vector3& value) { x[index] = value.x; y[index] = value.y; z[index] = value.z; }
+
+		//Copies one attribute out of the vertices, the position by default
+		static Vector3Array FromVertices(const Vertex* pVertices, size_t vertexCount, Vector3 Vertex::* pAttribute = &Vertex::position);
+	};
+
+	//Transforms whole arrays at once, with AVX when the build enables it and SSE otherwise.
+	//The results are identical to Matrix::TransformPoint and Matrix::TransformVector, and the destination may be the source.
+	namespace BatchTransform
+	{
+		void TransformPoints(const Matrix& matrix, const Vector3* pPoints, size_t count, Vector3* pDestination);
+		void TransformVectors(const Matrix& matrix, const Vector3* pVectors, size_t count, Vector3* pDestination);
+
+		void TransformPoints(const Matrix& matrix, const Vector3Array& points, Vector3Array& destination);
+		void TransformVectors(const Matrix& matrix, const Vector3Array& vectors, Vector3Array& destination);
+
+		//Homogeneous result with w = 1, what a vertex shader does with a world view projection
+		void ProjectPoints(const Matrix& matrix, const Vector3* pPoints, size_t count, Vector4* pDestination);
+
+		//Positions are transformed by matrix, tangents by matrix and normals by normalMatrix (the inverse transpose when the scale is non uniform).
+		//Both directions are normalized again, uvs and the handedness are copied.
+		void TransformVertices(const Matrix& matrix, const Matrix& normalMatrix, const Vertex* pVertices, size_t vertexCount, Vertex* pDestination);
+
+		//Box around the transformed box, from the extents instead of the eight corners
+		BoundingBox TransformBounds(const Matrix& matrix, const BoundingBox& bounds);
+	}
+}
@@ -1,7 +1,9 @@
 #pragma once
 #include <cassert>
+#ifndef DAE_HEADLESS
 #include <SDL_keyboard.h>
 #include <SDL_mouse.h>
+#endif
 
 #include "Math.h"
 #include "Timer.h"
@@ -53,8 +55,8 @@ namespace dae
 			invViewMatrix = Matrix::CreateRotation(totalPitch, totalYaw, 0.0f);
 			invViewMatrix *= Matrix::CreateTranslation(origin);
 
-			//Inverse(ONB) => ViewMatrix
-			viewMatrix = Matrix::Inverse(invViewMatrix);
+			//Inverse(ONB) => ViewMatrix, only rotation and translation so the transpose does
+			viewMatrix = Matrix::InverseRigid(invViewMatrix);
 
 			//DirectX Implementation => https://learn.microsoft.com/en-us/windows/win32/direct3d9/d3dxmatrixlookatlh
 		}
@@ -66,6 +68,7 @@ namespace dae
 			//DirectX Implementation => https://learn.microsoft.com/en-us/windows/win32/direct3d9/d3dxmatrixperspectivefovlh
 		}
 
+#ifndef DAE_HEADLESS
 		void Update(const Timer* pTimer)
 		{
 			const float deltaTime = pTimer->GetElapsed();
@@ -121,5 +124,6 @@ namespace dae
 			CalculateViewMatrix();
 			CalculateProjectionMatrix();
 		}
+#endif
 	};
 }
@@ -8,19 +8,102 @@ struct Vertex
 	dae::Vector3 position{};
 	dae::Vector2 uv{};
 	dae::Vector3 normal{};
-	dae::Vector3 tangent{};
+	dae::Vector4 tangent{};	//w holds the handedness of the bitangent
 };
 
+//Compact vertex for the GPU, see VertexFormats::Pack
+struct PackedVertex
+{
+	uint16_t position[4]{};	//Quantized to the mesh bounds, w holds the handedness of the bitangent (0 is -1, 65535 is 1)
+	uint16_t uv[2]{};		//Half floats
+	int16_t normal[2]{};	//Octahedral
+	int16_t tangent[2]{};	//Octahedral
+};
+
+//Output of the vertex stage of the software rasterizer, like VS_OUTPUT in PosCol3D.fx
 struct Vertex_Out
 {
-	dae::Vector4 position{};
+	dae::Vector4 position{};	//Clip space
+	dae::Vector3 worldPosition{};
 	dae::Vector2 uv{};
 	dae::Vector3 normal{};
-	dae::Vector3 tangent{};
+	dae::Vector4 tangent{};	//w holds the handedness of the bitangent
 };
 
 enum class PrimitiveTopology
 {
 	TriangleList,
 	TriangleStrip
-};
\ No newline at end of file
+};
+
+struct BoundingBox
+{
+	dae::Vector3 min{ FLT_MAX, FLT_MAX, FLT_MAX };
+	dae::Vector3 max{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+	void Grow(const dae::Vector3& point)
+	{
+		min = { std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z) };
+		max = { std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z) };
+	}
+
+	static BoundingBox FromVertices(const Vertex* pVertices, size_t vertexCount)
+	{
+		BoundingBox bounds{};
+		for (size_t i{ 0 }; i < vertexCount; ++i)
+			bounds.Grow(pVertices[i].position);
+
+		return bounds;
+	}
+};
+
+//Ritter's sphere: a few percent larger than the minimal one, in two passes over the points
+struct BoundingSphere
+{
+	dae::Vector3 center{};
+	float radius{};
+
+	static BoundingSphere FromVertices(const Vertex* pVertices, size_t vertexCount)
+	{
+		BoundingSphere sphere{};
+		if (vertexCount == 0)
+			return sphere;
+
+		auto findFarthest = [&](const dae::Vector3& from)
+			{
+				dae::Vector3 farthest{ from };
+				float farthestDistance{ 0.f };
+				for (size_t i{ 0 }; i < vertexCount; ++i)
+				{
+					const float distance{ (pVertices[i].position - from).SqrMagnitude() };
+					if (distance > farthestDistance)
+					{
+						farthestDistance = distance;
+						farthest = pVertices[i].position;
+					}
+				}
+
+				return farthest;
+			};
+
+		const dae::Vector3 a{ findFarthest(pVertices[0].position) };
+		const dae::Vector3 b{ findFarthest(a) };
+
+		sphere.center = (a + b) * 0.5f;
+		sphere.radius = (b - a).Magnitude() * 0.5f;
+
+		//Grow the sphere just enough to include every point left outside
+		for (size_t i{ 0 }; i < vertexCount; ++i)
+		{
+			const float distance{ (pVertices[i].position - sphere.center).Magnitude() };
+			if (distance > sphere.radius)
+			{
+				const float newRadius{ (sphere.radius + distance) * 0.5f };
+				sphere.center += (pVertices[i].position - sphere.center) * ((newRadius - sphere.radius) / distance);
+				sphere.radius = newRadius;
+			}
+		}
+
+		return sphere;
+	}
+};
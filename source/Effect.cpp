@@ -62,6 +62,18 @@ Effect::Effect(ID3D11Device* pDevice, const std::wstring& assetFile)
 	{
 		std::wcout << L"g_NormalMapEnabled is not valid.\n";
 	}
+
+	m_pPositionOffset = m_pEffect->GetVariableByName("g_PositionOffset")->AsVector();
+	if (!m_pPositionOffset->IsValid())
+	{
+		std::wcout << L"g_PositionOffset is not valid.\n";
+	}
+
+	m_pPositionScale = m_pEffect->GetVariableByName("g_PositionScale")->AsVector();
+	if (!m_pPositionScale->IsValid())
+	{
+		std::wcout << L"g_PositionScale is not valid.\n";
+	}
 }
 
 Effect::~Effect()
@@ -172,23 +184,52 @@ void Effect::CycleFilteringMethods()
 	{
 	case Effect::FilteringMethod::Point:
 		m_FilteringMethod = FilteringMethod::Linear;
-		m_FilteringMethodName = m_LinearFilteringMethodName;
 		std::cout << YELLOW_TEXT("Filtering Method: Linear\n");
 		break;
 
 	case Effect::FilteringMethod::Linear:
 		m_FilteringMethod = FilteringMethod::Anisotropic;
-		m_FilteringMethodName = m_AnisotropicFilteringMethodName;
 		std::cout << YELLOW_TEXT("Filtering Method: Anisotropic\n");
 		break;
 
 	case Effect::FilteringMethod::Anisotropic:
 		m_FilteringMethod = FilteringMethod::Point;
-		m_FilteringMethodName = m_PointFilteringMethodName;
 		std::cout << YELLOW_TEXT("Filtering Method: Point\n");
 		break;
 	}
 
+	UpdateTechnique();
+}
+
+void Effect::UsePackedVertices(const dae::Vector3& positionOffset, const dae::Vector3& positionScale)
+{
+	m_UsePackedVertices = true;
+	UpdateTechnique();
+
+	//Vector variables always read four floats
+	const float offset[4]{ positionOffset.x, positionOffset.y, positionOffset.z, 0.f };
+	const float scale[4]{ positionScale.x, positionScale.y, positionScale.z, 0.f };
+	m_pPositionOffset->SetFloatVector(offset);
+	m_pPositionScale->SetFloatVector(scale);
+}
+
+void Effect::UpdateTechnique()
+{
+	switch (m_FilteringMethod)
+	{
+	case Effect::FilteringMethod::Point:
+		m_FilteringMethodName = m_UsePackedVertices ? m_PointFilteringPackedMethodName : m_PointFilteringMethodName;
+		break;
+
+	case Effect::FilteringMethod::Linear:
+		m_FilteringMethodName = m_UsePackedVertices ? m_LinearFilteringPackedMethodName : m_LinearFilteringMethodName;
+		break;
+
+	case Effect::FilteringMethod::Anisotropic:
+		m_FilteringMethodName = m_UsePackedVertices ? m_AnisotropicFilteringPackedMethodName : m_AnisotropicFilteringMethodName;
+		break;
+	}
+
 	m_pTechnique = m_pEffect->GetTechniqueByName(m_FilteringMethodName);
 }
 
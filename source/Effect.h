@@ -27,6 +27,9 @@ public:
 	void CycleFilteringMethods();
 	void ToggleNormalMap();
 
+	//Switches to the techniques that decode PackedVertex, call it before CreateInputLayout
+	void UsePackedVertices(const struct dae::Vector3& positionOffset, const struct dae::Vector3& positionScale);
+
 private:
 
 	enum class FilteringMethod
@@ -42,7 +45,12 @@ private:
 	const LPCSTR m_LinearFilteringMethodName{ "LinearFilteringTechnique" };
 	const LPCSTR m_AnisotropicFilteringMethodName{ "AnisotropicFilteringTechnique" };
 
+	const LPCSTR m_PointFilteringPackedMethodName{ "PointFilteringPackedTechnique" };
+	const LPCSTR m_LinearFilteringPackedMethodName{ "LinearFilteringPackedTechnique" };
+	const LPCSTR m_AnisotropicFilteringPackedMethodName{ "AnisotropicFilteringPackedTechnique" };
+
 	LPCSTR m_FilteringMethodName{ m_PointFilteringMethodName };
+	bool m_UsePackedVertices{ false };
 
 	struct ID3DX11Effect* m_pEffect;
 	struct ID3DX11EffectTechnique* m_pTechnique;
@@ -56,4 +64,9 @@ private:
 
 	struct ID3DX11EffectScalarVariable* m_pNormalMapEnabled;
 	bool m_NormalMapEnabledValue{ true };
+
+	struct ID3DX11EffectVectorVariable* m_pPositionOffset;
+	struct ID3DX11EffectVectorVariable* m_pPositionScale;
+
+	void UpdateTechnique();
 };
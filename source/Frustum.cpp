@@ -0,0 +1,279 @@
+#include "pch.h"
+#include "Frustum.h"
+#include "DataTypes.h"
+#include "Matrix.h"
+
+//Follows the Matrix backend like BatchTransform, AVX is used when the compiler is allowed to emit it (/arch:AVX2)
+#ifdef DAE_MATRIX_SSE
+#define DAE_CULLING_SSE
+#if defined(__AVX__)
+#define DAE_CULLING_AVX
+#include <immintrin.h>
+#endif
+#endif
+
+namespace dae
+{
+	namespace
+	{
+		//The scalar tests every path ends with, the vector kernels add up in the same order so they agree on every bounds
+		bool IsSphereOutsidePlanes(const Vector4* pPlanes, float centerX, float centerY, float centerZ, float radius)
+		{
+			for (int plane{ 0 }; plane < Frustum::PlaneCount; ++plane)
+			{
+				const Vector4& p{ pPlanes[plane] };
+				if (p.x * centerX + p.y * centerY + p.z * centerZ + p.w < -radius)
+					return true;
+			}
+
+			return false;
+		}
+
+		//The box reaches furthest towards the inside of a plane by its half extents along the absolute normal
+		bool IsBoxOutsidePlanes(const Vector4* pPlanes, float centerX, float centerY, float centerZ, float extentX, float extentY, float extentZ)
+		{
+			for (int plane{ 0 }; plane < Frustum::PlaneCount; ++plane)
+			{
+				const Vector4& p{ pPlanes[plane] };
+				const float reach{ std::abs(p.x) * extentX + std::abs(p.y) * extentY + std::abs(p.z) * extentZ };
+				if (p.x * centerX + p.y * centerY + p.z * centerZ + p.w < -reach)
+					return true;
+			}
+
+			return false;
+		}
+
+#ifdef DAE_CULLING_SSE
+		//For every mask of four visible lanes, the visible lanes moved to the front
+		alignas(16) constexpr int32_t g_CompactedLanes[16][4]{
+			{ 0, 0, 0, 0 }, { 0, 0, 0, 0 }, { 1, 0, 0, 0 }, { 0, 1, 0, 0 },
+			{ 2, 0, 0, 0 }, { 0, 2, 0, 0 }, { 1, 2, 0, 0 }, { 0, 1, 2, 0 },
+			{ 3, 0, 0, 0 }, { 0, 3, 0, 0 }, { 1, 3, 0, 0 }, { 0, 1, 3, 0 },
+			{ 2, 3, 0, 0 }, { 0, 2, 3, 0 }, { 1, 2, 3, 0 }, { 0, 1, 2, 3 } };
+		constexpr uint32_t g_LaneCounts[16]{ 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+		//Writes all four slots but only moves the end past the visible ones, so there are no branches. The writes stay below first + 4.
+		inline void AppendVisible(uint32_t* pVisibleIndices, size_t& visibleCount, size_t first, int visibleMask)
+		{
+			const __m128i lanes{ _mm_load_si128(reinterpret_cast<const __m128i*>(g_CompactedLanes[visibleMask])) };
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pVisibleIndices + visibleCount), _mm_add_epi32(_mm_set1_epi32(static_cast<int>(first)), lanes));
+			visibleCount += g_LaneCounts[visibleMask];
+		}
+
+		struct Sse
+		{
+			using Register = __m128;
+			static constexpr size_t Width{ 4 };
+
+			static Register Load(const float* p) { return _mm_loadu_ps(p); }
+			static Register Set(float value) { return _mm_set1_ps(value); }
+			static Register Zero() { return _mm_setzero_ps(); }
+			static Register Add(Register a, Register b) { return _mm_add_ps(a, b); }
+			static Register Sub(Register a, Register b) { return _mm_sub_ps(a, b); }
+			static Register Mul(Register a, Register b) { return _mm_mul_ps(a, b); }
+			static Register Or(Register a, Register b) { return _mm_or_ps(a, b); }
+			static Register Less(Register a, Register b) { return _mm_cmplt_ps(a, b); }
+			static int MoveMask(Register value) { return _mm_movemask_ps(value); }
+		};
+#endif
+
+#ifdef DAE_CULLING_AVX
+		struct Avx
+		{
+			using Register = __m256;
+			static constexpr size_t Width{ 8 };
+
+			static Register Load(const float* p) { return _mm256_loadu_ps(p); }
+			static Register Set(float value) { return _mm256_set1_ps(value); }
+			static Register Zero() { return _mm256_setzero_ps(); }
+			static Register Add(Register a, Register b) { return _mm256_add_ps(a, b); }
+			static Register Sub(Register a, Register b) { return _mm256_sub_ps(a, b); }
+			static Register Mul(Register a, Register b) { return _mm256_mul_ps(a, b); }
+			static Register Or(Register a, Register b) { return _mm256_or_ps(a, b); }
+			static Register Less(Register a, Register b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+			static int MoveMask(Register value) { return _mm256_movemask_ps(value); }
+		};
+#endif
+
+#ifdef DAE_CULLING_SSE
+		//Width bounds per iteration against all six planes, the planes are broadcast once per call
+		template<typename Simd, bool TestSpheres, bool TestBoxes>
+		size_t CullBlocks(const Frustum& frustum, const CullingBounds& bounds, size_t first, size_t& visibleCount, uint32_t* pVisibleIndices)
+		{
+			using Register = typename Simd::Register;
+
+			Register planeX[Frustum::PlaneCount], planeY[Frustum::PlaneCount], planeZ[Frustum::PlaneCount], planeW[Frustum::PlaneCount];
+			//Negated so the boxes get -reach straight away, which is exact
+			Register negativeAbsPlaneX[Frustum::PlaneCount], negativeAbsPlaneY[Frustum::PlaneCount], negativeAbsPlaneZ[Frustum::PlaneCount];
+			for (int plane{ 0 }; plane < Frustum::PlaneCount; ++plane)
+			{
+				const Vector4& p{ frustum.planes[plane] };
+				planeX[plane] = Simd::Set(p.x);
+				planeY[plane] = Simd::Set(p.y);
+				planeZ[plane] = Simd::Set(p.z);
+				planeW[plane] = Simd::Set(p.w);
+				negativeAbsPlaneX[plane] = Simd::Set(-std::abs(p.x));
+				negativeAbsPlaneY[plane] = Simd::Set(-std::abs(p.y));
+				negativeAbsPlaneZ[plane] = Simd::Set(-std::abs(p.z));
+			}
+
+			const auto distance = [&](int plane, Register x, Register y, Register z)
+				{
+					Register result{ Simd::Mul(planeX[plane], x) };
+					result = Simd::Add(result, Simd::Mul(planeY[plane], y));
+					result = Simd::Add(result, Simd::Mul(planeZ[plane], z));
+					return Simd::Add(result, planeW[plane]);
+				};
+
+			const size_t count{ bounds.GetSize() };
+			size_t i{ first };
+			for (; i + Simd::Width <= count; i += Simd::Width)
+			{
+				Register outside{ Simd::Zero() };
+
+				if constexpr (TestSpheres)
+				{
+					const Register x{ Simd::Load(bounds.centerX.data() + i) };
+					const Register y{ Simd::Load(bounds.centerY.data() + i) };
+					const Register z{ Simd::Load(bounds.centerZ.data() + i) };
+					const Register negativeRadius{ Simd::Sub(Simd::Zero(), Simd::Load(bounds.radius.data() + i)) };
+
+					for (int plane{ 0 }; plane < Frustum::PlaneCount; ++plane)
+						outside = Simd::Or(outside, Simd::Less(distance(plane, x, y, z), negativeRadius));
+				}
+
+				if constexpr (TestBoxes)
+				{
+					const Register x{ Simd::Load(bounds.boxCenterX.data() + i) };
+					const Register y{ Simd::Load(bounds.boxCenterY.data() + i) };
+					const Register z{ Simd::Load(bounds.boxCenterZ.data() + i) };
+					const Register extentX{ Simd::Load(bounds.extentX.data() + i) };
+					const Register extentY{ Simd::Load(bounds.extentY.data() + i) };
+					const Register extentZ{ Simd::Load(bounds.extentZ.data() + i) };
+
+					for (int plane{ 0 }; plane < Frustum::PlaneCount; ++plane)
+					{
+						Register negativeReach{ Simd::Mul(negativeAbsPlaneX[plane], extentX) };
+						negativeReach = Simd::Add(negativeReach, Simd::Mul(negativeAbsPlaneY[plane], extentY));
+						negativeReach = Simd::Add(negativeReach, Simd::Mul(negativeAbsPlaneZ[plane], extentZ));
+						outside = Simd::Or(outside, Simd::Less(distance(plane, x, y, z), negativeReach));
+					}
+				}
+
+				const int visibleMask{ ~Simd::MoveMask(outside) };
+				for (size_t lane{ 0 }; lane < Simd::Width; lane += 4)
+					AppendVisible(pVisibleIndices, visibleCount, i + lane, (visibleMask >> lane) & 15);
+			}
+
+			return i;
+		}
+#endif
+
+		template<bool TestSpheres, bool TestBoxes>
+		size_t CullBounds(const Frustum& frustum, const CullingBounds& bounds, uint32_t* pVisibleIndices)
+		{
+			size_t visibleCount{ 0 };
+			size_t i{ 0 };
+#ifdef DAE_CULLING_AVX
+			i = CullBlocks<Avx, TestSpheres, TestBoxes>(frustum, bounds, i, visibleCount, pVisibleIndices);
+#endif
+#ifdef DAE_CULLING_SSE
+			i = CullBlocks<Sse, TestSpheres, TestBoxes>(frustum, bounds, i, visibleCount, pVisibleIndices);
+#endif
+
+			for (; i < bounds.GetSize(); ++i)
+			{
+				if (TestSpheres && IsSphereOutsidePlanes(frustum.planes, bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i], bounds.radius[i]))
+					continue;
+
+				if (TestBoxes && IsBoxOutsidePlanes(frustum.planes, bounds.boxCenterX[i], bounds.boxCenterY[i], bounds.boxCenterZ[i],
+					bounds.extentX[i], bounds.extentY[i], bounds.extentZ[i]))
+					continue;
+
+				pVisibleIndices[visibleCount++] = static_cast<uint32_t>(i);
+			}
+
+			return visibleCount;
+		}
+	}
+
+	void CullingBounds::Resize(size_t size)
+	{
+		for (std::vector<float>* pComponent : { &centerX, &centerY, &centerZ, &radius, &boxCenterX, &boxCenterY, &boxCenterZ, &extentX, &extentY, &extentZ })
+			pComponent->resize(size);
+	}
+
+	void CullingBounds::SetSphere(size_t index, const BoundingSphere& sphere)
+	{
+		centerX[index] = sphere.center.x;
+		centerY[index] = sphere.center.y;
+		centerZ[index] = sphere.center.z;
+		radius[index] = sphere.radius;
+	}
+
+	void CullingBounds::SetBox(size_t index, const BoundingBox& box)
+	{
+		const Vector3 center{ (box.min + box.max) * 0.5f };
+		const Vector3 extent{ (box.max - box.min) * 0.5f };
+
+		boxCenterX[index] = center.x;
+		boxCenterY[index] = center.y;
+		boxCenterZ[index] = center.z;
+		extentX[index] = extent.x;
+		extentY[index] = extent.y;
+		extentZ[index] = extent.z;
+	}
+
+	Frustum Frustum::FromMatrix(const Matrix& viewProjection)
+	{
+		//Clip space component i is the dot product of the point with column i
+		Vector4 columns[4]{};
+		for (int column{ 0 }; column < 4; ++column)
+			columns[column] = { viewProjection[0][column], viewProjection[1][column], viewProjection[2][column], viewProjection[3][column] };
+
+		Frustum frustum{};
+		frustum.planes[Left] = columns[3] + columns[0];
+		frustum.planes[Right] = columns[3] - columns[0];
+		frustum.planes[Bottom] = columns[3] + columns[1];
+		frustum.planes[Top] = columns[3] - columns[1];
+		frustum.planes[Near] = columns[2];
+		frustum.planes[Far] = columns[3] - columns[2];
+
+		//Unit normals, so plane distances are real distances to compare radii with
+		for (Vector4& plane : frustum.planes)
+		{
+			const float length{ Vector3{ plane.x, plane.y, plane.z }.Magnitude() };
+			if (length > 0.f)
+				plane = plane * (1.f / length);
+		}
+
+		return frustum;
+	}
+
+	bool Frustum::IsSphereOutside(const Vector3& center, float radius) const
+	{
+		return IsSphereOutsidePlanes(planes, center.x, center.y, center.z, radius);
+	}
+
+	bool Frustum::IsBoxOutside(const BoundingBox& box) const
+	{
+		const Vector3 center{ (box.min + box.max) * 0.5f };
+		const Vector3 extent{ (box.max - box.min) * 0.5f };
+		return IsBoxOutsidePlanes(planes, center.x, center.y, center.z, extent.x, extent.y, extent.z);
+	}
+
+	size_t Frustum::CullSpheres(const CullingBounds& bounds, uint32_t* pVisibleIndices) const
+	{
+		return CullBounds<true, false>(*this, bounds, pVisibleIndices);
+	}
+
+	size_t Frustum::CullBoxes(const CullingBounds& bounds, uint32_t* pVisibleIndices) const
+	{
+		return CullBounds<false, true>(*this, bounds, pVisibleIndices);
+	}
+
+	size_t Frustum::Cull(const CullingBounds& bounds, uint32_t* pVisibleIndices) const
+	{
+		return CullBounds<true, true>(*this, bounds, pVisibleIndices);
+	}
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Vector3.h"
+#include "Vector4.h"
+
+struct BoundingBox;
+struct BoundingSphere;
+
+namespace dae
+{
+	struct Matrix;
+
+	//Structure of arrays of bounds to cull many objects at once, every component is contiguous so one register holds the same component of several objects.
+	//Boxes are kept as center and half extents, the sphere and the box of an object share nothing but their index.
+	struct CullingBounds
+	{
+		std::vector<float> centerX{};
+		std::vector<float> centerY{};
+		std::vector<float> centerZ{};
+		std::vector<float> radius{};
+
+		std::vector<float> boxCenterX{};
+		std::vector<float> boxCenterY{};
+		std::vector<float> boxCenterZ{};
+		std::vector<float> extentX{};
+		std::vector<float> extentY{};
+		std::vector<float> extentZ{};
+
+		inline size_t GetSize() const { return centerX.size(); }
+		void Resize(size_t size);
+
+		void SetSphere(size_t index, const BoundingSphere& sphere);
+		void SetBox(size_t index, const BoundingBox& box);
+	};
+
+	//Six inward facing planes (xyz normal, w distance), a point p is inside a plane when dot(xyz, p) + w >= 0
+	struct Frustum
+	{
+		enum Plane
+		{
+			Left,
+			Right,
+			Bottom,
+			Top,
+			Near,
+			Far,
+			PlaneCount
+		};
+
+		Vector4 planes[PlaneCount]{};
+
+		//Extracts the planes from a (world)view projection matrix for row vectors and a [0, 1] depth range.
+		//The planes end up in the space the matrix transforms from, so a world view projection gives object space planes.
+		static Frustum FromMatrix(const Matrix& viewProjection);
+
+		//Conservative: spheres and boxes near the corners can pass while being outside
+		bool IsSphereOutside(const Vector3& center, float radius) const;
+		bool IsBoxOutside(const BoundingBox& box) const;
+
+		//Write the indices of the bounds that are not outside to pVisibleIndices in increasing order and return how many there are.
+		//pVisibleIndices needs room for every bounds. Four (SSE) or eight (AVX) bounds are tested per iteration, with the same results as the single tests.
+		size_t CullSpheres(const CullingBounds& bounds, uint32_t* pVisibleIndices) const;
+		size_t CullBoxes(const CullingBounds& bounds, uint32_t* pVisibleIndices) const;
+		//Culled when either the sphere or the box is outside, tighter than both on their own
+		size_t Cull(const CullingBounds& bounds, uint32_t* pVisibleIndices) const;
+	};
+}
@@ -0,0 +1,539 @@
+#include "pch.h"
+#include "ImageReader.h"
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+
+namespace dae
+{
+	namespace ImageReader
+	{
+		namespace
+		{
+			//Decoded images larger than this are refused instead of allocated
+			constexpr uint64_t g_MaxImageBytes{ 1ull << 30 };
+
+			bool ReadFile(const std::string& path, std::vector<uint8_t>& bytes)
+			{
+				std::ifstream file{ path, std::ios::binary };
+				if (!file)
+					return false;
+
+				bytes.assign(std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{});
+				return !file.bad();
+			}
+
+			uint32_t ReadBigEndian(const uint8_t* pBytes)
+			{
+				return (uint32_t(pBytes[0]) << 24) | (uint32_t(pBytes[1]) << 16) | (uint32_t(pBytes[2]) << 8) | uint32_t(pBytes[3]);
+			}
+
+			uint32_t ToRGBA(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+			{
+				return uint32_t(r) | (uint32_t(g) << 8) | (uint32_t(b) << 16) | (uint32_t(a) << 24);
+			}
+
+			//Deflate packs its bits from the lowest bit of every byte up. Reading past the end returns zeros and is only reported by IsOverrun.
+			class BitReader final
+			{
+			public:
+				BitReader(const uint8_t* pData, size_t size)
+					: m_pData{ pData }
+					, m_Size{ size }
+				{
+				}
+
+				//Up to 16 bits
+				uint32_t Peek(int count)
+				{
+					while (m_BitCount < count)
+					{
+						const uint32_t byte{ m_Position < m_Size ? m_pData[m_Position] : 0u };
+						++m_Position;
+						m_Bits |= byte << m_BitCount;
+						m_BitCount += 8;
+					}
+
+					return m_Bits & ((1u << count) - 1);
+				}
+
+				void Skip(int count)
+				{
+					m_Bits >>= count;
+					m_BitCount -= count;
+				}
+
+				uint32_t Read(int count)
+				{
+					const uint32_t value{ Peek(count) };
+					Skip(count);
+					return value;
+				}
+
+				void AlignToByte()
+				{
+					Skip(m_BitCount % 8);
+				}
+
+				bool IsOverrun() const
+				{
+					return m_Position * 8 - m_BitCount > m_Size * 8;
+				}
+
+			private:
+				const uint8_t* m_pData;
+				size_t m_Size;
+				size_t m_Position{ 0 };
+				uint32_t m_Bits{ 0 };
+				int m_BitCount{ 0 };
+			};
+
+			//Canonical Huffman code. Codes up to FastBits long are found with one lookup, longer ones bit by bit.
+			struct HuffmanCode
+			{
+				static constexpr int MaxBits{ 15 };
+				static constexpr int FastBits{ 9 };
+
+				uint16_t counts[MaxBits + 1]{};
+				uint16_t symbols[288]{};
+				uint16_t fast[1 << FastBits]{};	//Symbol | length << 9, 0 for longer codes
+
+				bool Build(const uint8_t* pLengths, int symbolCount)
+				{
+					std::fill(std::begin(counts), std::end(counts), uint16_t{ 0 });
+					std::fill(std::begin(fast), std::end(fast), uint16_t{ 0 });
+					for (int symbol{ 0 }; symbol < symbolCount; ++symbol)
+						++counts[pLengths[symbol]];
+
+					//More codes of a length than there is room for is an error, fewer is allowed (a single distance code for example)
+					int remaining{ 1 };
+					for (int length{ 1 }; length <= MaxBits; ++length)
+					{
+						remaining = (remaining << 1) - counts[length];
+						if (remaining < 0)
+							return false;
+					}
+
+					uint16_t offsets[MaxBits + 2]{};
+					for (int length{ 1 }; length <= MaxBits; ++length)
+						offsets[length + 1] = offsets[length] + counts[length];
+
+					for (int symbol{ 0 }; symbol < symbolCount; ++symbol)
+					{
+						if (pLengths[symbol] != 0)
+							symbols[offsets[pLengths[symbol]]++] = static_cast<uint16_t>(symbol);
+					}
+
+					//The table is indexed by the bits as they come in, which are the code reversed
+					int code{ 0 }, index{ 0 };
+					for (int length{ 1 }; length <= FastBits; ++length)
+					{
+						for (int i{ 0 }; i < counts[length]; ++i, ++code, ++index)
+						{
+							int reversed{ 0 };
+							for (int bit{ 0 }; bit < length; ++bit)
+								reversed |= ((code >> bit) & 1) << (length - 1 - bit);
+
+							for (int entry{ reversed }; entry < (1 << FastBits); entry += 1 << length)
+								fast[entry] = static_cast<uint16_t>(symbols[index] | (length << 9));
+						}
+
+						code <<= 1;
+					}
+
+					return true;
+				}
+
+				//-1 for bits that are not a code
+				int Decode(BitReader& reader) const
+				{
+					const uint32_t entry{ fast[reader.Peek(FastBits)] };
+					if (entry != 0)
+					{
+						reader.Skip(entry >> 9);
+						return entry & 511;
+					}
+
+					int code{ 0 }, first{ 0 }, index{ 0 };
+					for (int length{ 1 }; length <= MaxBits; ++length)
+					{
+						code |= reader.Read(1);
+						const int count{ counts[length] };
+						if (code - first < count)
+							return symbols[index + code - first];
+
+						index += count;
+						first = (first + count) << 1;
+						code <<= 1;
+					}
+
+					return -1;
+				}
+			};
+
+			constexpr uint16_t g_LengthBases[29]{ 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+			constexpr uint8_t g_LengthExtraBits[29]{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+			constexpr uint16_t g_DistanceBases[30]{ 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+			constexpr uint8_t g_DistanceExtraBits[30]{ 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+			bool InflateCodes(BitReader& reader, const HuffmanCode& literals, const HuffmanCode& distances, size_t maxSize, std::vector<uint8_t>& bytes)
+			{
+				while (true)
+				{
+					const int symbol{ literals.Decode(reader) };
+					if (symbol < 0 || reader.IsOverrun())
+						return false;
+
+					if (symbol < 256)
+					{
+						if (bytes.size() >= maxSize)
+							return false;
+
+						bytes.push_back(static_cast<uint8_t>(symbol));
+						continue;
+					}
+
+					if (symbol == 256)
+						return true;
+
+					const int lengthSymbol{ symbol - 257 };
+					if (lengthSymbol >= 29)
+						return false;
+
+					const size_t length{ g_LengthBases[lengthSymbol] + reader.Read(g_LengthExtraBits[lengthSymbol]) };
+					const int distanceSymbol{ distances.Decode(reader) };
+					if (distanceSymbol < 0 || distanceSymbol >= 30)
+						return false;
+
+					const size_t distance{ g_DistanceBases[distanceSymbol] + reader.Read(g_DistanceExtraBits[distanceSymbol]) };
+					if (distance > bytes.size() || bytes.size() + length > maxSize)
+						return false;
+
+					//Byte by byte, the copy may overlap what it writes
+					const size_t start{ bytes.size() - distance };
+					for (size_t i{ 0 }; i < length; ++i)
+						bytes.push_back(bytes[start + i]);
+				}
+			}
+
+			bool InflateDynamicCodes(BitReader& reader, HuffmanCode& literals, HuffmanCode& distances)
+			{
+				constexpr uint8_t lengthOrder[19]{ 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+				const int literalCount{ static_cast<int>(reader.Read(5)) + 257 };
+				const int distanceCount{ static_cast<int>(reader.Read(5)) + 1 };
+				const int lengthCount{ static_cast<int>(reader.Read(4)) + 4 };
+				if (literalCount > 286 || distanceCount > 30)
+					return false;
+
+				uint8_t lengths[286 + 30]{};
+				for (int i{ 0 }; i < lengthCount; ++i)
+					lengths[lengthOrder[i]] = static_cast<uint8_t>(reader.Read(3));
+
+				HuffmanCode lengthCode{};
+				if (!lengthCode.Build(lengths, 19))
+					return false;
+
+				std::fill(std::begin(lengths), std::end(lengths), uint8_t{ 0 });
+				for (int i{ 0 }; i < literalCount + distanceCount;)
+				{
+					const int symbol{ lengthCode.Decode(reader) };
+					if (symbol < 0 || reader.IsOverrun())
+						return false;
+
+					if (symbol < 16)
+					{
+						lengths[i++] = static_cast<uint8_t>(symbol);
+						continue;
+					}
+
+					//16 repeats the previous length 3-6 times, 17 and 18 write 3-10 and 11-138 zeros
+					uint8_t length{ 0 };
+					int repeat{};
+					if (symbol == 16)
+					{
+						if (i == 0)
+							return false;
+
+						length = lengths[i - 1];
+						repeat = 3 + static_cast<int>(reader.Read(2));
+					}
+					else
+						repeat = symbol == 17 ? 3 + static_cast<int>(reader.Read(3)) : 11 + static_cast<int>(reader.Read(7));
+
+					if (i + repeat > literalCount + distanceCount)
+						return false;
+
+					while (repeat-- > 0)
+						lengths[i++] = length;
+				}
+
+				return lengths[256] != 0 && literals.Build(lengths, literalCount) && distances.Build(lengths + literalCount, distanceCount);
+			}
+
+			struct FixedCodes
+			{
+				HuffmanCode literals{};
+				HuffmanCode distances{};
+
+				FixedCodes()
+				{
+					uint8_t lengths[288]{};
+					std::fill(lengths, lengths + 144, uint8_t{ 8 });
+					std::fill(lengths + 144, lengths + 256, uint8_t{ 9 });
+					std::fill(lengths + 256, lengths + 280, uint8_t{ 7 });
+					std::fill(lengths + 280, lengths + 288, uint8_t{ 8 });
+					literals.Build(lengths, 288);
+
+					std::fill(lengths, lengths + 30, uint8_t{ 5 });
+					distances.Build(lengths, 30);
+				}
+			};
+
+			uint8_t PaethPredictor(int a, int b, int c)
+			{
+				const int p{ a + b - c };
+				const int pa{ std::abs(p - a) };
+				const int pb{ std::abs(p - b) };
+				const int pc{ std::abs(p - c) };
+				if (pa <= pb && pa <= pc)
+					return static_cast<uint8_t>(a);
+
+				return static_cast<uint8_t>(pb <= pc ? b : c);
+			}
+		}
+
+		bool Inflate(const uint8_t* pData, size_t size, size_t maxSize, std::vector<uint8_t>& bytes)
+		{
+			//Zlib header: deflate, no preset dictionary, and a check that makes it a multiple of 31. The Adler-32 at the end is not checked.
+			if (size < 2 || (pData[0] & 0x0F) != 8 || (pData[1] & 0x20) != 0 || ((pData[0] << 8) | pData[1]) % 31 != 0)
+				return false;
+
+			static const FixedCodes fixedCodes{};
+			BitReader reader{ pData + 2, size - 2 };
+			bytes.clear();
+
+			bool isLastBlock{ false };
+			while (!isLastBlock)
+			{
+				isLastBlock = reader.Read(1) != 0;
+				const uint32_t type{ reader.Read(2) };
+
+				if (type == 0)
+				{
+					reader.AlignToByte();
+					const uint32_t length{ reader.Read(16) };
+					if (length != (~reader.Read(16) & 0xFFFF) || bytes.size() + length > maxSize)
+						return false;
+
+					for (uint32_t i{ 0 }; i < length; ++i)
+						bytes.push_back(static_cast<uint8_t>(reader.Read(8)));
+				}
+				else if (type == 1)
+				{
+					if (!InflateCodes(reader, fixedCodes.literals, fixedCodes.distances, maxSize, bytes))
+						return false;
+				}
+				else if (type == 2)
+				{
+					HuffmanCode literals{}, distances{};
+					if (!InflateDynamicCodes(reader, literals, distances) || !InflateCodes(reader, literals, distances, maxSize, bytes))
+						return false;
+				}
+				else
+					return false;
+
+				if (reader.IsOverrun())
+					return false;
+			}
+
+			return true;
+		}
+
+		bool ReadPPM(const std::string& path, std::vector<uint32_t>& pixels, uint32_t& width, uint32_t& height)
+		{
+			std::vector<uint8_t> bytes{};
+			if (!ReadFile(path, bytes) || bytes.size() < 2 || bytes[0] != 'P' || bytes[1] != '6')
+				return false;
+
+			//Width, height and the largest value, separated by whitespace and comments
+			size_t position{ 2 };
+			uint64_t values[3]{};
+			for (uint64_t& value : values)
+			{
+				while (position < bytes.size() && (std::isspace(bytes[position]) || bytes[position] == '#'))
+				{
+					if (bytes[position] == '#')
+					{
+						while (position < bytes.size() && bytes[position] != '\n')
+							++position;
+					}
+					else
+						++position;
+				}
+
+				if (position >= bytes.size() || !std::isdigit(bytes[position]))
+					return false;
+
+				while (position < bytes.size() && std::isdigit(bytes[position]) && value < g_MaxImageBytes)
+					value = value * 10 + (bytes[position++] - '0');
+
+				if (position < bytes.size() && std::isdigit(bytes[position]))
+					return false;
+			}
+
+			//A single whitespace byte ends the header
+			++position;
+			const uint64_t pixelCount{ values[0] * values[1] };
+			if (values[2] != 255 || pixelCount == 0 || pixelCount * 4 > g_MaxImageBytes || position + pixelCount * 3 > bytes.size())
+				return false;
+
+			width = static_cast<uint32_t>(values[0]);
+			height = static_cast<uint32_t>(values[1]);
+			pixels.resize(pixelCount);
+			for (size_t i{ 0 }; i < pixelCount; ++i)
+			{
+				const uint8_t* pPixel{ bytes.data() + position + i * 3 };
+				pixels[i] = ToRGBA(pPixel[0], pPixel[1], pPixel[2], 255);
+			}
+
+			return true;
+		}
+
+		bool ReadPNG(const std::string& path, std::vector<uint32_t>& pixels, uint32_t& width, uint32_t& height)
+		{
+			constexpr uint8_t signature[8]{ 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+			std::vector<uint8_t> bytes{};
+			if (!ReadFile(path, bytes) || bytes.size() < 8 || !std::equal(signature, signature + 8, bytes.begin()))
+				return false;
+
+			//Chunks are length, type, data and a CRC, which is not checked
+			uint32_t bitDepth{}, colorType{}, interlace{};
+			width = height = 0;
+			std::vector<uint8_t> imageData{};
+			uint32_t palette[256]{};
+			std::fill(std::begin(palette), std::end(palette), ToRGBA(0, 0, 0, 255));
+
+			size_t position{ 8 };
+			bool hasEnded{ false };
+			while (!hasEnded && position + 12 <= bytes.size())
+			{
+				const uint32_t length{ ReadBigEndian(bytes.data() + position) };
+				const std::string_view type{ reinterpret_cast<const char*>(bytes.data() + position + 4), 4 };
+				const uint8_t* pData{ bytes.data() + position + 8 };
+				if (length > bytes.size() - position - 12)
+					return false;
+
+				if (type == "IHDR" && length >= 13)
+				{
+					width = ReadBigEndian(pData);
+					height = ReadBigEndian(pData + 4);
+					bitDepth = pData[8];
+					colorType = pData[9];
+					interlace = pData[12];
+				}
+				else if (type == "PLTE")
+				{
+					for (uint32_t i{ 0 }; i < std::min(length / 3, 256u); ++i)
+						palette[i] = ToRGBA(pData[i * 3], pData[i * 3 + 1], pData[i * 3 + 2], 255);
+				}
+				else if (type == "tRNS" && colorType == 3)
+				{
+					for (uint32_t i{ 0 }; i < std::min(length, 256u); ++i)
+						palette[i] = (palette[i] & 0x00FFFFFFu) | (uint32_t(pData[i]) << 24);
+				}
+				else if (type == "IDAT")
+					imageData.insert(imageData.end(), pData, pData + length);
+				else if (type == "IEND")
+					hasEnded = true;
+
+				position += size_t(length) + 12;
+			}
+
+			//Channels per color type: gray, -, RGB, palette, gray and alpha, -, RGBA
+			constexpr uint32_t channelCounts[7]{ 1, 0, 3, 1, 2, 0, 4 };
+			if (colorType > 6 || channelCounts[colorType] == 0 || (bitDepth != 8 && bitDepth != 16) || (colorType == 3 && bitDepth != 8) || interlace != 0)
+				return false;
+
+			const uint64_t sampleSize{ bitDepth / 8 };
+			const uint64_t pixelSize{ channelCounts[colorType] * sampleSize };
+			const uint64_t rowSize{ uint64_t(width) * pixelSize };
+			const uint64_t filteredSize{ (rowSize + 1) * height };
+			if (width == 0 || height == 0 || filteredSize > g_MaxImageBytes || uint64_t(width) * height * 4 > g_MaxImageBytes)
+				return false;
+
+			std::vector<uint8_t> filtered{};
+			filtered.reserve(filteredSize);
+			if (!Inflate(imageData.data(), imageData.size(), filteredSize, filtered) || filtered.size() != filteredSize)
+				return false;
+
+			//Every row starts with its filter type, which predicts each byte from the one a pixel to the left, the one above, or both
+			std::vector<uint8_t> previous(rowSize, 0);
+			std::vector<uint8_t> current(rowSize, 0);
+			pixels.resize(size_t(width) * height);
+			for (uint32_t y{ 0 }; y < height; ++y)
+			{
+				const uint8_t* pRow{ filtered.data() + y * (rowSize + 1) };
+				const uint8_t filter{ pRow[0] };
+				if (filter > 4)
+					return false;
+
+				for (size_t i{ 0 }; i < rowSize; ++i)
+				{
+					const int a{ i >= pixelSize ? current[i - pixelSize] : 0 };
+					const int b{ previous[i] };
+					const int c{ i >= pixelSize ? previous[i - pixelSize] : 0 };
+					int prediction{ 0 };
+					switch (filter)
+					{
+					case 1: prediction = a; break;
+					case 2: prediction = b; break;
+					case 3: prediction = (a + b) / 2; break;
+					case 4: prediction = PaethPredictor(a, b, c); break;
+					default: break;
+					}
+
+					current[i] = static_cast<uint8_t>(pRow[i + 1] + prediction);
+				}
+
+				//The most significant byte of 16 bit samples
+				for (uint32_t x{ 0 }; x < width; ++x)
+				{
+					const uint8_t* pPixel{ current.data() + x * pixelSize };
+					const auto sample = [&](uint32_t channel) { return pPixel[channel * sampleSize]; };
+
+					uint32_t& pixel{ pixels[size_t(y) * width + x] };
+					switch (colorType)
+					{
+					case 0: pixel = ToRGBA(sample(0), sample(0), sample(0), 255); break;
+					case 2: pixel = ToRGBA(sample(0), sample(1), sample(2), 255); break;
+					case 3: pixel = palette[sample(0)]; break;
+					case 4: pixel = ToRGBA(sample(0), sample(0), sample(0), sample(1)); break;
+					default: pixel = ToRGBA(sample(0), sample(1), sample(2), sample(3)); break;
+					}
+				}
+
+				std::swap(previous, current);
+			}
+
+			return true;
+		}
+
+		bool Read(const std::string& path, std::vector<uint32_t>& pixels, uint32_t& width, uint32_t& height)
+		{
+			const size_t dot{ path.find_last_of('.') };
+			std::string extension{ dot == std::string::npos ? "" : path.substr(dot + 1) };
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+
+			if (extension == "ppm")
+				return ReadPPM(path, pixels, width, height);
+
+			if (extension == "png")
+				return ReadPNG(path, pixels, width, height);
+
+			return false;
+		}
+	}
+}
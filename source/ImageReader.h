@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dae
+{
+	//Reads images into 8 bit RGBA pixels (r in the lowest byte, rows top to bottom) without any image library, the counterpart of ImageWriter.
+	//PNG with 8 or 16 bit channels in any color type, not interlaced, and binary PPM with 8 bit channels.
+	namespace ImageReader
+	{
+		bool ReadPPM(const std::string& path, std::vector<uint32_t>& pixels, uint32_t& width, uint32_t& height);
+		bool ReadPNG(const std::string& path, std::vector<uint32_t>& pixels, uint32_t& width, uint32_t& height);
+
+		//Picks the format from the extension, false for anything else
+		bool Read(const std::string& path, std::vector<uint32_t>& pixels, uint32_t& width, uint32_t& height);
+
+		//Zlib stream to the bytes it holds, failing when they would be more than maxSize
+		bool Inflate(const uint8_t* pData, size_t size, size_t maxSize, std::vector<uint8_t>& bytes);
+	}
+}
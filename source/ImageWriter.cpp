@@ -0,0 +1,167 @@
+#include "pch.h"
+#include "ImageWriter.h"
+#include <fstream>
+
+namespace dae
+{
+	namespace ImageWriter
+	{
+		namespace
+		{
+			//Stored deflate blocks hold at most this many bytes
+			constexpr uint32_t g_MaxStoredBlockSize{ 65535 };
+
+			struct Crc32Table
+			{
+				uint32_t values[256]{};
+
+				Crc32Table()
+				{
+					for (uint32_t i{ 0 }; i < 256; ++i)
+					{
+						uint32_t value{ i };
+						for (int bit{ 0 }; bit < 8; ++bit)
+							value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+
+						values[i] = value;
+					}
+				}
+			};
+
+			uint32_t UpdateCrc32(uint32_t crc, const uint8_t* pData, size_t size)
+			{
+				static const Crc32Table table{};
+				for (size_t i{ 0 }; i < size; ++i)
+					crc = table.values[(crc ^ pData[i]) & 0xFF] ^ (crc >> 8);
+
+				return crc;
+			}
+
+			void AppendBigEndian(std::vector<uint8_t>& bytes, uint32_t value)
+			{
+				bytes.push_back(static_cast<uint8_t>(value >> 24));
+				bytes.push_back(static_cast<uint8_t>(value >> 16));
+				bytes.push_back(static_cast<uint8_t>(value >> 8));
+				bytes.push_back(static_cast<uint8_t>(value));
+			}
+
+			//Length, type, data and the CRC of type and data
+			void AppendChunk(std::vector<uint8_t>& png, const char* pType, const std::vector<uint8_t>& data)
+			{
+				AppendBigEndian(png, static_cast<uint32_t>(data.size()));
+
+				const size_t typeStart{ png.size() };
+				png.insert(png.end(), pType, pType + 4);
+				png.insert(png.end(), data.begin(), data.end());
+
+				const uint32_t crc{ UpdateCrc32(0xFFFFFFFFu, png.data() + typeStart, png.size() - typeStart) ^ 0xFFFFFFFFu };
+				AppendBigEndian(png, crc);
+			}
+
+			bool WriteFile(const std::string& path, const uint8_t* pData, size_t size)
+			{
+				std::ofstream file{ path, std::ios::binary };
+				if (!file)
+					return false;
+
+				file.write(reinterpret_cast<const char*>(pData), static_cast<std::streamsize>(size));
+				return static_cast<bool>(file);
+			}
+		}
+
+		bool WritePPM(const std::string& path, const uint32_t* pPixels, uint32_t width, uint32_t height)
+		{
+			const std::string header{ "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n" };
+
+			std::vector<uint8_t> bytes(header.begin(), header.end());
+			bytes.reserve(bytes.size() + size_t(width) * height * 3);
+
+			for (size_t i{ 0 }; i < size_t(width) * height; ++i)
+			{
+				bytes.push_back(static_cast<uint8_t>(pPixels[i]));
+				bytes.push_back(static_cast<uint8_t>(pPixels[i] >> 8));
+				bytes.push_back(static_cast<uint8_t>(pPixels[i] >> 16));
+			}
+
+			return WriteFile(path, bytes.data(), bytes.size());
+		}
+
+		bool WritePNG(const std::string& path, const uint32_t* pPixels, uint32_t width, uint32_t height)
+		{
+			//Every row starts with its filter type, 0 leaves the bytes as they are
+			std::vector<uint8_t> rows{};
+			rows.reserve(size_t(height) * (size_t(width) * 3 + 1));
+			for (uint32_t y{ 0 }; y < height; ++y)
+			{
+				rows.push_back(0);
+				for (uint32_t x{ 0 }; x < width; ++x)
+				{
+					const uint32_t pixel{ pPixels[size_t(y) * width + x] };
+					rows.push_back(static_cast<uint8_t>(pixel));
+					rows.push_back(static_cast<uint8_t>(pixel >> 8));
+					rows.push_back(static_cast<uint8_t>(pixel >> 16));
+				}
+			}
+
+			//Zlib stream of stored blocks, followed by the Adler-32 of the uncompressed bytes
+			std::vector<uint8_t> imageData{ 0x78, 0x01 };
+			imageData.reserve(rows.size() + rows.size() / g_MaxStoredBlockSize * 5 + 16);
+
+			size_t offset{ 0 };
+			do
+			{
+				const uint32_t blockSize{ static_cast<uint32_t>(std::min<size_t>(g_MaxStoredBlockSize, rows.size() - offset)) };
+				const bool isLast{ offset + blockSize == rows.size() };
+
+				imageData.push_back(isLast ? 1 : 0);
+				imageData.push_back(static_cast<uint8_t>(blockSize));
+				imageData.push_back(static_cast<uint8_t>(blockSize >> 8));
+				imageData.push_back(static_cast<uint8_t>(~blockSize));
+				imageData.push_back(static_cast<uint8_t>(~blockSize >> 8));
+				imageData.insert(imageData.end(), rows.begin() + offset, rows.begin() + offset + blockSize);
+
+				offset += blockSize;
+			} while (offset < rows.size());
+
+			//Sums modulo 65521, 5552 bytes is the longest run that cannot overflow before the modulo
+			uint32_t a{ 1 }, b{ 0 };
+			for (size_t first{ 0 }; first < rows.size(); first += 5552)
+			{
+				const size_t last{ std::min(rows.size(), first + 5552) };
+				for (size_t i{ first }; i < last; ++i)
+				{
+					a += rows[i];
+					b += a;
+				}
+
+				a %= 65521;
+				b %= 65521;
+			}
+			AppendBigEndian(imageData, (b << 16) | a);
+
+			std::vector<uint8_t> header{};
+			AppendBigEndian(header, width);
+			AppendBigEndian(header, height);
+			header.insert(header.end(), { 8, 2, 0, 0, 0 });	//8 bits per channel, RGB, deflate, adaptive filtering, no interlacing
+
+			std::vector<uint8_t> png{ 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+			AppendChunk(png, "IHDR", header);
+			AppendChunk(png, "IDAT", imageData);
+			AppendChunk(png, "IEND", {});
+
+			return WriteFile(path, png.data(), png.size());
+		}
+
+		bool Write(const std::string& path, const uint32_t* pPixels, uint32_t width, uint32_t height)
+		{
+			const size_t dot{ path.find_last_of('.') };
+			std::string extension{ dot == std::string::npos ? "" : path.substr(dot + 1) };
+			std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+
+			if (extension == "ppm")
+				return WritePPM(path, pPixels, width, height);
+
+			return WritePNG(path, pPixels, width, height);
+		}
+	}
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace dae
+{
+	//Writes 8 bit RGBA pixels (r in the lowest byte, rows top to bottom) without any image library, so it also works on headless machines.
+	//Alpha is dropped, both formats are stored as RGB.
+	namespace ImageWriter
+	{
+		bool WritePPM(const std::string& path, const uint32_t* pPixels, uint32_t width, uint32_t height);
+
+		//Uncompressed deflate blocks: larger files than a real encoder, but any PNG reader opens them
+		bool WritePNG(const std::string& path, const uint32_t* pPixels, uint32_t width, uint32_t height);
+
+		//Picks the format from the extension, .ppm or .png
+		bool Write(const std::string& path, const uint32_t* pPixels, uint32_t width, uint32_t height);
+	}
+}
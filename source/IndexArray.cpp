@@ -0,0 +1,95 @@
+#include "pch.h"
+#include "IndexArray.h"
+#include "DataTypes.h"
+
+namespace dae
+{
+	namespace IndexArrays
+	{
+		size_t GetIndexCount(const IndexArray& indices)
+		{
+			return std::visit([](const auto& array) { return array.size(); }, indices);
+		}
+
+		uint32_t GetIndexSize(const IndexArray& indices)
+		{
+			return std::holds_alternative<std::vector<uint16_t>>(indices) ? 2u : 4u;
+		}
+
+		const void* GetData(const IndexArray& indices)
+		{
+			return std::visit([](const auto& array) { return static_cast<const void*>(array.data()); }, indices);
+		}
+
+		IndexArray Compact(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, std::vector<MeshSection>& sections)
+		{
+			sections.clear();
+
+			if (vertices.size() <= MaxSectionVertexCount)
+			{
+				sections.push_back({ 0, static_cast<uint32_t>(indices.size()), 0 });
+				return std::vector<uint16_t>(indices.begin(), indices.end());
+			}
+
+			//Cut the triangles, in their optimized order, into runs that use at most MaxSectionVertexCount vertices
+			std::vector<uint32_t> localIndices(vertices.size());
+			std::vector<uint32_t> sectionStamps(vertices.size(), UINT32_MAX);
+			std::vector<uint32_t> sectionVertices{};
+			std::vector<uint16_t> shortIndices(indices.size());
+
+			uint32_t sectionId{ 0 };
+			size_t sectionVertexCount{ 0 };
+			size_t sectionStart{ 0 };
+
+			for (size_t iIndex{ 0 }; iIndex + 2 < indices.size(); iIndex += 3)
+			{
+				uint32_t newVertexCount{ 0 };
+				for (size_t i{ iIndex }; i < iIndex + 3; ++i)
+				{
+					if (sectionStamps[indices[i]] != sectionId)
+						++newVertexCount;
+				}
+
+				if (sectionVertexCount + newVertexCount > MaxSectionVertexCount)
+				{
+					sections.push_back({ static_cast<uint32_t>(sectionStart), static_cast<uint32_t>(iIndex - sectionStart), static_cast<int32_t>(sectionVertices.size() - sectionVertexCount) });
+					sectionStart = iIndex;
+					sectionVertexCount = 0;
+					++sectionId;
+				}
+
+				for (size_t i{ iIndex }; i < iIndex + 3; ++i)
+				{
+					const uint32_t index{ indices[i] };
+					if (sectionStamps[index] != sectionId)
+					{
+						sectionStamps[index] = sectionId;
+						localIndices[index] = static_cast<uint32_t>(sectionVertexCount++);
+						sectionVertices.push_back(index);
+					}
+
+					shortIndices[i] = static_cast<uint16_t>(localIndices[index]);
+				}
+			}
+
+			sections.push_back({ static_cast<uint32_t>(sectionStart), static_cast<uint32_t>(indices.size() - sectionStart), static_cast<int32_t>(sectionVertices.size() - sectionVertexCount) });
+
+			//Splitting pays off when the vertices copied into several sections take less memory than the halved indices save.
+			//Unused vertices are dropped by the split, so the copies are counted against the vertices the indices use.
+			const size_t usedVertexCount{ static_cast<size_t>(std::count_if(sectionStamps.begin(), sectionStamps.end(), [](uint32_t stamp) { return stamp != UINT32_MAX; })) };
+			const size_t duplicatedVertexCount{ sectionVertices.size() - usedVertexCount };
+			if (duplicatedVertexCount * sizeof(Vertex) >= indices.size() * (sizeof(uint32_t) - sizeof(uint16_t)) || sectionVertices.size() > INT32_MAX)
+			{
+				sections.assign(1, { 0, static_cast<uint32_t>(indices.size()), 0 });
+				return indices;
+			}
+
+			std::vector<Vertex> sectionedVertices(sectionVertices.size());
+			for (size_t i{ 0 }; i < sectionVertices.size(); ++i)
+				sectionedVertices[i] = vertices[sectionVertices[i]];
+
+			vertices = std::move(sectionedVertices);
+			return shortIndices;
+		}
+	}
+}
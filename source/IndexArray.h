@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+struct Vertex;
+
+namespace dae
+{
+	//CPU side index buffer, 16-bit whenever every section of the mesh has at most 65536 vertices
+	using IndexArray = std::variant<std::vector<uint16_t>, std::vector<uint32_t>>;
+
+	//Range of the index buffer drawn with its own base vertex, so 16-bit indices can address meshes of any size
+	struct MeshSection
+	{
+		uint32_t firstIndex{};
+		uint32_t indexCount{};
+		int32_t baseVertex{};
+	};
+
+	//Level of detail, a range of the index buffer that draws the whole mesh with fewer triangles
+	struct MeshLod
+	{
+		uint32_t firstIndex{};
+		uint32_t indexCount{};
+		float error{};	//Root mean square distance of the worst collapse from the original triangles around it, in object space. Not a bound, single points can be further off
+	};
+
+	namespace IndexArrays
+	{
+		//Vertices a section can address with 16-bit indices
+		constexpr size_t MaxSectionVertexCount{ 65536 };
+
+		size_t GetIndexCount(const IndexArray& indices);
+		uint32_t GetIndexSize(const IndexArray& indices);
+		const void* GetData(const IndexArray& indices);
+
+		//Picks the smallest index format for the mesh, and always returns at least one section.
+		//Larger meshes are split into consecutive sections of at most MaxSectionVertexCount vertices, each with its own copy of the vertices it uses,
+		//when the duplicated border vertices cost less than the index bytes saved. Otherwise they keep 32-bit indices.
+		IndexArray Compact(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, std::vector<MeshSection>& sections);
+	}
+}
@@ -0,0 +1,164 @@
+#include "pch.h"
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dae
+{
+	MappedFile::MappedFile(const std::string& path)
+	{
+		Open(path);
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this == &other)
+			return *this;
+
+		Close();
+
+		m_pData = other.m_pData;
+		m_Size = other.m_Size;
+		m_IsOpen = other.m_IsOpen;
+#if defined(_WIN32)
+		m_pFileHandle = other.m_pFileHandle;
+		m_pMappingHandle = other.m_pMappingHandle;
+		other.m_pFileHandle = nullptr;
+		other.m_pMappingHandle = nullptr;
+#else
+		m_FileDescriptor = other.m_FileDescriptor;
+		other.m_FileDescriptor = -1;
+#endif
+		other.m_pData = nullptr;
+		other.m_Size = 0;
+		other.m_IsOpen = false;
+
+		return *this;
+	}
+
+#if defined(_WIN32)
+	bool MappedFile::Open(const std::string& path)
+	{
+		Close();
+
+		HANDLE file{ CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr) };
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER fileSize{};
+		if (!GetFileSizeEx(file, &fileSize))
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		m_pFileHandle = file;
+		m_Size = static_cast<size_t>(fileSize.QuadPart);
+		m_IsOpen = true;
+
+		//Empty files cannot be mapped, but are still valid (empty) views
+		if (m_Size == 0)
+			return true;
+
+		m_pMappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (m_pMappingHandle == nullptr)
+		{
+			Close();
+			return false;
+		}
+
+		m_pData = static_cast<const char*>(MapViewOfFile(m_pMappingHandle, FILE_MAP_READ, 0, 0, 0));
+		if (m_pData == nullptr)
+		{
+			Close();
+			return false;
+		}
+
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (m_pData)
+			UnmapViewOfFile(m_pData);
+
+		if (m_pMappingHandle)
+			CloseHandle(m_pMappingHandle);
+
+		if (m_pFileHandle)
+			CloseHandle(m_pFileHandle);
+
+		m_pData = nullptr;
+		m_pMappingHandle = nullptr;
+		m_pFileHandle = nullptr;
+		m_Size = 0;
+		m_IsOpen = false;
+	}
+#else
+	bool MappedFile::Open(const std::string& path)
+	{
+		Close();
+
+		const int fileDescriptor{ open(path.c_str(), O_RDONLY) };
+		if (fileDescriptor < 0)
+			return false;
+
+		struct stat fileStats {};
+		if (fstat(fileDescriptor, &fileStats) != 0)
+		{
+			close(fileDescriptor);
+			return false;
+		}
+
+		m_FileDescriptor = fileDescriptor;
+		m_Size = static_cast<size_t>(fileStats.st_size);
+		m_IsOpen = true;
+
+		if (m_Size == 0)
+			return true;
+
+		void* pData{ mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0) };
+		if (pData == MAP_FAILED)
+		{
+			Close();
+			return false;
+		}
+
+		madvise(pData, m_Size, MADV_SEQUENTIAL);
+		m_pData = static_cast<const char*>(pData);
+
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (m_pData)
+			munmap(const_cast<char*>(m_pData), m_Size);
+
+		if (m_FileDescriptor >= 0)
+			close(m_FileDescriptor);
+
+		m_pData = nullptr;
+		m_FileDescriptor = -1;
+		m_Size = 0;
+		m_IsOpen = false;
+	}
+#endif
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <string>
+#include <string_view>
+
+namespace dae
+{
+	//Read-only view of a whole file, backed by the OS page cache instead of a heap copy
+	class MappedFile final
+	{
+	public:
+		MappedFile() = default;
+		explicit MappedFile(const std::string& path);
+		~MappedFile();
+
+		MappedFile(const MappedFile& other) = delete;
+		MappedFile& operator=(const MappedFile& other) = delete;
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+
+		bool Open(const std::string& path);
+		void Close();
+
+		inline bool IsOpen() const { return m_IsOpen; }
+		inline const char* GetData() const { return m_pData; }
+		inline size_t GetSize() const { return m_Size; }
+		inline std::string_view GetView() const { return { m_pData, m_Size }; }
+
+	private:
+		const char* m_pData{ nullptr };
+		size_t m_Size{};
+		bool m_IsOpen{ false };
+
+#if defined(_WIN32)
+		void* m_pFileHandle{ nullptr };
+		void* m_pMappingHandle{ nullptr };
+#else
+		int m_FileDescriptor{ -1 };
+#endif
+	};
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include <cfloat>
 #include <cmath>
 
 namespace dae
@@ -21,36 +22,38 @@ namespace dae
 	constexpr auto TO_RADIANS(PI / 180.0f);
 
 	/* --- HELPER FUNCTIONS --- */
-	inline float Square(float a)
+	constexpr float Square(float a)
 	{
 		return a * a;
 	}
 
-	inline float Lerpf(float a, float b, float factor)
+	constexpr float Lerpf(float a, float b, float factor)
 	{
 		return ((1 - factor) * a) + (factor * b);
 	}
 
-	inline bool AreEqual(float a, float b, float epsilon = FLT_EPSILON)
+	constexpr bool AreEqual(float a, float b, float epsilon = FLT_EPSILON)
 	{
-		return abs(a - b) < epsilon;
+		//std::abs is not constexpr before C++23
+		const float difference{ a - b };
+		return (difference < 0.f ? -difference : difference) < epsilon;
 	}
 
-	inline int Clamp(const int v, int min, int max)
+	constexpr int Clamp(const int v, int min, int max)
 	{
 		if (v < min) return min;
 		if (v > max) return max;
 		return v;
 	}
 
-	inline float Clamp(const float v, float min, float max)
+	constexpr float Clamp(const float v, float min, float max)
 	{
 		if (v < min) return min;
 		if (v > max) return max;
 		return v;
 	}
 
-	inline float Saturate(const float v)
+	constexpr float Saturate(const float v)
 	{
 		if (v < 0.f) return 0.f;
 		if (v > 1.f) return 1.f;
@@ -1,65 +1,91 @@
 #pragma once
+#include <cassert>
+#include <cmath>
+#include <type_traits>
+#include "MathHelpers.h"
 #include "Vector3.h"
 #include "Vector4.h"
 
+//SSE is part of every x64 target, define DAE_MATRIX_SCALAR to build the plain implementation instead.
+//Both do the same float operations in the same order (no FMA), so they give identical results.
+//Constant evaluation always takes the plain path, intrinsics are not constexpr.
+#if !defined(DAE_MATRIX_SCALAR) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__))
+#define DAE_MATRIX_SSE
+#include <xmmintrin.h>
+#endif
+
 namespace dae {
 	struct Matrix
 	{
-		Matrix() = default;
-		Matrix(
+		constexpr Matrix() noexcept = default;
+		constexpr Matrix(
 			const Vector3& xAxis,
 			const Vector3& yAxis,
 			const Vector3& zAxis,
-			const Vector3& t);
+			const Vector3& t) noexcept;
 
-		Matrix(
+		constexpr Matrix(
 			const Vector4& xAxis,
 			const Vector4& yAxis,
 			const Vector4& zAxis,
-			const Vector4& t);
-
-		Matrix(const Matrix& m);
-
-		Vector3 TransformVector(const Vector3& v) const;
-		Vector3 TransformVector(float x, float y, float z) const;
-		Vector3 TransformPoint(const Vector3& p) const;
-		Vector3 TransformPoint(float x, float y, float z) const;
-
-		Vector4 TransformPoint(const Vector4& p) const;
-		Vector4 TransformPoint(float x, float y, float z, float w) const;
-
-		const Matrix& Transpose();
-		const Matrix& Inverse();
-
-		Vector3 GetAxisX() const;
-		Vector3 GetAxisY() const;
-		Vector3 GetAxisZ() const;
-		Vector3 GetTranslation() const;
-
-		static Matrix CreateTranslation(float x, float y, float z);
-		static Matrix CreateTranslation(const Vector3& t);
-		static Matrix CreateRotationX(float pitch);
-		static Matrix CreateRotationY(float yaw);
-		static Matrix CreateRotationZ(float roll);
-		static Matrix CreateRotation(float pitch, float yaw, float roll);
-		static Matrix CreateRotation(const Vector3& r);
-		static Matrix CreateScale(float sx, float sy, float sz);
-		static Matrix CreateScale(const Vector3& s);
-		static Matrix Transpose(const Matrix& m);
-		static Matrix Inverse(const Matrix& m);
-
-		static Matrix CreateLookAtLH(const Vector3& origin, const Vector3& forward, const Vector3& up);
-		static Matrix CreatePerspectiveFovLH(float fovy, float aspect, float zn, float zf);
-
-		Vector4& operator[](int index);
-		Vector4 operator[](int index) const;
-		Matrix operator*(const Matrix& m) const;
-		const Matrix& operator*=(const Matrix& m);
+			const Vector4& t) noexcept;
+
+		constexpr Matrix(const Matrix& m) noexcept = default;
+		constexpr Matrix& operator=(const Matrix& m) noexcept = default;
+
+		constexpr Vector3 TransformVector(const Vector3& v) const noexcept;
+		constexpr Vector3 TransformVector(float x, float y, float z) const noexcept;
+		constexpr Vector3 TransformPoint(const Vector3& p) const noexcept;
+		constexpr Vector3 TransformPoint(float x, float y, float z) const noexcept;
+
+		constexpr Vector4 TransformPoint(const Vector4& p) const noexcept;
+		constexpr Vector4 TransformPoint(float x, float y, float z, float w) const noexcept;
+
+		constexpr const Matrix& Transpose() noexcept;
+		constexpr const Matrix& Inverse() noexcept;
+		//Cheaper inverses for when the last column is (0, 0, 0, 1): any 3x3 part, or only rotation.
+		//InverseRigid asserts IsRigid. Without asserts a scaled matrix is still transposed, so m * InverseRigid(m) is the squared scale, not the identity.
+		constexpr const Matrix& InverseAffine() noexcept;
+		constexpr const Matrix& InverseRigid() noexcept;
+
+		constexpr bool IsAffine(float epsilon = 1e-5f) const noexcept;
+		constexpr bool IsRigid(float epsilon = 1e-4f) const noexcept;
+
+		constexpr Vector3 GetAxisX() const noexcept;
+		constexpr Vector3 GetAxisY() const noexcept;
+		constexpr Vector3 GetAxisZ() const noexcept;
+		constexpr Vector3 GetTranslation() const noexcept;
+
+		static constexpr Matrix CreateTranslation(float x, float y, float z) noexcept;
+		static constexpr Matrix CreateTranslation(const Vector3& t) noexcept;
+		static Matrix CreateRotationX(float pitch) noexcept;
+		static Matrix CreateRotationY(float yaw) noexcept;
+		static Matrix CreateRotationZ(float roll) noexcept;
+		static Matrix CreateRotation(float pitch, float yaw, float roll) noexcept;
+		static Matrix CreateRotation(const Vector3& r) noexcept;
+		static constexpr Matrix CreateScale(float sx, float sy, float sz) noexcept;
+		static constexpr Matrix CreateScale(const Vector3& s) noexcept;
+		static constexpr Matrix Transpose(const Matrix& m) noexcept;
+		static constexpr Matrix Inverse(const Matrix& m) noexcept;
+		static constexpr Matrix InverseAffine(const Matrix& m) noexcept;
+		static constexpr Matrix InverseRigid(const Matrix& m) noexcept;
+		//Inverse transpose of the upper 3x3 without translation, transforms normals with TransformVector under non uniform scale
+		static constexpr Matrix CreateNormalMatrix(const Matrix& m) noexcept;
+
+		static Matrix CreateLookAtLH(const Vector3& origin, const Vector3& forward, const Vector3& up) noexcept;
+		static constexpr Matrix CreatePerspectiveFovLH(float fovy, float aspect, float zn, float zf) noexcept;
+
+		constexpr Vector4& operator[](int index) noexcept;
+		constexpr Vector4 operator[](int index) const noexcept;
+		constexpr Matrix operator*(const Matrix& m) const noexcept;
+		constexpr const Matrix& operator*=(const Matrix& m) noexcept;
+
+		static const Matrix Identity;
 
 	private:
 
-		//Row-Major Matrix
-		Vector4 data[4]
+		//Row-Major Matrix, rows are aligned so the SSE backend can load them directly
+		alignas(16) Vector4 data[4]
 		{
 			{1,0,0,0}, //xAxis
 			{0,1,0,0}, //yAxis
@@ -72,4 +98,609 @@ namespace dae {
 		// v2x v2y v2z v2w
 		// v3x v3y v3z v3w
 	};
-}
\ No newline at end of file
+
+	inline constexpr Matrix Matrix::Identity{};
+
+#ifdef DAE_MATRIX_SSE
+	namespace MatrixSse
+	{
+		inline __m128 LoadRow(const Vector4& row) noexcept
+		{
+			return _mm_load_ps(&row.x);
+		}
+
+		inline void StoreRow(Vector4& row, __m128 value) noexcept
+		{
+			_mm_store_ps(&row.x, value);
+		}
+
+		template<int Lane>
+		inline __m128 Splat(__m128 value) noexcept
+		{
+			return _mm_shuffle_ps(value, value, _MM_SHUFFLE(Lane, Lane, Lane, Lane));
+		}
+
+		//x * row0 + y * row1 + z * row2 + w * row3, added left to right like the scalar version
+		inline __m128 CombineRows(__m128 weights, __m128 row0, __m128 row1, __m128 row2, __m128 row3) noexcept
+		{
+			__m128 result{ _mm_mul_ps(Splat<0>(weights), row0) };
+			result = _mm_add_ps(result, _mm_mul_ps(Splat<1>(weights), row1));
+			result = _mm_add_ps(result, _mm_mul_ps(Splat<2>(weights), row2));
+			return _mm_add_ps(result, _mm_mul_ps(Splat<3>(weights), row3));
+		}
+
+		inline __m128 CombineRows(__m128 weights, const Vector4* pRows) noexcept
+		{
+			return CombineRows(weights, LoadRow(pRows[0]), LoadRow(pRows[1]), LoadRow(pRows[2]), LoadRow(pRows[3]));
+		}
+
+		//x * row0 + y * row1 + z * row2, plus row3 for points
+		inline __m128 TransformRows(float x, float y, float z, const Vector4* pRows, bool isPoint) noexcept
+		{
+			__m128 result{ _mm_mul_ps(_mm_set1_ps(x), LoadRow(pRows[0])) };
+			result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(y), LoadRow(pRows[1])));
+			result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(z), LoadRow(pRows[2])));
+			return isPoint ? _mm_add_ps(result, LoadRow(pRows[3])) : result;
+		}
+
+		inline __m128 Cross(__m128 a, __m128 b) noexcept
+		{
+			const __m128 aYZX{ _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1)) };
+			const __m128 bZXY{ _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2)) };
+			const __m128 aZXY{ _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2)) };
+			const __m128 bYZX{ _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1)) };
+			return _mm_sub_ps(_mm_mul_ps(aYZX, bZXY), _mm_mul_ps(aZXY, bYZX));
+		}
+
+		//xyz only, summed as (x + y) + z like Vector3::Dot
+		inline float Dot3(__m128 a, __m128 b) noexcept
+		{
+			const __m128 product{ _mm_mul_ps(a, b) };
+			const __m128 sum{ _mm_add_ss(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(1, 1, 1, 1))) };
+			return _mm_cvtss_f32(_mm_add_ss(sum, _mm_movehl_ps(product, product)));
+		}
+
+		//Rows of the upper 3x3 inverse transposed (the normal matrix), from the cofactors: b x c, c x a, a x b over the determinant
+		inline void InverseTransposeRows(__m128 a, __m128 b, __m128 c, __m128& r0, __m128& r1, __m128& r2) noexcept
+		{
+			r0 = Cross(b, c);
+			r1 = Cross(c, a);
+			r2 = Cross(a, b);
+
+			const float det{ Dot3(a, r0) };
+			assert((!AreEqual(det, 0.f)) && "ERROR: determinant is 0, there is no INVERSE!");
+			const __m128 invDet{ _mm_set1_ps(1.f / det) };
+
+			r0 = _mm_mul_ps(r0, invDet);
+			r1 = _mm_mul_ps(r1, invDet);
+			r2 = _mm_mul_ps(r2, invDet);
+		}
+
+		//Inverse of [rows of 3x3, t] given the inverse transposed rows: transpose them and make the translation -t times the result
+		inline void StoreAffineInverse(Vector4* pData, __m128 r0, __m128 r1, __m128 r2, __m128 t) noexcept
+		{
+			//The w lanes of r0-r2 only end up in r3, which is not stored
+			__m128 r3{ _mm_setzero_ps() };
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+			//Adds up in the same order as the dot products of the scalar version, w is 1 - 0
+			__m128 translation{ _mm_mul_ps(Splat<0>(t), r0) };
+			translation = _mm_add_ps(translation, _mm_mul_ps(Splat<1>(t), r1));
+			translation = _mm_add_ps(translation, _mm_mul_ps(Splat<2>(t), r2));
+			translation = _mm_sub_ps(_mm_set_ps(1.f, 0.f, 0.f, 0.f), translation);
+
+			StoreRow(pData[0], r0);
+			StoreRow(pData[1], r1);
+			StoreRow(pData[2], r2);
+			StoreRow(pData[3], translation);
+		}
+
+		inline Vector3 ToVector3(__m128 value) noexcept
+		{
+			alignas(16) float values[4];
+			_mm_store_ps(values, value);
+			return Vector3{ values[0], values[1], values[2] };
+		}
+	}
+#endif
+
+	constexpr Matrix::Matrix(const Vector3& xAxis, const Vector3& yAxis, const Vector3& zAxis, const Vector3& t) noexcept :
+		Matrix({ xAxis, 0 }, { yAxis, 0 }, { zAxis, 0 }, { t, 1 })
+	{
+	}
+
+	constexpr Matrix::Matrix(const Vector4& xAxis, const Vector4& yAxis, const Vector4& zAxis, const Vector4& t) noexcept :
+		data{ xAxis, yAxis, zAxis, t }
+	{
+	}
+
+	constexpr Vector3 Matrix::TransformVector(const Vector3& v) const noexcept
+	{
+		return TransformVector(v.x, v.y, v.z);
+	}
+
+	constexpr Vector3 Matrix::TransformVector(float x, float y, float z) const noexcept
+	{
+#ifdef DAE_MATRIX_SSE
+		if (!std::is_constant_evaluated())
+			return MatrixSse::ToVector3(MatrixSse::TransformRows(x, y, z, data, false));
+#endif
+
+		return Vector3{
+			data[0].x * x + data[1].x * y + data[2].x * z,
+			data[0].y * x + data[1].y * y + data[2].y * z,
+			data[0].z * x + data[1].z * y + data[2].z * z
+		};
+	}
+
+	constexpr Vector3 Matrix::TransformPoint(const Vector3& p) const noexcept
+	{
+		return TransformPoint(p.x, p.y, p.z);
+	}
+
+	constexpr Vector3 Matrix::TransformPoint(float x, float y, float z) const noexcept
+	{
+#ifdef DAE_MATRIX_SSE
+		if (!std::is_constant_evaluated())
+			return MatrixSse::ToVector3(MatrixSse::TransformRows(x, y, z, data, true));
+#endif
+
+		return Vector3{
+			data[0].x * x + data[1].x * y + data[2].x * z + data[3].x,
+			data[0].y * x + data[1].y * y + data[2].y * z + data[3].y,
+			data[0].z * x + data[1].z * y + data[2].z * z + data[3].z,
+		};
+	}
+
+	constexpr Vector4 Matrix::TransformPoint(const Vector4& p) const noexcept
+	{
+		return TransformPoint(p.x, p.y, p.z, p.w);
+	}
+
+	constexpr Vector4 Matrix::TransformPoint(float x, float y, float z, float w) const noexcept
+	{
+#ifdef DAE_MATRIX_SSE
+		//Matches the scalar version, which adds the last row without scaling it by w
+		if (!std::is_constant_evaluated())
+		{
+			Vector4 transformed;
+			_mm_storeu_ps(&transformed.x, MatrixSse::TransformRows(x, y, z, data, true));
+			return transformed;
+		}
+#endif
+
+		return Vector4{
+			data[0].x * x + data[1].x * y + data[2].x * z + data[3].x,
+			data[0].y * x + data[1].y * y + data[2].y * z + data[3].y,
+			data[0].z * x + data[1].z * y + data[2].z * z + data[3].z,
+			data[0].w * x + data[1].w * y + data[2].w * z + data[3].w
+		};
+	}
+
+	constexpr const Matrix& Matrix::Transpose() noexcept
+	{
+#ifdef DAE_MATRIX_SSE
+		if (!std::is_constant_evaluated())
+		{
+			__m128 row0{ MatrixSse::LoadRow(data[0]) }, row1{ MatrixSse::LoadRow(data[1]) }, row2{ MatrixSse::LoadRow(data[2]) }, row3{ MatrixSse::LoadRow(data[3]) };
+			_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+			MatrixSse::StoreRow(data[0], row0);
+			MatrixSse::StoreRow(data[1], row1);
+			MatrixSse::StoreRow(data[2], row2);
+			MatrixSse::StoreRow(data[3], row3);
+
+			return *this;
+		}
+#endif
+
+		Matrix result{};
+		for (int r{ 0 }; r < 4; ++r)
+		{
+			for (int c{ 0 }; c < 4; ++c)
+			{
+				result[r][c] = data[c][r];
+			}
+		}
+
+		data[0] = result[0];
+		data[1] = result[1];
+		data[2] = result[2];
+		data[3] = result[3];
+
+		return *this;
+	}
+
+	constexpr const Matrix& Matrix::Inverse() noexcept
+	{
+#ifdef DAE_MATRIX_SSE
+		//Same FGED1 inverse as below, three lanes at a time
+		if (!std::is_constant_evaluated())
+		{
+			using namespace MatrixSse;
+
+			const __m128 a{ LoadRow(data[0]) };
+			const __m128 b{ LoadRow(data[1]) };
+			const __m128 c{ LoadRow(data[2]) };
+			const __m128 d{ LoadRow(data[3]) };
+
+			const __m128 x{ Splat<3>(a) };
+			const __m128 y{ Splat<3>(b) };
+			const __m128 z{ Splat<3>(c) };
+			const __m128 w{ Splat<3>(d) };
+
+			__m128 s{ Cross(a, b) };
+			__m128 t{ Cross(c, d) };
+			__m128 u{ _mm_sub_ps(_mm_mul_ps(a, y), _mm_mul_ps(b, x)) };
+			__m128 v{ _mm_sub_ps(_mm_mul_ps(c, w), _mm_mul_ps(d, z)) };
+
+			const float det{ Dot3(s, v) + Dot3(t, u) };
+			assert((!AreEqual(det, 0.f)) && "ERROR: determinant is 0, there is no INVERSE!");
+			const __m128 invDet{ _mm_set1_ps(1.f / det) };
+
+			s = _mm_mul_ps(s, invDet); t = _mm_mul_ps(t, invDet); u = _mm_mul_ps(u, invDet); v = _mm_mul_ps(v, invDet);
+
+			__m128 r0{ _mm_add_ps(Cross(b, v), _mm_mul_ps(t, y)) };
+			__m128 r1{ _mm_sub_ps(Cross(v, a), _mm_mul_ps(t, x)) };
+			__m128 r2{ _mm_add_ps(Cross(d, u), _mm_mul_ps(s, w)) };
+			__m128 r3{ _mm_sub_ps(Cross(u, c), _mm_mul_ps(s, z)) };
+
+			const Vector4 translation{ -Dot3(b, t), Dot3(a, t), -Dot3(d, s), Dot3(c, s) };
+
+			//The rows come out as columns
+			_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+			StoreRow(data[0], r0);
+			StoreRow(data[1], r1);
+			StoreRow(data[2], r2);
+			data[3] = translation;
+
+			return *this;
+		}
+#endif
+
+		//Optimized Inverse as explained in FGED1 - used widely in other libraries too.
+		const Vector3 a = data[0];
+		const Vector3 b = data[1];
+		const Vector3 c = data[2];
+		const Vector3 d = data[3];
+
+		const float x = data[0][3];
+		const float y = data[1][3];
+		const float z = data[2][3];
+		const float w = data[3][3];
+
+		Vector3 s = Vector3::Cross(a, b);
+		Vector3 t = Vector3::Cross(c, d);
+		Vector3 u = a * y - b * x;
+		Vector3 v = c * w - d * z;
+
+		const float det = Vector3::Dot(s, v) + Vector3::Dot(t, u);
+		assert((!AreEqual(det, 0.f)) && "ERROR: determinant is 0, there is no INVERSE!");
+		const float invDet = 1.f / det;
+
+		s *= invDet; t *= invDet; u *= invDet; v *= invDet;
+
+		const Vector3 r0 = Vector3::Cross(b, v) + t * y;
+		const Vector3 r1 = Vector3::Cross(v, a) - t * x;
+		const Vector3 r2 = Vector3::Cross(d, u) + s * w;
+		const Vector3 r3 = Vector3::Cross(u, c) - s * z;
+
+		data[0] = Vector4{ r0.x, r1.x, r2.x, r3.x };
+		data[1] = Vector4{ r0.y, r1.y, r2.y, r3.y };
+		data[2] = Vector4{ r0.z, r1.z, r2.z, r3.z };
+		data[3] = {-Vector3::Dot(b, t),Vector3::Dot(a, t),-Vector3::Dot(d, s),Vector3::Dot(c, s) };
+
+		return *this;
+	}
+
+	constexpr const Matrix& Matrix::InverseAffine() noexcept
+	{
+		assert(IsAffine() && "ERROR: InverseAffine needs (0, 0, 0, 1) as the last column!");
+
+#ifdef DAE_MATRIX_SSE
+		if (!std::is_constant_evaluated())
+		{
+			using namespace MatrixSse;
+
+			__m128 r0, r1, r2;
+			InverseTransposeRows(LoadRow(data[0]), LoadRow(data[1]), LoadRow(data[2]), r0, r1, r2);
+			StoreAffineInverse(data, r0, r1, r2, LoadRow(data[3]));
+
+			return *this;
+		}
+#endif
+
+		const Matrix normalMatrix{ CreateNormalMatrix(*this) };
+		const Vector3 r0{ normalMatrix.data[0] };
+		const Vector3 r1{ normalMatrix.data[1] };
+		const Vector3 r2{ normalMatrix.data[2] };
+		const Vector3 t{ data[3] };
+
+		data[0] = Vector4{ r0.x, r1.x, r2.x, 0.f };
+		data[1] = Vector4{ r0.y, r1.y, r2.y, 0.f };
+		data[2] = Vector4{ r0.z, r1.z, r2.z, 0.f };
+		data[3] = Vector4{ -Vector3::Dot(t, r0), -Vector3::Dot(t, r1), -Vector3::Dot(t, r2), 1.f };
+
+		return *this;
+	}
+
+	constexpr const Matrix& Matrix::InverseRigid() noexcept
+	{
+		//The rotation is orthonormal, so its inverse is its transpose
+		assert(IsRigid() && "ERROR: InverseRigid needs a rotation and translation only matrix!");
+
+#ifdef DAE_MATRIX_SSE
+		if (!std::is_constant_evaluated())
+		{
+			using namespace MatrixSse;
+			StoreAffineInverse(data, LoadRow(data[0]), LoadRow(data[1]), LoadRow(data[2]), LoadRow(data[3]));
+
+			return *this;
+		}
+#endif
+
+		const Vector3 r0{ data[0] };
+		const Vector3 r1{ data[1] };
+		const Vector3 r2{ data[2] };
+		const Vector3 t{ data[3] };
+
+		data[0] = Vector4{ r0.x, r1.x, r2.x, 0.f };
+		data[1] = Vector4{ r0.y, r1.y, r2.y, 0.f };
+		data[2] = Vector4{ r0.z, r1.z, r2.z, 0.f };
+		data[3] = Vector4{ -Vector3::Dot(t, r0), -Vector3::Dot(t, r1), -Vector3::Dot(t, r2), 1.f };
+
+		return *this;
+	}
+
+	constexpr bool Matrix::IsAffine(float epsilon) const noexcept
+	{
+		return AreEqual(data[0].w, 0.f, epsilon) && AreEqual(data[1].w, 0.f, epsilon) && AreEqual(data[2].w, 0.f, epsilon) && AreEqual(data[3].w, 1.f, epsilon);
+	}
+
+	constexpr bool Matrix::IsRigid(float epsilon) const noexcept
+	{
+		const Vector3 x{ data[0] };
+		const Vector3 y{ data[1] };
+		const Vector3 z{ data[2] };
+
+		return IsAffine(epsilon) &&
+			AreEqual(x.SqrMagnitude(), 1.f, epsilon) && AreEqual(y.SqrMagnitude(), 1.f, epsilon) && AreEqual(z.SqrMagnitude(), 1.f, epsilon) &&
+			AreEqual(Vector3::Dot(x, y), 0.f, epsilon) && AreEqual(Vector3::Dot(y, z), 0.f, epsilon) && AreEqual(Vector3::Dot(z, x), 0.f, epsilon) &&
+			Vector3::Dot(Vector3::Cross(x, y), z) > 0.f;
+	}
+
+	constexpr Matrix Matrix::Transpose(const Matrix& m) noexcept
+	{
+		Matrix out{ m };
+		out.Transpose();
+
+		return out;
+	}
+
+	constexpr Matrix Matrix::Inverse(const Matrix& m) noexcept
+	{
+		Matrix out{ m };
+		out.Inverse();
+
+		return out;
+	}
+
+	constexpr Matrix Matrix::InverseAffine(const Matrix& m) noexcept
+	{
+		Matrix out{ m };
+		out.InverseAffine();
+
+		return out;
+	}
+
+	constexpr Matrix Matrix::InverseRigid(const Matrix& m) noexcept
+	{
+		Matrix out{ m };
+		out.InverseRigid();
+
+		return out;
+	}
+
+	constexpr Matrix Matrix::CreateNormalMatrix(const Matrix& m) noexcept
+	{
+#ifdef DAE_MATRIX_SSE
+		if (!std::is_constant_evaluated())
+		{
+			using namespace MatrixSse;
+
+			__m128 r0, r1, r2;
+			InverseTransposeRows(LoadRow(m.data[0]), LoadRow(m.data[1]), LoadRow(m.data[2]), r0, r1, r2);
+
+			//The w lanes of the cross products are a.w * b.w - a.w * b.w, so already 0
+			Matrix normalMatrix{};
+			StoreRow(normalMatrix.data[0], r0);
+			StoreRow(normalMatrix.data[1], r1);
+			StoreRow(normalMatrix.data[2], r2);
+
+			return normalMatrix;
+		}
+#endif
+
+		const Vector3 a{ m.data[0] };
+		const Vector3 b{ m.data[1] };
+		const Vector3 c{ m.data[2] };
+
+		Vector3 r0{ Vector3::Cross(b, c) };
+		Vector3 r1{ Vector3::Cross(c, a) };
+		Vector3 r2{ Vector3::Cross(a, b) };
+
+		const float det{ Vector3::Dot(a, r0) };
+		assert((!AreEqual(det, 0.f)) && "ERROR: determinant is 0, there is no INVERSE!");
+		const float invDet{ 1.f / det };
+
+		r0 *= invDet; r1 *= invDet; r2 *= invDet;
+
+		return { r0, r1, r2, Vector3::Zero };
+	}
+
+	inline Matrix Matrix::CreateLookAtLH(const Vector3& origin, const Vector3& forward, const Vector3& up) noexcept
+	{
+		assert(false && "Not Implemented");
+		return {};
+	}
+
+	constexpr Matrix Matrix::CreatePerspectiveFovLH(float fov, float aspect, float zn, float zf) noexcept
+	{
+		return { { (1.0f / (fov * aspect)), 0, 0, 0},
+				 { 0, (1.0f / fov), 0, 0 },
+				 { 0, 0, zf / (zf - zn), 1 },
+				 { 0, 0, -(zf * zn) / (zf - zn), 1 } };
+	}
+
+	constexpr Vector3 Matrix::GetAxisX() const noexcept
+	{
+		return data[0];
+	}
+
+	constexpr Vector3 Matrix::GetAxisY() const noexcept
+	{
+		return data[1];
+	}
+
+	constexpr Vector3 Matrix::GetAxisZ() const noexcept
+	{
+		return data[2];
+	}
+
+	constexpr Vector3 Matrix::GetTranslation() const noexcept
+	{
+		return data[3];
+	}
+
+	constexpr Matrix Matrix::CreateTranslation(float x, float y, float z) noexcept
+	{
+		return CreateTranslation({ x, y, z });
+	}
+
+	constexpr Matrix Matrix::CreateTranslation(const Vector3& t) noexcept
+	{
+		return { Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, t };
+	}
+
+	inline Matrix Matrix::CreateRotationX(float pitch) noexcept
+	{
+		return {
+			{1, 0, 0, 0},
+			{0, std::cos(pitch), -std::sin(pitch), 0},
+			{0, std::sin(pitch), std::cos(pitch), 0},
+			{0, 0, 0, 1}
+		};
+	}
+
+	inline Matrix Matrix::CreateRotationY(float yaw) noexcept
+	{
+		return {
+			{std::cos(yaw), 0, -std::sin(yaw), 0},
+			{0, 1, 0, 0},
+			{std::sin(yaw), 0, std::cos(yaw), 0},
+			{0, 0, 0, 1}
+		};
+	}
+
+	inline Matrix Matrix::CreateRotationZ(float roll) noexcept
+	{
+		return {
+			{std::cos(roll), std::sin(roll), 0, 0},
+			{-std::sin(roll), std::cos(roll), 0, 0},
+			{0, 0, 1, 0},
+			{0, 0, 0, 1}
+		};
+	}
+
+	inline Matrix Matrix::CreateRotation(float pitch, float yaw, float roll) noexcept
+	{
+		return CreateRotation({ pitch, yaw, roll });
+	}
+
+	inline Matrix Matrix::CreateRotation(const Vector3& r) noexcept
+	{
+		return CreateRotationX(r[0]) * CreateRotationY(r[1]) * CreateRotationZ(r[2]);
+	}
+
+	constexpr Matrix Matrix::CreateScale(float sx, float sy, float sz) noexcept
+	{
+		return { {sx, 0, 0}, {0, sy, 0}, {0, 0, sz}, Vector3::Zero };
+	}
+
+	constexpr Matrix Matrix::CreateScale(const Vector3& s) noexcept
+	{
+		return CreateScale(s[0], s[1], s[2]);
+	}
+
+#pragma region Operator Overloads
+	constexpr Vector4& Matrix::operator[](int index) noexcept
+	{
+		assert(index <= 3 && index >= 0);
+		return data[index];
+	}
+
+	constexpr Vector4 Matrix::operator[](int index) const noexcept
+	{
+		assert(index <= 3 && index >= 0);
+		return data[index];
+	}
+
+	constexpr Matrix Matrix::operator*(const Matrix& m) const noexcept
+	{
+#ifdef DAE_MATRIX_SSE
+		//Every result row is the rows of m weighted by this row, which sums each element in the same order as the dot products
+		if (!std::is_constant_evaluated())
+		{
+			Matrix result;
+			for (int r{ 0 }; r < 4; ++r)
+				MatrixSse::StoreRow(result.data[r], MatrixSse::CombineRows(MatrixSse::LoadRow(data[r]), m.data));
+
+			return result;
+		}
+#endif
+
+		Matrix result{};
+		Matrix m_transposed = Transpose(m);
+
+		for (int r{ 0 }; r < 4; ++r)
+		{
+			for (int c{ 0 }; c < 4; ++c)
+			{
+				result[r][c] = Vector4::Dot(data[r], m_transposed[c]);
+			}
+		}
+
+		return result;
+	}
+
+	constexpr const Matrix& Matrix::operator*=(const Matrix& m) noexcept
+	{
+#ifdef DAE_MATRIX_SSE
+		//Every row only depends on itself and m, so it can be overwritten in place once m is in registers, even when m is this matrix
+		if (!std::is_constant_evaluated())
+		{
+			const __m128 mRow0{ MatrixSse::LoadRow(m.data[0]) };
+			const __m128 mRow1{ MatrixSse::LoadRow(m.data[1]) };
+			const __m128 mRow2{ MatrixSse::LoadRow(m.data[2]) };
+			const __m128 mRow3{ MatrixSse::LoadRow(m.data[3]) };
+			for (int r{ 0 }; r < 4; ++r)
+				MatrixSse::StoreRow(data[r], MatrixSse::CombineRows(MatrixSse::LoadRow(data[r]), mRow0, mRow1, mRow2, mRow3));
+
+			return *this;
+		}
+#endif
+
+		Matrix copy{ *this };
+		Matrix m_transposed = Transpose(m);
+
+		for (int r{ 0 }; r < 4; ++r)
+		{
+			for (int c{ 0 }; c < 4; ++c)
+			{
+				data[r][c] = Vector4::Dot(copy[r], m_transposed[c]);
+			}
+		}
+
+		return *this;
+	}
+#pragma endregion
+}
@@ -5,118 +5,184 @@
 #include "Camera.h"
 #include "Texture.h"
 #include "Utils.h"
+#include "BatchTransform.h"
+#include "Frustum.h"
+#include "MappedFile.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "TangentSpace.h"
+#include <cassert>
 
 namespace dae {
 
-	Mesh::Mesh(ID3D11Device* pDevice, const std::wstring& effectFile, std::vector<Vertex> newVertices, std::vector<uint32_t> newIndices)
+	namespace
+	{
+		DXGI_FORMAT ToDXGIFormat(AttributeFormat format)
+		{
+			switch (format)
+			{
+			case AttributeFormat::Float2: return DXGI_FORMAT_R32G32_FLOAT;
+			case AttributeFormat::Float3: return DXGI_FORMAT_R32G32B32_FLOAT;
+			case AttributeFormat::Float4: return DXGI_FORMAT_R32G32B32A32_FLOAT;
+			case AttributeFormat::UNorm16x4: return DXGI_FORMAT_R16G16B16A16_UNORM;
+			case AttributeFormat::Half2: return DXGI_FORMAT_R16G16_FLOAT;
+			case AttributeFormat::SNorm16x2: return DXGI_FORMAT_R16G16_SNORM;
+			}
+
+			return DXGI_FORMAT_UNKNOWN;
+		}
+	}
+
+	Mesh::Mesh(ID3D11Device* pDevice, const std::wstring& effectFile, std::vector<Vertex> newVertices, std::vector<uint32_t> newIndices, VertexFormat vertexFormat)
 		: m_Vertices{ newVertices }
-		, m_Indices{ newIndices }
 		, m_pEffect{ new Effect(pDevice, effectFile) }
+		, m_VertexFormat{ vertexFormat }
 	{
-		static constexpr uint32_t elementsCount{ 4 };
-		D3D11_INPUT_ELEMENT_DESC vertexDesc[elementsCount]{};
+		TangentSpace::Generate(m_Vertices.data(), m_Vertices.size(), newIndices.data(), newIndices.size());
 
-		vertexDesc[0].SemanticName = "POSITION";
-		vertexDesc[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		vertexDesc[0].AlignedByteOffset = 0;
-		vertexDesc[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+		MeshOptimizer::OptimizeVertexCache(newIndices.data(), newIndices.size(), m_Vertices.size());
+		MeshOptimizer::OptimizeOverdraw(newIndices.data(), newIndices.size(), m_Vertices.data(), m_Vertices.size());
+		MeshOptimizer::OptimizeVertexFetch(m_Vertices, newIndices);
+		MeshSimplifier::GenerateLodChain(m_Vertices, newIndices, m_Lods);
 
-		vertexDesc[1].SemanticName = "TEXCOORD";
-		vertexDesc[1].Format = DXGI_FORMAT_R32G32_FLOAT;
-		vertexDesc[1].AlignedByteOffset = 12;
-		vertexDesc[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+		m_Indices = IndexArrays::Compact(m_Vertices, newIndices, m_Sections);
 
-		vertexDesc[2].SemanticName = "NORMAL";
-		vertexDesc[2].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		vertexDesc[2].AlignedByteOffset = 20;
-		vertexDesc[2].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+		MeshletData meshletData{};
+		Meshlets::Build(m_Vertices.data(), m_Vertices.size(), m_Indices, m_Sections, m_Lods, meshletData);
+		m_Meshlets = std::move(meshletData.meshlets);
 
-		vertexDesc[3].SemanticName = "TANGENT";
-		vertexDesc[3].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		vertexDesc[3].AlignedByteOffset = 32;
-		vertexDesc[3].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-
-		m_pEffect->CreateInputLayout(pDevice, vertexDesc, elementsCount);
-
-		D3D11_BUFFER_DESC bufferDesc{};
-		bufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-		bufferDesc.ByteWidth = sizeof(Vertex) * static_cast<uint32_t>(m_Vertices.size());
-		bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-		bufferDesc.CPUAccessFlags = 0;
-		bufferDesc.MiscFlags = 0;
-
-		D3D11_SUBRESOURCE_DATA	initData{};
-		initData.pSysMem = m_Vertices.data();
+		m_Bounds = BoundingBox::FromVertices(m_Vertices.data(), m_Vertices.size());
+		m_BoundingSphere = BoundingSphere::FromVertices(m_Vertices.data(), m_Vertices.size());
+		Initialize(pDevice, m_Vertices.data(), static_cast<uint32_t>(m_Vertices.size()),
+			IndexArrays::GetData(m_Indices), static_cast<uint32_t>(IndexArrays::GetIndexCount(m_Indices)), IndexArrays::GetIndexSize(m_Indices));
+	}
 
-		HRESULT result = pDevice->CreateBuffer(&bufferDesc, &initData, &m_pVertexBuffer);
-		if (FAILED(result))
+	Mesh::Mesh(struct ID3D11Device* pDevice, const std::wstring& effectFile, const std::string& objFile, VertexFormat vertexFormat)
+		: m_pEffect{ new Effect(pDevice, effectFile) }
+		, m_VertexFormat{ vertexFormat }
+	{
+		const MappedFile sourceFile{ objFile };
+		if (!sourceFile.IsOpen())
 		{
-			std::cerr << "Error: " << std::hex << result << std::endl;
+			std::cout << "Invalid file!\n";
 			return;
 		}
 
-		m_IndicesCount = static_cast<uint32_t>(m_Indices.size());
+		Utils::OBJParseSettings parseSettings{};
+		parseSettings.flipAxisAndWinding = true;
+		parseSettings.threadCount = 0;
 
-		bufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-		bufferDesc.ByteWidth = sizeof(uint32_t) * m_IndicesCount;
-		bufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-		bufferDesc.CPUAccessFlags = 0;
-		bufferDesc.MiscFlags = 0;
-		initData.pSysMem = m_Indices.data();
+		//Upload straight from the binary cache when it was built from this exact file
+		const std::string cacheFile{ MeshCache::GetCachePath(objFile) };
+		const uint64_t sourceHash{ MeshCache::HashContent(sourceFile.GetView()) };
 
-		result = pDevice->CreateBuffer(&bufferDesc, &initData, &m_pIndexBuffer);
-		if (FAILED(result))
+		MeshCache cache{};
+		if (cache.Load(cacheFile, sourceHash, parseSettings.GetCacheKey()))
 		{
-			std::cerr << "Error: " << std::hex << result << std::endl;
+			std::cout << MAGENTA_TEXT("Loaded ") << cacheFile << ": " << cache.GetVertexCount() << " vertices\n";
+
+			m_Bounds = cache.GetBounds();
+			m_BoundingSphere = BoundingSphere::FromVertices(cache.GetVertices(), cache.GetVertexCount());
+			m_Sections.assign(cache.GetSections(), cache.GetSections() + cache.GetSectionCount());
+			m_Lods.assign(cache.GetLods(), cache.GetLods() + cache.GetLodCount());
+			m_Meshlets.assign(cache.GetMeshlets(), cache.GetMeshlets() + cache.GetMeshletCount());
+			Initialize(pDevice, cache.GetVertices(), cache.GetVertexCount(), cache.GetIndices(), cache.GetIndexCount(), cache.GetIndexSize());
 			return;
 		}
-	}
 
-	Mesh::Mesh(struct ID3D11Device* pDevice, const std::wstring& effectFile, const std::string& objFile)
-		: m_pEffect{ new Effect(pDevice, effectFile) }
-	{
 		std::vector<Vertex> vertices;
 		std::vector<uint32_t> indices;
-		if (!Utils::ParseOBJ(objFile, vertices, indices, true))
+
+		Utils::OBJParseStatistics parseStatistics{};
+		if (!Utils::ParseOBJ(sourceFile, vertices, indices, parseSettings, &parseStatistics))
 		{
 			std::cout << "Invalid file!\n";
 			return;
 		}
 
-		static constexpr uint32_t elementsCount{ 4 };
-		D3D11_INPUT_ELEMENT_DESC vertexDesc[elementsCount]{};
+		std::cout << MAGENTA_TEXT("Loaded ") << objFile << ": " << parseStatistics.cornerCount << " -> " << parseStatistics.vertexCount
+			<< " vertices in " << parseStatistics.loadTime << " ms\n";
+		std::cout << "  ACMR " << parseStatistics.fileOrderVertexCache.ACMR << " -> " << parseStatistics.vertexCache.ACMR
+			<< ", ATVR " << parseStatistics.fileOrderVertexCache.ATVR << " -> " << parseStatistics.vertexCache.ATVR << "\n";
+		if (parseSettings.measureOverdraw)
+		{
+			std::cout << "  overdraw " << parseStatistics.fileOrderOverdraw.overdraw << " -> " << parseStatistics.overdraw.overdraw << "\n";
+		}
+
+		MeshSimplifier::GenerateLodChain(vertices, indices, m_Lods);
+		for (size_t i{ 1 }; i < m_Lods.size(); ++i)
+		{
+			std::cout << "  LOD " << i << ": " << m_Lods[i].indexCount / 3 << " triangles, rms error " << m_Lods[i].error << "\n";
+		}
+
+		IndexArray compactIndices{ IndexArrays::Compact(vertices, indices, m_Sections) };
+		m_Bounds = BoundingBox::FromVertices(vertices.data(), vertices.size());
+		m_BoundingSphere = BoundingSphere::FromVertices(vertices.data(), vertices.size());
+
+		//Meshlets reorder the indices, so they are built before caching and later loads upload the cached order as is
+		MeshletData meshletData{};
+		Meshlets::Build(vertices.data(), vertices.size(), compactIndices, m_Sections, m_Lods, meshletData);
+		m_Meshlets = std::move(meshletData.meshlets);
+
+		if (!MeshCache::Write(cacheFile, sourceHash, parseSettings.GetCacheKey(), vertices, compactIndices, m_Sections, m_Lods, m_Meshlets, m_Bounds))
+		{
+			std::cout << YELLOW_TEXT("Could not write mesh cache ") << cacheFile << "\n";
+		}
 
-		vertexDesc[0].SemanticName = "POSITION";
-		vertexDesc[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		vertexDesc[0].AlignedByteOffset = 0;
-		vertexDesc[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+		Initialize(pDevice, vertices.data(), static_cast<uint32_t>(vertices.size()),
+			IndexArrays::GetData(compactIndices), static_cast<uint32_t>(IndexArrays::GetIndexCount(compactIndices)), IndexArrays::GetIndexSize(compactIndices));
+	}
 
-		vertexDesc[1].SemanticName = "TEXCOORD";
-		vertexDesc[1].Format = DXGI_FORMAT_R32G32_FLOAT;
-		vertexDesc[1].AlignedByteOffset = 12;
-		vertexDesc[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	void Mesh::Initialize(ID3D11Device* pDevice, const Vertex* pVertices, uint32_t vertexCount, const void* pIndices, uint32_t indexCount, uint32_t indexSize)
+	{
+		//Packed vertices are quantized to the bounds, so the effect needs those to decode them
+		std::vector<PackedVertex> packedVertices{};
+		if (m_VertexFormat == VertexFormat::Packed)
+		{
+			const VertexFormats::Quantization quantization{ VertexFormats::GetQuantization(m_Bounds) };
+
+			packedVertices.resize(vertexCount);
+			VertexFormats::Pack(pVertices, vertexCount, quantization, packedVertices.data());
+
+#if defined(DEBUG) || defined(_DEBUG)
+			VertexFormats::PackingError packingError{};
+			if (!VertexFormats::ValidatePacking(pVertices, packedVertices.data(), vertexCount, quantization, &packingError))
+			{
+				std::cout << RED_TEXT("Packed vertices exceed their error bounds: ") << "position " << packingError.position << ", uv " << packingError.uv
+					<< ", normal " << packingError.normalAngle << " rad, tangent " << packingError.tangentAngle << " rad\n";
+				assert(false && "ERROR: packed vertices exceed their error bounds");
+			}
+#endif
+
+			m_pEffect->UsePackedVertices(quantization.offset, quantization.scale);
+		}
 
-		vertexDesc[2].SemanticName = "NORMAL";
-		vertexDesc[2].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		vertexDesc[2].AlignedByteOffset = 20;
-		vertexDesc[2].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+		const std::span<const VertexAttribute> layout{ VertexFormats::GetLayout(m_VertexFormat) };
 
-		vertexDesc[3].SemanticName = "TANGENT";
-		vertexDesc[3].Format = DXGI_FORMAT_R32G32B32_FLOAT;
-		vertexDesc[3].AlignedByteOffset = 32;
-		vertexDesc[3].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+		static constexpr uint32_t maxElementsCount{ 4 };
+		D3D11_INPUT_ELEMENT_DESC vertexDesc[maxElementsCount]{};
+		const uint32_t elementsCount{ static_cast<uint32_t>(std::min<size_t>(layout.size(), maxElementsCount)) };
+
+		for (uint32_t i{ 0 }; i < elementsCount; ++i)
+		{
+			vertexDesc[i].SemanticName = layout[i].semanticName;
+			vertexDesc[i].Format = ToDXGIFormat(layout[i].format);
+			vertexDesc[i].AlignedByteOffset = layout[i].offset;
+			vertexDesc[i].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+		}
 
 		m_pEffect->CreateInputLayout(pDevice, vertexDesc, elementsCount);
 
 		D3D11_BUFFER_DESC bufferDesc{};
 		bufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-		bufferDesc.ByteWidth = sizeof(Vertex) * static_cast<uint32_t>(vertices.size());
+		bufferDesc.ByteWidth = VertexFormats::GetStride(m_VertexFormat) * vertexCount;
 		bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 		bufferDesc.CPUAccessFlags = 0;
 		bufferDesc.MiscFlags = 0;
 
 		D3D11_SUBRESOURCE_DATA	initData{};
-		initData.pSysMem = vertices.data();
+		initData.pSysMem = packedVertices.empty() ? static_cast<const void*>(pVertices) : packedVertices.data();
 
 		HRESULT result = pDevice->CreateBuffer(&bufferDesc, &initData, &m_pVertexBuffer);
 		if (FAILED(result))
@@ -125,14 +191,15 @@ namespace dae {
 			return;
 		}
 
-		m_IndicesCount = static_cast<uint32_t>(indices.size());
+		m_IndicesCount = indexCount;
+		m_IndexSize = indexSize;
 
 		bufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
-		bufferDesc.ByteWidth = sizeof(uint32_t) * m_IndicesCount;
+		bufferDesc.ByteWidth = m_IndexSize * m_IndicesCount;
 		bufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
 		bufferDesc.CPUAccessFlags = 0;
 		bufferDesc.MiscFlags = 0;
-		initData.pSysMem = indices.data();
+		initData.pSysMem = pIndices;
 
 		result = pDevice->CreateBuffer(&bufferDesc, &initData, &m_pIndexBuffer);
 		if (FAILED(result))
@@ -158,12 +225,12 @@ namespace dae {
 		pDeviceContext->IASetInputLayout(m_pEffect->GetInputLayout());
 
 		//3. Set VertexBuffer
-		constexpr UINT stride = sizeof(Vertex);
+		const UINT stride = VertexFormats::GetStride(m_VertexFormat);
 		constexpr UINT offset = 0;
 		pDeviceContext->IASetVertexBuffers(0, 1, &m_pVertexBuffer, &stride, &offset);
 
 		//4. Set IndexBuffer
-		pDeviceContext->IASetIndexBuffer(m_pIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+		pDeviceContext->IASetIndexBuffer(m_pIndexBuffer, m_IndexSize == sizeof(uint16_t) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT, 0);
 
 		//5. Draw
 		D3DX11_TECHNIQUE_DESC techniqueDesc{};
@@ -172,35 +239,122 @@ namespace dae {
 		for (UINT p{ 0 }; p < techniqueDesc.Passes; ++p)
 		{
 			m_pEffect->GetTechnique()->GetPassByIndex(p)->Apply(0, pDeviceContext);
-			pDeviceContext->DrawIndexed(m_IndicesCount, 0, 0);
+
+			for (const MeshSection& section : m_VisibleSections)
+				pDeviceContext->DrawIndexed(section.indexCount, section.firstIndex, section.baseVertex);
 		}
 	}
 
 	void Mesh::RotateX(float pitch)
 	{
-		m_RotationMatrix = Matrix::CreateRotationX(pitch) * m_RotationMatrix;
+		m_Transform.Rotate(Quaternion::CreateRotationX(pitch));
 	}
 	void Mesh::RotateY(float yaw)
 	{
-		m_RotationMatrix = Matrix::CreateRotationY(yaw) * m_RotationMatrix;
+		m_Transform.Rotate(Quaternion::CreateRotationY(yaw));
 	}
 	void Mesh::RotateZ(float roll)
 	{
-		m_RotationMatrix = Matrix::CreateRotationZ(roll) * m_RotationMatrix;
+		m_Transform.Rotate(Quaternion::CreateRotationZ(roll));
 	}
 
-	void Mesh::SetMatrix(const Camera& camera)
+	void Mesh::SetMatrix(const Camera& camera, int viewportHeight)
 	{
-		const Matrix worldMatrix{ m_ScaleMatrix *( m_RotationMatrix * m_TranslationMatrix) };
+		const Matrix& worldMatrix{ m_Transform.GetWorldMatrix() };
 		const Matrix worldViewProjectionMatrix{ worldMatrix * (camera.viewMatrix * camera.projectionMatrix) };
 
 		m_pEffect->SetMatrix(worldViewProjectionMatrix);
+
+		if (m_Lods.empty())
+			return;
+
+		SelectLod(camera, worldMatrix, viewportHeight);
+
+		const MeshLod& lod{ m_Lods[m_CurrentLod] };
+		const uint32_t lodEnd{ lod.firstIndex + lod.indexCount };
+
+		//Cull in object space, where the meshlet bounds are
+		const Frustum frustum{ Frustum::FromMatrix(worldViewProjectionMatrix) };
+		const Vector3 cameraPosition{ m_Transform.InverseTransformPoint(camera.origin) };
+
+		m_VisibleSections.clear();
+		m_CullingStatistics = {};
+
+		for (const MeshSection& section : m_Sections)
+		{
+			const uint32_t rangeStart{ std::max(section.firstIndex, lod.firstIndex) };
+			const uint32_t rangeEnd{ std::min(section.firstIndex + section.indexCount, lodEnd) };
+			if (rangeStart >= rangeEnd)
+				continue;
+
+			if (!m_IsMeshletCullingEnabled)
+			{
+				m_VisibleSections.push_back({ rangeStart, rangeEnd - rangeStart, section.baseVertex });
+				continue;
+			}
+
+			//Meshlets are sorted by their index range, neighbouring visible ones merge into one draw
+			auto meshletIt{ std::lower_bound(m_Meshlets.begin(), m_Meshlets.end(), rangeStart,
+				[](const Meshlet& meshlet, uint32_t firstIndex) { return meshlet.firstIndex < firstIndex; }) };
+
+			for (; meshletIt != m_Meshlets.end() && meshletIt->firstIndex < rangeEnd; ++meshletIt)
+			{
+				const Meshlet& meshlet{ *meshletIt };
+				++m_CullingStatistics.meshletCount;
+				m_CullingStatistics.triangleCount += meshlet.triangleCount;
+
+				if (Meshlets::IsCulled(meshlet, frustum, cameraPosition, m_IsMeshletBackFaceCullingEnabled))
+				{
+					++m_CullingStatistics.culledMeshletCount;
+					m_CullingStatistics.culledTriangleCount += meshlet.triangleCount;
+					continue;
+				}
+
+				MeshSection* pLast{ m_VisibleSections.empty() ? nullptr : &m_VisibleSections.back() };
+				if (pLast && pLast->baseVertex == section.baseVertex && pLast->firstIndex + pLast->indexCount == meshlet.firstIndex)
+					pLast->indexCount += meshlet.triangleCount * 3;
+				else
+					m_VisibleSections.push_back({ meshlet.firstIndex, meshlet.triangleCount * 3, section.baseVertex });
+			}
+		}
+	}
+
+	void Mesh::SelectLod(const Camera& camera, const Matrix& worldMatrix, int viewportHeight)
+	{
+		//Project every level's error from the closest point of the bounding sphere, the perspective scale is the projection's y axis
+		const float worldScale{ std::max({ worldMatrix.GetAxisX().Magnitude(), worldMatrix.GetAxisY().Magnitude(), worldMatrix.GetAxisZ().Magnitude() }) };
+		const Vector3 center{ worldMatrix.TransformPoint(m_BoundingSphere.center) };
+		const float radius{ m_BoundingSphere.radius * worldScale };
+
+		const float distance{ std::max((center - camera.origin).Magnitude() - radius, camera.nearPlane) };
+		const float pixelsPerUnit{ camera.projectionMatrix[1][1] * static_cast<float>(viewportHeight) * 0.5f / distance };
+
+		m_CurrentLod = 0;
+		for (uint32_t iLod{ static_cast<uint32_t>(m_Lods.size()) - 1 }; iLod > 0; --iLod)
+		{
+			if (m_Lods[iLod].error * worldScale * pixelsPerUnit <= m_MaxLodRmsPixelError)
+			{
+				m_CurrentLod = iLod;
+				break;
+			}
+		}
+	}
+
+	BoundingBox Mesh::GetWorldBounds() const
+	{
+		return BatchTransform::TransformBounds(m_Transform.GetWorldMatrix(), m_Bounds);
+	}
+
+	BoundingSphere Mesh::GetWorldBoundingSphere() const
+	{
+		const Vector3& scale{ m_Transform.GetScale() };
+		const float maxScale{ std::max({ std::abs(scale.x), std::abs(scale.y), std::abs(scale.z) }) };
+		return { m_Transform.GetWorldMatrix().TransformPoint(m_BoundingSphere.center), m_BoundingSphere.radius * maxScale };
 	}
 
 	void Mesh::SetWorldMatrix()
 	{
-		const Matrix worldMatrix{ m_ScaleMatrix * (m_RotationMatrix * m_TranslationMatrix) };
-		m_pEffect->SetWorldMatrix(worldMatrix);
+		m_pEffect->SetWorldMatrix(m_Transform.GetWorldMatrix());
 	}
 
 	void Mesh::SetDiffuseMap(const dae::Texture* pDiffuseMap)
@@ -232,4 +386,10 @@ namespace dae {
 	{
 		m_pEffect->ToggleNormalMap();
 	}
+
+	void Mesh::ToggleMeshletCulling()
+	{
+		m_IsMeshletCullingEnabled = !m_IsMeshletCullingEnabled;
+		m_CullingStatistics = {};
+	}
 }
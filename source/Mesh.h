@@ -1,4 +1,8 @@
 #pragma once
+#include "IndexArray.h"
+#include "Meshlet.h"
+#include "Transform.h"
+#include "VertexFormat.h"
 
 namespace dae {
 
@@ -7,8 +11,8 @@ namespace dae {
 	public:
 
 		Mesh() = default;
-		Mesh(struct ID3D11Device* pDevice, const std::wstring& effectFile, std::vector<Vertex> newVertices, std::vector<uint32_t> newIndices);
-		Mesh(struct ID3D11Device* pDevice, const std::wstring& effectFile, const std::string& objFile);
+		Mesh(struct ID3D11Device* pDevice, const std::wstring& effectFile, std::vector<Vertex> newVertices, std::vector<uint32_t> newIndices, VertexFormat vertexFormat = VertexFormat::Full);
+		Mesh(struct ID3D11Device* pDevice, const std::wstring& effectFile, const std::string& objFile, VertexFormat vertexFormat = VertexFormat::Full);
 		~Mesh();
 
 		Mesh(const Mesh& other) = delete;
@@ -21,7 +25,8 @@ namespace dae {
 		void RotateY(float yaw);
 		void RotateZ(float roll);
 
-		void SetMatrix(const struct Camera& camera);
+		//Also picks the level of detail and culls the meshlets for the next Draw
+		void SetMatrix(const struct Camera& camera, int viewportHeight);
 		void SetWorldMatrix();
 		void SetDiffuseMap(const class Texture* pDiffuseMap);
 		void SetNormalMap(const class Texture* pNormalMap);
@@ -29,18 +34,51 @@ namespace dae {
 		void SetGlossinessMap(const class Texture* pGlossinessMap);
 		void CycleFilteringMethods();
 		void ToggleNormalMap();
+		void ToggleMeshletCulling();
+
+		inline const BoundingBox& GetBounds() const { return m_Bounds; }
+		inline const BoundingSphere& GetBoundingSphere() const { return m_BoundingSphere; }
+		BoundingBox GetWorldBounds() const;
+		BoundingSphere GetWorldBoundingSphere() const;
+		inline Transform& GetTransform() { return m_Transform; }
+		inline const Transform& GetTransform() const { return m_Transform; }
+		inline bool IsMeshletCullingEnabled() const { return m_IsMeshletCullingEnabled; }
+		inline uint32_t GetCurrentLod() const { return m_CurrentLod; }
+		inline uint32_t GetLodTriangleCount(uint32_t lod) const { return lod < m_Lods.size() ? m_Lods[lod].indexCount / 3 : 0; }
+		inline const Meshlets::CullingStatistics& GetCullingStatistics() const { return m_CullingStatistics; }
 
 	private:
 		std::vector<Vertex> m_Vertices{};
-		std::vector<uint32_t> m_Indices{};
+		IndexArray m_Indices{};
+		std::vector<MeshSection> m_Sections{};
+
+		//Every level is a range of the index buffer, the coarsest one whose error stays below m_MaxLodRmsPixelError on screen is drawn.
+		//The errors are root mean square distances, so single silhouette points of a level can be off by more pixels than that.
+		std::vector<MeshLod> m_Lods{};
+		uint32_t m_CurrentLod{};
+		const float m_MaxLodRmsPixelError{ 1.f };
+
+		//Rejected on the CPU in SetMatrix, which leaves the ranges of the surviving ones to draw.
+		//Only outside the frustum: PosCol3D.fx draws both sides (CullMode = none), so back facing meshlets are visible too.
+		//Turn on the cone test together with back face culling in the rasterizer state.
+		std::vector<Meshlet> m_Meshlets{};
+		std::vector<MeshSection> m_VisibleSections{};
+		bool m_IsMeshletCullingEnabled{ true };
+		const bool m_IsMeshletBackFaceCullingEnabled{ false };
+		Meshlets::CullingStatistics m_CullingStatistics{};
 
 		class Effect* m_pEffect{ nullptr };
 		struct ID3D11Buffer* m_pVertexBuffer{ nullptr };
 		struct ID3D11Buffer* m_pIndexBuffer{ nullptr };
 		uint32_t m_IndicesCount{};
+		uint32_t m_IndexSize{};
+		VertexFormat m_VertexFormat{ VertexFormat::Full };
+		BoundingBox m_Bounds{};
+		BoundingSphere m_BoundingSphere{};
+
+		Transform m_Transform{};
 
-		Matrix m_TranslationMatrix{ Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, Vector3::Zero };
-		Matrix m_RotationMatrix{ Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, Vector3::Zero };
-		Matrix m_ScaleMatrix{ Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, Vector3::Zero };
+		void SelectLod(const struct Camera& camera, const Matrix& worldMatrix, int viewportHeight);
+		void Initialize(struct ID3D11Device* pDevice, const Vertex* pVertices, uint32_t vertexCount, const void* pIndices, uint32_t indexCount, uint32_t indexSize);
 	};
 }
\ No newline at end of file
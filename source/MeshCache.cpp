@@ -0,0 +1,266 @@
+#include "pch.h"
+#include "MeshCache.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace dae
+{
+	namespace
+	{
+		//Bump when the layout of the file or of Vertex changes
+		constexpr uint32_t g_MeshCacheVersion{ 6 };
+		constexpr char g_MeshCacheMagic[4]{ 'D', 'A', 'E', 'M' };
+		constexpr uint64_t g_DataAlignment{ 16 };
+
+		struct MeshCacheHeader
+		{
+			char magic[4]{};
+			uint32_t version{};
+			uint64_t sourceHash{};
+			uint64_t payloadHash{};	//HashContent of everything after the header, padding included
+			uint32_t settingsKey{};
+			uint32_t vertexStride{};
+			uint32_t vertexCount{};
+			uint32_t indexCount{};
+			uint32_t indexSize{};
+			uint32_t sectionCount{};
+			uint32_t lodCount{};
+			uint32_t meshletCount{};
+			uint64_t vertexOffset{};
+			uint64_t indexOffset{};
+			uint64_t sectionOffset{};
+			uint64_t lodOffset{};
+			uint64_t meshletOffset{};
+			BoundingBox bounds{};
+		};
+
+		uint64_t AlignUp(uint64_t value)
+		{
+			return (value + g_DataAlignment - 1) & ~(g_DataAlignment - 1);
+		}
+
+		uint64_t Mix(uint64_t value)
+		{
+			value ^= value >> 33;
+			value *= 0xFF51AFD7ED558CCDull;
+			value ^= value >> 33;
+			value *= 0xC4CEB9FE1A85EC53ull;
+			value ^= value >> 33;
+			return value;
+		}
+
+		uint64_t GetEnd(uint64_t offset, uint32_t count, uint64_t elementSize)
+		{
+			return offset + count * elementSize;
+		}
+
+		//The arrays follow the header in order without overlapping, and the meshlets end the file, so the payload hash covers every byte after the header
+		bool IsLayoutValid(const MeshCacheHeader& header, uint64_t fileSize)
+		{
+			//Every offset within the file first, so adding a size to one cannot wrap around
+			const auto follows = [fileSize](uint64_t offset, uint64_t previousEnd) { return offset >= previousEnd && offset <= fileSize; };
+			return
+				follows(header.vertexOffset, sizeof(MeshCacheHeader)) &&
+				follows(header.indexOffset, GetEnd(header.vertexOffset, header.vertexCount, sizeof(Vertex))) &&
+				follows(header.sectionOffset, GetEnd(header.indexOffset, header.indexCount, header.indexSize)) &&
+				follows(header.lodOffset, GetEnd(header.sectionOffset, header.sectionCount, sizeof(MeshSection))) &&
+				follows(header.meshletOffset, GetEnd(header.lodOffset, header.lodCount, sizeof(MeshLod))) &&
+				GetEnd(header.meshletOffset, header.meshletCount, sizeof(Meshlet)) == fileSize;
+		}
+
+		template<typename Index>
+		bool AreIndicesBelow(const char* pIndices, const MeshSection& section, uint64_t vertexCount)
+		{
+			const Index* pSectionIndices{ reinterpret_cast<const Index*>(pIndices) + section.firstIndex };
+			Index maxIndex{};
+			for (uint32_t i{ 0 }; i < section.indexCount; ++i)
+				maxIndex = std::max(maxIndex, pSectionIndices[i]);
+
+			return section.indexCount == 0 || section.baseVertex + uint64_t(maxIndex) < vertexCount;
+		}
+
+		//Mesh draws these ranges without further checks, so a range past the buffers is as bad as a corrupt file
+		bool AreRangesValid(const MeshCacheHeader& header, const char* pData)
+		{
+			const auto isIndexRangeValid = [&header](uint32_t firstIndex, uint64_t indexCount)
+				{
+					return indexCount % 3 == 0 && firstIndex + indexCount <= header.indexCount;
+				};
+
+			const MeshSection* pSections{ reinterpret_cast<const MeshSection*>(pData + header.sectionOffset) };
+			for (uint32_t i{ 0 }; i < header.sectionCount; ++i)
+			{
+				const MeshSection& section{ pSections[i] };
+				if (!isIndexRangeValid(section.firstIndex, section.indexCount) || section.baseVertex < 0 || uint32_t(section.baseVertex) > header.vertexCount)
+					return false;
+
+				const bool areIndicesValid{ header.indexSize == sizeof(uint16_t)
+					? AreIndicesBelow<uint16_t>(pData + header.indexOffset, section, header.vertexCount)
+					: AreIndicesBelow<uint32_t>(pData + header.indexOffset, section, header.vertexCount) };
+				if (!areIndicesValid)
+					return false;
+			}
+
+			const MeshLod* pLods{ reinterpret_cast<const MeshLod*>(pData + header.lodOffset) };
+			for (uint32_t i{ 0 }; i < header.lodCount; ++i)
+			{
+				if (!isIndexRangeValid(pLods[i].firstIndex, pLods[i].indexCount))
+					return false;
+			}
+
+			//Mesh binary searches the meshlets by their first index
+			const Meshlet* pMeshlets{ reinterpret_cast<const Meshlet*>(pData + header.meshletOffset) };
+			for (uint32_t i{ 0 }; i < header.meshletCount; ++i)
+			{
+				const Meshlet& meshlet{ pMeshlets[i] };
+				if (!isIndexRangeValid(meshlet.firstIndex, uint64_t(meshlet.triangleCount) * 3) || (i > 0 && meshlet.firstIndex < pMeshlets[i - 1].firstIndex))
+					return false;
+			}
+
+			return true;
+		}
+	}
+
+	uint64_t MeshCache::HashContent(std::string_view content)
+	{
+		//Four independent lanes keep the multiplies pipelined, hashing runs at memory speed compared to parsing
+		constexpr uint64_t prime{ 0x9E3779B97F4A7C15ull };
+		uint64_t lanes[4]{ prime, prime ^ 1, prime ^ 2, prime ^ 3 };
+
+		const char* pData{ content.data() };
+		const size_t size{ content.size() };
+
+		size_t i{ 0 };
+		for (; i + 32 <= size; i += 32)
+		{
+			for (size_t lane{ 0 }; lane < 4; ++lane)
+			{
+				uint64_t word{};
+				std::memcpy(&word, pData + i + lane * 8, 8);
+				lanes[lane] = (lanes[lane] ^ word) * prime;
+				lanes[lane] ^= lanes[lane] >> 29;
+			}
+		}
+
+		uint64_t hash{ Mix(lanes[0]) ^ (Mix(lanes[1]) * 3) ^ (Mix(lanes[2]) * 5) ^ (Mix(lanes[3]) * 7) };
+		for (; i < size; ++i)
+			hash = (hash ^ static_cast<uint8_t>(pData[i])) * prime;
+
+		return Mix(hash ^ size);
+	}
+
+	bool MeshCache::Load(const std::string& cacheFile, uint64_t sourceHash, uint32_t settingsKey)
+	{
+		if (!m_File.Open(cacheFile) || m_File.GetSize() < sizeof(MeshCacheHeader))
+			return false;
+
+		MeshCacheHeader header{};
+		std::memcpy(&header, m_File.GetData(), sizeof(MeshCacheHeader));
+
+		const bool isValid{
+			std::memcmp(header.magic, g_MeshCacheMagic, sizeof(g_MeshCacheMagic)) == 0 &&
+			header.version == g_MeshCacheVersion &&
+			header.vertexStride == sizeof(Vertex) &&
+			header.sourceHash == sourceHash &&
+			header.settingsKey == settingsKey &&
+			header.vertexOffset % g_DataAlignment == 0 &&
+			header.indexOffset % g_DataAlignment == 0 &&
+			header.sectionOffset % g_DataAlignment == 0 &&
+			header.lodOffset % g_DataAlignment == 0 &&
+			header.meshletOffset % g_DataAlignment == 0 &&
+			(header.indexSize == sizeof(uint16_t) || header.indexSize == sizeof(uint32_t)) &&
+			header.sectionCount > 0 &&
+			header.lodCount > 0 &&
+			IsLayoutValid(header, m_File.GetSize()) &&
+			HashContent(m_File.GetView().substr(sizeof(MeshCacheHeader))) == header.payloadHash &&
+			AreRangesValid(header, m_File.GetData()) };
+
+		if (!isValid)
+		{
+			m_File.Close();
+			return false;
+		}
+
+		//The mapping is page aligned and the offsets are 16 byte aligned, so the arrays can be used in place
+		m_pVertices = reinterpret_cast<const Vertex*>(m_File.GetData() + header.vertexOffset);
+		m_pIndices = m_File.GetData() + header.indexOffset;
+		m_pSections = reinterpret_cast<const MeshSection*>(m_File.GetData() + header.sectionOffset);
+		m_pLods = reinterpret_cast<const MeshLod*>(m_File.GetData() + header.lodOffset);
+		m_pMeshlets = reinterpret_cast<const Meshlet*>(m_File.GetData() + header.meshletOffset);
+		m_VertexCount = header.vertexCount;
+		m_IndexCount = header.indexCount;
+		m_IndexSize = header.indexSize;
+		m_SectionCount = header.sectionCount;
+		m_LodCount = header.lodCount;
+		m_MeshletCount = header.meshletCount;
+		m_Bounds = header.bounds;
+
+		return true;
+	}
+
+	bool MeshCache::Write(const std::string& cacheFile, uint64_t sourceHash, uint32_t settingsKey,
+		const std::vector<Vertex>& vertices, const IndexArray& indices, const std::vector<MeshSection>& sections, const std::vector<MeshLod>& lods,
+		const std::vector<Meshlet>& meshlets, const BoundingBox& bounds)
+	{
+		const size_t indexCount{ IndexArrays::GetIndexCount(indices) };
+		const uint32_t indexSize{ IndexArrays::GetIndexSize(indices) };
+
+		MeshCacheHeader header{};
+		std::memcpy(header.magic, g_MeshCacheMagic, sizeof(g_MeshCacheMagic));
+		header.version = g_MeshCacheVersion;
+		header.sourceHash = sourceHash;
+		header.settingsKey = settingsKey;
+		header.vertexStride = sizeof(Vertex);
+		header.vertexCount = static_cast<uint32_t>(vertices.size());
+		header.indexCount = static_cast<uint32_t>(indexCount);
+		header.indexSize = indexSize;
+		header.sectionCount = static_cast<uint32_t>(sections.size());
+		header.lodCount = static_cast<uint32_t>(lods.size());
+		header.meshletCount = static_cast<uint32_t>(meshlets.size());
+		header.vertexOffset = AlignUp(sizeof(MeshCacheHeader));
+		header.indexOffset = AlignUp(header.vertexOffset + vertices.size() * sizeof(Vertex));
+		header.sectionOffset = AlignUp(header.indexOffset + indexCount * indexSize);
+		header.lodOffset = AlignUp(header.sectionOffset + sections.size() * sizeof(MeshSection));
+		header.meshletOffset = AlignUp(header.lodOffset + lods.size() * sizeof(MeshLod));
+		header.bounds = bounds;
+
+		//The payload is assembled in memory first, its hash goes in the header in front of it
+		std::string payload(header.meshletOffset + meshlets.size() * sizeof(Meshlet) - sizeof(MeshCacheHeader), '\0');
+		const auto copy = [&payload](uint64_t offset, const void* pSource, size_t size)
+			{
+				if (size > 0)
+					std::memcpy(payload.data() + (offset - sizeof(MeshCacheHeader)), pSource, size);
+			};
+		copy(header.vertexOffset, vertices.data(), vertices.size() * sizeof(Vertex));
+		copy(header.indexOffset, IndexArrays::GetData(indices), indexCount * indexSize);
+		copy(header.sectionOffset, sections.data(), sections.size() * sizeof(MeshSection));
+		copy(header.lodOffset, lods.data(), lods.size() * sizeof(MeshLod));
+		copy(header.meshletOffset, meshlets.data(), meshlets.size() * sizeof(Meshlet));
+		header.payloadHash = HashContent(payload);
+
+		//Write next to the destination and swap it in, so a crash never leaves a half written cache behind
+		const std::string tempFile{ cacheFile + ".tmp" };
+		{
+			std::ofstream file(tempFile, std::ios::binary | std::ios::trunc);
+			if (!file)
+				return false;
+
+			file.write(reinterpret_cast<const char*>(&header), sizeof(MeshCacheHeader));
+			file.write(payload.data(), payload.size());
+
+			if (!file)
+				return false;
+		}
+
+		std::error_code error{};
+		std::filesystem::rename(tempFile, cacheFile, error);
+		if (error)
+		{
+			std::filesystem::remove(tempFile, error);
+			return false;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include "DataTypes.h"
+#include "IndexArray.h"
+#include "MappedFile.h"
+#include "Meshlet.h"
+
+namespace dae
+{
+	//Binary copy of a parsed mesh, stored next to its source file and memory-mapped on later loads.
+	//The vertex and index arrays are laid out exactly like the GPU buffers, so they can be uploaded straight from the mapping.
+	//The indices are already in meshlet order, and the meshlets keep their bounds and normal cones for culling.
+	class MeshCache final
+	{
+	public:
+		MeshCache() = default;
+		~MeshCache() = default;
+
+		MeshCache(const MeshCache& other) = delete;
+		MeshCache& operator=(const MeshCache& other) = delete;
+		MeshCache(MeshCache&& other) = default;
+		MeshCache& operator=(MeshCache&& other) = default;
+
+		//Fails when the file is missing, from another version, or was built from different source content or settings.
+		//Also when the payload does not match its hash, or a section, LOD or meshlet reaches past the vertex or index array.
+		bool Load(const std::string& cacheFile, uint64_t sourceHash, uint32_t settingsKey);
+		static bool Write(const std::string& cacheFile, uint64_t sourceHash, uint32_t settingsKey,
+			const std::vector<Vertex>& vertices, const IndexArray& indices, const std::vector<MeshSection>& sections, const std::vector<MeshLod>& lods,
+			const std::vector<Meshlet>& meshlets, const BoundingBox& bounds);
+
+		static std::string GetCachePath(const std::string& sourceFile) { return sourceFile + ".meshcache"; }
+		static uint64_t HashContent(std::string_view content);
+
+		inline const Vertex* GetVertices() const { return m_pVertices; }
+		inline uint32_t GetVertexCount() const { return m_VertexCount; }
+		inline const void* GetIndices() const { return m_pIndices; }
+		inline uint32_t GetIndexCount() const { return m_IndexCount; }
+		inline uint32_t GetIndexSize() const { return m_IndexSize; }
+		inline const MeshSection* GetSections() const { return m_pSections; }
+		inline uint32_t GetSectionCount() const { return m_SectionCount; }
+		inline const MeshLod* GetLods() const { return m_pLods; }
+		inline uint32_t GetLodCount() const { return m_LodCount; }
+		inline const Meshlet* GetMeshlets() const { return m_pMeshlets; }
+		inline uint32_t GetMeshletCount() const { return m_MeshletCount; }
+		inline const BoundingBox& GetBounds() const { return m_Bounds; }
+
+	private:
+		MappedFile m_File{};
+
+		const Vertex* m_pVertices{ nullptr };
+		const void* m_pIndices{ nullptr };
+		const MeshSection* m_pSections{ nullptr };
+		const MeshLod* m_pLods{ nullptr };
+		const Meshlet* m_pMeshlets{ nullptr };
+		uint32_t m_VertexCount{};
+		uint32_t m_IndexCount{};
+		uint32_t m_IndexSize{};
+		uint32_t m_SectionCount{};
+		uint32_t m_LodCount{};
+		uint32_t m_MeshletCount{};
+		BoundingBox m_Bounds{};
+	};
+}
@@ -0,0 +1,504 @@
+#include "pch.h"
+#include "MeshOptimizer.h"
+#include "DataTypes.h"
+#include <tuple>
+
+namespace dae
+{
+	namespace MeshOptimizer
+	{
+		namespace
+		{
+			//Tuning from Forsyth's article. The modelled LRU cache is larger than the FIFO one being measured, which works well in practice.
+			constexpr uint32_t g_ModelledCacheSize{ 32 };
+			constexpr float g_CacheDecayPower{ 1.5f };
+			constexpr float g_LastTriangleScore{ 0.75f };
+			constexpr float g_ValenceBoostScale{ 2.f };
+			constexpr float g_ValenceBoostPower{ 0.5f };
+			constexpr uint32_t g_MaxScoredValence{ 64 };
+
+			struct ScoreTables
+			{
+				float cache[g_ModelledCacheSize]{};
+				float valence[g_MaxScoredValence]{};
+
+				ScoreTables()
+				{
+					for (uint32_t i{ 0 }; i < g_ModelledCacheSize; ++i)
+					{
+						//The three most recent vertices belong to the last triangle, using them again is good but not as good as it looks
+						if (i < 3)
+						{
+							cache[i] = g_LastTriangleScore;
+							continue;
+						}
+
+						const float scaler{ 1.f / (g_ModelledCacheSize - 3) };
+						cache[i] = powf(1.f - (i - 3) * scaler, g_CacheDecayPower);
+					}
+
+					//Vertices with few triangles left get a boost, so they are finished instead of lingering
+					for (uint32_t i{ 1 }; i < g_MaxScoredValence; ++i)
+						valence[i] = g_ValenceBoostScale * powf(static_cast<float>(i), -g_ValenceBoostPower);
+				}
+
+				float GetVertexScore(int32_t cachePosition, uint32_t remainingTriangles) const
+				{
+					if (remainingTriangles == 0)
+						return -1.f;
+
+					const float cacheScore{ cachePosition < 0 ? 0.f : cache[cachePosition] };
+					return cacheScore + valence[std::min(remainingTriangles, g_MaxScoredValence - 1)];
+				}
+			};
+
+			struct Cluster
+			{
+				size_t firstTriangle{};
+				size_t triangleCount{};
+				float sortKey{};
+			};
+
+			//Number of cache misses of every triangle in the current order, with a FIFO cache that is reset at every cluster start
+			uint32_t CountTriangleMisses(const uint32_t* pTriangle, std::vector<uint32_t>& pushTimes, uint32_t& pushCount)
+			{
+				uint32_t misses{ 0 };
+				for (int iCorner{ 0 }; iCorner < 3; ++iCorner)
+				{
+					const uint32_t index{ pTriangle[iCorner] };
+					if (pushTimes[index] == 0 || pushCount - pushTimes[index] >= SimulatedCacheSize)
+					{
+						pushTimes[index] = ++pushCount;
+						++misses;
+					}
+				}
+
+				return misses;
+			}
+
+			//Triangles whose three vertices all miss start a hard cluster, keeping them together costs no cache reuse
+			std::vector<size_t> FindHardBoundaries(const uint32_t* pIndices, size_t triangleCount, size_t vertexCount)
+			{
+				std::vector<size_t> boundaries{};
+				std::vector<uint32_t> pushTimes(vertexCount, 0);
+				uint32_t pushCount{ 0 };
+
+				for (size_t i{ 0 }; i < triangleCount; ++i)
+				{
+					if (CountTriangleMisses(pIndices + i * 3, pushTimes, pushCount) == 3)
+						boundaries.push_back(i);
+				}
+
+				boundaries.push_back(triangleCount);
+				return boundaries;
+			}
+
+			//Splits every hard cluster again wherever the part so far has an ACMR within threshold of the whole cluster's
+			std::vector<Cluster> FindClusters(const uint32_t* pIndices, size_t triangleCount, size_t vertexCount, float threshold)
+			{
+				const std::vector<size_t> hardBoundaries{ FindHardBoundaries(pIndices, triangleCount, vertexCount) };
+
+				std::vector<Cluster> clusters{};
+
+				//Pushes far enough apart are misses again, so the cache is reset by moving the counter instead of clearing the times
+				std::vector<uint32_t> pushTimes(vertexCount, 0);
+				uint32_t pushCount{ 0 };
+
+				for (size_t iHard{ 0 }; iHard + 1 < hardBoundaries.size(); ++iHard)
+				{
+					const size_t start{ hardBoundaries[iHard] };
+					const size_t end{ hardBoundaries[iHard + 1] };
+
+					pushCount += SimulatedCacheSize;
+
+					size_t hardMisses{ 0 };
+					for (size_t i{ start }; i < end; ++i)
+						hardMisses += CountTriangleMisses(pIndices + i * 3, pushTimes, pushCount);
+
+					const float targetACMR{ threshold * static_cast<float>(hardMisses) / static_cast<float>(end - start) };
+					pushCount += SimulatedCacheSize;
+
+					size_t clusterStart{ start };
+					size_t clusterMisses{ 0 };
+					for (size_t i{ start }; i < end; ++i)
+					{
+						clusterMisses += CountTriangleMisses(pIndices + i * 3, pushTimes, pushCount);
+
+						const size_t clusterSize{ i + 1 - clusterStart };
+						if (i + 1 < end && static_cast<float>(clusterMisses) / static_cast<float>(clusterSize) <= targetACMR)
+						{
+							clusters.push_back({ clusterStart, clusterSize });
+							clusterStart = i + 1;
+							clusterMisses = 0;
+							pushCount += SimulatedCacheSize;
+						}
+					}
+
+					clusters.push_back({ clusterStart, end - clusterStart });
+				}
+
+				return clusters;
+			}
+
+			//Occlusion potential of Sander et al.: how far the cluster lies out from the mesh centre along its own normal.
+			//Clusters on the outside facing away from the centre are in front for most of the directions they are seen from.
+			void CalculateSortKeys(std::vector<Cluster>& clusters, const uint32_t* pIndices, const Vertex* pVertices)
+			{
+				Vector3 meshCentroid{};
+				float meshArea{ 0.f };
+
+				std::vector<Vector3> clusterCentroids(clusters.size());
+				std::vector<Vector3> clusterNormals(clusters.size());
+
+				for (size_t iCluster{ 0 }; iCluster < clusters.size(); ++iCluster)
+				{
+					const Cluster& cluster{ clusters[iCluster] };
+
+					Vector3 centroid{};
+					Vector3 normal{};
+					float area{ 0.f };
+
+					for (size_t i{ cluster.firstTriangle }; i < cluster.firstTriangle + cluster.triangleCount; ++i)
+					{
+						const Vertex& v0{ pVertices[pIndices[i * 3]] };
+						const Vertex& v1{ pVertices[pIndices[i * 3 + 1]] };
+						const Vertex& v2{ pVertices[pIndices[i * 3 + 2]] };
+
+						//Orient the face normal with the vertex normals, the winding depends on the loader settings
+						Vector3 faceNormal{ Vector3::Cross(v1.position - v0.position, v2.position - v0.position) };
+						if (Vector3::Dot(faceNormal, v0.normal + v1.normal + v2.normal) < 0.f)
+							faceNormal = -faceNormal;
+
+						const float faceArea{ faceNormal.Magnitude() * 0.5f };
+						centroid += (v0.position + v1.position + v2.position) * (faceArea / 3.f);
+						normal += faceNormal;
+						area += faceArea;
+					}
+
+					meshCentroid += centroid;
+					meshArea += area;
+
+					clusterCentroids[iCluster] = area > 0.f ? centroid * (1.f / area) : pVertices[pIndices[cluster.firstTriangle * 3]].position;
+					clusterNormals[iCluster] = normal.SqrMagnitude() > 0.f ? normal.Normalized() : Vector3::Zero;
+				}
+
+				if (meshArea > 0.f)
+					meshCentroid = meshCentroid * (1.f / meshArea);
+
+				for (size_t iCluster{ 0 }; iCluster < clusters.size(); ++iCluster)
+					clusters[iCluster].sortKey = Vector3::Dot(clusterCentroids[iCluster] - meshCentroid, clusterNormals[iCluster]);
+			}
+
+			//Directions spread evenly over the sphere with a Fibonacci spiral
+			Vector3 GetViewDirection(uint32_t view, uint32_t viewCount)
+			{
+				const float goldenAngle{ PI * (3.f - sqrtf(5.f)) };
+				const float y{ 1.f - 2.f * (view + 0.5f) / viewCount };
+				const float radius{ sqrtf(std::max(0.f, 1.f - y * y)) };
+				const float angle{ goldenAngle * view };
+
+				return { cosf(angle) * radius, y, sinf(angle) * radius };
+			}
+		}
+
+		VertexCacheStatistics AnalyzeVertexCache(const uint32_t* pIndices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+		{
+			VertexCacheStatistics statistics{};
+			if (indexCount < 3 || vertexCount == 0)
+				return statistics;
+
+			//FIFO: a vertex is in the cache when it was pushed less than cacheSize pushes ago
+			std::vector<uint32_t> pushTimes(vertexCount, 0);
+			std::vector<bool> isReferenced(vertexCount, false);
+			uint32_t pushCount{ 0 };
+			size_t referencedCount{ 0 };
+
+			for (size_t i{ 0 }; i < indexCount; ++i)
+			{
+				const uint32_t index{ pIndices[i] };
+				if (pushTimes[index] == 0 || pushCount - pushTimes[index] >= cacheSize)
+				{
+					++pushCount;
+					pushTimes[index] = pushCount;
+					++statistics.transformedVertexCount;
+				}
+
+				if (!isReferenced[index])
+				{
+					isReferenced[index] = true;
+					++referencedCount;
+				}
+			}
+
+			statistics.ACMR = static_cast<float>(statistics.transformedVertexCount) / static_cast<float>(indexCount / 3);
+			statistics.ATVR = static_cast<float>(statistics.transformedVertexCount) / static_cast<float>(referencedCount);
+			return statistics;
+		}
+
+		void OptimizeVertexCache(uint32_t* pIndices, size_t indexCount, size_t vertexCount)
+		{
+			const size_t triangleCount{ indexCount / 3 };
+			if (triangleCount < 2)
+				return;
+
+			static const ScoreTables scoreTables{};
+
+			//Triangles of every vertex, the first remainingTriangles of its list are not emitted yet
+			std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+			for (size_t i{ 0 }; i < triangleCount * 3; ++i)
+				++remainingTriangles[pIndices[i]];
+
+			std::vector<uint32_t> firstTriangles(vertexCount + 1, 0);
+			for (size_t i{ 0 }; i < vertexCount; ++i)
+				firstTriangles[i + 1] = firstTriangles[i] + remainingTriangles[i];
+
+			std::vector<uint32_t> vertexTriangles(triangleCount * 3);
+			{
+				std::vector<uint32_t> nextTriangles(firstTriangles.begin(), firstTriangles.end() - 1);
+				for (size_t i{ 0 }; i < triangleCount * 3; ++i)
+					vertexTriangles[nextTriangles[pIndices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+
+			std::vector<float> vertexScores(vertexCount);
+			for (size_t i{ 0 }; i < vertexCount; ++i)
+				vertexScores[i] = scoreTables.GetVertexScore(-1, remainingTriangles[i]);
+
+			std::vector<float> triangleScores(triangleCount);
+			for (size_t i{ 0 }; i < triangleCount; ++i)
+				triangleScores[i] = vertexScores[pIndices[i * 3]] + vertexScores[pIndices[i * 3 + 1]] + vertexScores[pIndices[i * 3 + 2]];
+
+			std::vector<bool> isEmitted(triangleCount, false);
+			std::vector<uint32_t> optimizedIndices(triangleCount * 3);
+
+			//Room for the modelled cache plus the three vertices pushed in front of it
+			uint32_t cache[g_ModelledCacheSize + 3];
+			uint32_t cacheCount{ 0 };
+			uint32_t newCache[g_ModelledCacheSize + 3];
+
+			size_t nextInputTriangle{ 0 };
+			uint32_t bestTriangle{ UINT32_MAX };
+
+			for (size_t iOutput{ 0 }; iOutput < triangleCount; ++iOutput)
+			{
+				//Nothing in the cache touches a triangle that is left, continue with the next one in input order
+				if (bestTriangle == UINT32_MAX)
+				{
+					while (isEmitted[nextInputTriangle])
+						++nextInputTriangle;
+
+					bestTriangle = static_cast<uint32_t>(nextInputTriangle);
+				}
+
+				const uint32_t* pTriangle{ pIndices + size_t(bestTriangle) * 3 };
+				std::copy(pTriangle, pTriangle + 3, optimizedIndices.begin() + iOutput * 3);
+				isEmitted[bestTriangle] = true;
+
+				//Remove the triangle from its vertices' lists
+				for (int iCorner{ 0 }; iCorner < 3; ++iCorner)
+				{
+					const uint32_t vertex{ pTriangle[iCorner] };
+					uint32_t* pFirst{ vertexTriangles.data() + firstTriangles[vertex] };
+					uint32_t* pLast{ pFirst + remainingTriangles[vertex] - 1 };
+
+					std::iter_swap(std::find(pFirst, pLast + 1, bestTriangle), pLast);
+					--remainingTriangles[vertex];
+				}
+
+				//The triangle's vertices move to the front of the LRU cache, everything else shifts back
+				uint32_t newCacheCount{ 0 };
+				for (int iCorner{ 0 }; iCorner < 3; ++iCorner)
+					newCache[newCacheCount++] = pTriangle[iCorner];
+
+				for (uint32_t i{ 0 }; i < cacheCount; ++i)
+				{
+					const uint32_t vertex{ cache[i] };
+					if (vertex != pTriangle[0] && vertex != pTriangle[1] && vertex != pTriangle[2])
+						newCache[newCacheCount++] = vertex;
+				}
+
+				//Update the scores of everything that was in either cache, and pick the best triangle among their neighbours
+				bestTriangle = UINT32_MAX;
+				float bestScore{ -1.f };
+
+				for (uint32_t i{ 0 }; i < newCacheCount; ++i)
+				{
+					const uint32_t vertex{ newCache[i] };
+					const int32_t cachePosition{ i < g_ModelledCacheSize ? static_cast<int32_t>(i) : -1 };
+
+					const float score{ scoreTables.GetVertexScore(cachePosition, remainingTriangles[vertex]) };
+					const float scoreChange{ score - vertexScores[vertex] };
+					vertexScores[vertex] = score;
+
+					for (uint32_t j{ firstTriangles[vertex] }; j < firstTriangles[vertex] + remainingTriangles[vertex]; ++j)
+					{
+						const uint32_t triangle{ vertexTriangles[j] };
+						triangleScores[triangle] += scoreChange;
+
+						if (triangleScores[triangle] > bestScore)
+						{
+							bestScore = triangleScores[triangle];
+							bestTriangle = triangle;
+						}
+					}
+				}
+
+				cacheCount = std::min(newCacheCount, g_ModelledCacheSize);
+				std::copy(newCache, newCache + cacheCount, cache);
+			}
+
+			std::copy(optimizedIndices.begin(), optimizedIndices.end(), pIndices);
+		}
+
+		void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+		{
+			std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+			std::vector<Vertex> orderedVertices{};
+			orderedVertices.reserve(vertices.size());
+
+			for (uint32_t& index : indices)
+			{
+				if (remap[index] == UINT32_MAX)
+				{
+					remap[index] = static_cast<uint32_t>(orderedVertices.size());
+					orderedVertices.push_back(vertices[index]);
+				}
+
+				index = remap[index];
+			}
+
+			vertices = std::move(orderedVertices);
+		}
+
+		void OptimizeOverdraw(uint32_t* pIndices, size_t indexCount, const Vertex* pVertices, size_t vertexCount, float threshold)
+		{
+			const size_t triangleCount{ indexCount / 3 };
+			if (triangleCount < 2)
+				return;
+
+			std::vector<Cluster> clusters{ FindClusters(pIndices, triangleCount, vertexCount, threshold) };
+			CalculateSortKeys(clusters, pIndices, pVertices);
+
+			//Stable, so equal keys keep their cache friendly order
+			std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b)
+				{
+					return a.sortKey > b.sortKey;
+				});
+
+			std::vector<uint32_t> sortedIndices{};
+			sortedIndices.reserve(triangleCount * 3);
+			for (const Cluster& cluster : clusters)
+				sortedIndices.insert(sortedIndices.end(), pIndices + cluster.firstTriangle * 3, pIndices + (cluster.firstTriangle + cluster.triangleCount) * 3);
+
+			std::copy(sortedIndices.begin(), sortedIndices.end(), pIndices);
+		}
+
+		OverdrawStatistics AnalyzeOverdraw(const uint32_t* pIndices, size_t indexCount, const Vertex* pVertices, size_t vertexCount, uint32_t viewCount, uint32_t resolution)
+		{
+			OverdrawStatistics statistics{};
+			if (indexCount < 3 || vertexCount == 0 || viewCount == 0 || resolution == 0)
+				return statistics;
+
+			const BoundingBox bounds{ BoundingBox::FromVertices(pVertices, vertexCount) };
+			const Vector3 center{ (bounds.min + bounds.max) * 0.5f };
+			const float radius{ std::max((bounds.max - bounds.min).Magnitude() * 0.5f, FLT_MIN) };
+
+			std::vector<float> depthBuffer(size_t(resolution) * resolution);
+			std::vector<Vector3> projected(vertexCount);
+
+			for (uint32_t view{ 0 }; view < viewCount; ++view)
+			{
+				//Orthographic camera looking along forward, the bounding sphere fills the viewport
+				const Vector3 forward{ GetViewDirection(view, viewCount) };
+				const Vector3 right{ Vector3::Cross(std::abs(forward.y) < 0.99f ? Vector3::UnitY : Vector3::UnitX, forward).Normalized() };
+				const Vector3 up{ Vector3::Cross(forward, right) };
+				const float scale{ resolution * 0.5f / radius };
+
+				for (size_t i{ 0 }; i < vertexCount; ++i)
+				{
+					const Vector3 offset{ pVertices[i].position - center };
+					projected[i] = { (Vector3::Dot(offset, right) + radius) * scale, (radius - Vector3::Dot(offset, up)) * scale, Vector3::Dot(offset, forward) };
+				}
+
+				std::fill(depthBuffer.begin(), depthBuffer.end(), FLT_MAX);
+
+				for (size_t iIndex{ 0 }; iIndex + 2 < indexCount; iIndex += 3)
+				{
+					const Vector3& v0{ projected[pIndices[iIndex]] };
+					Vector3 v1{ projected[pIndices[iIndex + 1]] };
+					Vector3 v2{ projected[pIndices[iIndex + 2]] };
+
+					float area{ (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x) };
+					if (area == 0.f)
+						continue;
+
+					//No culling, so bring both windings to the same orientation
+					if (area < 0.f)
+					{
+						std::swap(v1, v2);
+						area = -area;
+					}
+
+					const int minX{ std::max(0, static_cast<int>(std::min({ v0.x, v1.x, v2.x }))) };
+					const int maxX{ std::min(static_cast<int>(resolution) - 1, static_cast<int>(std::max({ v0.x, v1.x, v2.x }))) };
+					const int minY{ std::max(0, static_cast<int>(std::min({ v0.y, v1.y, v2.y }))) };
+					const int maxY{ std::min(static_cast<int>(resolution) - 1, static_cast<int>(std::max({ v0.y, v1.y, v2.y }))) };
+
+					for (int y{ minY }; y <= maxY; ++y)
+					{
+						for (int x{ minX }; x <= maxX; ++x)
+						{
+							const float px{ x + 0.5f };
+							const float py{ y + 0.5f };
+
+							const float w0{ (v2.x - v1.x) * (py - v1.y) - (v2.y - v1.y) * (px - v1.x) };
+							const float w1{ (v0.x - v2.x) * (py - v2.y) - (v0.y - v2.y) * (px - v2.x) };
+							const float w2{ (v1.x - v0.x) * (py - v0.y) - (v1.y - v0.y) * (px - v0.x) };
+							if (w0 < 0.f || w1 < 0.f || w2 < 0.f)
+								continue;
+
+							const float depth{ (w0 * v0.z + w1 * v1.z + w2 * v2.z) / area };
+							float& storedDepth{ depthBuffer[size_t(y) * resolution + x] };
+							if (depth < storedDepth)
+							{
+								if (storedDepth == FLT_MAX)
+									++statistics.coveredPixelCount;
+
+								storedDepth = depth;
+								++statistics.shadedPixelCount;
+							}
+						}
+					}
+				}
+			}
+
+			statistics.overdraw = statistics.coveredPixelCount > 0 ? static_cast<float>(statistics.shadedPixelCount) / static_cast<float>(statistics.coveredPixelCount) : 0.f;
+			return statistics;
+		}
+
+		std::vector<uint32_t> GeneratePositionRemap(const Vertex* pVertices, size_t vertexCount)
+		{
+			std::vector<uint32_t> sortedVertices(vertexCount);
+			for (uint32_t i{ 0 }; i < vertexCount; ++i)
+				sortedVertices[i] = i;
+
+			auto isLess = [pVertices](uint32_t a, uint32_t b)
+				{
+					const Vector3& pa{ pVertices[a].position };
+					const Vector3& pb{ pVertices[b].position };
+					return std::tie(pa.x, pa.y, pa.z) < std::tie(pb.x, pb.y, pb.z);
+				};
+
+			//Stable, so every run of equal positions starts with its lowest vertex index
+			std::stable_sort(sortedVertices.begin(), sortedVertices.end(), isLess);
+
+			std::vector<uint32_t> remap(vertexCount);
+			for (size_t i{ 0 }; i < vertexCount; ++i)
+			{
+				const bool isNewPosition{ i == 0 || isLess(sortedVertices[i - 1], sortedVertices[i]) };
+				remap[sortedVertices[i]] = isNewPosition ? sortedVertices[i] : remap[sortedVertices[i - 1]];
+			}
+
+			return remap;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+struct Vertex;
+
+namespace dae
+{
+	namespace MeshOptimizer
+	{
+		//Size of the FIFO post-transform cache the metrics simulate, a common size on current GPUs
+		constexpr uint32_t SimulatedCacheSize{ 16 };
+
+		struct VertexCacheStatistics
+		{
+			uint32_t transformedVertexCount{};	//Vertex shader invocations
+			float ACMR{};	//Average cache miss ratio, transformed vertices per triangle. 0.5 is ideal on a regular grid, 3 means no reuse at all.
+			float ATVR{};	//Average transformed vertex ratio, transformed vertices per referenced vertex. 1 is ideal.
+		};
+
+		struct OverdrawStatistics
+		{
+			uint64_t coveredPixelCount{};
+			uint64_t shadedPixelCount{};	//Fragments that passed the depth test, so ran the pixel shader
+			float overdraw{};	//Shaded samples per covered pixel, 1 is ideal
+		};
+
+		//Simulates a FIFO post-transform cache of cacheSize entries over the index buffer
+		VertexCacheStatistics AnalyzeVertexCache(const uint32_t* pIndices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = SimulatedCacheSize);
+
+		//Reorders the triangles for post-transform cache reuse, using Tom Forsyth's linear-speed vertex cache optimisation.
+		//The triangles themselves, and their winding, are not changed.
+		void OptimizeVertexCache(uint32_t* pIndices, size_t indexCount, size_t vertexCount);
+
+		//Splits the (vertex cache optimized) triangle order into clusters and sorts them so the ones most likely to occlude the rest
+		//come first, which is front-to-back for most view directions. Clusters only end where the cache would mostly miss anyway,
+		//or where the ACMR stays within threshold times that of the unsplit order, so most of the cache gains are kept.
+		void OptimizeOverdraw(uint32_t* pIndices, size_t indexCount, const Vertex* pVertices, size_t vertexCount, float threshold = 1.05f);
+
+		//Rasterizes the mesh orthographically from viewCount directions spread over the sphere, with a depth test in draw order and no culling
+		//like the rasterizer state of PosCol3D.fx, and counts how often every covered pixel is shaded.
+		OverdrawStatistics AnalyzeOverdraw(const uint32_t* pIndices, size_t indexCount, const Vertex* pVertices, size_t vertexCount, uint32_t viewCount = 16, uint32_t resolution = 256);
+
+		//Reorders the vertices in the order the index buffer first uses them, so vertex fetches walk memory forward.
+		//Unreferenced vertices are dropped and the indices are remapped.
+		void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+		//Maps every vertex to the first vertex with the same position. Uv and normal seams split vertices,
+		//so mesh topology should compare these rather than the vertex indices.
+		std::vector<uint32_t> GeneratePositionRemap(const Vertex* pVertices, size_t vertexCount);
+	}
+}
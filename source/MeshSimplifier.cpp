@@ -0,0 +1,422 @@
+#include "pch.h"
+#include "MeshSimplifier.h"
+#include "DataTypes.h"
+#include "MeshOptimizer.h"
+#include <cfloat>
+#include <utility>
+
+namespace dae
+{
+	namespace MeshSimplifier
+	{
+		namespace
+		{
+			//Border planes count this much more than the faces, so outlines hold while the inside simplifies
+			constexpr double g_BorderWeight{ 10.0 };
+
+			//A level has to drop at least this share of the triangles of the previous one to be worth its index memory
+			constexpr float g_MinLodReduction{ 0.2f };
+
+			enum class VertexKind : uint8_t
+			{
+				Manifold,	//Collapses in any direction
+				Border,		//Only collapses along an open edge
+				Locked		//Non-manifold, or on a border and a seam at once
+			};
+
+			//Sum of squared distances to a set of planes, symmetric so 10 coefficients hold the 4x4 matrix
+			struct Quadric
+			{
+				double a2{}, b2{}, c2{}, ab{}, ac{}, bc{}, ad{}, bd{}, cd{}, d2{};
+				double weight{};
+
+				void AddPlane(const Vector3& normal, float distance, double planeWeight)
+				{
+					const double a{ normal.x }, b{ normal.y }, c{ normal.z }, d{ distance };
+					a2 += a * a * planeWeight;
+					b2 += b * b * planeWeight;
+					c2 += c * c * planeWeight;
+					ab += a * b * planeWeight;
+					ac += a * c * planeWeight;
+					bc += b * c * planeWeight;
+					ad += a * d * planeWeight;
+					bd += b * d * planeWeight;
+					cd += c * d * planeWeight;
+					d2 += d * d * planeWeight;
+					weight += planeWeight;
+				}
+
+				Quadric& operator+=(const Quadric& other)
+				{
+					a2 += other.a2; b2 += other.b2; c2 += other.c2;
+					ab += other.ab; ac += other.ac; bc += other.bc;
+					ad += other.ad; bd += other.bd; cd += other.cd;
+					d2 += other.d2;
+					weight += other.weight;
+					return *this;
+				}
+
+				//Weighted mean of the squared plane distances
+				double Evaluate(const Vector3& point) const
+				{
+					const double x{ point.x }, y{ point.y }, z{ point.z };
+					const double error{ a2 * x * x + b2 * y * y + c2 * z * z
+						+ 2.0 * (ab * x * y + ac * x * z + bc * y * z)
+						+ 2.0 * (ad * x + bd * y + cd * z)
+						+ d2 };
+
+					return weight > 0.0 ? std::max(error, 0.0) / weight : 0.0;
+				}
+			};
+
+			struct Collapse
+			{
+				uint32_t position{};	//Position ids, see MeshOptimizer::GeneratePositionRemap
+				uint32_t target{};
+				double error{};
+			};
+
+			//Triangles around every position id, in compressed rows
+			struct Adjacency
+			{
+				std::vector<uint32_t> offsets{};
+				std::vector<uint32_t> triangles{};
+
+				void Build(const std::vector<uint32_t>& indices, const std::vector<uint32_t>& positionIds)
+				{
+					offsets.assign(positionIds.size() + 1, 0);
+					for (const uint32_t index : indices)
+						++offsets[positionIds[index] + 1];
+
+					for (size_t i{ 0 }; i + 1 < offsets.size(); ++i)
+						offsets[i + 1] += offsets[i];
+
+					triangles.resize(indices.size());
+					std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+					for (size_t i{ 0 }; i < indices.size(); ++i)
+						triangles[cursors[positionIds[indices[i]]]++] = static_cast<uint32_t>(i / 3);
+				}
+
+				//Triangles that have both positions as corners
+				uint32_t CountEdgeTriangles(const std::vector<uint32_t>& indices, const std::vector<uint32_t>& positionIds, uint32_t position, uint32_t other) const
+				{
+					uint32_t count{ 0 };
+					for (uint32_t i{ offsets[position] }; i < offsets[position + 1]; ++i)
+					{
+						const uint32_t* pTriangle{ indices.data() + triangles[i] * 3 };
+						if (positionIds[pTriangle[0]] == other || positionIds[pTriangle[1]] == other || positionIds[pTriangle[2]] == other)
+							++count;
+					}
+
+					return count;
+				}
+			};
+
+			Vector3 GetTriangleNormal(const Vector3& p0, const Vector3& p1, const Vector3& p2)
+			{
+				return Vector3::Cross(p1 - p0, p2 - p0);
+			}
+		}
+
+		size_t Simplify(uint32_t* pDestination, const uint32_t* pIndices, size_t indexCount, const Vertex* pVertices, size_t vertexCount,
+			size_t targetIndexCount, float* pError)
+		{
+			std::vector<uint32_t> indices(pIndices, pIndices + indexCount - indexCount % 3);
+			const std::vector<uint32_t> positionIds{ MeshOptimizer::GeneratePositionRemap(pVertices, vertexCount) };
+
+			Adjacency adjacency{};
+			adjacency.Build(indices, positionIds);
+
+			//Seams: positions with more than one vertex, every one of them a wedge with its own attributes
+			std::vector<uint32_t> wedgeCounts(vertexCount, 0);
+			{
+				std::vector<bool> isCounted(vertexCount, false);
+				for (const uint32_t index : indices)
+				{
+					if (!isCounted[index])
+					{
+						isCounted[index] = true;
+						++wedgeCounts[positionIds[index]];
+					}
+				}
+			}
+
+			std::vector<Quadric> quadrics(vertexCount);
+			std::vector<VertexKind> kinds(vertexCount, VertexKind::Manifold);
+
+			for (size_t iTriangle{ 0 }; iTriangle < indices.size() / 3; ++iTriangle)
+			{
+				const uint32_t* pTriangle{ indices.data() + iTriangle * 3 };
+				const Vector3& p0{ pVertices[pTriangle[0]].position };
+				const Vector3& p1{ pVertices[pTriangle[1]].position };
+				const Vector3& p2{ pVertices[pTriangle[2]].position };
+
+				Vector3 normal{ GetTriangleNormal(p0, p1, p2) };
+				const float area{ normal.Normalize() * 0.5f };
+				if (area <= 0.f)
+					continue;
+
+				const float distance{ -Vector3::Dot(normal, p0) };
+				for (uint32_t corner{ 0 }; corner < 3; ++corner)
+					quadrics[positionIds[pTriangle[corner]]].AddPlane(normal, distance, area);
+
+				for (uint32_t corner{ 0 }; corner < 3; ++corner)
+				{
+					const uint32_t position{ positionIds[pTriangle[corner]] };
+					const uint32_t next{ positionIds[pTriangle[(corner + 1) % 3]] };
+					const uint32_t edgeTriangleCount{ adjacency.CountEdgeTriangles(indices, positionIds, position, next) };
+
+					if (edgeTriangleCount > 2)
+					{
+						kinds[position] = VertexKind::Locked;
+						kinds[next] = VertexKind::Locked;
+					}
+					else if (edgeTriangleCount == 1)
+					{
+						//Open edge, a plane through it perpendicular to the face keeps the outline in place
+						const Vector3& edgeStart{ pVertices[position].position };
+						Vector3 edge{ pVertices[next].position - edgeStart };
+						Vector3 borderNormal{ Vector3::Cross(edge, normal) };
+						if (borderNormal.Normalize() > 0.f)
+						{
+							const double borderWeight{ static_cast<double>(edge.SqrMagnitude()) * g_BorderWeight };
+							quadrics[position].AddPlane(borderNormal, -Vector3::Dot(borderNormal, edgeStart), borderWeight);
+							quadrics[next].AddPlane(borderNormal, -Vector3::Dot(borderNormal, edgeStart), borderWeight);
+						}
+
+						for (const uint32_t borderPosition : { position, next })
+						{
+							if (kinds[borderPosition] == VertexKind::Manifold)
+								kinds[borderPosition] = VertexKind::Border;
+						}
+					}
+				}
+			}
+
+			for (size_t position{ 0 }; position < vertexCount; ++position)
+			{
+				if (kinds[position] == VertexKind::Border && wedgeCounts[position] > 1)
+					kinds[position] = VertexKind::Locked;
+			}
+
+			const size_t targetTriangleCount{ targetIndexCount / 3 };
+			size_t triangleCount{ indices.size() / 3 };
+			double maxError{ 0.0 };
+
+			std::vector<uint32_t> remap(vertexCount);
+			std::vector<bool> isLocked(vertexCount);
+			std::vector<Collapse> bestCollapses(vertexCount);
+			std::vector<Collapse> collapses{};
+
+			//Every pass picks the cheapest collapse of every position, then applies as many of them as it can without two touching
+			while (triangleCount > targetTriangleCount)
+			{
+				for (size_t i{ 0 }; i < vertexCount; ++i)
+				{
+					remap[i] = static_cast<uint32_t>(i);
+					bestCollapses[i] = { static_cast<uint32_t>(i), UINT32_MAX, DBL_MAX };
+				}
+
+				std::fill(isLocked.begin(), isLocked.end(), false);
+
+				for (size_t iTriangle{ 0 }; iTriangle < triangleCount; ++iTriangle)
+				{
+					const uint32_t* pTriangle{ indices.data() + iTriangle * 3 };
+					for (uint32_t corner{ 0 }; corner < 3; ++corner)
+					{
+						const uint32_t a{ positionIds[pTriangle[corner]] };
+						const uint32_t b{ positionIds[pTriangle[(corner + 1) % 3]] };
+
+						for (const auto& [position, target] : { std::pair{ a, b }, std::pair{ b, a } })
+						{
+							if (kinds[position] == VertexKind::Locked)
+								continue;
+
+							if (kinds[position] == VertexKind::Border && adjacency.CountEdgeTriangles(indices, positionIds, position, target) != 1)
+								continue;
+
+							const double error{ quadrics[position].Evaluate(pVertices[target].position) };
+							if (error < bestCollapses[position].error)
+								bestCollapses[position] = { position, target, error };
+						}
+					}
+				}
+
+				collapses.clear();
+				for (const Collapse& collapse : bestCollapses)
+				{
+					if (collapse.target != UINT32_MAX)
+						collapses.push_back(collapse);
+				}
+
+				if (collapses.empty())
+					break;
+
+				std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.error < b.error || (a.error == b.error && a.position < b.position); });
+
+				//Most collapses remove two triangles, going for half of the rest keeps the pass from overshooting or taking expensive ones early
+				const size_t removalGoal{ std::max<size_t>((triangleCount - targetTriangleCount) / 2, 1) };
+				size_t removedCount{ 0 };
+
+				for (const Collapse& collapse : collapses)
+				{
+					if (removedCount >= removalGoal)
+						break;
+
+					const uint32_t position{ collapse.position };
+					const uint32_t target{ collapse.target };
+					if (isLocked[position] || isLocked[target])
+						continue;
+
+					//Every wedge moves to the wedge of the target it shares a triangle with, a seam only collapses along itself
+					//when no two wedges share the same one
+					uint32_t wedges[16]{};
+					uint32_t wedgeTargets[16]{};
+					uint32_t wedgeCount{ 0 };
+					uint32_t removedTriangleCount{ 0 };
+					bool isValid{ true };
+
+					for (uint32_t i{ adjacency.offsets[position] }; i < adjacency.offsets[position + 1] && isValid; ++i)
+					{
+						const uint32_t* pTriangle{ indices.data() + adjacency.triangles[i] * 3 };
+
+						uint32_t corner{ 0 };
+						while (positionIds[pTriangle[corner]] != position)
+							++corner;
+
+						const uint32_t wedge{ pTriangle[corner] };
+						const uint32_t next{ pTriangle[(corner + 1) % 3] };
+						const uint32_t previous{ pTriangle[(corner + 2) % 3] };
+
+						uint32_t iWedge{ 0 };
+						while (iWedge < wedgeCount && wedges[iWedge] != wedge)
+							++iWedge;
+
+						if (iWedge == wedgeCount)
+						{
+							if (wedgeCount == 16)
+							{
+								isValid = false;
+								break;
+							}
+
+							wedges[wedgeCount] = wedge;
+							wedgeTargets[wedgeCount++] = UINT32_MAX;
+						}
+
+						if (positionIds[next] == target || positionIds[previous] == target)
+						{
+							const uint32_t targetWedge{ positionIds[next] == target ? next : previous };
+							if (wedgeTargets[iWedge] != UINT32_MAX && wedgeTargets[iWedge] != targetWedge)
+								isValid = false;
+
+							wedgeTargets[iWedge] = targetWedge;
+							++removedTriangleCount;
+							continue;
+						}
+
+						//The triangles that stay must not turn over
+						const Vector3& p1{ pVertices[next].position };
+						const Vector3& p2{ pVertices[previous].position };
+						const Vector3 oldNormal{ GetTriangleNormal(pVertices[wedge].position, p1, p2) };
+						const Vector3 newNormal{ GetTriangleNormal(pVertices[target].position, p1, p2) };
+						if (Vector3::Dot(oldNormal, newNormal) <= 0.f)
+							isValid = false;
+					}
+
+					for (uint32_t iWedge{ 0 }; iWedge < wedgeCount && isValid; ++iWedge)
+					{
+						if (wedgeTargets[iWedge] == UINT32_MAX)
+							isValid = false;
+
+						for (uint32_t other{ 0 }; other < iWedge && isValid; ++other)
+						{
+							if (wedgeTargets[other] == wedgeTargets[iWedge])
+								isValid = false;
+						}
+					}
+
+					if (!isValid)
+						continue;
+
+					for (uint32_t iWedge{ 0 }; iWedge < wedgeCount; ++iWedge)
+						remap[wedges[iWedge]] = wedgeTargets[iWedge];
+
+					quadrics[target] += quadrics[position];
+					maxError = std::max(maxError, collapse.error);
+					removedCount += removedTriangleCount;
+
+					//The neighbourhood changed, its collapses are stale until the next pass
+					for (uint32_t i{ adjacency.offsets[position] }; i < adjacency.offsets[position + 1]; ++i)
+					{
+						const uint32_t* pTriangle{ indices.data() + adjacency.triangles[i] * 3 };
+						for (uint32_t corner{ 0 }; corner < 3; ++corner)
+							isLocked[positionIds[pTriangle[corner]]] = true;
+					}
+				}
+
+				if (removedCount == 0)
+					break;
+
+				//Apply the collapses and drop the triangles that lost an edge
+				size_t writeIndex{ 0 };
+				for (size_t iTriangle{ 0 }; iTriangle < triangleCount; ++iTriangle)
+				{
+					const uint32_t i0{ remap[indices[iTriangle * 3]] };
+					const uint32_t i1{ remap[indices[iTriangle * 3 + 1]] };
+					const uint32_t i2{ remap[indices[iTriangle * 3 + 2]] };
+
+					if (positionIds[i0] == positionIds[i1] || positionIds[i1] == positionIds[i2] || positionIds[i0] == positionIds[i2])
+						continue;
+
+					indices[writeIndex++] = i0;
+					indices[writeIndex++] = i1;
+					indices[writeIndex++] = i2;
+				}
+
+				indices.resize(writeIndex);
+				triangleCount = writeIndex / 3;
+				adjacency.Build(indices, positionIds);
+			}
+
+			std::copy(indices.begin(), indices.end(), pDestination);
+
+			//The quadrics hold mean squared distances, so this is the root mean square distance of the worst collapse
+			if (pError)
+				*pError = static_cast<float>(std::sqrt(maxError));
+
+			return indices.size();
+		}
+
+		void GenerateLodChain(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, std::vector<MeshLod>& lods, uint32_t maxLodCount)
+		{
+			const size_t fullIndexCount{ indices.size() };
+			lods.assign(1, { 0, static_cast<uint32_t>(fullIndexCount), 0.f });
+
+			std::vector<uint32_t> lodIndices(fullIndexCount);
+			size_t previousIndexCount{ fullIndexCount };
+
+			for (uint32_t iLod{ 1 }; iLod <= maxLodCount; ++iLod)
+			{
+				const size_t targetIndexCount{ (fullIndexCount / 3 >> iLod) * 3 };
+				if (targetIndexCount < 3)
+					break;
+
+				float error{};
+				const size_t lodIndexCount{ Simplify(lodIndices.data(), indices.data(), fullIndexCount, vertices.data(), vertices.size(), targetIndexCount, &error) };
+				if (lodIndexCount == 0 || static_cast<float>(lodIndexCount) > static_cast<float>(previousIndexCount) * (1.f - g_MinLodReduction))
+					break;
+
+				//The collapses scatter the triangles, so every level gets its own cache order
+				MeshOptimizer::OptimizeVertexCache(lodIndices.data(), lodIndexCount, vertices.size());
+
+				//Errors are measured against the full mesh, so they only grow, but keep them strictly ordered for the selection anyway
+				error = std::max(error, lods.back().error);
+
+				lods.push_back({ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(lodIndexCount), error });
+				indices.insert(indices.end(), lodIndices.begin(), lodIndices.begin() + lodIndexCount);
+				previousIndexCount = lodIndexCount;
+			}
+		}
+	}
+}
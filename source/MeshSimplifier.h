@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "IndexArray.h"
+
+struct Vertex;
+
+namespace dae
+{
+	namespace MeshSimplifier
+	{
+		//Collapses edges onto one of their vertices, cheapest first by the quadric error metric (Garland and Heckbert), until at most
+		//targetIndexCount indices are left or nothing can collapse anymore. Vertices are not moved or created, so the result indexes the same vertices.
+		//Uv and normal seams only collapse along themselves, and open borders only along the border, so the attributes and outline stay intact.
+		//Returns the index count written to pDestination, which needs room for indexCount indices. pError receives the error of the worst collapse,
+		//the root of the area weighted mean squared distance of the kept vertex from the planes of the original triangles it replaced, in the units of the positions.
+		//That is a root mean square, not a bound: parts of the surface can move further than it.
+		size_t Simplify(uint32_t* pDestination, const uint32_t* pIndices, size_t indexCount, const Vertex* pVertices, size_t vertexCount,
+			size_t targetIndexCount, float* pError = nullptr);
+
+		//Appends up to maxLodCount levels with half the triangles of the previous one each, all simplified from the full mesh in indices.
+		//The full mesh becomes lods[0]. Levels that barely simplify end the chain.
+		void GenerateLodChain(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, std::vector<MeshLod>& lods, uint32_t maxLodCount = 3);
+	}
+}
@@ -0,0 +1,335 @@
+#include "pch.h"
+#include "Meshlet.h"
+#include "DataTypes.h"
+#include "Frustum.h"
+#include "MeshOptimizer.h"
+#include <type_traits>
+#include <variant>
+
+namespace dae
+{
+	namespace
+	{
+		//How much a triangle widening the normal cone costs, compared to one new vertex
+		constexpr float g_ConeWeight{ 0.5f };
+
+		//Triangles turned more than 60 degrees from the cone axis are left for another meshlet. That makes the meshlets of hard surface
+		//models smaller, but without it most of their cones open beyond 90 degrees and can never be culled.
+		constexpr float g_MinConeDot{ 0.5f };
+
+		//Ritter's bounding sphere: a few percent larger than the minimal one, in two passes
+		void ComputeBoundingSphere(const Vertex* pVertices, const uint32_t* pMeshletVertices, uint32_t vertexCount, Vector3& center, float& radius)
+		{
+			const Vector3& first{ pVertices[pMeshletVertices[0]].position };
+
+			auto findFarthest = [&](const Vector3& from)
+				{
+					Vector3 farthest{ from };
+					float farthestDistance{ 0.f };
+					for (uint32_t i{ 0 }; i < vertexCount; ++i)
+					{
+						const Vector3& position{ pVertices[pMeshletVertices[i]].position };
+						const float distance{ (position - from).SqrMagnitude() };
+						if (distance > farthestDistance)
+						{
+							farthestDistance = distance;
+							farthest = position;
+						}
+					}
+
+					return farthest;
+				};
+
+			const Vector3 a{ findFarthest(first) };
+			const Vector3 b{ findFarthest(a) };
+
+			center = (a + b) * 0.5f;
+			radius = (b - a).Magnitude() * 0.5f;
+
+			//Grow the sphere just enough to include every point left outside
+			for (uint32_t i{ 0 }; i < vertexCount; ++i)
+			{
+				const Vector3& position{ pVertices[pMeshletVertices[i]].position };
+				const float distance{ (position - center).Magnitude() };
+				if (distance > radius)
+				{
+					const float newRadius{ (radius + distance) * 0.5f };
+					center += (position - center) * ((newRadius - radius) / distance);
+					radius = newRadius;
+				}
+			}
+		}
+
+		void ComputeNormalCone(const Vertex* pVertices, const MeshletData& meshletData, Meshlet& meshlet)
+		{
+			const uint32_t* pMeshletVertices{ meshletData.vertices.data() + meshlet.vertexOffset };
+			const uint8_t* pTriangles{ meshletData.triangles.data() + meshlet.triangleOffset * 3 };
+
+			//Unit normals of the non-degenerate triangles, every one counts the same no matter its size
+			Vector3 normals[Meshlets::MaxTriangleCount]{};
+			uint32_t normalCount{ 0 };
+			Vector3 axis{};
+
+			for (uint32_t iTriangle{ 0 }; iTriangle < meshlet.triangleCount; ++iTriangle)
+			{
+				const Vector3& p0{ pVertices[pMeshletVertices[pTriangles[iTriangle * 3]]].position };
+				const Vector3& p1{ pVertices[pMeshletVertices[pTriangles[iTriangle * 3 + 1]]].position };
+				const Vector3& p2{ pVertices[pMeshletVertices[pTriangles[iTriangle * 3 + 2]]].position };
+
+				//Clockwise front faces in a left-handed space
+				Vector3 normal{ Vector3::Cross(p1 - p0, p2 - p0) };
+				if (normal.Normalize() <= 0.f)
+					continue;
+
+				normals[normalCount++] = normal;
+				axis += normal;
+			}
+
+			meshlet.coneAxis = Vector3::Zero;
+			meshlet.coneCutoff = 1.f;
+
+			if (normalCount == 0 || axis.Normalize() <= 0.f)
+				return;
+
+			float minDot{ 1.f };
+			for (uint32_t i{ 0 }; i < normalCount; ++i)
+				minDot = std::min(minDot, Vector3::Dot(normals[i], axis));
+
+			//Normals more than 90 degrees apart, some triangle faces the camera from every position
+			if (minDot <= 0.f)
+				return;
+
+			meshlet.coneAxis = axis;
+			meshlet.coneCutoff = std::sqrt(1.f - minDot * minDot);
+		}
+	}
+
+	namespace Meshlets
+	{
+		void Build(const Vertex* pVertices, size_t vertexCount, uint32_t* pIndices, size_t indexCount, MeshletData& meshletData, uint32_t firstIndex)
+		{
+			const uint32_t triangleCount{ static_cast<uint32_t>(indexCount / 3) };
+			if (triangleCount == 0)
+				return;
+
+			//Unit face normals, zero for degenerate triangles
+			std::vector<Vector3> triangleNormals(triangleCount);
+			for (uint32_t iTriangle{ 0 }; iTriangle < triangleCount; ++iTriangle)
+			{
+				const uint32_t* pTriangle{ pIndices + iTriangle * 3 };
+				const Vector3& p0{ pVertices[pTriangle[0]].position };
+				triangleNormals[iTriangle] = Vector3::Cross(pVertices[pTriangle[1]].position - p0, pVertices[pTriangle[2]].position - p0);
+				if (triangleNormals[iTriangle].Normalize() <= 0.f)
+					triangleNormals[iTriangle] = Vector3::Zero;
+			}
+
+			//Uv and normal seams split vertices, so triangles are neighbours when they share a position rather than a vertex
+			const std::vector<uint32_t> positionIds{ MeshOptimizer::GeneratePositionRemap(pVertices, vertexCount) };
+
+			//Triangles around every position, in compressed rows
+			std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+			for (uint32_t i{ 0 }; i < triangleCount * 3; ++i)
+				++adjacencyOffsets[positionIds[pIndices[i]] + 1];
+
+			for (size_t i{ 0 }; i < vertexCount; ++i)
+				adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+
+			std::vector<uint32_t> adjacentTriangles(triangleCount * 3);
+			{
+				std::vector<uint32_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+				for (uint32_t i{ 0 }; i < triangleCount * 3; ++i)
+					adjacentTriangles[cursors[positionIds[pIndices[i]]]++] = i / 3;
+			}
+
+			std::vector<bool> isTriangleUsed(triangleCount, false);
+			std::vector<uint32_t> vertexMeshlet(vertexCount, UINT32_MAX);	//Last meshlet that used the vertex
+			std::vector<uint32_t> reorderedIndices{};
+			reorderedIndices.reserve(triangleCount * 3);
+
+			std::vector<uint32_t> meshletTriangles{};
+			std::vector<uint32_t> candidates{};
+			uint32_t seedCursor{ 0 };
+
+			while (true)
+			{
+				while (seedCursor < triangleCount && isTriangleUsed[seedCursor])
+					++seedCursor;
+
+				if (seedCursor == triangleCount)
+					break;
+
+				const uint32_t meshletIndex{ static_cast<uint32_t>(meshletData.meshlets.size()) };
+				uint32_t meshletVertexCount{ 0 };
+				Vector3 normalSum{};
+
+				meshletTriangles.clear();
+				candidates.clear();
+
+				auto countNewVertices = [&](uint32_t iTriangle)
+					{
+						const uint32_t* pTriangle{ pIndices + iTriangle * 3 };
+						uint32_t newVertexCount{ 0 };
+						for (uint32_t corner{ 0 }; corner < 3; ++corner)
+						{
+							//Degenerate triangles can repeat a vertex, which must only be counted once
+							const bool isRepeated{ (corner > 0 && pTriangle[corner] == pTriangle[0]) || (corner > 1 && pTriangle[corner] == pTriangle[1]) };
+							if (vertexMeshlet[pTriangle[corner]] != meshletIndex && !isRepeated)
+								++newVertexCount;
+						}
+
+						return newVertexCount;
+					};
+
+				auto addTriangle = [&](uint32_t iTriangle)
+					{
+						isTriangleUsed[iTriangle] = true;
+						meshletTriangles.push_back(iTriangle);
+						normalSum += triangleNormals[iTriangle];
+
+						for (uint32_t corner{ 0 }; corner < 3; ++corner)
+						{
+							const uint32_t vertex{ pIndices[iTriangle * 3 + corner] };
+							if (vertexMeshlet[vertex] == meshletIndex)
+								continue;
+
+							vertexMeshlet[vertex] = meshletIndex;
+							++meshletVertexCount;
+
+							const uint32_t positionId{ positionIds[vertex] };
+							for (uint32_t i{ adjacencyOffsets[positionId] }; i < adjacencyOffsets[positionId + 1]; ++i)
+							{
+								if (!isTriangleUsed[adjacentTriangles[i]])
+									candidates.push_back(adjacentTriangles[i]);
+							}
+						}
+					};
+
+				addTriangle(seedCursor);
+
+				//Grow over the neighbouring triangles, cheapest first: those adding the fewest vertices, then those closest to the normal cone
+				while (meshletTriangles.size() < MaxTriangleCount)
+				{
+					Vector3 axis{ normalSum };
+					const bool hasAxis{ axis.Normalize() > 0.f };
+
+					uint32_t bestTriangle{ UINT32_MAX };
+					float bestScore{ FLT_MAX };
+
+					//Drop the candidates that were used in the meantime, so the list stays short around high valence vertices
+					candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](uint32_t candidate) { return isTriangleUsed[candidate]; }), candidates.end());
+
+					for (const uint32_t candidate : candidates)
+					{
+						//Degenerate triangles face nowhere, so they fit any cone
+						const bool isDegenerate{ triangleNormals[candidate].SqrMagnitude() == 0.f };
+						const float coneDot{ hasAxis && !isDegenerate ? Vector3::Dot(triangleNormals[candidate], axis) : 1.f };
+						if (coneDot < g_MinConeDot)
+							continue;
+
+						const uint32_t newVertexCount{ countNewVertices(candidate) };
+						if (meshletVertexCount + newVertexCount > MaxVertexCount)
+							continue;
+
+						const float score{ static_cast<float>(newVertexCount) + g_ConeWeight * (1.f - coneDot) };
+						if (score < bestScore || (score == bestScore && candidate < bestTriangle))
+						{
+							bestScore = score;
+							bestTriangle = candidate;
+						}
+					}
+
+					if (bestTriangle == UINT32_MAX)
+						break;
+
+					addTriangle(bestTriangle);
+				}
+
+				//Emit the triangles in their original order, which keeps the vertex cache order within the meshlet
+				std::sort(meshletTriangles.begin(), meshletTriangles.end());
+
+				Meshlet meshlet{};
+				meshlet.vertexOffset = static_cast<uint32_t>(meshletData.vertices.size());
+				meshlet.triangleOffset = static_cast<uint32_t>(meshletData.triangles.size() / 3);
+				meshlet.triangleCount = static_cast<uint32_t>(meshletTriangles.size());
+				meshlet.firstIndex = firstIndex + static_cast<uint32_t>(reorderedIndices.size());
+
+				for (const uint32_t iTriangle : meshletTriangles)
+				{
+					for (uint32_t corner{ 0 }; corner < 3; ++corner)
+					{
+						const uint32_t vertex{ pIndices[iTriangle * 3 + corner] };
+						reorderedIndices.push_back(vertex);
+
+						//Local indices are handed out on first use
+						uint32_t localIndex{ meshlet.vertexCount };
+						for (uint32_t i{ 0 }; i < meshlet.vertexCount; ++i)
+						{
+							if (meshletData.vertices[meshlet.vertexOffset + i] == vertex)
+							{
+								localIndex = i;
+								break;
+							}
+						}
+
+						if (localIndex == meshlet.vertexCount)
+						{
+							meshletData.vertices.push_back(vertex);
+							++meshlet.vertexCount;
+						}
+
+						meshletData.triangles.push_back(static_cast<uint8_t>(localIndex));
+					}
+				}
+
+				ComputeBoundingSphere(pVertices, meshletData.vertices.data() + meshlet.vertexOffset, meshlet.vertexCount, meshlet.center, meshlet.radius);
+				ComputeNormalCone(pVertices, meshletData, meshlet);
+				meshletData.meshlets.push_back(meshlet);
+			}
+
+			std::copy(reorderedIndices.begin(), reorderedIndices.end(), pIndices);
+		}
+
+		void Build(const Vertex* pVertices, size_t vertexCount, IndexArray& indices, const std::vector<MeshSection>& sections, const std::vector<MeshLod>& lods,
+			MeshletData& meshletData)
+		{
+			std::visit([&](auto& array)
+				{
+					using Index = typename std::decay_t<decltype(array)>::value_type;
+					std::vector<uint32_t> rangeIndices{};
+
+					for (const MeshSection& section : sections)
+					{
+						for (const MeshLod& lod : lods)
+						{
+							const uint32_t rangeStart{ std::max(section.firstIndex, lod.firstIndex) };
+							const uint32_t rangeEnd{ std::min(section.firstIndex + section.indexCount, lod.firstIndex + lod.indexCount) };
+							if (rangeStart >= rangeEnd)
+								continue;
+
+							rangeIndices.resize(rangeEnd - rangeStart);
+							for (uint32_t i{ 0 }; i < rangeIndices.size(); ++i)
+								rangeIndices[i] = array[rangeStart + i] + section.baseVertex;
+
+							Build(pVertices, vertexCount, rangeIndices.data(), rangeIndices.size(), meshletData, rangeStart);
+
+							for (uint32_t i{ 0 }; i < rangeIndices.size(); ++i)
+								array[rangeStart + i] = static_cast<Index>(rangeIndices[i] - section.baseVertex);
+						}
+					}
+				}, indices);
+		}
+
+		bool IsCulled(const Meshlet& meshlet, const Frustum& frustum, const Vector3& cameraPosition, bool cullBackFaces)
+		{
+			return frustum.IsSphereOutside(meshlet.center, meshlet.radius) || (cullBackFaces && IsBackFacing(meshlet, cameraPosition));
+		}
+
+		bool IsBackFacing(const Meshlet& meshlet, const Vector3& cameraPosition)
+		{
+			//Every point of the bounding sphere has to see every triangle from behind: the angle to the axis plus the cone's
+			//and the sphere's half angles must stay below 90 degrees, which the sum of their sines checks conservatively
+			const Vector3 toCenter{ meshlet.center - cameraPosition };
+			return Vector3::Dot(toCenter, meshlet.coneAxis) >= meshlet.coneCutoff * toCenter.Magnitude() + meshlet.radius;
+		}
+	}
+}
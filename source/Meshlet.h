@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "IndexArray.h"
+#include "Vector3.h"
+
+struct Vertex;
+
+namespace dae
+{
+	struct Frustum;
+
+	//Cluster of neighbouring triangles with the data to cull it as a whole
+	struct Meshlet
+	{
+		uint32_t vertexOffset{};	//Into MeshletData::vertices
+		uint32_t triangleOffset{};	//Into MeshletData::triangles, in triangles
+		uint32_t vertexCount{};
+		uint32_t triangleCount{};
+
+		//The builder reorders the index buffer so every meshlet is also a contiguous range of it, starting here
+		uint32_t firstIndex{};
+
+		Vector3 center{};
+		float radius{};
+
+		//Every triangle normal is within the cone around axis, which is open wider than 90 degrees when cutoff is 1
+		Vector3 coneAxis{};
+		float coneCutoff{ 1.f };	//Sine of the cone's half angle
+	};
+
+	struct MeshletData
+	{
+		std::vector<Meshlet> meshlets{};
+		std::vector<uint32_t> vertices{};	//Indices into the source vertices
+		std::vector<uint8_t> triangles{};	//Three meshlet local vertex indices per triangle
+	};
+
+	namespace Meshlets
+	{
+		//Limits that fit the output of a mesh shader thread group and keep the local indices in a byte
+		constexpr uint32_t MaxVertexCount{ 64 };
+		constexpr uint32_t MaxTriangleCount{ 124 };
+
+		struct CullingStatistics
+		{
+			uint32_t meshletCount{};
+			uint32_t culledMeshletCount{};
+			uint64_t triangleCount{};
+			uint64_t culledTriangleCount{};
+		};
+
+		//Grows every meshlet from the first unused triangle over its neighbours, preferring the ones that add the fewest vertices
+		//and keep the normal cone narrow. Then the triangles are reordered meshlet by meshlet, keeping their previous (vertex cache) order within one.
+		//Meshlets are appended, firstIndex is added to their index buffer ranges for index buffers that are built from several parts.
+		void Build(const Vertex* pVertices, size_t vertexCount, uint32_t* pIndices, size_t indexCount, MeshletData& meshletData, uint32_t firstIndex = 0);
+
+		//Build for every section and level of detail of a compacted mesh, so no meshlet needs two base vertices or spans two levels.
+		//The index buffer is reordered in place and the meshlets come out sorted by firstIndex. Done once before the mesh is cached.
+		void Build(const Vertex* pVertices, size_t vertexCount, IndexArray& indices, const std::vector<MeshSection>& sections, const std::vector<MeshLod>& lods,
+			MeshletData& meshletData);
+
+		//True when the whole meshlet is outside the frustum, or faces away from the camera when back faces are culled.
+		//Both have to be in the space of the vertices. Front faces are wound clockwise, like PosCol3D.fx expects.
+		bool IsCulled(const Meshlet& meshlet, const Frustum& frustum, const Vector3& cameraPosition, bool cullBackFaces);
+		bool IsBackFacing(const Meshlet& meshlet, const Vector3& cameraPosition);
+	}
+}
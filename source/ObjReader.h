@@ -0,0 +1,297 @@
+#pragma once
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+#include "Math.h"
+#include "Triangulation.h"
+
+namespace dae
+{
+	//1-based OBJ indices, 0 when neither the corner nor an earlier corner of its face specified the attribute
+	struct ObjCorner
+	{
+		//Set on indices a handler resolved against its own attribute counts, see ObjIndexBase.
+		//The other bits then hold a signed 31-bit index, which is below 1 when it points before the handler's part of the file.
+		static constexpr uint32_t LocalIndexFlag{ 0x80000000u };
+
+		uint32_t position{};
+		uint32_t uv{};
+		uint32_t normal{};
+	};
+
+	//Attribute counts negative (relative) indices are resolved against, and the flag tagged onto the result.
+	//Handlers that only see part of the file resolve against their own counts and tag the indices to offset them later.
+	struct ObjIndexBase
+	{
+		uint32_t positionCount{};
+		uint32_t uvCount{};
+		uint32_t normalCount{};
+		uint32_t resolvedFlag{};
+	};
+
+	//Allocation-free cursor over OBJ text, mirroring the istream calls the parser used to make (>>, peek, ignore)
+	class ObjReader final
+	{
+	public:
+		explicit ObjReader(std::string_view text)
+			: m_pCurrent{ text.data() }
+			, m_pEnd{ text.data() + text.size() }
+		{
+		}
+
+		inline bool IsAtEnd() const { return m_pCurrent >= m_pEnd; }
+		inline const char* GetPosition() const { return m_pCurrent; }
+
+		inline char Peek() const
+		{
+			return IsAtEnd() ? '\0' : *m_pCurrent;
+		}
+
+		inline void Ignore()
+		{
+			if (!IsAtEnd())
+				++m_pCurrent;
+		}
+
+		//Skips all whitespace, including line breaks, then returns the next word
+		std::string_view ReadToken()
+		{
+			while (!IsAtEnd() && IsWhitespace(*m_pCurrent))
+				++m_pCurrent;
+
+			const char* pStart{ m_pCurrent };
+			while (!IsAtEnd() && !IsWhitespace(*m_pCurrent))
+				++m_pCurrent;
+
+			return { pStart, static_cast<size_t>(m_pCurrent - pStart) };
+		}
+
+		bool ReadFloat(float& value)
+		{
+			SkipBlanks();
+
+			//from_chars is locale independent and correctly rounded, so results match the stream extraction bit for bit
+			const char* pStart{ m_pCurrent };
+			if (pStart < m_pEnd && *pStart == '+')
+				++pStart;
+
+			const std::from_chars_result result{ std::from_chars(pStart, m_pEnd, value) };
+			if (result.ec != std::errc{})
+				return false;
+
+			m_pCurrent = result.ptr;
+			return true;
+		}
+
+		//Fails on numbers that do not fit a size_t, so a long digit string cannot wrap around to a valid index
+		bool ReadIndex(size_t& value)
+		{
+			SkipBlanks();
+
+			const char* pStart{ m_pCurrent };
+			size_t result{};
+			while (!IsAtEnd() && IsDigit(*m_pCurrent))
+			{
+				const size_t digit{ static_cast<size_t>(*m_pCurrent - '0') };
+				if (result > (SIZE_MAX - digit) / 10)
+					return false;
+
+				result = result * 10 + digit;
+				++m_pCurrent;
+			}
+
+			if (m_pCurrent == pStart)
+				return false;
+
+			value = result;
+			return true;
+		}
+
+		bool ReadSignedIndex(int64_t& value)
+		{
+			SkipBlanks();
+
+			const bool isNegative{ !IsAtEnd() && *m_pCurrent == '-' };
+			if (isNegative)
+				++m_pCurrent;
+
+			size_t magnitude{};
+			if (!ReadIndex(magnitude) || magnitude > INT64_MAX)
+				return false;
+
+			value = isNegative ? -static_cast<int64_t>(magnitude) : static_cast<int64_t>(magnitude);
+			return true;
+		}
+
+		//True when the rest of the line starts with another index
+		bool IsAtIndex()
+		{
+			SkipBlanks();
+			return !IsAtEnd() && (IsDigit(*m_pCurrent) || *m_pCurrent == '-');
+		}
+
+		//Read till end of line and ignore all remaining chars
+		void SkipLine()
+		{
+			while (!IsAtEnd() && *m_pCurrent != '\n')
+				++m_pCurrent;
+
+			Ignore();
+		}
+
+	private:
+		const char* m_pCurrent;
+		const char* m_pEnd;
+
+		static inline bool IsWhitespace(char c)
+		{
+			return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+		}
+
+		static inline bool IsDigit(char c)
+		{
+			return c >= '0' && c <= '9';
+		}
+
+		inline void SkipBlanks()
+		{
+			while (!IsAtEnd() && (*m_pCurrent == ' ' || *m_pCurrent == '\t'))
+				++m_pCurrent;
+		}
+	};
+
+	namespace ObjRecords
+	{
+		inline bool ReadCornerIndex(ObjReader& reader, uint32_t attributeCount, uint32_t resolvedFlag, uint32_t& index)
+		{
+			int64_t value{};
+			if (!reader.ReadSignedIndex(value) || value == 0)
+				return false;
+
+			if (value > 0)
+			{
+				if (value >= ObjCorner::LocalIndexFlag)
+					return false;
+
+				index = static_cast<uint32_t>(value);
+				return true;
+			}
+
+			//Negative indices count back from the last attribute defined before the face, -1 being that attribute
+			const int64_t resolved{ static_cast<int64_t>(attributeCount) + 1 + value };
+			if (resolvedFlag == 0)
+			{
+				if (resolved < 1)
+					return false;
+
+				index = static_cast<uint32_t>(resolved);
+				return true;
+			}
+
+			if (resolved <= -static_cast<int64_t>(ObjCorner::LocalIndexFlag / 2))
+				return false;
+
+			index = (static_cast<uint32_t>(resolved) & ~resolvedFlag) | resolvedFlag;
+			return true;
+		}
+
+		//Reads a polygon of "p", "p/t", "p//n" or "p/t/n" corners, at most MaxPolygonCorners of them.
+		//A corner without uv/normal keeps the previous corner's one, like the stream parser did.
+		inline bool ReadFace(ObjReader& reader, const ObjIndexBase& base, ObjCorner* pCorners, uint32_t& cornerCount)
+		{
+			uint32_t previousUV{ 0 };
+			uint32_t previousNormal{ 0 };
+			cornerCount = 0;
+
+			while (reader.IsAtIndex())
+			{
+				if (cornerCount == Triangulation::MaxPolygonCorners)
+					return false;
+
+				ObjCorner& corner{ pCorners[cornerCount++] };
+				corner.uv = previousUV;
+				corner.normal = previousNormal;
+
+				if (!ReadCornerIndex(reader, base.positionCount, base.resolvedFlag, corner.position))
+					return false;
+
+				if ('/' == reader.Peek())
+				{
+					reader.Ignore();
+
+					// Optional texture coordinate
+					if ('/' != reader.Peek() && !ReadCornerIndex(reader, base.uvCount, base.resolvedFlag, corner.uv))
+						return false;
+
+					if ('/' == reader.Peek())
+					{
+						reader.Ignore();
+
+						// Optional vertex normal
+						if (!ReadCornerIndex(reader, base.normalCount, base.resolvedFlag, corner.normal))
+							return false;
+					}
+				}
+
+				previousUV = corner.uv;
+				previousNormal = corner.normal;
+			}
+
+			return cornerCount >= 3;
+		}
+
+		//Feeds every record to the handler: OnPosition(Vector3), OnUV(Vector2), OnNormal(Vector3) and OnFace(const ObjCorner*, cornerCount) -> bool.
+		//GetIndexBase() -> ObjIndexBase is asked for before every face to resolve its negative indices.
+		template<typename Handler>
+		bool Parse(ObjReader& reader, Handler& handler)
+		{
+			while (!reader.IsAtEnd())
+			{
+				//read the first word of the line
+				const std::string_view command{ reader.ReadToken() };
+
+				if (command == "v")
+				{
+					//Vertex
+					float x{}, y{}, z{};
+					reader.ReadFloat(x);
+					reader.ReadFloat(y);
+					reader.ReadFloat(z);
+
+					handler.OnPosition(Vector3{ x, y, z });
+				}
+				else if (command == "vt")
+				{
+					// Vertex TexCoord
+					float u{}, v{};
+					reader.ReadFloat(u);
+					reader.ReadFloat(v);
+
+					handler.OnUV(Vector2{ u, 1 - v });
+				}
+				else if (command == "vn")
+				{
+					// Vertex Normal
+					float x{}, y{}, z{};
+					reader.ReadFloat(x);
+					reader.ReadFloat(y);
+					reader.ReadFloat(z);
+
+					handler.OnNormal(Vector3{ x, y, z });
+				}
+				else if (command == "f")
+				{
+					// Faces or polygons, triangulated by the handler
+					ObjCorner corners[Triangulation::MaxPolygonCorners];
+					uint32_t cornerCount{};
+					if (!ReadFace(reader, handler.GetIndexBase(), corners, cornerCount) || !handler.OnFace(corners, cornerCount))
+						return false;
+				}
+
+				reader.SkipLine();
+			}
+
+			return true;
+		}
+	}
+}
@@ -0,0 +1,274 @@
+#include "pch.h"
+#include "ObjStream.h"
+#include <fstream>
+#include "ObjReader.h"
+#include "SpillableArray.h"
+#include "Utils.h"
+
+namespace dae
+{
+	namespace Utils
+	{
+		namespace
+		{
+			constexpr size_t g_ReadBufferSize{ 4 * 1024 * 1024 };
+
+			class StreamRecordHandler final
+			{
+			public:
+				StreamRecordHandler(const OBJStreamSettings& settings, const std::function<void(const OBJBatch&)>& onBatch)
+					: m_Settings{ settings }
+					, m_OnBatch{ onBatch }
+				{
+					//A batch is flushed after the polygon that fills it, so leave room for the largest one
+					const size_t batchCornerCount{ (size_t(std::max(m_Settings.batchTriangleCount, 1u)) + Triangulation::MaxPolygonCorners - 2) * 3 };
+					m_Vertices.reserve(batchCornerCount);
+					m_Indices.reserve(batchCornerCount);
+
+					m_FixedMemoryUsage = g_ReadBufferSize + batchCornerCount * (sizeof(Vertex) + sizeof(uint32_t));
+					m_ReadBufferSize = g_ReadBufferSize;
+					m_Statistics.peakMemoryUsage = m_FixedMemoryUsage;
+				}
+
+				//The read buffer has to hold a whole line. Unlike the arrays it cannot spill, so when doubling it leaves less
+				//than the quarter of the memory limit the read caches of spilled arrays take, the line is too long to load.
+				bool GrowReadBuffer(size_t& bufferSize)
+				{
+					const size_t newBufferSize{ bufferSize * 2 };
+					const size_t newFixedMemoryUsage{ m_FixedMemoryUsage - m_ReadBufferSize + newBufferSize };
+					if (newFixedMemoryUsage > m_Settings.memoryLimit - m_Settings.memoryLimit / 4)
+					{
+						m_Statistics.isLineTooLong = true;
+						return false;
+					}
+
+					m_FixedMemoryUsage = newFixedMemoryUsage;
+					m_ReadBufferSize = newBufferSize;
+					bufferSize = newBufferSize;
+
+					m_PushesSinceCheck = SpillableArray<Vector3>::BlockSize;
+					EnforceMemoryLimit();
+					return true;
+				}
+
+				void OnPosition(const Vector3& position)
+				{
+					m_Positions.PushBack(position);
+					EnforceMemoryLimit();
+				}
+
+				void OnUV(const Vector2& uv)
+				{
+					m_UVs.PushBack(uv);
+					EnforceMemoryLimit();
+				}
+
+				void OnNormal(const Vector3& normal)
+				{
+					m_Normals.PushBack(normal);
+					EnforceMemoryLimit();
+				}
+
+				//The whole file so far has been seen, so negative indices resolve to their final value right away
+				ObjIndexBase GetIndexBase() const
+				{
+					return { static_cast<uint32_t>(m_Positions.GetSize()), static_cast<uint32_t>(m_UVs.GetSize()), static_cast<uint32_t>(m_Normals.GetSize()), 0 };
+				}
+
+				bool OnFace(const ObjCorner* pCorners, uint32_t cornerCount)
+				{
+					Vector3 polygon[Triangulation::MaxPolygonCorners];
+					for (uint32_t i{ 0 }; i < cornerCount; ++i)
+					{
+						const ObjCorner& corner{ pCorners[i] };
+
+						// OBJ format uses 1-based arrays
+						if (corner.position > m_Positions.GetSize() || corner.uv > m_UVs.GetSize() || corner.normal > m_Normals.GetSize())
+							return false;
+
+						polygon[i] = m_Positions.Get(corner.position - 1);
+					}
+
+					uint8_t polygonTriangles[(Triangulation::MaxPolygonCorners - 2) * 3];
+					const uint32_t triangleCount{ Triangulation::TriangulatePolygon(polygon, cornerCount, polygonTriangles) };
+
+					for (uint32_t iTriangle{ 0 }; iTriangle < triangleCount; ++iTriangle)
+					{
+						uint32_t tempIndices[3];
+						for (size_t iFace = 0; iFace < 3; iFace++)
+						{
+							const uint8_t iCorner{ polygonTriangles[iTriangle * 3 + iFace] };
+							const ObjCorner& corner{ pCorners[iCorner] };
+
+							Vertex vertex{};
+							vertex.position = polygon[iCorner];
+
+							if (corner.uv != 0)
+								vertex.uv = m_UVs.Get(corner.uv - 1);
+
+							if (corner.normal != 0)
+								vertex.normal = m_Normals.Get(corner.normal - 1);
+
+							m_Vertices.push_back(vertex);
+							tempIndices[iFace] = static_cast<uint32_t>(m_Vertices.size()) - 1;
+						}
+
+						m_Indices.push_back(tempIndices[0]);
+						if (m_Settings.flipAxisAndWinding)
+						{
+							m_Indices.push_back(tempIndices[2]);
+							m_Indices.push_back(tempIndices[1]);
+						}
+						else
+						{
+							m_Indices.push_back(tempIndices[1]);
+							m_Indices.push_back(tempIndices[2]);
+						}
+					}
+
+					m_Statistics.triangleCount += triangleCount;
+
+					if (m_Indices.size() >= size_t(m_Settings.batchTriangleCount) * 3)
+						Flush();
+
+					return true;
+				}
+
+				void Flush()
+				{
+					if (m_Indices.empty())
+						return;
+
+					//Every vertex belongs to a single triangle, so the batch's tangents equal the whole mesh's
+					CalculateTangents(m_Vertices, m_Indices, m_Settings.flipAxisAndWinding, 1);
+
+					OBJBatch batch{};
+					batch.pVertices = m_Vertices.data();
+					batch.vertexCount = static_cast<uint32_t>(m_Vertices.size());
+					batch.pIndices = m_Indices.data();
+					batch.indexCount = static_cast<uint32_t>(m_Indices.size());
+					batch.firstVertex = m_FirstVertex;
+					m_OnBatch(batch);
+
+					m_FirstVertex += m_Vertices.size();
+					++m_Statistics.batchCount;
+
+					m_Vertices.clear();
+					m_Indices.clear();
+				}
+
+				bool HasFailed() const
+				{
+					return m_Positions.HasFailed() || m_UVs.HasFailed() || m_Normals.HasFailed();
+				}
+
+				const OBJStreamStatistics& GetStatistics() const { return m_Statistics; }
+
+			private:
+				const OBJStreamSettings& m_Settings;
+				const std::function<void(const OBJBatch&)>& m_OnBatch;
+
+				SpillableArray<Vector3> m_Positions{};
+				SpillableArray<Vector2> m_UVs{};
+				SpillableArray<Vector3> m_Normals{};
+
+				std::vector<Vertex> m_Vertices{};
+				std::vector<uint32_t> m_Indices{};
+				uint64_t m_FirstVertex{};
+
+				size_t m_FixedMemoryUsage{};	//The read buffer and the batch
+				size_t m_ReadBufferSize{};
+				size_t m_PushesSinceCheck{};
+				OBJStreamStatistics m_Statistics{};
+
+				size_t GetMemoryUsage() const
+				{
+					return m_FixedMemoryUsage + m_Positions.GetMemoryUsage() + m_UVs.GetMemoryUsage() + m_Normals.GetMemoryUsage();
+				}
+
+				void EnforceMemoryLimit()
+				{
+					//Usage only changes when a block is completed
+					if (++m_PushesSinceCheck < SpillableArray<Vector3>::BlockSize)
+						return;
+
+					m_PushesSinceCheck = 0;
+
+					size_t memoryUsage{ GetMemoryUsage() };
+					if (memoryUsage > m_Settings.memoryLimit)
+					{
+						//A quarter of the budget is split between the read caches of the three arrays
+						const size_t cacheBudget{ m_Settings.memoryLimit / 4 / 3 };
+
+						m_Positions.Spill(cacheBudget / (SpillableArray<Vector3>::PageSize * sizeof(Vector3)));
+						m_UVs.Spill(cacheBudget / (SpillableArray<Vector2>::PageSize * sizeof(Vector2)));
+						m_Normals.Spill(cacheBudget / (SpillableArray<Vector3>::PageSize * sizeof(Vector3)));
+
+						m_Statistics.hasSpilled = true;
+						memoryUsage = GetMemoryUsage();
+					}
+
+					m_Statistics.peakMemoryUsage = std::max(m_Statistics.peakMemoryUsage, memoryUsage);
+				}
+			};
+		}
+
+		bool StreamOBJ(const std::string& filename, const OBJStreamSettings& settings, const std::function<void(const OBJBatch&)>& onBatch, OBJStreamStatistics* pStatistics)
+		{
+			std::ifstream file(filename, std::ios::binary);
+			if (!file)
+				return false;
+
+			StreamRecordHandler handler{ settings, onBatch };
+
+			std::vector<char> buffer(g_ReadBufferSize);
+			size_t bufferUsed{ 0 };
+			bool isAtEnd{ false };
+
+			const auto finish = [&handler, pStatistics](bool isLoaded)
+				{
+					if (pStatistics)
+						*pStatistics = handler.GetStatistics();
+
+					return isLoaded;
+				};
+
+			while (!isAtEnd)
+			{
+				file.read(buffer.data() + bufferUsed, static_cast<std::streamsize>(buffer.size() - bufferUsed));
+				bufferUsed += static_cast<size_t>(file.gcount());
+				isAtEnd = !file;
+
+				//Only complete lines are parsed, the rest moves to the front of the buffer for the next read
+				const std::string_view text{ buffer.data(), bufferUsed };
+				size_t parseEnd{ text.size() };
+				if (!isAtEnd)
+				{
+					parseEnd = text.rfind('\n');
+					if (parseEnd == std::string_view::npos)
+					{
+						//A single line longer than the buffer
+						size_t bufferSize{ buffer.size() };
+						if (!handler.GrowReadBuffer(bufferSize))
+							return finish(false);
+
+						buffer.resize(bufferSize);
+						continue;
+					}
+
+					++parseEnd;
+				}
+
+				ObjReader reader{ text.substr(0, parseEnd) };
+				if (!ObjRecords::Parse(reader, handler) || handler.HasFailed())
+					return finish(false);
+
+				std::copy(buffer.begin() + parseEnd, buffer.begin() + bufferUsed, buffer.begin());
+				bufferUsed -= parseEnd;
+			}
+
+			handler.Flush();
+			return finish(!handler.HasFailed());
+		}
+	}
+}
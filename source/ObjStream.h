@@ -0,0 +1,47 @@
+#pragma once
+#include <functional>
+#include <string>
+#include "DataTypes.h"
+
+namespace dae
+{
+	namespace Utils
+	{
+		struct OBJStreamSettings
+		{
+			bool flipAxisAndWinding{ true };
+
+			//Triangles handed to the callback at once
+			uint32_t batchTriangleCount{ 65536 };
+
+			//Upper bound for everything the loader holds in memory. When the position/uv/normal arrays outgrow it,
+			//they move to temporary files and are read back through a small block cache. The read buffer grows for lines longer
+			//than itself, a line that cannot fit within the limit fails the load.
+			size_t memoryLimit{ 256ull * 1024 * 1024 };
+		};
+
+		//Vertices are not shared between faces, so every batch is self-contained and its indices start at 0.
+		//firstVertex is the position of the batch in the whole mesh.
+		struct OBJBatch
+		{
+			const Vertex* pVertices{ nullptr };
+			uint32_t vertexCount{};
+			const uint32_t* pIndices{ nullptr };
+			uint32_t indexCount{};
+			uint64_t firstVertex{};
+		};
+
+		struct OBJStreamStatistics
+		{
+			uint64_t triangleCount{};
+			uint32_t batchCount{};
+			size_t peakMemoryUsage{};
+			bool hasSpilled{ false };
+			bool isLineTooLong{ false };	//The load failed on a line that does not fit in the memory limit
+		};
+
+		//Same output as ParseOBJ without welding, delivered in batches while the file is read through a fixed-size buffer.
+		//Faces may only reference attributes defined above them. The statistics are also filled in when the load fails.
+		bool StreamOBJ(const std::string& filename, const OBJStreamSettings& settings, const std::function<void(const OBJBatch&)>& onBatch, OBJStreamStatistics* pStatistics = nullptr);
+	}
+}
@@ -0,0 +1,155 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dae
+{
+	namespace Parallel
+	{
+		//0 means "use every hardware thread"
+		inline uint32_t ResolveThreadCount(uint32_t threadCount)
+		{
+			if (threadCount == 0)
+				threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+			return threadCount;
+		}
+
+		//Set on the workers and on a caller while it runs jobs, so a job that calls For again runs that loop itself instead of waiting on the pool
+		inline thread_local bool g_IsInsideJob{ false };
+
+		//Workers that live for the whole program and sleep between loops, so a For per frame does not start and join threads every time.
+		//One loop runs at a time, a second thread calling Run waits for the first to finish.
+		class ThreadPool final
+		{
+		public:
+			static ThreadPool& Get()
+			{
+				static ThreadPool threadPool{};
+				return threadPool;
+			}
+
+			ThreadPool(const ThreadPool& other) = delete;
+			ThreadPool& operator=(const ThreadPool& other) = delete;
+			ThreadPool(ThreadPool&& other) = delete;
+			ThreadPool& operator=(ThreadPool&& other) = delete;
+
+			~ThreadPool()
+			{
+				{
+					const std::lock_guard lock{ m_Mutex };
+					m_IsStopping = true;
+				}
+				m_WorkCondition.notify_all();
+
+				for (std::thread& worker : m_Workers)
+					worker.join();
+			}
+
+			//The calling thread and threadCount - 1 workers take jobs from a shared counter until they run out
+			template<typename Job>
+			void Run(uint32_t jobCount, uint32_t threadCount, const Job& job)
+			{
+				const std::lock_guard runLock{ m_RunMutex };
+				{
+					const std::lock_guard lock{ m_Mutex };
+
+					//Started at the current generation, so new workers only pick up the loop below
+					while (m_Workers.size() < threadCount - 1)
+					{
+						const uint32_t workerIndex{ static_cast<uint32_t>(m_Workers.size()) };
+						m_Workers.emplace_back([this, workerIndex, generation = m_Generation]() { WorkerLoop(workerIndex, generation); });
+					}
+
+					m_pRunJob = [](const void* pJob, uint32_t jobIndex) { (*static_cast<const Job*>(pJob))(jobIndex); };
+					m_pJob = &job;
+					m_JobCount = jobCount;
+					m_NextJob = 0;
+					m_ActiveWorkerCount = threadCount - 1;
+					m_BusyWorkerCount = m_ActiveWorkerCount;
+					++m_Generation;
+				}
+				m_WorkCondition.notify_all();
+
+				g_IsInsideJob = true;
+				RunJobs();
+				g_IsInsideJob = false;
+
+				//Every active worker checks in, even when the others already took all jobs, so none of them can still see this loop during the next one
+				std::unique_lock lock{ m_Mutex };
+				m_DoneCondition.wait(lock, [this]() { return m_BusyWorkerCount == 0; });
+			}
+
+		private:
+			std::mutex m_RunMutex{};
+			std::mutex m_Mutex{};
+			std::condition_variable m_WorkCondition{};
+			std::condition_variable m_DoneCondition{};
+			std::vector<std::thread> m_Workers{};
+			uint64_t m_Generation{};
+			bool m_IsStopping{ false };
+
+			//The loop that is running, the job is type erased so the workers do not depend on its type
+			void (*m_pRunJob)(const void* pJob, uint32_t jobIndex) {};
+			const void* m_pJob{ nullptr };
+			uint32_t m_JobCount{};
+			std::atomic<uint32_t> m_NextJob{};
+			uint32_t m_ActiveWorkerCount{};
+			uint32_t m_BusyWorkerCount{};
+
+			ThreadPool() = default;
+
+			void RunJobs()
+			{
+				for (uint32_t i{ m_NextJob++ }; i < m_JobCount; i = m_NextJob++)
+					m_pRunJob(m_pJob, i);
+			}
+
+			void WorkerLoop(uint32_t workerIndex, uint64_t generation)
+			{
+				g_IsInsideJob = true;
+
+				std::unique_lock lock{ m_Mutex };
+				while (true)
+				{
+					m_WorkCondition.wait(lock, [this, generation]() { return m_IsStopping || m_Generation != generation; });
+					if (m_IsStopping)
+						return;
+
+					generation = m_Generation;
+					if (workerIndex >= m_ActiveWorkerCount)
+						continue;
+
+					lock.unlock();
+					RunJobs();
+					lock.lock();
+
+					if (--m_BusyWorkerCount == 0)
+						m_DoneCondition.notify_one();
+				}
+			}
+		};
+
+		//Runs job(jobIndex) for every job index, spread over at most threadCount threads of the ThreadPool. The calling thread takes part as well.
+		template<typename Job>
+		void For(uint32_t jobCount, uint32_t threadCount, const Job& job)
+		{
+			threadCount = std::min(ResolveThreadCount(threadCount), jobCount);
+
+			if (threadCount <= 1 || g_IsInsideJob)
+			{
+				for (uint32_t i{ 0 }; i < jobCount; ++i)
+					job(i);
+
+				return;
+			}
+
+			ThreadPool::Get().Run(jobCount, threadCount, job);
+		}
+	}
+}
@@ -0,0 +1,380 @@
+#include "pch.h"
+#include "PhongShader.h"
+#include "SoftwareTexture.h"
+#include <cfloat>
+
+//Follows the Matrix backend like BatchTransform. The texture lookups need the integer instructions of SSE2, which every x64 target has,
+//and blocks of 8 pixels need AVX2 (/arch:AVX2) for its gathers.
+#if defined(DAE_MATRIX_SSE) && (defined(_M_X64) || defined(__SSE2__))
+#define DAE_SHADING_SSE
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#define DAE_SHADING_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+namespace dae
+{
+	namespace PhongShader
+	{
+		namespace
+		{
+			//The globals of PosCol3D.fx
+			const Vector3 g_LightDirection{ Vector3{ 0.577f, -0.577f, 0.577f }.Normalized() };
+			constexpr float g_LightIntensity{ 7.f };
+			constexpr float g_Shininess{ 25.f };
+
+			constexpr float g_ByteToFloat{ 1.f / 255.f };
+
+			ColorRGB SampleColor(const SoftwareTexture* pTexture, const Vector2& uv)
+			{
+				if (pTexture == nullptr)
+					return { 1.f, 1.f, 1.f };
+
+				const uint32_t texel{ pTexture->Sample(uv) };
+				return { (texel & 0xFF) * g_ByteToFloat, ((texel >> 8) & 0xFF) * g_ByteToFloat, ((texel >> 16) & 0xFF) * g_ByteToFloat };
+			}
+
+			Vertex_Out GetPixel(const PixelBlock& pixels, uint32_t lane)
+			{
+				const auto& a{ pixels.attributes };
+
+				Vertex_Out pixel{};
+				pixel.worldPosition = { a[WorldPositionX][lane], a[WorldPositionY][lane], a[WorldPositionZ][lane] };
+				pixel.uv = { a[U][lane], a[V][lane] };
+				pixel.normal = { a[NormalX][lane], a[NormalY][lane], a[NormalZ][lane] };
+				pixel.tangent = { a[TangentX][lane], a[TangentY][lane], a[TangentZ][lane], a[TangentW][lane] };
+				return pixel;
+			}
+
+#ifdef DAE_SHADING_SSE
+			struct Sse
+			{
+				using Register = __m128;
+				using IntRegister = __m128i;
+				static constexpr uint32_t Width{ 4 };
+
+				static Register Load(const float* p) { return _mm_loadu_ps(p); }
+				static void Store(float* p, Register value) { _mm_storeu_ps(p, value); }
+				static Register Set(float value) { return _mm_set1_ps(value); }
+				static Register Add(Register a, Register b) { return _mm_add_ps(a, b); }
+				static Register Sub(Register a, Register b) { return _mm_sub_ps(a, b); }
+				static Register Mul(Register a, Register b) { return _mm_mul_ps(a, b); }
+				static Register Div(Register a, Register b) { return _mm_div_ps(a, b); }
+				static Register Sqrt(Register value) { return _mm_sqrt_ps(value); }
+				//b when a is NaN
+				static Register Min(Register a, Register b) { return _mm_min_ps(a, b); }
+				static Register Max(Register a, Register b) { return _mm_max_ps(a, b); }
+				static Register Less(Register a, Register b) { return _mm_cmplt_ps(a, b); }
+				static Register Greater(Register a, Register b) { return _mm_cmpgt_ps(a, b); }
+				static Register And(Register a, Register b) { return _mm_and_ps(a, b); }
+				static Register Or(Register a, Register b) { return _mm_or_ps(a, b); }
+
+				//Truncation rounds towards zero, so negative values with a fraction end up one too high
+				static Register Floor(Register value)
+				{
+					const Register truncated{ _mm_cvtepi32_ps(_mm_cvttps_epi32(value)) };
+					return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, value), _mm_set1_ps(1.f)));
+				}
+
+				static IntRegister SetInt(int32_t value) { return _mm_set1_epi32(value); }
+				static IntRegister AddInt(IntRegister a, IntRegister b) { return _mm_add_epi32(a, b); }
+				static IntRegister SubInt(IntRegister a, IntRegister b) { return _mm_sub_epi32(a, b); }
+				template<int Shift>
+				static IntRegister ShiftLeft(IntRegister value) { return _mm_slli_epi32(value, Shift); }
+				template<int Shift>
+				static IntRegister ShiftRight(IntRegister value) { return _mm_srli_epi32(value, Shift); }
+				static IntRegister AsInt(Register value) { return _mm_castps_si128(value); }
+				static Register AsFloat(IntRegister value) { return _mm_castsi128_ps(value); }
+				static IntRegister Truncate(Register value) { return _mm_cvttps_epi32(value); }
+				static Register ToFloat(IntRegister value) { return _mm_cvtepi32_ps(value); }
+
+				//No gather before AVX2
+				static IntRegister Gather(const uint32_t* pTexels, Register indices)
+				{
+					alignas(16) int32_t lanes[4];
+					_mm_store_si128(reinterpret_cast<__m128i*>(lanes), _mm_cvttps_epi32(indices));
+					return _mm_set_epi32(static_cast<int32_t>(pTexels[lanes[3]]), static_cast<int32_t>(pTexels[lanes[2]]),
+						static_cast<int32_t>(pTexels[lanes[1]]), static_cast<int32_t>(pTexels[lanes[0]]));
+				}
+
+				template<int Shift>
+				static Register Channel(IntRegister texels) { return _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(texels, Shift), _mm_set1_epi32(0xFF))); }
+			};
+#endif
+
+#ifdef DAE_SHADING_AVX2
+			struct Avx2
+			{
+				using Register = __m256;
+				using IntRegister = __m256i;
+				static constexpr uint32_t Width{ 8 };
+
+				static Register Load(const float* p) { return _mm256_loadu_ps(p); }
+				static void Store(float* p, Register value) { _mm256_storeu_ps(p, value); }
+				static Register Set(float value) { return _mm256_set1_ps(value); }
+				static Register Add(Register a, Register b) { return _mm256_add_ps(a, b); }
+				static Register Sub(Register a, Register b) { return _mm256_sub_ps(a, b); }
+				static Register Mul(Register a, Register b) { return _mm256_mul_ps(a, b); }
+				static Register Div(Register a, Register b) { return _mm256_div_ps(a, b); }
+				static Register Sqrt(Register value) { return _mm256_sqrt_ps(value); }
+				//b when a is NaN
+				static Register Min(Register a, Register b) { return _mm256_min_ps(a, b); }
+				static Register Max(Register a, Register b) { return _mm256_max_ps(a, b); }
+				static Register Less(Register a, Register b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+				static Register Greater(Register a, Register b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+				static Register And(Register a, Register b) { return _mm256_and_ps(a, b); }
+				static Register Or(Register a, Register b) { return _mm256_or_ps(a, b); }
+				static Register Floor(Register value) { return _mm256_floor_ps(value); }
+
+				static IntRegister SetInt(int32_t value) { return _mm256_set1_epi32(value); }
+				static IntRegister AddInt(IntRegister a, IntRegister b) { return _mm256_add_epi32(a, b); }
+				static IntRegister SubInt(IntRegister a, IntRegister b) { return _mm256_sub_epi32(a, b); }
+				template<int Shift>
+				static IntRegister ShiftLeft(IntRegister value) { return _mm256_slli_epi32(value, Shift); }
+				template<int Shift>
+				static IntRegister ShiftRight(IntRegister value) { return _mm256_srli_epi32(value, Shift); }
+				static IntRegister AsInt(Register value) { return _mm256_castps_si256(value); }
+				static Register AsFloat(IntRegister value) { return _mm256_castsi256_ps(value); }
+				static IntRegister Truncate(Register value) { return _mm256_cvttps_epi32(value); }
+				static Register ToFloat(IntRegister value) { return _mm256_cvtepi32_ps(value); }
+
+				static IntRegister Gather(const uint32_t* pTexels, Register indices)
+				{
+					return _mm256_i32gather_epi32(reinterpret_cast<const int*>(pTexels), _mm256_cvttps_epi32(indices), 4);
+				}
+
+				template<int Shift>
+				static Register Channel(IntRegister texels) { return _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(texels, Shift), _mm256_set1_epi32(0xFF))); }
+			};
+#endif
+
+#ifdef DAE_SHADING_SSE
+			template<typename Simd>
+			typename Simd::Register SaturateLanes(typename Simd::Register value)
+			{
+				return Simd::Min(Simd::Max(value, Simd::Set(0.f)), Simd::Set(1.f));
+			}
+
+			//Natural logarithm of positive values, the polynomial of the Cephes logf: split into a mantissa in [sqrt(0.5), sqrt(2)) and the exponent
+			template<typename Simd>
+			typename Simd::Register Log(typename Simd::Register x)
+			{
+				using Register = typename Simd::Register;
+
+				x = Simd::Max(x, Simd::Set(FLT_MIN));
+				Register exponent{ Simd::ToFloat(Simd::SubInt(Simd::template ShiftRight<23>(Simd::AsInt(x)), Simd::SetInt(126))) };
+				x = Simd::Or(Simd::And(x, Simd::AsFloat(Simd::SetInt(~0x7F800000))), Simd::Set(0.5f));
+
+				const Register isSmall{ Simd::Less(x, Simd::Set(0.707106781186547524f)) };
+				exponent = Simd::Sub(exponent, Simd::And(isSmall, Simd::Set(1.f)));
+				x = Simd::Add(Simd::Sub(x, Simd::Set(1.f)), Simd::And(isSmall, x));
+
+				const Register z{ Simd::Mul(x, x) };
+				Register y{ Simd::Set(7.0376836292e-2f) };
+				for (const float coefficient : { -1.1514610310e-1f, 1.1676998740e-1f, -1.2420140846e-1f, 1.4249322787e-1f,
+					-1.6668057665e-1f, 2.0000714765e-1f, -2.4999993993e-1f, 3.3333331174e-1f })
+					y = Simd::Add(Simd::Mul(y, x), Simd::Set(coefficient));
+
+				y = Simd::Mul(Simd::Mul(y, x), z);
+				y = Simd::Add(y, Simd::Mul(exponent, Simd::Set(-2.12194440e-4f)));
+				y = Simd::Sub(y, Simd::Mul(z, Simd::Set(0.5f)));
+				return Simd::Add(Simd::Add(x, y), Simd::Mul(exponent, Simd::Set(0.693359375f)));
+			}
+
+			//e^x with the polynomial of the Cephes expf: 2^n from the exponent bits times e^r for the remainder
+			template<typename Simd>
+			typename Simd::Register Exp(typename Simd::Register x)
+			{
+				using Register = typename Simd::Register;
+
+				x = Simd::Max(Simd::Min(x, Simd::Set(88.3762626647949f)), Simd::Set(-88.3762626647949f));
+				const Register n{ Simd::Floor(Simd::Add(Simd::Mul(x, Simd::Set(1.44269504088896341f)), Simd::Set(0.5f))) };
+				x = Simd::Sub(Simd::Sub(x, Simd::Mul(n, Simd::Set(0.693359375f))), Simd::Mul(n, Simd::Set(-2.12194440e-4f)));
+
+				Register y{ Simd::Set(1.9875691500e-4f) };
+				for (const float coefficient : { 1.3981999507e-3f, 8.3334519073e-3f, 4.1665795894e-2f, 1.6666665459e-1f, 5.0000001201e-1f })
+					y = Simd::Add(Simd::Mul(y, x), Simd::Set(coefficient));
+
+				y = Simd::Add(Simd::Add(Simd::Mul(y, Simd::Mul(x, x)), x), Simd::Set(1.f));
+				return Simd::Mul(y, Simd::AsFloat(Simd::template ShiftLeft<23>(Simd::AddInt(Simd::Truncate(n), Simd::SetInt(127)))));
+			}
+
+			//SoftwareTexture::Sample for every lane, with the texel index in a float. That is exact up to 2^24 texels.
+			template<typename Simd>
+			void Sample(const SoftwareTexture* pTexture, typename Simd::Register u, typename Simd::Register v,
+				typename Simd::Register& r, typename Simd::Register& g, typename Simd::Register& b)
+			{
+				using Register = typename Simd::Register;
+
+				if (pTexture == nullptr)
+				{
+					r = g = b = Simd::Set(1.f);
+					return;
+				}
+
+				const auto toTexel = [](Register coordinate, uint32_t size)
+					{
+						const Register wrapped{ Simd::Mul(Simd::Sub(coordinate, Simd::Floor(coordinate)), Simd::Set(static_cast<float>(size))) };
+						return Simd::Floor(Simd::Min(wrapped, Simd::Set(size - 1.f)));
+					};
+
+				const Register x{ toTexel(u, pTexture->GetWidth()) };
+				const Register y{ toTexel(v, pTexture->GetHeight()) };
+				const auto texels{ Simd::Gather(pTexture->GetTexels(), Simd::Add(Simd::Mul(y, Simd::Set(static_cast<float>(pTexture->GetWidth()))), x)) };
+
+				r = Simd::Mul(Simd::template Channel<0>(texels), Simd::Set(g_ByteToFloat));
+				g = Simd::Mul(Simd::template Channel<8>(texels), Simd::Set(g_ByteToFloat));
+				b = Simd::Mul(Simd::template Channel<16>(texels), Simd::Set(g_ByteToFloat));
+			}
+
+			//ShadePixel on Width pixels at a time, in the same order of operations. Returns where the scalar tail starts.
+			template<typename Simd>
+			uint32_t ShadeLanes(const PixelBlock& pixels, uint32_t first, uint32_t count, const Vector3& cameraPosition, const Material& material, ColorRGB* pColors)
+			{
+				using Register = typename Simd::Register;
+
+				const auto dot = [](Register ax, Register ay, Register az, Register bx, Register by, Register bz)
+					{
+						return Simd::Add(Simd::Add(Simd::Mul(ax, bx), Simd::Mul(ay, by)), Simd::Mul(az, bz));
+					};
+
+				const Register toLightX{ Simd::Set(-g_LightDirection.x) };
+				const Register toLightY{ Simd::Set(-g_LightDirection.y) };
+				const Register toLightZ{ Simd::Set(-g_LightDirection.z) };
+				const bool isNormalMapped{ material.isNormalMapEnabled && material.pNormalMap != nullptr };
+
+				for (; first + Simd::Width <= count; first += Simd::Width)
+				{
+					const auto load = [&pixels, first](Attribute attribute) { return Simd::Load(pixels.attributes[attribute] + first); };
+
+					const Register u{ load(U) };
+					const Register v{ load(V) };
+					Register normalX{ load(NormalX) };
+					Register normalY{ load(NormalY) };
+					Register normalZ{ load(NormalZ) };
+
+					if (isNormalMapped)
+					{
+						const Register tangentX{ load(TangentX) };
+						const Register tangentY{ load(TangentY) };
+						const Register tangentZ{ load(TangentZ) };
+						const Register handedness{ load(TangentW) };
+
+						const Register binormalX{ Simd::Mul(Simd::Sub(Simd::Mul(normalY, tangentZ), Simd::Mul(normalZ, tangentY)), handedness) };
+						const Register binormalY{ Simd::Mul(Simd::Sub(Simd::Mul(normalZ, tangentX), Simd::Mul(normalX, tangentZ)), handedness) };
+						const Register binormalZ{ Simd::Mul(Simd::Sub(Simd::Mul(normalX, tangentY), Simd::Mul(normalY, tangentX)), handedness) };
+
+						Register sampledX{}, sampledY{}, sampledZ{};
+						Sample<Simd>(material.pNormalMap, u, v, sampledX, sampledY, sampledZ);
+						sampledX = Simd::Sub(Simd::Mul(Simd::Set(2.f), sampledX), Simd::Set(1.f));
+						sampledY = Simd::Sub(Simd::Mul(Simd::Set(2.f), sampledY), Simd::Set(1.f));
+						sampledZ = Simd::Sub(Simd::Mul(Simd::Set(2.f), sampledZ), Simd::Set(1.f));
+
+						const auto toWorld = [&](Register tangent, Register binormal, Register normal)
+							{
+								return Simd::Add(Simd::Add(Simd::Mul(tangent, sampledX), Simd::Mul(binormal, sampledY)), Simd::Mul(normal, sampledZ));
+							};
+
+						const Register mappedX{ toWorld(tangentX, binormalX, normalX) };
+						const Register mappedY{ toWorld(tangentY, binormalY, normalY) };
+						normalZ = toWorld(tangentZ, binormalZ, normalZ);
+						normalX = mappedX;
+						normalY = mappedY;
+					}
+
+					Register viewX{ Simd::Sub(Simd::Set(cameraPosition.x), load(WorldPositionX)) };
+					Register viewY{ Simd::Sub(Simd::Set(cameraPosition.y), load(WorldPositionY)) };
+					Register viewZ{ Simd::Sub(Simd::Set(cameraPosition.z), load(WorldPositionZ)) };
+					const Register viewLength{ Simd::Sqrt(dot(viewX, viewY, viewZ, viewX, viewY, viewZ)) };
+					viewX = Simd::Div(viewX, viewLength);
+					viewY = Simd::Div(viewY, viewLength);
+					viewZ = Simd::Div(viewZ, viewLength);
+
+					const Register normalDotLight{ dot(normalX, normalY, normalZ, toLightX, toLightY, toLightZ) };
+					const Register observedArea{ SaturateLanes<Simd>(normalDotLight) };
+
+					Register diffuseR{}, diffuseG{}, diffuseB{};
+					Sample<Simd>(material.pDiffuseMap, u, v, diffuseR, diffuseG, diffuseB);
+
+					Register glossiness{}, unusedG{}, unusedB{};
+					Sample<Simd>(material.pGlossinessMap, u, v, glossiness, unusedG, unusedB);
+					glossiness = Simd::Mul(Simd::Set(g_Shininess), glossiness);
+
+					const Register twiceDot{ Simd::Add(normalDotLight, normalDotLight) };
+					const Register reflectionX{ Simd::Sub(toLightX, Simd::Mul(twiceDot, normalX)) };
+					const Register reflectionY{ Simd::Sub(toLightY, Simd::Mul(twiceDot, normalY)) };
+					const Register reflectionZ{ Simd::Sub(toLightZ, Simd::Mul(twiceDot, normalZ)) };
+					const Register cosine{ SaturateLanes<Simd>(dot(reflectionX, reflectionY, reflectionZ, viewX, viewY, viewZ)) };
+					const Register phong{ Simd::And(Simd::Greater(cosine, Simd::Set(0.f)), Exp<Simd>(Simd::Mul(glossiness, Log<Simd>(cosine)))) };
+
+					Register specularR{}, specularG{}, specularB{};
+					Sample<Simd>(material.pSpecularMap, u, v, specularR, specularG, specularB);
+
+					const auto shade = [&](Register diffuse, Register specular)
+						{
+							const Register lambert{ Simd::Mul(diffuse, Simd::Set(1.f / PI)) };
+							return Simd::Mul(Simd::Add(Simd::Mul(Simd::Set(g_LightIntensity), lambert), Simd::Mul(specular, phong)), observedArea);
+						};
+
+					float colors[3][Simd::Width];
+					Simd::Store(colors[0], shade(diffuseR, specularR));
+					Simd::Store(colors[1], shade(diffuseG, specularG));
+					Simd::Store(colors[2], shade(diffuseB, specularB));
+
+					for (uint32_t lane{ 0 }; lane < Simd::Width; ++lane)
+						pColors[first + lane] = { colors[0][lane], colors[1][lane], colors[2][lane] };
+				}
+
+				return first;
+			}
+#endif
+		}
+
+		ColorRGB ShadePixel(const Vertex_Out& pixel, const Vector3& cameraPosition, const Material& material)
+		{
+			//No normalization of the normals, just like the effect
+			Vector3 normal{ pixel.normal };
+			if (material.isNormalMapEnabled && material.pNormalMap != nullptr)
+			{
+				const Vector3 tangent{ pixel.tangent.x, pixel.tangent.y, pixel.tangent.z };
+				const Vector3 binormal{ Vector3::Cross(pixel.normal, tangent) * pixel.tangent.w };
+
+				//Row vector times the matrix with the tangent, binormal and normal as rows
+				const ColorRGB sampled{ SampleColor(material.pNormalMap, pixel.uv) };
+				normal = tangent * (2.f * sampled.r - 1.f) + binormal * (2.f * sampled.g - 1.f) + pixel.normal * (2.f * sampled.b - 1.f);
+			}
+
+			const Vector3 viewDirection{ (cameraPosition - pixel.worldPosition).Normalized() };
+			const float observedArea{ Saturate(Vector3::Dot(normal, -g_LightDirection)) };
+
+			//Lambert with kd = 1, Phong with ks = 1
+			const ColorRGB lambert{ SampleColor(material.pDiffuseMap, pixel.uv) * (1.f / PI) };
+			const float glossiness{ g_Shininess * SampleColor(material.pGlossinessMap, pixel.uv).r };
+
+			const Vector3 reflection{ Vector3::Reflect(-g_LightDirection, normal) };
+			const float cosine{ Saturate(Vector3::Dot(reflection, viewDirection)) };
+			const float phong{ cosine > 0.f ? std::pow(cosine, glossiness) : 0.f };
+			const ColorRGB specular{ SampleColor(material.pSpecularMap, pixel.uv) * phong };
+
+			return (g_LightIntensity * lambert + specular) * observedArea;
+		}
+
+		void ShadeBlock(const PixelBlock& pixels, uint32_t count, const Vector3& cameraPosition, const Material& material, ColorRGB* pColors)
+		{
+			assert(count <= BlockWidth && "ERROR: More pixels than a block holds");
+
+			uint32_t i{ 0 };
+#ifdef DAE_SHADING_AVX2
+			i = ShadeLanes<Avx2>(pixels, i, count, cameraPosition, material, pColors);
+#endif
+#ifdef DAE_SHADING_SSE
+			i = ShadeLanes<Sse>(pixels, i, count, cameraPosition, material, pColors);
+#endif
+
+			for (; i < count; ++i)
+				pColors[i] = ShadePixel(GetPixel(pixels, i), cameraPosition, material);
+		}
+	}
+}
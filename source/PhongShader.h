@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include "DataTypes.h"
+
+namespace dae
+{
+	class SoftwareTexture;
+
+	//CPU port of PS_Phong in PosCol3D.fx, with its globals and the point sampler of the default technique.
+	//ShadePixel is the plain version of the shader, ShadeBlock runs the same math on the pixels of a block 8 at a time with AVX2 (4 with SSE2).
+	namespace PhongShader
+	{
+		constexpr uint32_t BlockWidth{ 8 };
+
+		//The maps of the effect, a missing one samples as white. Without a normal map the interpolated normal is used, like with g_NormalMapEnabled off.
+		struct Material
+		{
+			const SoftwareTexture* pDiffuseMap{};
+			const SoftwareTexture* pNormalMap{};
+			const SoftwareTexture* pSpecularMap{};
+			const SoftwareTexture* pGlossinessMap{};
+			bool isNormalMapEnabled{ true };
+		};
+
+		//Vertex_Out without the position, the rows of a PixelBlock
+		enum Attribute
+		{
+			WorldPositionX, WorldPositionY, WorldPositionZ,
+			U, V,
+			NormalX, NormalY, NormalZ,
+			TangentX, TangentY, TangentZ, TangentW,
+			AttributeCount
+		};
+
+		//The interpolated shader inputs of BlockWidth pixels as structure of arrays
+		struct PixelBlock
+		{
+			alignas(32) float attributes[AttributeCount][BlockWidth];
+		};
+
+		ColorRGB ShadePixel(const Vertex_Out& pixel, const Vector3& cameraPosition, const Material& material);
+
+		//The first count pixels of the block, count <= BlockWidth
+		void ShadeBlock(const PixelBlock& pixels, uint32_t count, const Vector3& cameraPosition, const Material& material, ColorRGB* pColors);
+	}
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include <cmath>
+#include "Vector3.h"
+#include "Vector4.h"
+#include "Matrix.h"
+
+namespace dae
+{
+	//Unit quaternion rotation, xyz is the axis scaled by sin(angle / 2) and w is cos(angle / 2).
+	//Products compose like the row vector matrices of this library: a * b rotates by a first and then by b,
+	//so (a * b).ToMatrix() equals a.ToMatrix() * b.ToMatrix().
+	struct Quaternion
+	{
+		float x{};
+		float y{};
+		float z{};
+		float w{ 1.f };
+
+		constexpr Quaternion() noexcept = default;
+		constexpr Quaternion(float _x, float _y, float _z, float _w) noexcept;
+
+		//Same rotations as Matrix::CreateRotationX/Y/Z, including the sign Matrix::CreateRotationX uses for pitch
+		static Quaternion CreateRotationX(float pitch) noexcept;
+		static Quaternion CreateRotationY(float yaw) noexcept;
+		static Quaternion CreateRotationZ(float roll) noexcept;
+		static Quaternion CreateRotation(const Vector3& r) noexcept;
+		static Quaternion CreateFromAxisAngle(const Vector3& axis, float angle) noexcept;
+
+		float Magnitude() const noexcept;
+		constexpr float SqrMagnitude() const noexcept;
+		float Normalize() noexcept;
+		Quaternion Normalized() const noexcept;
+		constexpr Quaternion Conjugate() const noexcept;
+
+		static constexpr float Dot(const Quaternion& q1, const Quaternion& q2) noexcept;
+
+		//Row vector convention, the same result as ToMatrix().TransformVector(v)
+		constexpr Vector3 Rotate(const Vector3& v) const noexcept;
+		constexpr Matrix ToMatrix() const noexcept;
+
+		constexpr Quaternion operator*(const Quaternion& q) const noexcept;
+		constexpr Quaternion& operator*=(const Quaternion& q) noexcept;
+
+		static const Quaternion Identity;
+	};
+
+	constexpr Quaternion::Quaternion(float _x, float _y, float _z, float _w) noexcept : x(_x), y(_y), z(_z), w(_w) {}
+
+	inline Quaternion Quaternion::CreateFromAxisAngle(const Vector3& axis, float angle) noexcept
+	{
+		const Vector3 unitAxis{ axis.Normalized() };
+		const float halfSin{ sinf(angle * 0.5f) };
+		return { unitAxis.x * halfSin, unitAxis.y * halfSin, unitAxis.z * halfSin, cosf(angle * 0.5f) };
+	}
+
+	inline Quaternion Quaternion::CreateRotationX(float pitch) noexcept
+	{
+		return { -sinf(pitch * 0.5f), 0.f, 0.f, cosf(pitch * 0.5f) };
+	}
+
+	inline Quaternion Quaternion::CreateRotationY(float yaw) noexcept
+	{
+		return { 0.f, sinf(yaw * 0.5f), 0.f, cosf(yaw * 0.5f) };
+	}
+
+	inline Quaternion Quaternion::CreateRotationZ(float roll) noexcept
+	{
+		return { 0.f, 0.f, sinf(roll * 0.5f), cosf(roll * 0.5f) };
+	}
+
+	inline Quaternion Quaternion::CreateRotation(const Vector3& r) noexcept
+	{
+		//Matches Matrix::CreateRotation: X, then Y, then Z
+		return CreateRotationX(r.x) * CreateRotationY(r.y) * CreateRotationZ(r.z);
+	}
+
+	inline float Quaternion::Magnitude() const noexcept
+	{
+		return sqrtf(SqrMagnitude());
+	}
+
+	constexpr float Quaternion::SqrMagnitude() const noexcept
+	{
+		return x * x + y * y + z * z + w * w;
+	}
+
+	inline float Quaternion::Normalize() noexcept
+	{
+		const float m = Magnitude();
+		x /= m;
+		y /= m;
+		z /= m;
+		w /= m;
+
+		return m;
+	}
+
+	inline Quaternion Quaternion::Normalized() const noexcept
+	{
+		const float m = Magnitude();
+		return { x / m, y / m, z / m, w / m };
+	}
+
+	constexpr Quaternion Quaternion::Conjugate() const noexcept
+	{
+		return { -x, -y, -z, w };
+	}
+
+	constexpr float Quaternion::Dot(const Quaternion& q1, const Quaternion& q2) noexcept
+	{
+		return q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+	}
+
+	constexpr Vector3 Quaternion::Rotate(const Vector3& v) const noexcept
+	{
+		//v + 2w(u x v) + 2u x (u x v), in the cheaper form with t = 2(u x v)
+		const Vector3 u{ x, y, z };
+		const Vector3 t{ Vector3::Cross(u, v) * 2.f };
+		return v + t * w + Vector3::Cross(u, t);
+	}
+
+	constexpr Matrix Quaternion::ToMatrix() const noexcept
+	{
+		const float xx{ x * x }, yy{ y * y }, zz{ z * z };
+		const float xy{ x * y }, xz{ x * z }, yz{ y * z };
+		const float wx{ w * x }, wy{ w * y }, wz{ w * z };
+
+		return {
+			Vector3{ 1.f - 2.f * (yy + zz), 2.f * (xy + wz), 2.f * (xz - wy) },
+			Vector3{ 2.f * (xy - wz), 1.f - 2.f * (xx + zz), 2.f * (yz + wx) },
+			Vector3{ 2.f * (xz + wy), 2.f * (yz - wx), 1.f - 2.f * (xx + yy) },
+			Vector3::Zero };
+	}
+
+#pragma region Operator Overloads
+	constexpr Quaternion Quaternion::operator*(const Quaternion& q) const noexcept
+	{
+		//Hamilton product q * this, applying this rotation first
+		return {
+			q.w * x + q.x * w + q.y * z - q.z * y,
+			q.w * y - q.x * z + q.y * w + q.z * x,
+			q.w * z + q.x * y - q.y * x + q.z * w,
+			q.w * w - q.x * x - q.y * y - q.z * z };
+	}
+
+	constexpr Quaternion& Quaternion::operator*=(const Quaternion& q) noexcept
+	{
+		*this = *this * q;
+		return *this;
+	}
+#pragma endregion
+
+	inline constexpr Quaternion Quaternion::Identity{ 0.f, 0.f, 0.f, 1.f };
+}
@@ -75,11 +75,29 @@ namespace dae
 			}
 		}
 
-		for (const auto& mesh : m_Meshes)
+		CullMeshes();
+
+		for (uint32_t meshIndex : m_VisibleMeshes)
+		{
+			m_Meshes[meshIndex]->SetMatrix(*m_pCamera, m_Height);
+			m_Meshes[meshIndex]->SetWorldMatrix();
+		}
+	}
+
+	void Renderer::CullMeshes()
+	{
+		m_MeshBounds.Resize(m_Meshes.size());
+		for (size_t i{ 0 }; i < m_Meshes.size(); ++i)
 		{
-			mesh->SetMatrix(*m_pCamera);
-			mesh->SetWorldMatrix();
+			m_MeshBounds.SetSphere(i, m_Meshes[i]->GetWorldBoundingSphere());
+			m_MeshBounds.SetBox(i, m_Meshes[i]->GetWorldBounds());
 		}
+
+		//World space planes, culled when either the sphere or the box is outside
+		const Frustum frustum{ Frustum::FromMatrix(m_pCamera->viewMatrix * m_pCamera->projectionMatrix) };
+
+		m_VisibleMeshes.resize(m_Meshes.size());
+		m_VisibleMeshes.resize(frustum.Cull(m_MeshBounds, m_VisibleMeshes.data()));
 	}
 
 	void Renderer::Render() const
@@ -91,9 +109,9 @@ namespace dae
 		m_pDeviceContext->ClearRenderTargetView(m_pRenderTargetView, color);
 		m_pDeviceContext->ClearDepthStencilView(m_pDepthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
 
-		for (const auto& mesh : m_Meshes)
+		for (uint32_t meshIndex : m_VisibleMeshes)
 		{
-			mesh->Draw(m_pDeviceContext);
+			m_Meshes[meshIndex]->Draw(m_pDeviceContext);
 		}
 		
 		m_pSwapChain->Present(0, 0);
@@ -115,6 +133,44 @@ namespace dae
 		}
 	}
 
+	void Renderer::ToggleMeshletCulling()
+	{
+		for (const auto& mesh : m_Meshes)
+		{
+			mesh->ToggleMeshletCulling();
+		}
+
+		const bool isEnabled{ !m_Meshes.empty() && m_Meshes.front()->IsMeshletCullingEnabled() };
+		std::cout << YELLOW_TEXT("Meshlet culling is ") << (isEnabled ? GREEN_TEXT("enabled.\n") : RED_TEXT("disabled.\n"));
+	}
+
+	void Renderer::PrintDrawStatistics() const
+	{
+		std::cout << m_VisibleMeshes.size() << "/" << m_Meshes.size() << " meshes visible, ";
+
+		Meshlets::CullingStatistics total{};
+		for (uint32_t meshIndex : m_VisibleMeshes)
+		{
+			const Mesh* mesh{ m_Meshes[meshIndex] };
+			std::cout << "LOD " << mesh->GetCurrentLod() << " (" << mesh->GetLodTriangleCount(mesh->GetCurrentLod()) << " triangles) ";
+
+			const Meshlets::CullingStatistics& statistics{ mesh->GetCullingStatistics() };
+			total.meshletCount += statistics.meshletCount;
+			total.culledMeshletCount += statistics.culledMeshletCount;
+			total.triangleCount += statistics.triangleCount;
+			total.culledTriangleCount += statistics.culledTriangleCount;
+		}
+
+		if (total.triangleCount == 0)
+		{
+			std::cout << "\n";
+			return;
+		}
+
+		std::cout << "culled " << total.culledMeshletCount << "/" << total.meshletCount << " meshlets, "
+			<< 100.0 * static_cast<double>(total.culledTriangleCount) / static_cast<double>(total.triangleCount) << "% of the triangles\n";
+	}
+
 	void Renderer::StartFastRotation()
 	{
 		m_CurrentRotationSpeed = m_MeshFastRotationSpeed;
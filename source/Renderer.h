@@ -1,4 +1,5 @@
 #pragma once
+#include "Frustum.h"
 
 namespace dae
 {
@@ -18,6 +19,8 @@ namespace dae
 		inline void ToggleRotation() { m_EnableRotating = !m_EnableRotating; }
 		void CycleFilteringMethods();
 		void ToggleNormalMap();
+		void ToggleMeshletCulling();
+		void PrintDrawStatistics() const;
 		void StartFastRotation();
 		void StopFastRotation();
 
@@ -35,6 +38,10 @@ namespace dae
 		class Effect* m_pEffect{ nullptr };
 
 		std::vector<class Mesh*> m_Meshes{};
+
+		//World space bounds of every mesh, culled against the camera in Update. Only the meshes in m_VisibleMeshes are set up and drawn.
+		CullingBounds m_MeshBounds{};
+		std::vector<uint32_t> m_VisibleMeshes{};
 		
 		float m_CurrentRotationSpeed{ m_MeshRotationSpeed };
 		bool m_EnableRotating{ true };
@@ -48,6 +55,7 @@ namespace dae
 		ID3D11Resource* m_pRenderTargetBuffer;
 		ID3D11RenderTargetView* m_pRenderTargetView;
 
+		void CullMeshes();
 		HRESULT InitializeDirectX();
 		//...
 	};
@@ -16,6 +16,10 @@ float g_Shininess = 25.0f;
 
 float PI = float(3.14159265f);
 
+//Maps the unorm positions of packed vertices back to the mesh bounds
+float3 g_PositionOffset = float3(0.0f, 0.0f, 0.0f);
+float3 g_PositionScale = float3(1.0f, 1.0f, 1.0f);
+
 SamplerState g_SampleStatePoint : SampleState
 {
     Filter = MIN_MAG_MIP_POINT;
@@ -49,7 +53,16 @@ struct VS_INPUT
 	float3 position : POSITION;
 	float2 UV : TEXCOORD;
 	float3 normal : NORMAL;
-	float3 tangent : TANGENT;
+	float4 tangent : TANGENT;	//w is the handedness of the bitangent
+};
+
+//Mirrors PackedVertex, see VertexFormat.cpp
+struct VS_PACKED_INPUT
+{
+	float4 position : POSITION;	//xyz relative to the mesh bounds, w is the bitangent handedness (0 or 1)
+	float2 UV : TEXCOORD;
+	float2 normal : NORMAL;		//Octahedral
+	float2 tangent : TANGENT;	//Octahedral
 };
 
 struct VS_OUTPUT
@@ -58,7 +71,7 @@ struct VS_OUTPUT
 	float4 worldPosition : TEXCOORD0;
 	float2 UV : TEXCOORD1;
 	float3 normal : NORMAL;
-	float3 tangent : TANGENT;
+	float4 tangent : TANGENT;
 };
 
 //Vertex Shader
@@ -69,10 +82,28 @@ VS_OUTPUT VS(VS_INPUT input)
 	output.position = mul(output.position, g_WorldViewProjection);
 	output.UV = input.UV;
 	output.normal = mul(normalize(input.normal), (float3x3)g_WorldMatrix);
-	output.tangent = mul(normalize(input.tangent), (float3x3)g_WorldMatrix);
+	output.tangent = float4(mul(normalize(input.tangent.xyz), (float3x3)g_WorldMatrix), input.tangent.w);
 	return output;
 }
 
+float3 DecodeOctahedral(float2 encoded)
+{
+	float3 direction = float3(encoded.xy, 1.0f - abs(encoded.x) - abs(encoded.y));
+	const float fold = saturate(-direction.z);
+	direction.xy += (direction.xy >= 0.0f) ? -fold : fold;
+	return normalize(direction);
+}
+
+VS_OUTPUT VS_Packed(VS_PACKED_INPUT input)
+{
+	VS_INPUT unpacked;
+	unpacked.position = g_PositionOffset + input.position.xyz * g_PositionScale;
+	unpacked.UV = input.UV;
+	unpacked.normal = DecodeOctahedral(input.normal);
+	unpacked.tangent = float4(DecodeOctahedral(input.tangent), input.position.w * 2.0f - 1.0f);
+	return VS(unpacked);
+}
+
 float4 Lambert(float kd, float4 cd)
 {
 	return float4((cd * kd) / PI);
@@ -95,9 +126,9 @@ float Phong(float ks, float exp, float3 light, float3 viewDirection, float3 norm
 //Pixel Shader
 float4 PS_Phong(VS_OUTPUT input, SamplerState samplerState) : SV_TARGET
 {
-	const float3 binormal = cross(input.normal, input.tangent);
+	const float3 binormal = cross(input.normal, input.tangent.xyz) * input.tangent.w;
 	const float4 zeroVector = float4(0.0f, 0.0f, 0.0f, 1.0f);
-	const float4x4 tangentSpaceAxis = float4x4( float4(input.tangent, 0.0f), float4(binormal, 0.0f), float4(input.normal, 0.0f), zeroVector );
+	const float4x4 tangentSpaceAxis = float4x4( float4(input.tangent.xyz, 0.0f), float4(binormal, 0.0f), float4(input.normal, 0.0f), zeroVector );
 
 	float3 sampledNormal = (2.0f * g_NormalMap.Sample(samplerState, input.UV).rgb - float3(1.0f, 1.0f, 1.0f));
 	float4 normal;
@@ -174,6 +205,39 @@ technique11 AnisotropicFilteringTechnique
 	}
 }
 
+technique11 PointFilteringPackedTechnique
+{
+	pass p0
+	{
+		SetRasterizerState(g_RasterizerState);
+		SetVertexShader(CompileShader(vs_5_0, VS_Packed()));
+		SetGeometryShader(NULL);
+		SetPixelShader(CompileShader(ps_5_0, PS_Point()));
+	}
+}
+
+technique11 LinearFilteringPackedTechnique
+{
+	pass p0
+	{
+		SetRasterizerState(g_RasterizerState);
+		SetVertexShader(CompileShader(vs_5_0, VS_Packed()));
+		SetGeometryShader(NULL);
+		SetPixelShader(CompileShader(ps_5_0, PS_Linear()));
+	}
+}
+
+technique11 AnisotropicFilteringPackedTechnique
+{
+	pass p0
+	{
+		SetRasterizerState(g_RasterizerState);
+		SetVertexShader(CompileShader(vs_5_0, VS_Packed()));
+		SetGeometryShader(NULL);
+		SetPixelShader(CompileShader(ps_5_0, PS_Anisotropic()));
+	}
+}
+
 /*technique11 DefaultTechnique
 {
 	pass p0
@@ -0,0 +1,940 @@
+#include "pch.h"
+#include "SoftwareRasterizer.h"
+#include "Frustum.h"
+#include "ImageWriter.h"
+#include "PhongShader.h"
+#include "Parallel.h"
+#include <bit>
+
+//Follows the Matrix backend like BatchTransform. The integer edge functions need SSE2, which every x64 target has,
+//and blocks of 8 pixels need AVX2 (/arch:AVX2).
+#if defined(DAE_MATRIX_SSE) && (defined(_M_X64) || defined(__SSE2__))
+#define DAE_RASTER_SSE
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#define DAE_RASTER_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+namespace dae
+{
+	namespace
+	{
+		//A triangle clipped against all six planes has at most one more vertex per plane
+		constexpr int g_MaxClippedVertexCount{ 3 + Frustum::PlaneCount };
+
+		//Signed distances to the planes of the clip volume, -w <= x <= w, -w <= y <= w and 0 <= z <= w, in the order of Frustum::Plane
+		float GetClipDistance(const Vector4& position, int plane)
+		{
+			switch (plane)
+			{
+			case Frustum::Left: return position.w + position.x;
+			case Frustum::Right: return position.w - position.x;
+			case Frustum::Bottom: return position.w + position.y;
+			case Frustum::Top: return position.w - position.y;
+			case Frustum::Near: return position.z;
+			default: return position.w - position.z;
+			}
+		}
+
+		//One bit per plane the position is outside of
+		uint32_t GetOutCode(const Vector4& position)
+		{
+			uint32_t outCode{ 0 };
+			for (int plane{ 0 }; plane < Frustum::PlaneCount; ++plane)
+			{
+				if (GetClipDistance(position, plane) < 0.f)
+					outCode |= 1u << plane;
+			}
+
+			return outCode;
+		}
+
+		Vertex_Out Lerp(const Vertex_Out& a, const Vertex_Out& b, float t)
+		{
+			Vertex_Out result{};
+			result.position = a.position + (b.position - a.position) * t;
+			result.worldPosition = a.worldPosition + (b.worldPosition - a.worldPosition) * t;
+			result.uv = a.uv + (b.uv - a.uv) * t;
+			result.normal = a.normal + (b.normal - a.normal) * t;
+			result.tangent = a.tangent + (b.tangent - a.tangent) * t;
+			return result;
+		}
+
+		//Sutherland-Hodgman against every plane in outCode, in clip space where the attributes are still linear
+		int ClipPolygon(Vertex_Out* pPolygon, int vertexCount, uint32_t outCode, Vertex_Out* pScratch)
+		{
+			Vertex_Out* pSource{ pPolygon };
+			Vertex_Out* pDestination{ pScratch };
+
+			for (int plane{ 0 }; plane < Frustum::PlaneCount && vertexCount > 0; ++plane)
+			{
+				if ((outCode & (1u << plane)) == 0)
+					continue;
+
+				int clippedCount{ 0 };
+				for (int i{ 0 }; i < vertexCount; ++i)
+				{
+					const Vertex_Out& current{ pSource[i] };
+					const Vertex_Out& next{ pSource[(i + 1) % vertexCount] };
+					const float currentDistance{ GetClipDistance(current.position, plane) };
+					const float nextDistance{ GetClipDistance(next.position, plane) };
+
+					if (currentDistance >= 0.f)
+						pDestination[clippedCount++] = current;
+
+					if ((currentDistance >= 0.f) != (nextDistance >= 0.f))
+						pDestination[clippedCount++] = Lerp(current, next, currentDistance / (currentDistance - nextDistance));
+				}
+
+				std::swap(pSource, pDestination);
+				vertexCount = clippedCount;
+			}
+
+			if (pSource != pPolygon)
+				std::copy(pSource, pSource + vertexCount, pPolygon);
+
+			return vertexCount;
+		}
+
+		//x and y in pixels, z / w and 1 / w
+		Vector4 ToScreen(const Vector4& position, float width, float height)
+		{
+			const float inverseW{ 1.f / position.w };
+			return {
+				(position.x * inverseW + 1.f) * 0.5f * width,
+				(1.f - position.y * inverseW) * 0.5f * height,
+				position.z * inverseW,
+				inverseW };
+		}
+
+		//Vertices snap to 1/16 of a pixel. The edge functions of an edge crossing a tile then stay far inside 32 bits for any framebuffer size.
+		constexpr int g_SubpixelBits{ 4 };
+		constexpr int g_SubpixelSteps{ 1 << g_SubpixelBits };
+
+		int Snap(float value)
+		{
+			return static_cast<int>(std::lround(value * g_SubpixelSteps));
+		}
+
+		//Top-left fill rule for triangles with a positive area: samples exactly on an edge belong to the triangle when it is a top or a left edge
+		bool IsTopLeft(int ax, int ay, int bx, int by)
+		{
+			return by < ay || (by == ay && bx > ax);
+		}
+
+		void GetAttributes(const Vertex_Out& vertex, float* pAttributes)
+		{
+			using namespace PhongShader;
+			pAttributes[WorldPositionX] = vertex.worldPosition.x;
+			pAttributes[WorldPositionY] = vertex.worldPosition.y;
+			pAttributes[WorldPositionZ] = vertex.worldPosition.z;
+			pAttributes[U] = vertex.uv.x;
+			pAttributes[V] = vertex.uv.y;
+			pAttributes[NormalX] = vertex.normal.x;
+			pAttributes[NormalY] = vertex.normal.y;
+			pAttributes[NormalZ] = vertex.normal.z;
+			pAttributes[TangentX] = vertex.tangent.x;
+			pAttributes[TangentY] = vertex.tangent.y;
+			pAttributes[TangentZ] = vertex.tangent.z;
+			pAttributes[TangentW] = vertex.tangent.w;
+		}
+
+		//Attributes as a0 + (a1 - a0) * p1 + (a2 - a0) * p2, with p the perspective correct barycentrics of vertex 1 and 2
+		void GetAttributes(const Vertex_Out& vertex0, const Vertex_Out& vertex1, const Vertex_Out& vertex2, float* pBase, float* pDelta1, float* pDelta2)
+		{
+			GetAttributes(vertex0, pBase);
+			GetAttributes(vertex1, pDelta1);
+			GetAttributes(vertex2, pDelta2);
+			for (int a{ 0 }; a < PhongShader::AttributeCount; ++a)
+			{
+				pDelta1[a] -= pBase[a];
+				pDelta2[a] -= pBase[a];
+			}
+		}
+
+		//A row of Width pixels. Masks hold one bit per lane, the first lane in the lowest bit.
+		struct Scalar
+		{
+			using Int = int32_t;
+			using Float = float;
+			static constexpr int Width{ 1 };
+
+			static Int SetInt(int32_t value) { return value; }
+			static Int RampInt(int32_t) { return 0; }
+			static Int AddInt(Int a, Int b) { return a + b; }
+			static uint32_t NegativeMask(Int a, Int b, Int c) { return (a | b | c) < 0 ? 1u : 0u; }
+
+			static Float Load(const float* p) { return *p; }
+			static void Store(float* p, Float value) { *p = value; }
+			static Float Set(float value) { return value; }
+			static Float Ramp(float) { return 0.f; }
+			static Float Add(Float a, Float b) { return a + b; }
+			static Float Mul(Float a, Float b) { return a * b; }
+			static Float Div(Float a, Float b) { return a / b; }
+			static Float Min(Float a, Float b) { return std::min(a, b); }
+			static Float Max(Float a, Float b) { return std::max(a, b); }
+			static uint32_t LessMask(Float a, Float b) { return a < b ? 1u : 0u; }
+			static uint32_t EqualMask(Float a, Float b) { return a == b ? 1u : 0u; }
+		};
+
+#ifdef DAE_RASTER_SSE
+		struct Sse
+		{
+			using Int = __m128i;
+			using Float = __m128;
+			static constexpr int Width{ 4 };
+
+			static Int SetInt(int32_t value) { return _mm_set1_epi32(value); }
+			static Int RampInt(int32_t step) { return _mm_set_epi32(3 * step, 2 * step, step, 0); }
+			static Int AddInt(Int a, Int b) { return _mm_add_epi32(a, b); }
+			static uint32_t NegativeMask(Int a, Int b, Int c) { return _mm_movemask_ps(_mm_castsi128_ps(_mm_or_si128(_mm_or_si128(a, b), c))); }
+
+			static Float Load(const float* p) { return _mm_loadu_ps(p); }
+			static void Store(float* p, Float value) { _mm_storeu_ps(p, value); }
+			static Float Set(float value) { return _mm_set1_ps(value); }
+			static Float Ramp(float step) { return _mm_set_ps(3.f * step, 2.f * step, step, 0.f); }
+			static Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+			static Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+			static Float Div(Float a, Float b) { return _mm_div_ps(a, b); }
+			static Float Min(Float a, Float b) { return _mm_min_ps(a, b); }
+			static Float Max(Float a, Float b) { return _mm_max_ps(a, b); }
+			static uint32_t LessMask(Float a, Float b) { return _mm_movemask_ps(_mm_cmplt_ps(a, b)); }
+			static uint32_t EqualMask(Float a, Float b) { return _mm_movemask_ps(_mm_cmpeq_ps(a, b)); }
+		};
+#endif
+
+#ifdef DAE_RASTER_AVX2
+		struct Avx2
+		{
+			using Int = __m256i;
+			using Float = __m256;
+			static constexpr int Width{ 8 };
+
+			static Int SetInt(int32_t value) { return _mm256_set1_epi32(value); }
+			static Int RampInt(int32_t step) { return _mm256_mullo_epi32(_mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0), _mm256_set1_epi32(step)); }
+			static Int AddInt(Int a, Int b) { return _mm256_add_epi32(a, b); }
+			static uint32_t NegativeMask(Int a, Int b, Int c) { return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_or_si256(_mm256_or_si256(a, b), c))); }
+
+			static Float Load(const float* p) { return _mm256_loadu_ps(p); }
+			static void Store(float* p, Float value) { _mm256_storeu_ps(p, value); }
+			static Float Set(float value) { return _mm256_set1_ps(value); }
+			static Float Ramp(float step) { return _mm256_mul_ps(_mm256_set_ps(7.f, 6.f, 5.f, 4.f, 3.f, 2.f, 1.f, 0.f), _mm256_set1_ps(step)); }
+			static Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+			static Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+			static Float Div(Float a, Float b) { return _mm256_div_ps(a, b); }
+			static Float Min(Float a, Float b) { return _mm256_min_ps(a, b); }
+			static Float Max(Float a, Float b) { return _mm256_max_ps(a, b); }
+			static uint32_t LessMask(Float a, Float b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ)); }
+			static uint32_t EqualMask(Float a, Float b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); }
+		};
+#endif
+
+#if defined(DAE_RASTER_AVX2)
+		using Simd = Avx2;
+#elif defined(DAE_RASTER_SSE)
+		using Simd = Sse;
+#else
+		using Simd = Scalar;
+#endif
+
+		static_assert(SoftwareRasterizer::TileSize % Simd::Width == 0, "Blocks must not cross tiles");
+		static_assert(Simd::Width <= PhongShader::BlockWidth, "Blocks must fit in a PixelBlock");
+
+		//The first level of the depth bounds, the tile itself is the second
+		constexpr int g_HiZBlockSize{ 8 };
+		constexpr int g_HiZBlocksPerRow{ static_cast<int>(SoftwareRasterizer::TileSize) / g_HiZBlockSize };
+		constexpr int g_HiZBlockCount{ g_HiZBlocksPerRow * g_HiZBlocksPerRow };
+		static_assert(g_HiZBlockSize % Simd::Width == 0, "Blocks must not cross 8x8 blocks");
+		static_assert(SoftwareRasterizer::TileSize <= 64, "A row of the tile must fit in a uint64_t mask");
+
+		//Pixels of the visibility buffer that no triangle covers
+		constexpr uint32_t g_NoTriangle{ UINT32_MAX };
+
+		//Bounds of the depth plane are computed differently than its samples, this keeps a few bits of rounding on the safe side
+		constexpr float g_DepthBoundMargin{ 1e-5f };
+	}
+
+	struct SoftwareRasterizer::Tile
+	{
+		int minX{};
+		int minY{};
+		int width{};
+		int height{};
+
+		uint32_t colors[TileSize * TileSize];
+		float depths[TileSize * TileSize];
+
+		//Nearest and farthest depth of every 8x8 block and of the whole tile, the pixels outside the framebuffer count as 0
+		float blockMinDepths[g_HiZBlockCount]{};
+		float blockMaxDepths[g_HiZBlockCount]{};
+		float minDepth{};
+		float maxDepth{};
+		bool isMaxDepthStale{ false };
+
+		//The nearest triangle of every pixel with the visibility buffer, next to its depth in depths
+		uint32_t triangles[TileSize * TileSize];
+
+		//One bit per pixel the color pass of a depth pre-pass already shaded, so equal depths keep the first triangle like the depth test does
+		uint64_t shadedRows[TileSize];
+
+		void UpdateBlockDepths(int block)
+		{
+			const float* pDepths{ depths + (block / g_HiZBlocksPerRow) * g_HiZBlockSize * TileSize + (block % g_HiZBlocksPerRow) * g_HiZBlockSize };
+			Simd::Float nearest{ Simd::Load(pDepths) };
+			Simd::Float farthest{ nearest };
+			for (int y{ 0 }; y < g_HiZBlockSize; ++y)
+			{
+				for (int x{ 0 }; x < g_HiZBlockSize; x += Simd::Width)
+				{
+					const Simd::Float value{ Simd::Load(pDepths + y * TileSize + x) };
+					nearest = Simd::Min(nearest, value);
+					farthest = Simd::Max(farthest, value);
+				}
+			}
+
+			alignas(32) float nearestLanes[Simd::Width];
+			alignas(32) float farthestLanes[Simd::Width];
+			Simd::Store(nearestLanes, nearest);
+			Simd::Store(farthestLanes, farthest);
+			const float previousMaxDepth{ blockMaxDepths[block] };
+			blockMinDepths[block] = *std::min_element(nearestLanes, nearestLanes + Simd::Width);
+			blockMaxDepths[block] = *std::max_element(farthestLanes, farthestLanes + Simd::Width);
+
+			//Depths only get nearer, so the tile only has to look at all of its blocks again when the farthest one moved
+			minDepth = std::min(minDepth, blockMinDepths[block]);
+			isMaxDepthStale |= previousMaxDepth == maxDepth && blockMaxDepths[block] != maxDepth;
+		}
+
+		void UpdateDepths()
+		{
+			minDepth = *std::min_element(blockMinDepths, blockMinDepths + g_HiZBlockCount);
+			maxDepth = *std::max_element(blockMaxDepths, blockMaxDepths + g_HiZBlockCount);
+			isMaxDepthStale = false;
+		}
+	};
+
+	void Framebuffer::Resize(uint32_t newWidth, uint32_t newHeight)
+	{
+		width = newWidth;
+		height = newHeight;
+		colors.resize(size_t(width) * height);
+		depths.resize(size_t(width) * height);
+	}
+
+	void Framebuffer::Clear(const ColorRGB& color, float depth)
+	{
+		std::fill(colors.begin(), colors.end(), ToRGBA(color));
+		std::fill(depths.begin(), depths.end(), depth);
+	}
+
+	bool Framebuffer::Write(const std::string& path) const
+	{
+		return ImageWriter::Write(path, colors.data(), width, height);
+	}
+
+	uint32_t Framebuffer::ToRGBA(const ColorRGB& color)
+	{
+		const auto toByte = [](float value) { return static_cast<uint32_t>(Saturate(value) * 255.f + 0.5f); };
+		return toByte(color.r) | (toByte(color.g) << 8) | (toByte(color.b) << 16) | 0xFF000000u;
+	}
+
+	SoftwareRasterizer::SoftwareRasterizer(uint32_t width, uint32_t height, uint32_t threadCount)
+		: m_ThreadCount{ threadCount }
+		, m_TileCountX{ (width + TileSize - 1) / TileSize }
+		, m_TileCountY{ (height + TileSize - 1) / TileSize }
+	{
+		m_Framebuffer.Resize(width, height);
+		m_TileBins.resize(size_t(m_TileCountX) * m_TileCountY);
+		m_TileStatistics.resize(m_TileBins.size());
+	}
+
+	void SoftwareRasterizer::Clear(const ColorRGB& color)
+	{
+		m_Framebuffer.Clear(color);
+		m_Statistics = {};
+
+		m_Vertices.clear();
+		m_ScreenPositions.clear();
+		m_DrawStates.clear();
+		m_Triangles.clear();
+		for (std::vector<uint32_t>& bin : m_TileBins)
+			bin.clear();
+	}
+
+	void SoftwareRasterizer::Draw(const Vertex* pVertices, size_t vertexCount, const uint32_t* pIndices, size_t indexCount, PrimitiveTopology topology,
+		const Matrix& worldMatrix, const Matrix& viewProjectionMatrix)
+	{
+		//Vertex stage, VS in PosCol3D.fx. That one never writes worldPosition, the pixel stage needs it for the view direction.
+		const Matrix worldViewProjectionMatrix{ worldMatrix * viewProjectionMatrix };
+		const float width{ static_cast<float>(m_Framebuffer.width) };
+		const float height{ static_cast<float>(m_Framebuffer.height) };
+
+		m_DrawStates.push_back({ m_Material, m_CameraPosition });
+
+		const uint32_t firstVertex{ static_cast<uint32_t>(m_Vertices.size()) };
+		m_Vertices.resize(firstVertex + vertexCount);
+		m_ScreenPositions.resize(firstVertex + vertexCount);
+
+		for (size_t i{ 0 }; i < vertexCount; ++i)
+		{
+			const Vertex& vertex{ pVertices[i] };
+			Vertex_Out& out{ m_Vertices[firstVertex + i] };
+
+			out.position = worldViewProjectionMatrix.TransformPoint(Vector4{ vertex.position, 1.f });
+			out.worldPosition = worldMatrix.TransformPoint(vertex.position);
+			out.uv = vertex.uv;
+			out.normal = worldMatrix.TransformVector(vertex.normal.Normalized());
+			out.tangent = Vector4{ worldMatrix.TransformVector(Vector3{ vertex.tangent }.Normalized()), vertex.tangent.w };
+
+			//Meaningless behind the camera, but those vertices only end up in triangles that are clipped
+			m_ScreenPositions[firstVertex + i] = ToScreen(out.position, width, height);
+		}
+
+		//Primitive assembly
+		if (topology == PrimitiveTopology::TriangleList)
+		{
+			for (size_t i{ 0 }; i + 2 < indexCount; i += 3)
+				AddTriangle(firstVertex + pIndices[i], firstVertex + pIndices[i + 1], firstVertex + pIndices[i + 2]);
+
+			return;
+		}
+
+		for (size_t i{ 0 }; i + 2 < indexCount; ++i)
+		{
+			//Repeated indices restart a strip, and every other triangle is swapped to keep the winding
+			const uint32_t i0{ pIndices[i] };
+			const uint32_t i1{ pIndices[i + (i & 1 ? 2 : 1)] };
+			const uint32_t i2{ pIndices[i + (i & 1 ? 1 : 2)] };
+			if (i0 == i1 || i1 == i2 || i2 == i0)
+				continue;
+
+			AddTriangle(firstVertex + i0, firstVertex + i1, firstVertex + i2);
+		}
+	}
+
+	void SoftwareRasterizer::Flush()
+	{
+		Parallel::For(static_cast<uint32_t>(m_TileBins.size()), m_ThreadCount, [this](uint32_t tileIndex) { RasterizeTile(tileIndex); });
+
+		for (size_t i{ 0 }; i < m_TileBins.size(); ++i)
+		{
+			const Statistics& tileStatistics{ m_TileStatistics[i] };
+			m_Statistics.hiZRejectedTriangleCount += tileStatistics.hiZRejectedTriangleCount;
+			m_Statistics.hiZRejectedBlockCount += tileStatistics.hiZRejectedBlockCount;
+			m_Statistics.rasterizedBlockCount += tileStatistics.rasterizedBlockCount;
+			m_Statistics.shadedPixelCount += tileStatistics.shadedPixelCount;
+			m_Statistics.shadedLaneCount += tileStatistics.shadedLaneCount;
+			m_TileBins[i].clear();
+		}
+
+		m_Vertices.clear();
+		m_ScreenPositions.clear();
+		m_DrawStates.clear();
+		m_Triangles.clear();
+	}
+
+	uint32_t SoftwareRasterizer::AddVertex(const Vertex_Out& vertex)
+	{
+		m_Vertices.push_back(vertex);
+		m_ScreenPositions.push_back(ToScreen(vertex.position, static_cast<float>(m_Framebuffer.width), static_cast<float>(m_Framebuffer.height)));
+		return static_cast<uint32_t>(m_Vertices.size() - 1);
+	}
+
+	void SoftwareRasterizer::AddTriangle(uint32_t i0, uint32_t i1, uint32_t i2)
+	{
+		++m_Statistics.triangleCount;
+
+		const uint32_t outCode0{ GetOutCode(m_Vertices[i0].position) };
+		const uint32_t outCode1{ GetOutCode(m_Vertices[i1].position) };
+		const uint32_t outCode2{ GetOutCode(m_Vertices[i2].position) };
+
+		if ((outCode0 & outCode1 & outCode2) != 0)
+		{
+			++m_Statistics.culledTriangleCount;
+			return;
+		}
+
+		const uint32_t outCode{ outCode0 | outCode1 | outCode2 };
+		if (outCode == 0)
+		{
+			BinTriangle(i0, i1, i2);
+			return;
+		}
+
+		++m_Statistics.clippedTriangleCount;
+
+		//Copies, AddVertex can move m_Vertices
+		Vertex_Out polygon[g_MaxClippedVertexCount]{ m_Vertices[i0], m_Vertices[i1], m_Vertices[i2] };
+		Vertex_Out scratch[g_MaxClippedVertexCount]{};
+		const int vertexCount{ ClipPolygon(polygon, 3, outCode, scratch) };
+		if (vertexCount < 3)
+			return;
+
+		const uint32_t first{ AddVertex(polygon[0]) };
+		uint32_t previous{ AddVertex(polygon[1]) };
+		for (int i{ 2 }; i < vertexCount; ++i)
+		{
+			const uint32_t current{ AddVertex(polygon[i]) };
+			BinTriangle(first, previous, current);
+			previous = current;
+		}
+	}
+
+	void SoftwareRasterizer::BinTriangle(uint32_t i0, uint32_t i1, uint32_t i2)
+	{
+		uint32_t vertices[3]{ i0, i1, i2 };
+		int x[3]{}, y[3]{};
+		for (int i{ 0 }; i < 3; ++i)
+		{
+			x[i] = Snap(m_ScreenPositions[vertices[i]].x);
+			y[i] = Snap(m_ScreenPositions[vertices[i]].y);
+		}
+
+		//No culling, so bring both windings to a positive area. Snapped coordinates make it exact.
+		int64_t area{ int64_t(x[2] - x[1]) * (y[0] - y[1]) - int64_t(y[2] - y[1]) * (x[0] - x[1]) };
+		if (area == 0)
+		{
+			++m_Statistics.culledTriangleCount;
+			return;
+		}
+
+		if (area < 0)
+		{
+			std::swap(vertices[1], vertices[2]);
+			std::swap(x[1], x[2]);
+			std::swap(y[1], y[2]);
+			area = -area;
+		}
+
+		//Pixels with their center (+ half a pixel) inside the snapped bounds, the clipping keeps those inside the viewport
+		constexpr int halfPixel{ g_SubpixelSteps / 2 };
+		Triangle triangle{ { vertices[0], vertices[1], vertices[2] }, static_cast<uint32_t>(m_DrawStates.size() - 1) };
+		triangle.minX = std::max(0, (std::min({ x[0], x[1], x[2] }) - halfPixel + g_SubpixelSteps - 1) >> g_SubpixelBits);
+		triangle.maxX = std::min(static_cast<int>(m_Framebuffer.width) - 1, (std::max({ x[0], x[1], x[2] }) - halfPixel) >> g_SubpixelBits);
+		triangle.minY = std::max(0, (std::min({ y[0], y[1], y[2] }) - halfPixel + g_SubpixelSteps - 1) >> g_SubpixelBits);
+		triangle.maxY = std::min(static_cast<int>(m_Framebuffer.height) - 1, (std::max({ y[0], y[1], y[2] }) - halfPixel) >> g_SubpixelBits);
+		if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+		{
+			++m_Statistics.culledTriangleCount;
+			return;
+		}
+
+		for (int i{ 0 }; i < 3; ++i)
+		{
+			const int a{ (i + 1) % 3 };
+			const int b{ (i + 2) % 3 };
+
+			triangle.edgeA[i] = y[a] - y[b];
+			triangle.edgeB[i] = x[b] - x[a];
+			triangle.edgeC[i] = -(int64_t(triangle.edgeA[i]) * x[a] + int64_t(triangle.edgeB[i]) * y[a]) - (IsTopLeft(x[a], y[a], x[b], y[b]) ? 0 : 1);
+		}
+
+		//The barycentrics of vertex 1 and 2 are their edge functions over the area, per pixel instead of per subpixel
+		const double inverseArea{ double(g_SubpixelSteps) / double(area) };
+		const double dx1{ triangle.edgeA[1] * inverseArea }, dy1{ triangle.edgeB[1] * inverseArea };
+		const double dx2{ triangle.edgeA[2] * inverseArea }, dy2{ triangle.edgeB[2] * inverseArea };
+		const auto toPlane = [&](float value0, float value1, float value2) -> ScreenPlane
+			{
+				return {
+					static_cast<float>((value1 - value0) * dx1 + (value2 - value0) * dx2),
+					static_cast<float>((value1 - value0) * dy1 + (value2 - value0) * dy2),
+					value0 };
+			};
+
+		const Vector4& s0{ m_ScreenPositions[vertices[0]] };
+		const Vector4& s1{ m_ScreenPositions[vertices[1]] };
+		const Vector4& s2{ m_ScreenPositions[vertices[2]] };
+		triangle.origin = { float(x[0]) / g_SubpixelSteps, float(y[0]) / g_SubpixelSteps };
+		triangle.minDepth = std::min({ s0.z, s1.z, s2.z });
+		triangle.maxDepth = std::max({ s0.z, s1.z, s2.z });
+		triangle.depth = toPlane(s0.z, s1.z, s2.z);
+		triangle.inverseW = toPlane(s0.w, s1.w, s2.w);
+		triangle.weight1 = toPlane(0.f, s1.w, 0.f);
+		triangle.weight2 = toPlane(0.f, 0.f, s2.w);
+
+		const uint32_t triangleIndex{ static_cast<uint32_t>(m_Triangles.size()) };
+		m_Triangles.push_back(triangle);
+
+		//Every tile the bounds touch, the edge functions skip the pixels of the tiles the triangle only passes near
+		for (uint32_t tileY{ triangle.minY / TileSize }; tileY <= triangle.maxY / TileSize; ++tileY)
+		{
+			for (uint32_t tileX{ triangle.minX / TileSize }; tileX <= triangle.maxX / TileSize; ++tileX)
+			{
+				m_TileBins[size_t(tileY) * m_TileCountX + tileX].push_back(triangleIndex);
+				++m_Statistics.binnedTriangleCount;
+			}
+		}
+	}
+
+	void SoftwareRasterizer::RasterizeTile(uint32_t tileIndex)
+	{
+		const std::vector<uint32_t>& bin{ m_TileBins[tileIndex] };
+		Statistics& statistics{ m_TileStatistics[tileIndex] };
+		statistics = {};
+		if (bin.empty())
+			return;
+
+		//The tile stays in this thread's cache while all of its triangles are drawn, the framebuffer is only touched to load and store it
+		Tile tile;
+		tile.minX = static_cast<int>((tileIndex % m_TileCountX) * TileSize);
+		tile.minY = static_cast<int>((tileIndex / m_TileCountX) * TileSize);
+		tile.width = std::min(static_cast<int>(TileSize), static_cast<int>(m_Framebuffer.width) - tile.minX);
+		tile.height = std::min(static_cast<int>(TileSize), static_cast<int>(m_Framebuffer.height) - tile.minY);
+
+		if (tile.width < static_cast<int>(TileSize) || tile.height < static_cast<int>(TileSize))
+			std::fill_n(tile.depths, TileSize * TileSize, 0.f);
+
+		for (int y{ 0 }; y < tile.height; ++y)
+		{
+			const size_t row{ size_t(tile.minY + y) * m_Framebuffer.width + tile.minX };
+			std::copy_n(m_Framebuffer.colors.data() + row, tile.width, tile.colors + y * TileSize);
+			std::copy_n(m_Framebuffer.depths.data() + row, tile.width, tile.depths + y * TileSize);
+		}
+
+		for (int block{ 0 }; block < g_HiZBlockCount; ++block)
+			tile.UpdateBlockDepths(block);
+
+		tile.UpdateDepths();
+
+		if (m_ShadingMode == ShadingMode::DepthPrePass)
+		{
+			for (uint32_t triangleIndex : bin)
+				RasterizeTriangle(triangleIndex, TilePass::DepthOnly, tile, statistics);
+
+			std::fill_n(tile.shadedRows, TileSize, 0);
+			for (uint32_t triangleIndex : bin)
+				RasterizeTriangle(triangleIndex, TilePass::ColorOnly, tile, statistics);
+		}
+		else if (m_ShadingMode == ShadingMode::VisibilityBuffer)
+		{
+			std::fill_n(tile.triangles, TileSize * TileSize, g_NoTriangle);
+			for (uint32_t triangleIndex : bin)
+				RasterizeTriangle(triangleIndex, TilePass::Visibility, tile, statistics);
+
+			ShadeVisibility(tile, statistics);
+		}
+		else
+		{
+			for (uint32_t triangleIndex : bin)
+				RasterizeTriangle(triangleIndex, TilePass::DepthAndColor, tile, statistics);
+		}
+
+		for (int y{ 0 }; y < tile.height; ++y)
+		{
+			const size_t row{ size_t(tile.minY + y) * m_Framebuffer.width + tile.minX };
+			std::copy_n(tile.colors + y * TileSize, tile.width, m_Framebuffer.colors.data() + row);
+			std::copy_n(tile.depths + y * TileSize, tile.width, m_Framebuffer.depths.data() + row);
+		}
+	}
+
+	void SoftwareRasterizer::RasterizeTriangle(uint32_t triangleIndex, TilePass pass, Tile& tile, Statistics& statistics) const
+	{
+		const Triangle& triangle{ m_Triangles[triangleIndex] };
+		constexpr uint32_t allLanes{ (1u << Simd::Width) - 1 };
+		constexpr int64_t halfPixel{ g_SubpixelSteps / 2 };
+
+		//The part of the bounds inside the tile, walked in whole 8x8 blocks that start at origin
+		const int minX{ std::max(triangle.minX, tile.minX) };
+		const int maxX{ std::min(triangle.maxX, tile.minX + tile.width - 1) };
+		const int minY{ std::max(triangle.minY, tile.minY) };
+		const int maxY{ std::min(triangle.maxY, tile.minY + tile.height - 1) };
+		const int firstBlockX{ (minX - tile.minX) / g_HiZBlockSize };
+		const int lastBlockX{ (maxX - tile.minX) / g_HiZBlockSize };
+		const int firstBlockY{ (minY - tile.minY) / g_HiZBlockSize };
+		const int lastBlockY{ (maxY - tile.minY) / g_HiZBlockSize };
+		const int originX{ tile.minX + firstBlockX * g_HiZBlockSize };
+		const int originY{ tile.minY + firstBlockY * g_HiZBlockSize };
+		const int64_t spanX{ int64_t((lastBlockX - firstBlockX + 1) * g_HiZBlockSize - 1) * g_SubpixelSteps };
+		const int64_t spanY{ int64_t((lastBlockY - firstBlockY + 1) * g_HiZBlockSize - 1) * g_SubpixelSteps };
+
+		//The edge functions at the origin need 64 bits across the screen. An edge that crosses the blocks stays within its reach there
+		//and steps in 32 bits, the others are either all outside or all inside and keep 0 with no steps.
+		int32_t originEdges[3]{}, edgeStepsX[3]{}, edgeStepsY[3]{};
+		for (int i{ 0 }; i < 3; ++i)
+		{
+			const int64_t edge{ triangle.edgeA[i] * (originX * g_SubpixelSteps + halfPixel) + triangle.edgeB[i] * (originY * g_SubpixelSteps + halfPixel) + triangle.edgeC[i] };
+			const int64_t reachX{ triangle.edgeA[i] * spanX };
+			const int64_t reachY{ triangle.edgeB[i] * spanY };
+			const int64_t lowest{ edge + std::min<int64_t>(reachX, 0) + std::min<int64_t>(reachY, 0) };
+			const int64_t highest{ edge + std::max<int64_t>(reachX, 0) + std::max<int64_t>(reachY, 0) };
+
+			if (highest < 0)
+				return;
+
+			if (lowest >= 0)
+				continue;
+
+			originEdges[i] = static_cast<int32_t>(edge);
+			edgeStepsX[i] = triangle.edgeA[i] * g_SubpixelSteps;
+			edgeStepsY[i] = triangle.edgeB[i] * g_SubpixelSteps;
+		}
+
+		//Depth is linear in screen space, so over a rectangle of samples it is bounded by the corners, and by the vertices over the triangle
+		const auto getDepthBounds = [&triangle](int x0, int y0, int x1, int y1, float& nearest, float& farthest)
+			{
+				const ScreenPlane& plane{ triangle.depth };
+				const float corner{ plane.value + plane.dx * (x0 + 0.5f - triangle.origin.x) + plane.dy * (y0 + 0.5f - triangle.origin.y) };
+				const float reachX{ plane.dx * (x1 - x0) };
+				const float reachY{ plane.dy * (y1 - y0) };
+				nearest = std::max(triangle.minDepth, corner + std::min(reachX, 0.f) + std::min(reachY, 0.f)) - g_DepthBoundMargin;
+				farthest = std::min(triangle.maxDepth, corner + std::max(reachX, 0.f) + std::max(reachY, 0.f)) + g_DepthBoundMargin;
+			};
+
+		//Nothing passes the depth test behind the farthest depth, and the color pass only shades what is equal to it
+		const auto isHidden = [pass](float nearest, float farthest)
+			{
+				return pass == TilePass::ColorOnly ? nearest > farthest : nearest >= farthest;
+			};
+
+		float nearest{}, farthest{};
+		getDepthBounds(minX, minY, maxX, maxY, nearest, farthest);
+		if (isHidden(nearest, tile.maxDepth))
+		{
+			++statistics.hiZRejectedTriangleCount;
+			return;
+		}
+
+		const DrawState& drawState{ m_DrawStates[triangle.drawIndex] };
+		const bool isWritingDepth{ pass != TilePass::ColorOnly };
+		const bool isShading{ pass == TilePass::DepthAndColor || pass == TilePass::ColorOnly };
+
+		//Set up by the first block that shades
+		bool hasAttributes{ false };
+		float baseAttributes[PhongShader::AttributeCount]{};
+		float deltaAttributes1[PhongShader::AttributeCount]{};
+		float deltaAttributes2[PhongShader::AttributeCount]{};
+
+		const Simd::Float depthRamp{ Simd::Ramp(triangle.depth.dx) };
+		const Simd::Float inverseWRamp{ Simd::Ramp(triangle.inverseW.dx) };
+		const Simd::Float weight1Ramp{ Simd::Ramp(triangle.weight1.dx) };
+		const Simd::Float weight2Ramp{ Simd::Ramp(triangle.weight2.dx) };
+		const auto evaluate = [](const ScreenPlane& plane, Simd::Float ramp, float offsetX, float offsetY)
+			{
+				return Simd::Add(Simd::Set(plane.value + plane.dx * offsetX + plane.dy * offsetY), ramp);
+			};
+
+		constexpr int blockReach{ g_HiZBlockSize - 1 };
+		for (int blockY{ firstBlockY }; blockY <= lastBlockY; ++blockY)
+		{
+			for (int blockX{ firstBlockX }; blockX <= lastBlockX; ++blockX)
+			{
+				const int blockMinX{ tile.minX + blockX * g_HiZBlockSize };
+				const int blockMinY{ tile.minY + blockY * g_HiZBlockSize };
+				const int x0{ std::max(blockMinX, minX) };
+				const int x1{ std::min(blockMinX + blockReach, maxX) };
+				const int y0{ std::max(blockMinY, minY) };
+				const int y1{ std::min(blockMinY + blockReach, maxY) };
+				if (x0 > x1 || y0 > y1)
+					continue;
+
+				//Blocks outside one of the edges, before the depth bounds so these do not count as rejected by them
+				int32_t blockEdges[3]{};
+				bool isOutside{ false };
+				for (int i{ 0 }; i < 3 && !isOutside; ++i)
+				{
+					blockEdges[i] = originEdges[i] + edgeStepsX[i] * (blockMinX - originX) + edgeStepsY[i] * (y0 - originY);
+					isOutside = blockEdges[i] + std::max(edgeStepsX[i] * blockReach, 0) + std::max(edgeStepsY[i] * (y1 - y0), 0) < 0;
+				}
+
+				if (isOutside)
+					continue;
+
+				const int block{ blockY * g_HiZBlocksPerRow + blockX };
+				getDepthBounds(x0, y0, x1, y1, nearest, farthest);
+				if (isHidden(nearest, tile.blockMaxDepths[block]))
+				{
+					++statistics.hiZRejectedBlockCount;
+					continue;
+				}
+
+				++statistics.rasterizedBlockCount;
+
+				//In front of everything in the block, so the depth test cannot fail
+				const bool isInFront{ pass != TilePass::ColorOnly && farthest < tile.blockMinDepths[block] };
+				bool hasWrittenBlockDepth{ false };
+
+				Simd::Int rowEdges[3]{}, groupSteps[3]{}, rowSteps[3]{};
+				for (int i{ 0 }; i < 3; ++i)
+				{
+					rowEdges[i] = Simd::AddInt(Simd::SetInt(blockEdges[i]), Simd::RampInt(edgeStepsX[i]));
+					groupSteps[i] = Simd::SetInt(edgeStepsX[i] * Simd::Width);
+					rowSteps[i] = Simd::SetInt(edgeStepsY[i]);
+				}
+
+				for (int y{ y0 }; y <= y1; ++y)
+				{
+					Simd::Int edges[3]{ rowEdges[0], rowEdges[1], rowEdges[2] };
+					const int tileY{ y - tile.minY };
+					const float offsetY{ y + 0.5f - triangle.origin.y };
+
+					for (int x{ blockMinX }; x <= x1; x += Simd::Width)
+					{
+						const int tileX{ x - tile.minX };
+						uint32_t coverage{ ~Simd::NegativeMask(edges[0], edges[1], edges[2]) & allLanes };
+						if (tileX + Simd::Width > tile.width)
+							coverage &= (1u << (tile.width - tileX)) - 1;
+
+						for (int i{ 0 }; i < 3; ++i)
+							edges[i] = Simd::AddInt(edges[i], groupSteps[i]);
+
+						if (pass == TilePass::ColorOnly)
+							coverage &= ~static_cast<uint32_t>(tile.shadedRows[tileY] >> tileX) & allLanes;
+
+						if (coverage == 0 || x + Simd::Width <= x0)
+							continue;
+
+						float* pDepths{ tile.depths + tileY * TileSize + tileX };
+						const float offsetX{ x + 0.5f - triangle.origin.x };
+						const Simd::Float depth{ evaluate(triangle.depth, depthRamp, offsetX, offsetY) };
+						if (pass == TilePass::ColorOnly)
+							coverage &= Simd::EqualMask(depth, Simd::Load(pDepths));
+						else if (!isInFront)
+							coverage &= Simd::LessMask(depth, Simd::Load(pDepths));
+
+						if (coverage == 0)
+							continue;
+
+						if (isWritingDepth)
+						{
+							alignas(32) float blockDepths[Simd::Width];
+							Simd::Store(blockDepths, depth);
+							for (uint32_t lanes{ coverage }; lanes != 0; lanes &= lanes - 1)
+							{
+								const int lane{ std::countr_zero(lanes) };
+								pDepths[lane] = blockDepths[lane];
+								if (pass == TilePass::Visibility)
+									tile.triangles[tileY * TileSize + tileX + lane] = triangleIndex;
+							}
+
+							hasWrittenBlockDepth = true;
+						}
+
+						if (!isShading)
+							continue;
+
+						if (!hasAttributes)
+						{
+							GetAttributes(m_Vertices[triangle.vertices[0]], m_Vertices[triangle.vertices[1]], m_Vertices[triangle.vertices[2]],
+								baseAttributes, deltaAttributes1, deltaAttributes2);
+							hasAttributes = true;
+						}
+
+						//Weights divided by the interpolated 1 / w, which makes them perspective correct
+						const Simd::Float inverseW{ evaluate(triangle.inverseW, inverseWRamp, offsetX, offsetY) };
+						const Simd::Float p1{ Simd::Div(evaluate(triangle.weight1, weight1Ramp, offsetX, offsetY), inverseW) };
+						const Simd::Float p2{ Simd::Div(evaluate(triangle.weight2, weight2Ramp, offsetX, offsetY), inverseW) };
+
+						PhongShader::PixelBlock pixels;
+						for (int a{ 0 }; a < PhongShader::AttributeCount; ++a)
+						{
+							const Simd::Float value{ Simd::Add(Simd::Set(baseAttributes[a]),
+								Simd::Add(Simd::Mul(Simd::Set(deltaAttributes1[a]), p1), Simd::Mul(Simd::Set(deltaAttributes2[a]), p2))) };
+							Simd::Store(pixels.attributes[a], value);
+						}
+
+						//The whole block, the lanes outside the triangle are cheaper to shade along than to pack away
+						ColorRGB shadedColors[Simd::Width];
+						PhongShader::ShadeBlock(pixels, Simd::Width, drawState.cameraPosition, drawState.material, shadedColors);
+
+						for (uint32_t lanes{ coverage }; lanes != 0; lanes &= lanes - 1)
+						{
+							const int lane{ std::countr_zero(lanes) };
+							tile.colors[tileY * TileSize + tileX + lane] = Framebuffer::ToRGBA(shadedColors[lane]);
+						}
+
+						statistics.shadedPixelCount += std::popcount(coverage);
+						statistics.shadedLaneCount += Simd::Width;
+						if (pass == TilePass::ColorOnly)
+							tile.shadedRows[tileY] |= uint64_t(coverage) << tileX;
+					}
+
+					for (int i{ 0 }; i < 3; ++i)
+						rowEdges[i] = Simd::AddInt(rowEdges[i], rowSteps[i]);
+				}
+
+				if (hasWrittenBlockDepth)
+					tile.UpdateBlockDepths(block);
+			}
+		}
+
+		if (tile.isMaxDepthStale)
+			tile.UpdateDepths();
+	}
+
+	void SoftwareRasterizer::ShadeVisibility(Tile& tile, Statistics& statistics) const
+	{
+		//The visible pixels of any triangle share a block as long as they come from the same Draw
+		PhongShader::PixelBlock pixels{};
+		int tilePixels[PhongShader::BlockWidth]{};
+		uint32_t pixelCount{ 0 };
+		uint32_t drawIndex{ 0 };
+
+		const auto shadePixels = [&]()
+			{
+				//Always the whole block, so every pixel goes through the same kernel as with the other modes
+				const DrawState& drawState{ m_DrawStates[drawIndex] };
+				ColorRGB shadedColors[PhongShader::BlockWidth];
+				PhongShader::ShadeBlock(pixels, PhongShader::BlockWidth, drawState.cameraPosition, drawState.material, shadedColors);
+
+				for (uint32_t i{ 0 }; i < pixelCount; ++i)
+					tile.colors[tilePixels[i]] = Framebuffer::ToRGBA(shadedColors[i]);
+
+				statistics.shadedPixelCount += pixelCount;
+				statistics.shadedLaneCount += PhongShader::BlockWidth;
+				pixelCount = 0;
+			};
+
+		uint32_t attributesTriangle{ g_NoTriangle };
+		float baseAttributes[PhongShader::AttributeCount]{};
+		float deltaAttributes1[PhongShader::AttributeCount]{};
+		float deltaAttributes2[PhongShader::AttributeCount]{};
+
+		for (int y{ 0 }; y < tile.height; ++y)
+		{
+			for (int x{ 0 }; x < tile.width; ++x)
+			{
+				const int tilePixel{ y * static_cast<int>(TileSize) + x };
+				const uint32_t triangleIndex{ tile.triangles[tilePixel] };
+				if (triangleIndex == g_NoTriangle)
+					continue;
+
+				const Triangle& triangle{ m_Triangles[triangleIndex] };
+				if (triangleIndex != attributesTriangle)
+				{
+					GetAttributes(m_Vertices[triangle.vertices[0]], m_Vertices[triangle.vertices[1]], m_Vertices[triangle.vertices[2]],
+						baseAttributes, deltaAttributes1, deltaAttributes2);
+					attributesTriangle = triangleIndex;
+				}
+
+				if (pixelCount > 0 && triangle.drawIndex != drawIndex)
+					shadePixels();
+
+				drawIndex = triangle.drawIndex;
+
+				//The planes at the first pixel of its block of Simd::Width plus its lane, exactly like RasterizeTriangle evaluates them
+				const int lane{ x % Simd::Width };
+				const float offsetX{ (tile.minX + x - lane) + 0.5f - triangle.origin.x };
+				const float offsetY{ (tile.minY + y) + 0.5f - triangle.origin.y };
+				const auto evaluate = [lane, offsetX, offsetY](const ScreenPlane& plane)
+					{
+						return (plane.value + plane.dx * offsetX + plane.dy * offsetY) + static_cast<float>(lane) * plane.dx;
+					};
+
+				const float inverseW{ evaluate(triangle.inverseW) };
+				const float p1{ evaluate(triangle.weight1) / inverseW };
+				const float p2{ evaluate(triangle.weight2) / inverseW };
+				for (int a{ 0 }; a < PhongShader::AttributeCount; ++a)
+					pixels.attributes[a][pixelCount] = baseAttributes[a] + (deltaAttributes1[a] * p1 + deltaAttributes2[a] * p2);
+
+				tilePixels[pixelCount++] = tilePixel;
+				if (pixelCount == PhongShader::BlockWidth)
+					shadePixels();
+			}
+		}
+
+		if (pixelCount > 0)
+			shadePixels();
+	}
+}
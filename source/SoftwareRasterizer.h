@@ -0,0 +1,161 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "DataTypes.h"
+#include "PhongShader.h"
+
+namespace dae
+{
+	//Color and depth target of the software rasterizer. Colors are 8 bit RGBA with r in the lowest byte, like DXGI_FORMAT_R8G8B8A8_UNORM,
+	//and depth is z / w in [0, 1] like the depth stencil view of the GPU path.
+	struct Framebuffer
+	{
+		uint32_t width{};
+		uint32_t height{};
+		std::vector<uint32_t> colors{};
+		std::vector<float> depths{};
+
+		void Resize(uint32_t newWidth, uint32_t newHeight);
+		void Clear(const ColorRGB& color, float depth = 1.f);
+
+		//.ppm or .png, see ImageWriter
+		bool Write(const std::string& path) const;
+
+		static uint32_t ToRGBA(const ColorRGB& color);
+	};
+
+	//CPU version of Mesh::Draw for machines without a GPU: the vertex stage of PosCol3D.fx into Vertex_Out, clipping in homogeneous space
+	//and edge function rasterization with perspective correct attributes, a depth test and PS_Phong. Both faces are drawn, like the rasterizer state of the effect.
+	//Draw only transforms and bins the triangles into screen tiles, Flush then rasterizes the tiles in parallel. Every tile keeps its color
+	//and depth in a local buffer while it works through its triangles in draw order, so the result does not depend on the thread count.
+	//Vertices are snapped to 1/16 of a pixel and coverage is tested with integer edge functions, so shared edges never leave cracks,
+	//and the tiles are walked in blocks of 8 pixels with AVX2 (4 with SSE2, 1 without either).
+	//Every tile keeps the nearest and farthest depth of itself and of its 8x8 blocks, so hidden triangles and blocks are dropped
+	//before anything is interpolated. With the depth pre-pass on, a tile first draws only depth and then shades just the visible pixels.
+	//With the visibility buffer, a tile only keeps the nearest triangle and its depth per pixel and shades afterwards, packing the visible pixels
+	//of any triangle into full blocks of the shader, so shading no longer depends on overdraw or on how small the triangles are.
+	class SoftwareRasterizer final
+	{
+	public:
+		static constexpr uint32_t TileSize{ 64 };
+
+		enum class ShadingMode
+		{
+			Forward,			//Shades every pixel that passes the depth test
+			DepthPrePass,		//Draws the depth of all triangles first, then shades the pixels that are equal to it
+			VisibilityBuffer	//Keeps the triangle and depth of the nearest one, then shades each visible pixel once
+		};
+
+		struct Statistics
+		{
+			uint64_t triangleCount{};		//Assembled from the index buffer
+			uint64_t clippedTriangleCount{};	//Crossed a frustum plane, so were cut into smaller ones
+			uint64_t culledTriangleCount{};	//Entirely outside the frustum, or without area
+			uint64_t binnedTriangleCount{};	//Triangles added to tiles, counted once per tile they overlap
+			uint64_t hiZRejectedTriangleCount{};	//Behind everything in a tile, counted once per tile and pass
+			uint64_t hiZRejectedBlockCount{};	//8x8 blocks of a triangle behind everything in the block, before any interpolation
+			uint64_t rasterizedBlockCount{};	//8x8 blocks of a triangle that went on to the depth test per pixel
+			uint64_t shadedPixelCount{};	//Passed the depth test
+			uint64_t shadedLaneCount{};	//Pixels the shader ran on, with the lanes of a block that are shaded along without being written
+		};
+
+		//0 threads uses every hardware thread
+		SoftwareRasterizer(uint32_t width, uint32_t height, uint32_t threadCount = 0);
+
+		//Also resets the statistics, and drops whatever was drawn but not flushed
+		void Clear(const ColorRGB& color);
+
+		//Same inputs as the GPU path: the vertices and indices of a Mesh, its world matrix and the camera's view * projection.
+		//The triangles keep the material and camera position set at the time of the call. Nothing shows up in the framebuffer until the next Flush.
+		void Draw(const Vertex* pVertices, size_t vertexCount, const uint32_t* pIndices, size_t indexCount, PrimitiveTopology topology,
+			const Matrix& worldMatrix, const Matrix& viewProjectionMatrix);
+		void Flush();
+
+		inline void SetThreadCount(uint32_t threadCount) { m_ThreadCount = threadCount; }
+		inline void SetMaterial(const PhongShader::Material& material) { m_Material = material; }
+		inline void SetCameraPosition(const Vector3& cameraPosition) { m_CameraPosition = cameraPosition; }
+		inline void SetShadingMode(ShadingMode shadingMode) { m_ShadingMode = shadingMode; }
+		inline const Framebuffer& GetFramebuffer() const { return m_Framebuffer; }
+		inline const Statistics& GetStatistics() const { return m_Statistics; }
+
+	private:
+		//Linear in screen space: value at the origin of the triangle plus the change per pixel
+		struct ScreenPlane
+		{
+			float dx{};
+			float dy{};
+			float value{};
+		};
+
+		//What the pixel stage needs from the time of a Draw
+		struct DrawState
+		{
+			PhongShader::Material material{};
+			Vector3 cameraPosition{};
+		};
+
+		//Wound to a positive area, with the pixel bounds it can cover and the setup the tiles share
+		struct Triangle
+		{
+			uint32_t vertices[3]{};
+			uint32_t drawIndex{};
+			int minX{};
+			int minY{};
+			int maxX{};
+			int maxY{};
+			float minDepth{};
+			float maxDepth{};
+
+			//Edge i is opposite vertex i, a * x + b * y + c in subpixels with the fill rule folded into c, so a sample is covered when all three are >= 0
+			int edgeA[3]{};
+			int edgeB[3]{};
+			int64_t edgeC[3]{};
+
+			//From the snapped first vertex, in pixels: z / w, 1 / w, and the screen space barycentrics of vertex 1 and 2 times their 1 / w
+			Vector2 origin{};
+			ScreenPlane depth{};
+			ScreenPlane inverseW{};
+			ScreenPlane weight1{};
+			ScreenPlane weight2{};
+		};
+
+		//A tile draws its triangles in one pass, in the two of a depth pre-pass, or into the visibility buffer before shading it
+		enum class TilePass
+		{
+			DepthAndColor,
+			DepthOnly,
+			ColorOnly,
+			Visibility
+		};
+
+		//The local buffers and depth bounds of a tile, see SoftwareRasterizer.cpp
+		struct Tile;
+
+		Framebuffer m_Framebuffer{};
+		Statistics m_Statistics{};
+		uint32_t m_ThreadCount{};
+		ShadingMode m_ShadingMode{ ShadingMode::Forward };
+		PhongShader::Material m_Material{};
+		Vector3 m_CameraPosition{};
+
+		uint32_t m_TileCountX{};
+		uint32_t m_TileCountY{};
+
+		//Everything drawn since the last Flush: the vertex stage output with the vertices clipping added, their screen positions
+		//(x and y in pixels, z / w and 1 / w), the state of every Draw and the triangles. Every tile lists the triangles that overlap it in draw order.
+		std::vector<Vertex_Out> m_Vertices{};
+		std::vector<Vector4> m_ScreenPositions{};
+		std::vector<DrawState> m_DrawStates{};
+		std::vector<Triangle> m_Triangles{};
+		std::vector<std::vector<uint32_t>> m_TileBins{};
+		std::vector<Statistics> m_TileStatistics{};
+
+		uint32_t AddVertex(const Vertex_Out& vertex);
+		void AddTriangle(uint32_t i0, uint32_t i1, uint32_t i2);
+		void BinTriangle(uint32_t i0, uint32_t i1, uint32_t i2);
+		void RasterizeTile(uint32_t tileIndex);
+		void RasterizeTriangle(uint32_t triangleIndex, TilePass pass, Tile& tile, Statistics& statistics) const;
+		void ShadeVisibility(Tile& tile, Statistics& statistics) const;
+	};
+}
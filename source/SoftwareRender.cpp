@@ -0,0 +1,84 @@
+#include "pch.h"
+#include "SoftwareRender.h"
+#include "Camera.h"
+#include "SoftwareTexture.h"
+#include "Utils.h"
+#include <chrono>
+
+namespace dae
+{
+	int RenderSoftware(const std::string& outputFile, uint32_t width, uint32_t height, uint32_t threadCount, SoftwareRasterizer::ShadingMode shadingMode)
+	{
+		//Same loader settings as Mesh
+		Utils::OBJParseSettings parseSettings{};
+		parseSettings.flipAxisAndWinding = true;
+		parseSettings.threadCount = 0;
+
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+		if (!Utils::ParseOBJ("Resources/vehicle.obj", vertices, indices, parseSettings))
+		{
+			std::cout << "Invalid file!\n";
+			return 1;
+		}
+
+		//Same camera as Renderer
+		Camera camera{ Vector3(0.0f, 0.0f, -50.0f), 45.0f };
+		camera.Initialize(45.0f, Vector3(0.0f, 0.0f, -50.0f), float(width) / float(height));
+		camera.CalculateViewMatrix();
+
+		//Same maps as Renderer
+		const SoftwareTexture diffuseMap{ "Resources/vehicle_diffuse.png" };
+		const SoftwareTexture normalMap{ "Resources/vehicle_normal.png" };
+		const SoftwareTexture specularMap{ "Resources/vehicle_specular.png" };
+		const SoftwareTexture glossinessMap{ "Resources/vehicle_gloss.png" };
+
+		PhongShader::Material material{};
+		material.pDiffuseMap = diffuseMap.IsValid() ? &diffuseMap : nullptr;
+		material.pNormalMap = normalMap.IsValid() ? &normalMap : nullptr;
+		material.pSpecularMap = specularMap.IsValid() ? &specularMap : nullptr;
+		material.pGlossinessMap = glossinessMap.IsValid() ? &glossinessMap : nullptr;
+
+		SoftwareRasterizer rasterizer{ width, height, threadCount };
+		rasterizer.SetMaterial(material);
+		rasterizer.SetCameraPosition(camera.origin);
+		rasterizer.SetShadingMode(shadingMode);
+
+		const auto startTime{ std::chrono::steady_clock::now() };
+		rasterizer.Clear({ 0.39f, 0.59f, 0.93f });
+		rasterizer.Draw(vertices.data(), vertices.size(), indices.data(), indices.size(), PrimitiveTopology::TriangleList,
+			Matrix::Identity, camera.viewMatrix * camera.projectionMatrix);
+		rasterizer.Flush();
+		const float renderTime{ std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count() };
+
+		const SoftwareRasterizer::Statistics& statistics{ rasterizer.GetStatistics() };
+		std::cout << "Rendered " << statistics.triangleCount << " triangles (" << statistics.clippedTriangleCount << " clipped, "
+			<< statistics.culledTriangleCount << " culled, " << statistics.binnedTriangleCount << " binned), " << statistics.shadedPixelCount << " pixels shaded in " << renderTime << " ms\n";
+		std::cout << "Hierarchical depth rejected " << statistics.hiZRejectedTriangleCount << " binned triangles and " << statistics.hiZRejectedBlockCount
+			<< " 8x8 blocks, " << statistics.rasterizedBlockCount << " blocks rasterized, " << statistics.shadedLaneCount << " shader lanes for the shaded pixels\n";
+
+		if (!rasterizer.GetFramebuffer().Write(outputFile))
+		{
+			std::cout << RED_TEXT("Could not write ") << outputFile << "\n";
+			return 1;
+		}
+
+		std::cout << GREEN_TEXT("Wrote ") << outputFile << "\n";
+		return 0;
+	}
+
+	int RenderSoftware(int argc, char* args[], int firstArgument)
+	{
+		const auto argument = [argc, args, firstArgument](int index) { return firstArgument + index < argc ? args[firstArgument + index] : nullptr; };
+
+		const std::string outputFile{ argument(0) ? argument(0) : "output.png" };
+		const uint32_t width{ argument(1) ? static_cast<uint32_t>(std::stoul(argument(1))) : 640u };
+		const uint32_t height{ argument(2) ? static_cast<uint32_t>(std::stoul(argument(2))) : 480u };
+		const uint32_t threadCount{ argument(3) ? static_cast<uint32_t>(std::stoul(argument(3))) : 0u };
+		const std::string shadingMode{ argument(4) ? argument(4) : "forward" };
+		return RenderSoftware(outputFile, width, height, threadCount,
+			shadingMode == "prepass" ? SoftwareRasterizer::ShadingMode::DepthPrePass
+			: shadingMode == "visibility" ? SoftwareRasterizer::ShadingMode::VisibilityBuffer
+			: SoftwareRasterizer::ShadingMode::Forward);
+	}
+}
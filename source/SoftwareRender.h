@@ -0,0 +1,13 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include "SoftwareRasterizer.h"
+
+namespace dae
+{
+	//Renders one frame of the vehicle on the CPU and writes it to outputFile, without a window or a GPU. 0 threads uses every hardware thread.
+	int RenderSoftware(const std::string& outputFile, uint32_t width, uint32_t height, uint32_t threadCount, SoftwareRasterizer::ShadingMode shadingMode);
+
+	//[output.png|output.ppm] [width] [height] [threads] [forward|prepass|visibility] from args[firstArgument] on, shared by main and the headless build
+	int RenderSoftware(int argc, char* args[], int firstArgument);
+}
@@ -0,0 +1,58 @@
+#include "pch.h"
+#include "SoftwareTexture.h"
+#include "ImageReader.h"
+#include <cstring>
+
+namespace dae
+{
+	SoftwareTexture::SoftwareTexture(const std::string& path)
+	{
+		//PNG and PPM without any library, so the headless build loads the same texels. SDL_image takes whatever ImageReader cannot read.
+		if (ImageReader::Read(path, m_Texels, m_Width, m_Height))
+			return;
+
+		m_Texels.clear();
+		m_Width = m_Height = 0;
+
+#ifdef DAE_HEADLESS
+		std::cerr << "SoftwareTexture: could not read " << path << ", the headless build only reads PNG and PPM" << std::endl;
+#else
+		SDL_Surface* pSurface = IMG_Load(path.c_str());
+		if (pSurface == nullptr)
+		{
+			std::cerr << "SoftwareTexture: error when calling IMG_Load: " << SDL_GetError() << std::endl;
+			return;
+		}
+
+		//Whatever IMG_Load returned (RGB, paletted, ...) as bytes in RGBA order
+		SDL_Surface* pConverted = SDL_ConvertSurfaceFormat(pSurface, SDL_PIXELFORMAT_RGBA32, 0);
+		SDL_FreeSurface(pSurface);
+		if (pConverted == nullptr)
+		{
+			std::cerr << "SoftwareTexture: error when calling SDL_ConvertSurfaceFormat: " << SDL_GetError() << std::endl;
+			return;
+		}
+
+		m_Width = static_cast<uint32_t>(pConverted->w);
+		m_Height = static_cast<uint32_t>(pConverted->h);
+		m_Texels.resize(size_t(m_Width) * m_Height);
+
+		const uint8_t* pPixels{ static_cast<const uint8_t*>(pConverted->pixels) };
+		for (uint32_t y{ 0 }; y < m_Height; ++y)
+			std::memcpy(m_Texels.data() + size_t(y) * m_Width, pPixels + size_t(y) * pConverted->pitch, m_Width * sizeof(uint32_t));
+
+		SDL_FreeSurface(pConverted);
+#endif
+	}
+
+	uint32_t SoftwareTexture::Sample(const Vector2& uv) const
+	{
+		return m_Texels[size_t(ToTexel(uv.y, m_Height)) * m_Width + ToTexel(uv.x, m_Width)];
+	}
+
+	uint32_t SoftwareTexture::ToTexel(float coordinate, uint32_t size)
+	{
+		const float wrapped{ (coordinate - std::floor(coordinate)) * size };
+		return wrapped < size - 1.f ? static_cast<uint32_t>(wrapped) : size - 1;
+	}
+}
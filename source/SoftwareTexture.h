@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Vector2.h"
+
+namespace dae
+{
+	//CPU copy of an image for the SoftwareRasterizer, 8 bit RGBA with r in the lowest byte like the DXGI_FORMAT_R8G8B8A8_UNORM of Texture
+	//PNG and PPM are read by ImageReader, other formats need SDL_image and are not available in the headless build
+	class SoftwareTexture final
+	{
+	public:
+		explicit SoftwareTexture(const std::string& path);
+
+		inline bool IsValid() const { return !m_Texels.empty(); }
+		inline uint32_t GetWidth() const { return m_Width; }
+		inline uint32_t GetHeight() const { return m_Height; }
+		inline const uint32_t* GetTexels() const { return m_Texels.data(); }
+
+		//Point sampling with wrapping, like g_SampleStatePoint in PosCol3D.fx
+		uint32_t Sample(const Vector2& uv) const;
+
+		//Wraps coordinate into [0, size). NaN and infinities end up on the last texel instead of outside the texture.
+		static uint32_t ToTexel(float coordinate, uint32_t size);
+
+	private:
+		uint32_t m_Width{};
+		uint32_t m_Height{};
+		std::vector<uint32_t> m_Texels{};
+	};
+}
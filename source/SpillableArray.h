@@ -0,0 +1,165 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace dae
+{
+	//Append-only array that keeps its elements in memory until Spill() moves them to a temporary file.
+	//Once spilled, reads go through a small direct-mapped cache of fixed-size pages, so memory use stays bounded.
+	template<typename T>
+	class SpillableArray final
+	{
+	public:
+		//Elements are appended in blocks, but read back in smaller pages so scattered reads do not pull in whole blocks
+		static constexpr size_t BlockSize{ 16384 };
+		static constexpr size_t PageSize{ 1024 };
+
+		SpillableArray()
+		{
+			m_Tail.reserve(BlockSize);
+		}
+
+		~SpillableArray()
+		{
+			if (m_File.is_open())
+			{
+				m_File.close();
+
+				std::error_code error{};
+				std::filesystem::remove(m_FilePath, error);
+			}
+		}
+
+		SpillableArray(const SpillableArray& other) = delete;
+		SpillableArray& operator=(const SpillableArray& other) = delete;
+		SpillableArray(SpillableArray&& other) = delete;
+		SpillableArray& operator=(SpillableArray&& other) = delete;
+
+		void PushBack(const T& value)
+		{
+			m_Tail.push_back(value);
+			++m_Size;
+
+			if (m_Tail.size() == BlockSize)
+				FlushTail();
+		}
+
+		//Not const: a read can replace a cached block
+		const T& Get(size_t index)
+		{
+			const size_t block{ index / BlockSize };
+			const size_t offset{ index % BlockSize };
+
+			if (block == m_BlockCount)
+				return m_Tail[offset];
+
+			if (!IsSpilled())
+				return m_Blocks[block][offset];
+
+			return LoadPage(index / PageSize)[index % PageSize];
+		}
+
+		inline size_t GetSize() const { return m_Size; }
+		inline bool IsSpilled() const { return m_File.is_open(); }
+		inline bool HasFailed() const { return m_HasFailed; }
+
+		size_t GetMemoryUsage() const
+		{
+			size_t elements{ m_Tail.capacity() + m_Blocks.size() * BlockSize };
+			for (const CachedPage& cachedPage : m_Cache)
+				elements += cachedPage.data.capacity();
+
+			return elements * sizeof(T);
+		}
+
+		//Moves every completed block to disk, later blocks are appended to the file directly
+		bool Spill(size_t cachePageCount)
+		{
+			if (IsSpilled())
+				return true;
+
+			static uint32_t spillCounter{ 0 };
+			const auto timeStamp{ std::chrono::steady_clock::now().time_since_epoch().count() };
+			m_FilePath = std::filesystem::temp_directory_path() / ("dae_spill_" + std::to_string(timeStamp) + "_" + std::to_string(spillCounter++) + ".bin");
+
+			m_File.open(m_FilePath, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+			if (!m_File)
+			{
+				m_HasFailed = true;
+				return false;
+			}
+
+			for (const std::vector<T>& block : m_Blocks)
+				m_File.write(reinterpret_cast<const char*>(block.data()), BlockSize * sizeof(T));
+
+			m_Blocks.clear();
+			m_Blocks.shrink_to_fit();
+			m_Cache.resize(std::max<size_t>(cachePageCount, 1));
+
+			if (!m_File)
+				m_HasFailed = true;
+
+			return !m_HasFailed;
+		}
+
+	private:
+		struct CachedPage
+		{
+			size_t pageIndex{ SIZE_MAX };
+			std::vector<T> data{};
+		};
+
+		std::vector<T> m_Tail{};
+		std::vector<std::vector<T>> m_Blocks{};
+		size_t m_BlockCount{};
+		size_t m_Size{};
+
+		std::filesystem::path m_FilePath{};
+		std::fstream m_File{};
+		std::vector<CachedPage> m_Cache{};
+		bool m_HasFailed{ false };
+
+		void FlushTail()
+		{
+			if (IsSpilled())
+			{
+				m_File.seekp(static_cast<std::streamoff>(m_BlockCount * BlockSize * sizeof(T)));
+				m_File.write(reinterpret_cast<const char*>(m_Tail.data()), BlockSize * sizeof(T));
+				if (!m_File)
+					m_HasFailed = true;
+
+				m_Tail.clear();
+			}
+			else
+			{
+				m_Blocks.push_back(std::move(m_Tail));
+				m_Tail = {};
+				m_Tail.reserve(BlockSize);
+			}
+
+			++m_BlockCount;
+		}
+
+		const T* LoadPage(size_t page)
+		{
+			CachedPage& cachedPage{ m_Cache[page % m_Cache.size()] };
+			if (cachedPage.pageIndex != page)
+			{
+				cachedPage.data.resize(PageSize);
+
+				m_File.seekg(static_cast<std::streamoff>(page * PageSize * sizeof(T)));
+				m_File.read(reinterpret_cast<char*>(cachedPage.data.data()), PageSize * sizeof(T));
+				if (!m_File)
+					m_HasFailed = true;
+
+				cachedPage.pageIndex = page;
+			}
+
+			return cachedPage.data.data();
+		}
+	};
+}
@@ -0,0 +1,159 @@
+#include "pch.h"
+#include "TangentSpace.h"
+#include "DataTypes.h"
+#include "Parallel.h"
+
+namespace dae
+{
+	namespace TangentSpace
+	{
+		namespace
+		{
+			//Work is split in ranges this big, so small meshes stay on the calling thread
+			constexpr size_t g_RangeSize{ 16384 };
+
+			//Contribution of one triangle corner, already weighted by its angle, and the area weighted normal of its triangle
+			struct CornerFrame
+			{
+				Vector3 tangent{};
+				Vector3 bitangent{};
+				Vector3 faceNormal{};
+			};
+
+			//Vector3::Reject divides by the length of the normal, a mesh without normals would turn every tangent into NaN
+			Vector3 Reject(const Vector3& v, const Vector3& normal)
+			{
+				const float sqrNormalLength{ normal.SqrMagnitude() };
+				if (sqrNormalLength <= FLT_MIN)
+					return v;
+
+				return v - normal * (Vector3::Dot(v, normal) / sqrNormalLength);
+			}
+
+			Vector3 ProjectOnPlane(const Vector3& v, const Vector3& normal)
+			{
+				Vector3 projected{ Reject(v, normal) };
+				if (projected.SqrMagnitude() > FLT_MIN)
+					projected.Normalize();
+				else
+					projected = Vector3::Zero;
+
+				return projected;
+			}
+
+			void CalculateCornerFrames(const Vertex* pVertices, const uint32_t* pTriangle, CornerFrame* pFrames)
+			{
+				const Vertex& v0{ pVertices[pTriangle[0]] };
+				const Vertex& v1{ pVertices[pTriangle[1]] };
+				const Vertex& v2{ pVertices[pTriangle[2]] };
+
+				const Vector3 edge0{ v1.position - v0.position };
+				const Vector3 edge1{ v2.position - v0.position };
+				const Vector2 uvEdge0{ v1.uv - v0.uv };
+				const Vector2 uvEdge1{ v2.uv - v0.uv };
+
+				//Corners without a normal, like those of an OBJ without vn lines, are projected onto the plane of the triangle instead
+				const Vector3 faceNormal{ Vector3::Cross(edge0, edge1) };
+				for (int i{ 0 }; i < 3; ++i)
+					pFrames[i] = { {}, {}, faceNormal };
+
+				//Both derivatives are scaled by the signed uv area, normalizing them (below) removes it together with its sign
+				const float uvArea{ Vector2::Cross(uvEdge0, uvEdge1) };
+				if (std::abs(uvArea) <= FLT_MIN)
+					return;
+
+				const float areaSign{ uvArea > 0.f ? 1.f : -1.f };
+				const Vector3 faceTangent{ (edge0 * uvEdge1.y - edge1 * uvEdge0.y) * areaSign };
+				const Vector3 faceBitangent{ (edge1 * uvEdge0.x - edge0 * uvEdge1.x) * areaSign };
+
+				const Vertex* corners[3]{ &v0, &v1, &v2 };
+				for (int i{ 0 }; i < 3; ++i)
+				{
+					const Vertex& corner{ *corners[i] };
+					const Vector3& normal{ corner.normal.SqrMagnitude() > FLT_MIN ? corner.normal : faceNormal };
+
+					//The corner angle is measured in the normal's plane as well, like MikkTSpace does
+					const Vector3 toNext{ ProjectOnPlane(corners[(i + 1) % 3]->position - corner.position, normal) };
+					const Vector3 toPrevious{ ProjectOnPlane(corners[(i + 2) % 3]->position - corner.position, normal) };
+					const float angle{ acosf(std::clamp(Vector3::Dot(toNext, toPrevious), -1.f, 1.f)) };
+
+					pFrames[i].tangent = ProjectOnPlane(faceTangent, normal) * angle;
+					pFrames[i].bitangent = ProjectOnPlane(faceBitangent, normal) * angle;
+				}
+			}
+		}
+
+		void Generate(Vertex* pVertices, size_t vertexCount, const uint32_t* pIndices, size_t indexCount, uint32_t threadCount)
+		{
+			const size_t triangleCount{ indexCount / 3 };
+			const size_t cornerCount{ triangleCount * 3 };
+
+			//1. Every triangle writes its own three slots, no two threads touch the same memory
+			std::vector<CornerFrame> frames(cornerCount);
+			const uint32_t triangleRangeCount{ static_cast<uint32_t>((triangleCount + g_RangeSize - 1) / g_RangeSize) };
+			Parallel::For(triangleRangeCount, threadCount, [&](uint32_t iRange)
+				{
+					const size_t end{ std::min(triangleCount, (iRange + 1) * g_RangeSize) };
+					for (size_t iTriangle{ iRange * g_RangeSize }; iTriangle < end; ++iTriangle)
+						CalculateCornerFrames(pVertices, pIndices + iTriangle * 3, frames.data() + iTriangle * 3);
+				});
+
+			//2. List the corners of every vertex, in index order
+			std::vector<uint32_t> firstCorners(vertexCount + 1, 0);
+			for (size_t i{ 0 }; i < cornerCount; ++i)
+				++firstCorners[pIndices[i] + 1];
+
+			for (size_t i{ 0 }; i < vertexCount; ++i)
+				firstCorners[i + 1] += firstCorners[i];
+
+			std::vector<uint32_t> vertexCorners(cornerCount);
+			{
+				std::vector<uint32_t> nextCorners(firstCorners.begin(), firstCorners.end() - 1);
+				for (size_t i{ 0 }; i < cornerCount; ++i)
+					vertexCorners[nextCorners[pIndices[i]]++] = static_cast<uint32_t>(i);
+			}
+
+			//3. Every vertex gathers its corners, so again no two threads write the same vertex
+			const uint32_t vertexRangeCount{ static_cast<uint32_t>((vertexCount + g_RangeSize - 1) / g_RangeSize) };
+			Parallel::For(vertexRangeCount, threadCount, [&](uint32_t iRange)
+				{
+					const size_t end{ std::min(vertexCount, (iRange + 1) * g_RangeSize) };
+					for (size_t iVertex{ iRange * g_RangeSize }; iVertex < end; ++iVertex)
+					{
+						Vertex& vertex{ pVertices[iVertex] };
+
+						Vector3 tangent{};
+						Vector3 bitangent{};
+						Vector3 faceNormal{};
+						for (uint32_t i{ firstCorners[iVertex] }; i < firstCorners[iVertex + 1]; ++i)
+						{
+							tangent += frames[vertexCorners[i]].tangent;
+							bitangent += frames[vertexCorners[i]].bitangent;
+							faceNormal += frames[vertexCorners[i]].faceNormal;
+						}
+
+						//Without a normal of its own the frame is built around the normal of its faces, without those (a vertex of
+						//degenerate triangles only) there is no plane to stay in and the tangent ends up on a fixed axis
+						Vector3 normal{ vertex.normal.SqrMagnitude() > FLT_MIN ? vertex.normal : faceNormal };
+						if (normal.SqrMagnitude() > FLT_MIN)
+							normal.Normalize();
+						else
+							normal = Vector3::Zero;
+
+						tangent = Reject(tangent, normal);
+						if (tangent.SqrMagnitude() <= FLT_MIN)
+						{
+							//No usable uv gradient, any direction perpendicular to the normal will do
+							const Vector3& axis{ std::abs(normal.x) < 0.9f ? Vector3::UnitX : Vector3::UnitY };
+							tangent = Reject(axis, normal);
+						}
+
+						tangent.Normalize();
+
+						const float handedness{ Vector3::Dot(Vector3::Cross(normal, tangent), bitangent) < 0.f ? -1.f : 1.f };
+						vertex.tangent = Vector4{ tangent, handedness };
+					}
+				});
+		}
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+
+struct Vertex;
+
+namespace dae
+{
+	namespace TangentSpace
+	{
+		//MikkTSpace style tangents: every triangle corner contributes its uv derivatives, projected onto the vertex normal's plane
+		//and weighted by the corner angle. The xyz is the averaged tangent and w the handedness, so bitangent = cross(normal, tangent) * w.
+		//Triangles are processed in parallel and every vertex sums its own corners in index order, so the result does not depend on the thread count.
+		//Vertices with a zero normal, like those of an OBJ without vn lines, build their frame around the normal of their faces instead.
+		void Generate(Vertex* pVertices, size_t vertexCount, const uint32_t* pIndices, size_t indexCount, uint32_t threadCount = 0);
+	}
+}
@@ -0,0 +1,75 @@
+#include "pch.h"
+#include "Transform.h"
+
+namespace dae
+{
+	Transform::Transform(const Vector3& position, const Quaternion& rotation, const Vector3& scale) :
+		m_Position{ position },
+		m_Rotation{ rotation.Normalized() },
+		m_Scale{ scale },
+		m_IsWorldMatrixDirty{ true }
+	{
+	}
+
+	void Transform::SetPosition(const Vector3& position)
+	{
+		m_Position = position;
+		m_IsWorldMatrixDirty = true;
+	}
+
+	void Transform::SetRotation(const Quaternion& rotation)
+	{
+		m_Rotation = rotation.Normalized();
+		m_RotationsSinceNormalize = 0;
+		m_IsWorldMatrixDirty = true;
+	}
+
+	void Transform::SetScale(const Vector3& scale)
+	{
+		m_Scale = scale;
+		m_IsWorldMatrixDirty = true;
+	}
+
+	void Transform::Translate(const Vector3& offset)
+	{
+		m_Position += offset;
+		m_IsWorldMatrixDirty = true;
+	}
+
+	void Transform::Rotate(const Quaternion& rotation)
+	{
+		m_Rotation = rotation * m_Rotation;
+
+		if (++m_RotationsSinceNormalize >= m_RotationsPerNormalize)
+		{
+			m_Rotation.Normalize();
+			m_RotationsSinceNormalize = 0;
+		}
+
+		m_IsWorldMatrixDirty = true;
+	}
+
+	const Matrix& Transform::GetWorldMatrix() const
+	{
+		if (m_IsWorldMatrixDirty)
+		{
+			//Same as CreateScale * rotation * CreateTranslation, without the two matrix products: scale the rotation rows and append the position
+			const Matrix rotation{ m_Rotation.ToMatrix() };
+			m_WorldMatrix = {
+				rotation.GetAxisX() * m_Scale.x,
+				rotation.GetAxisY() * m_Scale.y,
+				rotation.GetAxisZ() * m_Scale.z,
+				m_Position };
+
+			m_IsWorldMatrixDirty = false;
+		}
+
+		return m_WorldMatrix;
+	}
+
+	Vector3 Transform::InverseTransformPoint(const Vector3& point) const
+	{
+		const Vector3 local{ m_Rotation.Conjugate().Rotate(point - m_Position) };
+		return { local.x / m_Scale.x, local.y / m_Scale.y, local.z / m_Scale.z };
+	}
+}
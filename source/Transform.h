@@ -0,0 +1,43 @@
+#pragma once
+#include "Quaternion.h"
+
+namespace dae
+{
+	//Position, rotation and scale of an object. The world matrix (scale, then rotation, then translation) is cached
+	//and only rebuilt the first time it is asked for after something changed.
+	class Transform final
+	{
+	public:
+		Transform() = default;
+		explicit Transform(const Vector3& position, const Quaternion& rotation = Quaternion::Identity, const Vector3& scale = { 1.f, 1.f, 1.f });
+
+		inline const Vector3& GetPosition() const { return m_Position; }
+		inline const Quaternion& GetRotation() const { return m_Rotation; }
+		inline const Vector3& GetScale() const { return m_Scale; }
+
+		void SetPosition(const Vector3& position);
+		void SetRotation(const Quaternion& rotation);
+		void SetScale(const Vector3& scale);
+
+		void Translate(const Vector3& offset);
+		//Applied in local space, before the current rotation
+		void Rotate(const Quaternion& rotation);
+
+		const Matrix& GetWorldMatrix() const;
+
+		//Object space position of a world space point, without inverting the world matrix
+		Vector3 InverseTransformPoint(const Vector3& point) const;
+
+	private:
+		Vector3 m_Position{};
+		Quaternion m_Rotation{};
+		Vector3 m_Scale{ 1.f, 1.f, 1.f };
+
+		//Rounding in every product slowly pulls the rotation away from unit length, it is normalized again every this many rotations
+		static constexpr uint32_t m_RotationsPerNormalize{ 64 };
+		uint32_t m_RotationsSinceNormalize{};
+
+		mutable Matrix m_WorldMatrix{};
+		mutable bool m_IsWorldMatrixDirty{ false };
+	};
+}
@@ -0,0 +1,144 @@
+#include "pch.h"
+#include "Triangulation.h"
+
+namespace dae
+{
+	namespace Triangulation
+	{
+		namespace
+		{
+			//Newell's method, robust for slightly non-planar polygons
+			Vector3 CalculatePolygonNormal(const Vector3* pPositions, uint32_t cornerCount)
+			{
+				Vector3 normal{};
+				for (uint32_t i{ 0 }; i < cornerCount; ++i)
+				{
+					const Vector3& current{ pPositions[i] };
+					const Vector3& next{ pPositions[(i + 1) % cornerCount] };
+
+					normal.x += (current.y - next.y) * (current.z + next.z);
+					normal.y += (current.z - next.z) * (current.x + next.x);
+					normal.z += (current.x - next.x) * (current.y + next.y);
+				}
+
+				return normal;
+			}
+
+			bool IsConvex(const Vector3* pPositions, uint32_t cornerCount, const Vector3& normal)
+			{
+				for (uint32_t i{ 0 }; i < cornerCount; ++i)
+				{
+					const Vector3& previous{ pPositions[(i + cornerCount - 1) % cornerCount] };
+					const Vector3& current{ pPositions[i] };
+					const Vector3& next{ pPositions[(i + 1) % cornerCount] };
+
+					if (Vector3::Dot(Vector3::Cross(current - previous, next - current), normal) < 0.f)
+						return false;
+				}
+
+				return true;
+			}
+
+			void Fan(uint8_t firstCorner, const uint8_t* pCorners, uint32_t cornerCount, uint8_t*& pTriangleCorners)
+			{
+				for (uint32_t i{ 1 }; i + 1 < cornerCount; ++i)
+				{
+					*pTriangleCorners++ = firstCorner;
+					*pTriangleCorners++ = pCorners[i];
+					*pTriangleCorners++ = pCorners[i + 1];
+				}
+			}
+
+			inline float Cross2D(const Vector2& a, const Vector2& b, const Vector2& c)
+			{
+				return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+			}
+
+			void EarClip(const Vector3* pPositions, uint32_t cornerCount, const Vector3& normal, uint8_t* pTriangleCorners)
+			{
+				//Project onto the plane of the two axes the normal is smallest on, flipped so the polygon winds counter-clockwise
+				const Vector3 absNormal{ std::abs(normal.x), std::abs(normal.y), std::abs(normal.z) };
+				const int dropAxis{ (absNormal.x > absNormal.y && absNormal.x > absNormal.z) ? 0 : (absNormal.y > absNormal.z ? 1 : 2) };
+				const int uAxis{ (dropAxis + 1) % 3 };
+				const int vAxis{ (dropAxis + 2) % 3 };
+				const float orientation{ normal[dropAxis] < 0.f ? -1.f : 1.f };
+
+				Vector2 points[MaxPolygonCorners];
+				uint8_t remaining[MaxPolygonCorners];
+				for (uint32_t i{ 0 }; i < cornerCount; ++i)
+				{
+					points[i] = { pPositions[i][uAxis], pPositions[i][vAxis] * orientation };
+					remaining[i] = static_cast<uint8_t>(i);
+				}
+
+				uint32_t remainingCount{ cornerCount };
+				uint32_t current{ 0 };
+				uint32_t attemptsLeft{ remainingCount };
+
+				while (remainingCount > 3 && attemptsLeft > 0)
+				{
+					const uint32_t previous{ (current + remainingCount - 1) % remainingCount };
+					const uint32_t next{ (current + 1) % remainingCount };
+
+					const Vector2& a{ points[remaining[previous]] };
+					const Vector2& b{ points[remaining[current]] };
+					const Vector2& c{ points[remaining[next]] };
+
+					bool isEar{ Cross2D(a, b, c) > 0.f };
+					for (uint32_t i{ 0 }; isEar && i < remainingCount; ++i)
+					{
+						if (i == previous || i == current || i == next)
+							continue;
+
+						const Vector2& p{ points[remaining[i]] };
+						isEar = !(Cross2D(a, b, p) >= 0.f && Cross2D(b, c, p) >= 0.f && Cross2D(c, a, p) >= 0.f);
+					}
+
+					if (!isEar)
+					{
+						current = next;
+						--attemptsLeft;
+						continue;
+					}
+
+					*pTriangleCorners++ = remaining[previous];
+					*pTriangleCorners++ = remaining[current];
+					*pTriangleCorners++ = remaining[next];
+
+					for (uint32_t i{ current }; i + 1 < remainingCount; ++i)
+						remaining[i] = remaining[i + 1];
+
+					--remainingCount;
+					current %= remainingCount;
+					attemptsLeft = remainingCount;
+				}
+
+				//Self-intersecting or degenerate leftovers have no ears, fan them so the triangle count stays cornerCount - 2
+				Fan(remaining[0], remaining, remainingCount, pTriangleCorners);
+			}
+		}
+
+		uint32_t TriangulatePolygon(const Vector3* pPositions, uint32_t cornerCount, uint8_t* pTriangleCorners)
+		{
+			if (cornerCount < 3)
+				return 0;
+
+			const Vector3 normal{ CalculatePolygonNormal(pPositions, cornerCount) };
+
+			if (cornerCount == 3 || IsConvex(pPositions, cornerCount, normal))
+			{
+				uint8_t corners[MaxPolygonCorners];
+				for (uint32_t i{ 0 }; i < cornerCount; ++i)
+					corners[i] = static_cast<uint8_t>(i);
+
+				Fan(0, corners, cornerCount, pTriangleCorners);
+			}
+			else
+			{
+				EarClip(pPositions, cornerCount, normal, pTriangleCorners);
+			}
+
+			return cornerCount - 2;
+		}
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+#include "Math.h"
+
+namespace dae
+{
+	namespace Triangulation
+	{
+		//Largest polygon the loaders accept, so corner numbers fit a byte and scratch arrays fit the stack
+		constexpr uint32_t MaxPolygonCorners{ 255 };
+
+		//Writes (cornerCount - 2) triangles as triplets of corner numbers, keeping the winding of the polygon.
+		//Convex polygons become a fan, concave ones are ear clipped in the plane the polygon faces most.
+		uint32_t TriangulatePolygon(const Vector3* pPositions, uint32_t cornerCount, uint8_t* pTriangleCorners);
+	}
+}
@@ -0,0 +1,506 @@
+#include "pch.h"
+#include "Utils.h"
+#include <chrono>
+#include "MappedFile.h"
+#include "ObjReader.h"
+#include "Parallel.h"
+#include "TangentSpace.h"
+
+namespace dae
+{
+	namespace Utils
+	{
+		namespace
+		{
+			struct ObjRecordCounts
+			{
+				size_t positions{};
+				size_t UVs{};
+				size_t normals{};
+				size_t faces{};
+			};
+
+			//Everything one worker reads from its part of the file, before indices are resolved
+			struct ObjChunk
+			{
+				std::string_view text{};
+
+				std::vector<Vector3> positions{};
+				std::vector<Vector3> normals{};
+				std::vector<Vector2> UVs{};
+				std::vector<ObjCorner> corners{};
+				std::vector<uint8_t> faceCornerCounts{};
+				bool hasPolygons{ false };
+
+				size_t positionOffset{};
+				size_t normalOffset{};
+				size_t UVOffset{};
+				size_t cornerOffset{};
+
+				bool isValid{ true };
+			};
+
+			//Cheap pre-pass so every array is allocated exactly once
+			ObjRecordCounts CountRecords(std::string_view text)
+			{
+				ObjRecordCounts counts{};
+
+				size_t lineStart{ 0 };
+				while (lineStart < text.size())
+				{
+					size_t lineEnd{ text.find('\n', lineStart) };
+					if (lineEnd == std::string_view::npos)
+						lineEnd = text.size();
+
+					size_t i{ lineStart };
+					while (i < lineEnd && (text[i] == ' ' || text[i] == '\t'))
+						++i;
+
+					if (i + 1 < lineEnd)
+					{
+						const char next{ text[i + 1] };
+						if (text[i] == 'f' && (next == ' ' || next == '\t'))
+						{
+							++counts.faces;
+						}
+						else if (text[i] == 'v')
+						{
+							if (next == ' ' || next == '\t')
+								++counts.positions;
+							else if (next == 't')
+								++counts.UVs;
+							else if (next == 'n')
+								++counts.normals;
+						}
+					}
+
+					lineStart = lineEnd + 1;
+				}
+
+				return counts;
+			}
+
+			std::vector<ObjChunk> SplitOnLines(std::string_view text, uint32_t chunkCount)
+			{
+				//Small files are not worth waking up threads for
+				static constexpr size_t minChunkSize{ 256 * 1024 };
+				chunkCount = static_cast<uint32_t>(std::clamp<size_t>(text.size() / minChunkSize, 1, chunkCount));
+
+				std::vector<ObjChunk> chunks{};
+				chunks.reserve(chunkCount);
+
+				const size_t chunkSize{ text.size() / chunkCount + 1 };
+
+				size_t start{ 0 };
+				while (start < text.size())
+				{
+					size_t end{ std::min(start + chunkSize, text.size()) };
+					if (end < text.size())
+					{
+						end = text.find('\n', end);
+						end = (end == std::string_view::npos) ? text.size() : end + 1;
+					}
+
+					chunks.emplace_back().text = text.substr(start, end - start);
+					start = end;
+				}
+
+				return chunks;
+			}
+
+			struct ChunkRecordHandler
+			{
+				ObjChunk& chunk;
+
+				void OnPosition(const Vector3& position) { chunk.positions.push_back(position); }
+				void OnUV(const Vector2& uv) { chunk.UVs.push_back(uv); }
+				void OnNormal(const Vector3& normal) { chunk.normals.push_back(normal); }
+
+				//Negative indices are resolved against this chunk only, ResolveChunk() offsets them once the earlier chunks are merged
+				ObjIndexBase GetIndexBase() const
+				{
+					return { static_cast<uint32_t>(chunk.positions.size()), static_cast<uint32_t>(chunk.UVs.size()), static_cast<uint32_t>(chunk.normals.size()), ObjCorner::LocalIndexFlag };
+				}
+
+				//Polygons are kept whole, they can only be triangulated once every position they use is known
+				bool OnFace(const ObjCorner* pCorners, uint32_t cornerCount)
+				{
+					chunk.corners.insert(chunk.corners.end(), pCorners, pCorners + cornerCount);
+					chunk.faceCornerCounts.push_back(static_cast<uint8_t>(cornerCount));
+					chunk.hasPolygons |= cornerCount > 3;
+					return true;
+				}
+			};
+
+			void ParseChunk(ObjChunk& chunk)
+			{
+				const ObjRecordCounts counts{ CountRecords(chunk.text) };
+				chunk.positions.reserve(counts.positions);
+				chunk.normals.reserve(counts.normals);
+				chunk.UVs.reserve(counts.UVs);
+				chunk.corners.reserve(counts.faces * 3);
+				chunk.faceCornerCounts.reserve(counts.faces);
+
+				ObjReader reader{ chunk.text };
+				ChunkRecordHandler handler{ chunk };
+				chunk.isValid = ObjRecords::Parse(reader, handler);
+			}
+
+			template<typename T>
+			void MergeAttribute(std::vector<ObjChunk>& chunks, std::vector<T> ObjChunk::* pAttribute, size_t ObjChunk::* pOffset, std::vector<T>& merged, uint32_t threadCount)
+			{
+				if (chunks.size() == 1)
+				{
+					merged = std::move(chunks[0].*pAttribute);
+					return;
+				}
+
+				size_t total{ 0 };
+				for (ObjChunk& chunk : chunks)
+				{
+					chunk.*pOffset = total;
+					total += (chunk.*pAttribute).size();
+				}
+
+				merged.resize(total);
+				Parallel::For(static_cast<uint32_t>(chunks.size()), threadCount, [&](uint32_t i)
+					{
+						std::vector<T>& attribute{ chunks[i].*pAttribute };
+						std::copy(attribute.begin(), attribute.end(), merged.begin() + (chunks[i].*pOffset));
+						attribute = {};
+					});
+			}
+
+			inline bool ResolveIndex(uint32_t& index, size_t chunkOffset, size_t attributeCount)
+			{
+				if (index & ObjCorner::LocalIndexFlag)
+				{
+					//Sign extend the 31-bit chunk index, it can point into an earlier chunk
+					const int64_t chunkIndex{ static_cast<int32_t>(index << 1) >> 1 };
+					const int64_t resolved{ chunkIndex + static_cast<int64_t>(chunkOffset) };
+					if (resolved < 1)
+						return false;
+
+					index = static_cast<uint32_t>(std::min<int64_t>(resolved, UINT32_MAX));
+				}
+
+				// OBJ format uses 1-based arrays
+				return index <= attributeCount;
+			}
+
+			//Attributes can be referenced before the chunk that defines them has been merged, so validation waits until everything is known.
+			//Afterwards the chunk only holds triangles.
+			bool ResolveChunk(ObjChunk& chunk, const std::vector<Vector3>& positions, size_t UVCount, size_t normalCount)
+			{
+				for (ObjCorner& corner : chunk.corners)
+				{
+					if (!ResolveIndex(corner.position, chunk.positionOffset, positions.size()) || corner.position == 0 ||
+						!ResolveIndex(corner.uv, chunk.UVOffset, UVCount) ||
+						!ResolveIndex(corner.normal, chunk.normalOffset, normalCount))
+						return false;
+				}
+
+				if (chunk.hasPolygons)
+				{
+					std::vector<ObjCorner> triangleCorners{};
+					triangleCorners.reserve(chunk.corners.size() * 2);
+
+					Vector3 polygon[Triangulation::MaxPolygonCorners];
+					uint8_t polygonTriangles[(Triangulation::MaxPolygonCorners - 2) * 3];
+
+					const ObjCorner* pFace{ chunk.corners.data() };
+					for (const uint8_t cornerCount : chunk.faceCornerCounts)
+					{
+						for (uint32_t i{ 0 }; i < cornerCount; ++i)
+							polygon[i] = positions[pFace[i].position - 1];
+
+						const uint32_t triangleCount{ Triangulation::TriangulatePolygon(polygon, cornerCount, polygonTriangles) };
+						for (uint32_t i{ 0 }; i < triangleCount * 3; ++i)
+							triangleCorners.push_back(pFace[polygonTriangles[i]]);
+
+						pFace += cornerCount;
+					}
+
+					chunk.corners = std::move(triangleCorners);
+				}
+
+				chunk.faceCornerCounts = {};
+				return true;
+			}
+
+			Vertex MakeVertex(const ObjCorner& corner, const std::vector<Vector3>& positions, const std::vector<Vector2>& UVs, const std::vector<Vector3>& normals)
+			{
+				Vertex vertex{};
+				vertex.position = positions[corner.position - 1];
+
+				if (corner.uv != 0)
+					vertex.uv = UVs[corner.uv - 1];
+
+				if (corner.normal != 0)
+					vertex.normal = normals[corner.normal - 1];
+
+				return vertex;
+			}
+
+			void AddFaceIndices(uint32_t* pFaceIndices, const uint32_t tempIndices[3], bool flipAxisAndWinding)
+			{
+				pFaceIndices[0] = tempIndices[0];
+				if (flipAxisAndWinding)
+				{
+					pFaceIndices[1] = tempIndices[2];
+					pFaceIndices[2] = tempIndices[1];
+				}
+				else
+				{
+					pFaceIndices[1] = tempIndices[1];
+					pFaceIndices[2] = tempIndices[2];
+				}
+			}
+
+			//Every corner becomes its own vertex, bit-exact with the original loader
+			void ExpandChunk(const ObjChunk& chunk, const std::vector<Vector3>& positions, const std::vector<Vector2>& UVs, const std::vector<Vector3>& normals,
+				Vertex* pVertices, uint32_t* pIndices, bool flipAxisAndWinding)
+			{
+				for (size_t iCorner{ 0 }; iCorner < chunk.corners.size(); iCorner += 3)
+				{
+					uint32_t tempIndices[3];
+					for (size_t iFace = 0; iFace < 3; iFace++)
+					{
+						const size_t vertexIndex{ chunk.cornerOffset + iCorner + iFace };
+						pVertices[vertexIndex] = MakeVertex(chunk.corners[iCorner + iFace], positions, UVs, normals);
+						tempIndices[iFace] = static_cast<uint32_t>(vertexIndex);
+					}
+
+					AddFaceIndices(pIndices + chunk.cornerOffset + iCorner, tempIndices, flipAxisAndWinding);
+				}
+			}
+
+			//Open addressing table from (position, uv, normal) triplet to welded vertex index
+			class CornerWelder final
+			{
+			public:
+				explicit CornerWelder(size_t cornerCount)
+				{
+					size_t capacity{ 16 };
+					while (capacity < cornerCount * 2)
+						capacity *= 2;
+
+					m_Slots.resize(capacity, m_EmptySlot);
+					m_Keys.reserve(cornerCount);
+				}
+
+				//Returns the vertex index for the corner, isNew tells if a vertex has to be created for it
+				uint32_t FindOrAdd(const ObjCorner& corner, bool& isNew)
+				{
+					const size_t mask{ m_Slots.size() - 1 };
+					for (size_t slot{ Hash(corner) & mask };; slot = (slot + 1) & mask)
+					{
+						const uint32_t vertexIndex{ m_Slots[slot] };
+						if (vertexIndex == m_EmptySlot)
+						{
+							isNew = true;
+							m_Slots[slot] = static_cast<uint32_t>(m_Keys.size());
+							m_Keys.push_back(corner);
+							return m_Slots[slot];
+						}
+
+						const ObjCorner& key{ m_Keys[vertexIndex] };
+						if (key.position == corner.position && key.uv == corner.uv && key.normal == corner.normal)
+						{
+							isNew = false;
+							return vertexIndex;
+						}
+					}
+				}
+
+			private:
+				static constexpr uint32_t m_EmptySlot{ UINT32_MAX };
+
+				std::vector<uint32_t> m_Slots{};
+				std::vector<ObjCorner> m_Keys{};
+
+				static size_t Hash(const ObjCorner& corner)
+				{
+					uint64_t hash{ corner.position * 0x9E3779B97F4A7C15ull };
+					hash ^= (corner.uv + 0x632BE59BD9B4E019ull) * 0xC2B2AE3D27D4EB4Full;
+					hash ^= (corner.normal + 0x165667B19E3779F9ull) * 0x94D049BB133111EBull;
+					return static_cast<size_t>(hash ^ (hash >> 29));
+				}
+			};
+
+			void WeldChunks(const std::vector<ObjChunk>& chunks, size_t cornerCount, const std::vector<Vector3>& positions, const std::vector<Vector2>& UVs, const std::vector<Vector3>& normals,
+				std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding)
+			{
+				CornerWelder welder{ cornerCount };
+				vertices.reserve(std::min(cornerCount, positions.size() * 2));
+				indices.resize(cornerCount);
+
+				for (const ObjChunk& chunk : chunks)
+				{
+					for (size_t iCorner{ 0 }; iCorner < chunk.corners.size(); iCorner += 3)
+					{
+						uint32_t tempIndices[3];
+						for (size_t iFace = 0; iFace < 3; iFace++)
+						{
+							const ObjCorner& corner{ chunk.corners[iCorner + iFace] };
+
+							bool isNew{};
+							tempIndices[iFace] = welder.FindOrAdd(corner, isNew);
+							if (isNew)
+								vertices.push_back(MakeVertex(corner, positions, UVs, normals));
+						}
+
+						AddFaceIndices(indices.data() + chunk.cornerOffset + iCorner, tempIndices, flipAxisAndWinding);
+					}
+				}
+			}
+		}
+
+		void CalculateTangents(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, bool flipAxisAndWinding, uint32_t threadCount)
+		{
+			//Tangents are generated after the flip, so their handedness matches the mesh that gets rendered
+			if (flipAxisAndWinding)
+			{
+				for (Vertex& v : vertices)
+				{
+					v.position.z *= -1.f;
+					v.normal.z *= -1.f;
+				}
+			}
+
+			TangentSpace::Generate(vertices.data(), vertices.size(), indices.data(), indices.size(), threadCount);
+		}
+
+		bool ParseOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding)
+		{
+			OBJParseSettings settings{};
+			settings.flipAxisAndWinding = flipAxisAndWinding;
+			settings.weldVertices = false;
+			settings.optimizeVertexCache = false;
+			settings.optimizeOverdraw = false;
+
+			return ParseOBJ(filename, vertices, indices, settings);
+		}
+
+		bool ParseOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, const OBJParseSettings& settings, OBJParseStatistics* pStatistics)
+		{
+			const MappedFile file{ filename };
+			return ParseOBJ(file, vertices, indices, settings, pStatistics);
+		}
+
+		bool ParseOBJ(const MappedFile& file, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, const OBJParseSettings& settings, OBJParseStatistics* pStatistics)
+		{
+			const auto startTime{ std::chrono::steady_clock::now() };
+
+			if (!file.IsOpen())
+				return false;
+
+			vertices.clear();
+			indices.clear();
+
+			const uint32_t threadCount{ Parallel::ResolveThreadCount(settings.threadCount) };
+
+			//1. Parse every chunk into its own buffers
+			std::vector<ObjChunk> chunks{ SplitOnLines(file.GetView(), threadCount) };
+			if (chunks.empty())
+				return true;
+
+			Parallel::For(static_cast<uint32_t>(chunks.size()), threadCount, [&](uint32_t i)
+				{
+					ParseChunk(chunks[i]);
+				});
+
+			//2. Merge the attributes in file order, so the 1-based indices stay valid across chunks
+			for (const ObjChunk& chunk : chunks)
+			{
+				if (!chunk.isValid)
+					return false;
+			}
+
+			std::vector<Vector3> positions{};
+			std::vector<Vector3> normals{};
+			std::vector<Vector2> UVs{};
+			MergeAttribute(chunks, &ObjChunk::positions, &ObjChunk::positionOffset, positions, threadCount);
+			MergeAttribute(chunks, &ObjChunk::normals, &ObjChunk::normalOffset, normals, threadCount);
+			MergeAttribute(chunks, &ObjChunk::UVs, &ObjChunk::UVOffset, UVs, threadCount);
+
+			//3. Resolve the corners into triangles, then into vertices and indices
+			std::atomic<bool> isValid{ true };
+			Parallel::For(static_cast<uint32_t>(chunks.size()), threadCount, [&](uint32_t i)
+				{
+					if (!ResolveChunk(chunks[i], positions, UVs.size(), normals.size()))
+						isValid = false;
+				});
+
+			if (!isValid)
+				return false;
+
+			size_t cornerCount{ 0 };
+			for (ObjChunk& chunk : chunks)
+			{
+				chunk.cornerOffset = cornerCount;
+				cornerCount += chunk.corners.size();
+			}
+
+			if (cornerCount > UINT32_MAX)
+				return false;
+
+			if (settings.weldVertices)
+			{
+				WeldChunks(chunks, cornerCount, positions, UVs, normals, vertices, indices, settings.flipAxisAndWinding);
+			}
+			else
+			{
+				vertices.resize(cornerCount);
+				indices.resize(cornerCount);
+
+				Parallel::For(static_cast<uint32_t>(chunks.size()), threadCount, [&](uint32_t i)
+					{
+						ExpandChunk(chunks[i], positions, UVs, normals, vertices.data(), indices.data(), settings.flipAxisAndWinding);
+					});
+			}
+
+			CalculateTangents(vertices, indices, settings.flipAxisAndWinding, threadCount);
+
+			//The statistics are left out of loadTime, so it stays comparable whatever is measured
+			std::chrono::steady_clock::duration measureTime{};
+			const auto measure = [&measureTime](auto&& analyze)
+				{
+					const auto measureStartTime{ std::chrono::steady_clock::now() };
+					analyze();
+					measureTime += std::chrono::steady_clock::now() - measureStartTime;
+				};
+
+			const bool measureOverdraw{ pStatistics && settings.measureOverdraw };
+			if (pStatistics)
+				measure([&]() { pStatistics->fileOrderVertexCache = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertices.size()); });
+
+			if (measureOverdraw)
+				measure([&]() { pStatistics->fileOrderOverdraw = MeshOptimizer::AnalyzeOverdraw(indices.data(), indices.size(), vertices.data(), vertices.size()); });
+
+			if (settings.optimizeVertexCache)
+				MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), vertices.size());
+
+			if (settings.optimizeOverdraw)
+				MeshOptimizer::OptimizeOverdraw(indices.data(), indices.size(), vertices.data(), vertices.size());
+
+			if (settings.optimizeVertexCache || settings.optimizeOverdraw)
+				MeshOptimizer::OptimizeVertexFetch(vertices, indices);
+
+			if (pStatistics)
+			{
+				const auto endTime{ std::chrono::steady_clock::now() };
+
+				if (measureOverdraw)
+					pStatistics->overdraw = MeshOptimizer::AnalyzeOverdraw(indices.data(), indices.size(), vertices.data(), vertices.size());
+
+				pStatistics->vertexCache = MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertices.size());
+				pStatistics->cornerCount = cornerCount;
+				pStatistics->vertexCount = vertices.size();
+				pStatistics->loadTime = std::chrono::duration<float, std::milli>(endTime - startTime - measureTime).count();
+			}
+
+			return true;
+		}
+	}
+}
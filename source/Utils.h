@@ -1,165 +1,68 @@
 #pragma once
-#include <fstream>
+#include <string>
 #include <vector>
 #include "Math.h"
 #include "DataTypes.h"
+#include "MeshOptimizer.h"
 
 namespace dae
 {
+	class MappedFile;
+
 	namespace Utils
 	{
-		//Just parses vertices and indices
-#pragma warning(push)
-#pragma warning(disable : 4505) //Warning unreferenced local function
-		static bool ParseOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding = true)
+		struct OBJParseSettings
 		{
-			std::ifstream file(filename);
-			if (!file)
-				return false;
-
-			std::vector<Vector3> positions{};
-			std::vector<Vector3> normals{};
-			std::vector<Vector2> UVs{};
-
-			vertices.clear();
-			indices.clear();
-
-			std::string sCommand;
-			// start a while iteration ending when the end of file is reached (ios::eof)
-			while (!file.eof())
-			{
-				//read the first word of the string, use the >> operator (istream::operator>>) 
-				file >> sCommand;
-				//use conditional statements to process the different commands	
-				if (sCommand == "#")
-				{
-					// Ignore Comment
-				}
-				else if (sCommand == "v")
-				{
-					//Vertex
-					float x, y, z;
-					file >> x >> y >> z;
+			bool flipAxisAndWinding{ true };
 
-					positions.emplace_back(x, y, z);
-				}
-				else if (sCommand == "vt")
-				{
-					// Vertex TexCoord
-					float u, v;
-					file >> u >> v;
-					UVs.emplace_back(u, 1 - v);
-				}
-				else if (sCommand == "vn")
-				{
-					// Vertex Normal
-					float x, y, z;
-					file >> x >> y >> z;
+			//The file is split on line boundaries into one chunk per thread, 0 uses every hardware thread.
+			//The output does not depend on the thread count.
+			uint32_t threadCount{ 1 };
 
-					normals.emplace_back(x, y, z);
-				}
-				else if (sCommand == "f")
-				{
-					//if a face is read:
-					//construct the 3 vertices, add them to the vertex array
-					//add three indices to the index array
-					//add the material index as attibute to the attribute array
-					//
-					// Faces or triangles
-					Vertex vertex{};
-					size_t iPosition, iTexCoord, iNormal;
+			//Shares vertices between faces that use the same (position, uv, normal) triplet.
+			//Disable it to get one vertex per face corner, like the original loader.
+			bool weldVertices{ true };
 
-					uint32_t tempIndices[3];
-					for (size_t iFace = 0; iFace < 3; iFace++)
-					{
-						// OBJ format uses 1-based arrays
-						file >> iPosition;
-						vertex.position = positions[iPosition - 1];
+			//Reorders the triangles for the post-transform cache, then the vertices for fetch locality (see MeshOptimizer).
+			//Only pays off on welded meshes, unwelded ones have no shared vertices to reuse.
+			bool optimizeVertexCache{ true };
 
-						if ('/' == file.peek())//is next in buffer ==  '/' ?
-						{
-							file.ignore();//read and ignore one element ('/')
+			//Sorts clusters of triangles so the ones that occlude most are drawn first, at a small vertex cache cost
+			bool optimizeOverdraw{ true };
 
-							if ('/' != file.peek())
-							{
-								// Optional texture coordinate
-								file >> iTexCoord;
-								vertex.uv = UVs[iTexCoord - 1];
-							}
-
-							if ('/' == file.peek())
-							{
-								file.ignore();
-
-								// Optional vertex normal
-								file >> iNormal;
-								vertex.normal = normals[iNormal - 1];
-							}
-						}
-
-						vertices.push_back(vertex);
-						tempIndices[iFace] = uint32_t(vertices.size()) - 1;
-						//indices.push_back(uint32_t(vertices.size()) - 1);
-					}
-
-					indices.push_back(tempIndices[0]);
-					if (flipAxisAndWinding)
-					{
-						indices.push_back(tempIndices[2]);
-						indices.push_back(tempIndices[1]);
-					}
-					else
-					{
-						indices.push_back(tempIndices[1]);
-						indices.push_back(tempIndices[2]);
-					}
-				}
-				//read till end of line and ignore all remaining chars
-				file.ignore(1000, '\n');
-			}
+			//Fills the overdraw statistics, which rasterizes the mesh from every side twice and takes far longer than loading it.
+			//Only a measurement, so it is not part of the cache key.
+			bool measureOverdraw{ false };
 
-			//Cheap Tangent Calculations
-			for (uint32_t i = 0; i < indices.size(); i += 3)
+			//Identifies the settings that change the output, the thread count does not
+			uint32_t GetCacheKey() const
 			{
-				uint32_t index0 = indices[i];
-				uint32_t index1 = indices[size_t(i) + 1];
-				uint32_t index2 = indices[size_t(i) + 2];
-
-				const Vector3& p0 = vertices[index0].position;
-				const Vector3& p1 = vertices[index1].position;
-				const Vector3& p2 = vertices[index2].position;
-				const Vector2& uv0 = vertices[index0].uv;
-				const Vector2& uv1 = vertices[index1].uv;
-				const Vector2& uv2 = vertices[index2].uv;
-
-				const Vector3 edge0 = p1 - p0;
-				const Vector3 edge1 = p2 - p0;
-				const Vector2 diffX = Vector2(uv1.x - uv0.x, uv2.x - uv0.x);
-				const Vector2 diffY = Vector2(uv1.y - uv0.y, uv2.y - uv0.y);
-				float r = 1.f / Vector2::Cross(diffX, diffY);
-
-				Vector3 tangent = (edge0 * diffY.y - edge1 * diffY.x) * r;
-				vertices[index0].tangent += tangent;
-				vertices[index1].tangent += tangent;
-				vertices[index2].tangent += tangent;
+				return (flipAxisAndWinding ? 1u : 0u) | (weldVertices ? 2u : 0u) | (optimizeVertexCache ? 4u : 0u) | (optimizeOverdraw ? 8u : 0u);
 			}
+		};
 
-			//Create the Tangents (reject)
-			for (auto& v : vertices)
-			{
-				v.tangent = Vector3::Reject(v.tangent, v.normal).Normalized();
-
-				if (flipAxisAndWinding)
-				{
-					v.position.z *= -1.f;
-					v.normal.z *= -1.f;
-					v.tangent.z *= -1.f;
-				}
-
-			}
-
-			return true;
-		}
-#pragma warning(pop)
+		struct OBJParseStatistics
+		{
+			size_t cornerCount{};	//Vertices the mesh would have without welding
+			size_t vertexCount{};
+			float loadTime{};		//Milliseconds, without the time spent measuring the statistics
+
+			//Index buffer in file order and after optimizeVertexCache, the same when it is disabled
+			MeshOptimizer::VertexCacheStatistics fileOrderVertexCache{};
+			MeshOptimizer::VertexCacheStatistics vertexCache{};
+
+			//Only measured when measureOverdraw is set
+			MeshOptimizer::OverdrawStatistics fileOrderOverdraw{};
+			MeshOptimizer::OverdrawStatistics overdraw{};
+		};
+
+		//The output of the original loader: one vertex per face corner and the triangles in file order, so without welding or optimizations.
+		//The settings overloads weld and optimize by default, pass OBJParseSettings to get the compact mesh.
+		bool ParseOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding = true);
+		bool ParseOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, const OBJParseSettings& settings, OBJParseStatistics* pStatistics = nullptr);
+		bool ParseOBJ(const MappedFile& file, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, const OBJParseSettings& settings, OBJParseStatistics* pStatistics = nullptr);
+
+		//Applies the z flip of the loaders, then generates the tangent space of the flipped mesh (see TangentSpace::Generate)
+		void CalculateTangents(std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, bool flipAxisAndWinding, uint32_t threadCount = 0);
 	}
-}
\ No newline at end of file
+}
@@ -1,4 +1,6 @@
 #pragma once
+#include <cassert>
+#include <cmath>
 
 namespace dae
 {
@@ -7,40 +9,150 @@ namespace dae
 		float x{};
 		float y{};
 
-		Vector2() = default;
-		Vector2(float _x, float _y);
-		Vector2(const Vector2& from, const Vector2& to);
+		constexpr Vector2() noexcept = default;
+		constexpr Vector2(float _x, float _y) noexcept;
+		constexpr Vector2(const Vector2& from, const Vector2& to) noexcept;
 
-		float Magnitude() const;
-		float SqrMagnitude() const;
-		float Normalize();
-		Vector2 Normalized() const;
+		float Magnitude() const noexcept;
+		constexpr float SqrMagnitude() const noexcept;
+		float Normalize() noexcept;
+		Vector2 Normalized() const noexcept;
 
-		static float Dot(const Vector2& v1, const Vector2& v2);
-		static float Cross(const Vector2& v1, const Vector2& v2);
+		static constexpr float Dot(const Vector2& v1, const Vector2& v2) noexcept;
+		static constexpr float Cross(const Vector2& v1, const Vector2& v2) noexcept;
 
 		//Member Operators
-		Vector2 operator*(float scale) const;
-		Vector2 operator/(float scale) const;
-		Vector2 operator+(const Vector2& v) const;
-		Vector2 operator-(const Vector2& v) const;
-		Vector2 operator-() const;
+		constexpr Vector2 operator*(float scale) const noexcept;
+		constexpr Vector2 operator/(float scale) const noexcept;
+		constexpr Vector2 operator+(const Vector2& v) const noexcept;
+		constexpr Vector2 operator-(const Vector2& v) const noexcept;
+		constexpr Vector2 operator-() const noexcept;
 		//Vector2& operator-();
-		Vector2& operator+=(const Vector2& v);
-		Vector2& operator-=(const Vector2& v);
-		Vector2& operator/=(float scale);
-		Vector2& operator*=(float scale);
-		float& operator[](int index);
-		float operator[](int index) const;
+		constexpr Vector2& operator+=(const Vector2& v) noexcept;
+		constexpr Vector2& operator-=(const Vector2& v) noexcept;
+		constexpr Vector2& operator/=(float scale) noexcept;
+		constexpr Vector2& operator*=(float scale) noexcept;
+		constexpr float& operator[](int index) noexcept;
+		constexpr float operator[](int index) const noexcept;
 
 		static const Vector2 UnitX;
 		static const Vector2 UnitY;
 		static const Vector2 Zero;
 	};
 
+	constexpr Vector2::Vector2(float _x, float _y) noexcept : x(_x), y(_y) {}
+
+	constexpr Vector2::Vector2(const Vector2& from, const Vector2& to) noexcept : x(to.x - from.x), y(to.y - from.y) {}
+
 	//Global Operators
-	inline Vector2 operator*(float scale, const Vector2& v)
+	constexpr Vector2 operator*(float scale, const Vector2& v) noexcept
 	{
 		return { v.x * scale, v.y * scale };
 	}
+
+	inline float Vector2::Magnitude() const noexcept
+	{
+		return sqrtf(x * x + y * y);
+	}
+
+	constexpr float Vector2::SqrMagnitude() const noexcept
+	{
+		return x * x + y * y;
+	}
+
+	inline float Vector2::Normalize() noexcept
+	{
+		const float m = Magnitude();
+		x /= m;
+		y /= m;
+
+		return m;
+	}
+
+	inline Vector2 Vector2::Normalized() const noexcept
+	{
+		const float m = Magnitude();
+		return { x / m, y / m};
+	}
+
+	constexpr float Vector2::Dot(const Vector2& v1, const Vector2& v2) noexcept
+	{
+		return v1.x * v2.x + v1.y * v2.y;
+	}
+
+	constexpr float Vector2::Cross(const Vector2& v1, const Vector2& v2) noexcept
+	{
+		return v1.x * v2.y - v1.y * v2.x;
+	}
+
+#pragma region Operator Overloads
+	constexpr Vector2 Vector2::operator*(float scale) const noexcept
+	{
+		return { x * scale, y * scale };
+	}
+
+	constexpr Vector2 Vector2::operator/(float scale) const noexcept
+	{
+		return { x / scale, y / scale };
+	}
+
+	constexpr Vector2 Vector2::operator+(const Vector2& v) const noexcept
+	{
+		return { x + v.x, y + v.y };
+	}
+
+	constexpr Vector2 Vector2::operator-(const Vector2& v) const noexcept
+	{
+		return { x - v.x, y - v.y };
+	}
+
+	constexpr Vector2 Vector2::operator-() const noexcept
+	{
+		return { -x ,-y };
+	}
+
+	constexpr Vector2& Vector2::operator*=(float scale) noexcept
+	{
+		x *= scale;
+		y *= scale;
+		return *this;
+	}
+
+	constexpr Vector2& Vector2::operator/=(float scale) noexcept
+	{
+		x /= scale;
+		y /= scale;
+		return *this;
+	}
+
+	constexpr Vector2& Vector2::operator-=(const Vector2& v) noexcept
+	{
+		x -= v.x;
+		y -= v.y;
+		return *this;
+	}
+
+	constexpr Vector2& Vector2::operator+=(const Vector2& v) noexcept
+	{
+		x += v.x;
+		y += v.y;
+		return *this;
+	}
+
+	constexpr float& Vector2::operator[](int index) noexcept
+	{
+		assert(index <= 1 && index >= 0);
+		return index == 0 ? x : y;
+	}
+
+	constexpr float Vector2::operator[](int index) const noexcept
+	{
+		assert(index <= 1 && index >= 0);
+		return index == 0 ? x : y;
+	}
+#pragma endregion
+
+	inline constexpr Vector2 Vector2::UnitX{ 1, 0 };
+	inline constexpr Vector2 Vector2::UnitY{ 0, 1 };
+	inline constexpr Vector2 Vector2::Zero{ 0, 0 };
 }
@@ -1,8 +1,11 @@
 #pragma once
+#include <cassert>
+#include <cmath>
+#include "MathHelpers.h"
+#include "Vector2.h"
 
 namespace dae
 {
-	struct Vector2;
 	struct Vector4;
 	struct Vector3
 	{
@@ -10,42 +13,42 @@ namespace dae
 		float y{};
 		float z{};
 
-		Vector3() = default;
-		Vector3(float _x, float _y, float _z);
-		Vector3(const Vector3& from, const Vector3& to);
-		Vector3(const Vector4& v);
+		constexpr Vector3() noexcept = default;
+		constexpr Vector3(float _x, float _y, float _z) noexcept;
+		constexpr Vector3(const Vector3& from, const Vector3& to) noexcept;
+		constexpr Vector3(const Vector4& v) noexcept;
 
-		float Magnitude() const;
-		float SqrMagnitude() const;
-		float Normalize();
-		Vector3 Normalized() const;
+		float Magnitude() const noexcept;
+		constexpr float SqrMagnitude() const noexcept;
+		float Normalize() noexcept;
+		Vector3 Normalized() const noexcept;
 
-		static float Dot(const Vector3& v1, const Vector3& v2);
-		static Vector3 Cross(const Vector3& v1, const Vector3& v2);
-		static Vector3 Project(const Vector3& v1, const Vector3& v2);
-		static Vector3 Reject(const Vector3& v1, const Vector3& v2);
-		static Vector3 Reflect(const Vector3& v1, const Vector3& v2);
+		static constexpr float Dot(const Vector3& v1, const Vector3& v2) noexcept;
+		static constexpr Vector3 Cross(const Vector3& v1, const Vector3& v2) noexcept;
+		static constexpr Vector3 Project(const Vector3& v1, const Vector3& v2) noexcept;
+		static constexpr Vector3 Reject(const Vector3& v1, const Vector3& v2) noexcept;
+		static constexpr Vector3 Reflect(const Vector3& v1, const Vector3& v2) noexcept;
 
-		Vector4 ToPoint4() const;
-		Vector4 ToVector4() const;
+		constexpr Vector4 ToPoint4() const noexcept;
+		constexpr Vector4 ToVector4() const noexcept;
 
-		Vector2 GetXY() const;
+		constexpr Vector2 GetXY() const noexcept;
 
 		//Member Operators
-		Vector3 operator*(float scale) const;
-		Vector3 operator/(float scale) const;
-		Vector3 operator+(const Vector3& v) const;
-		Vector3 operator-(const Vector3& v) const;
-		Vector3 operator-() const;
+		constexpr Vector3 operator*(float scale) const noexcept;
+		constexpr Vector3 operator/(float scale) const noexcept;
+		constexpr Vector3 operator+(const Vector3& v) const noexcept;
+		constexpr Vector3 operator-(const Vector3& v) const noexcept;
+		constexpr Vector3 operator-() const noexcept;
 		//Vector3& operator-();
-		Vector3& operator+=(const Vector3& v);
-		Vector3& operator-=(const Vector3& v);
-		Vector3& operator/=(float scale);
-		Vector3& operator*=(float scale);
-		float& operator[](int index);
-		float operator[](int index) const;
+		constexpr Vector3& operator+=(const Vector3& v) noexcept;
+		constexpr Vector3& operator-=(const Vector3& v) noexcept;
+		constexpr Vector3& operator/=(float scale) noexcept;
+		constexpr Vector3& operator*=(float scale) noexcept;
+		constexpr float& operator[](int index) noexcept;
+		constexpr float operator[](int index) const noexcept;
 
-		bool operator==(const Vector3& v) const;
+		constexpr bool operator==(const Vector3& v) const noexcept;
 
 		static const Vector3 UnitX;
 		static const Vector3 UnitY;
@@ -53,9 +56,163 @@ namespace dae
 		static const Vector3 Zero;
 	};
 
+	constexpr Vector3::Vector3(float _x, float _y, float _z) noexcept : x(_x), y(_y), z(_z){}
+
+	constexpr Vector3::Vector3(const Vector3& from, const Vector3& to) noexcept : x(to.x - from.x), y(to.y - from.y), z(to.z - from.z){}
+
 	//Global Operators
-	inline Vector3 operator*(float scale, const Vector3& v)
+	constexpr Vector3 operator*(float scale, const Vector3& v) noexcept
 	{
 		return { v.x * scale, v.y * scale, v.z * scale };
 	}
+
+	inline float Vector3::Magnitude() const noexcept
+	{
+		return sqrtf(x * x + y * y + z * z);
+	}
+
+	constexpr float Vector3::SqrMagnitude() const noexcept
+	{
+		return x * x + y * y + z * z;
+	}
+
+	inline float Vector3::Normalize() noexcept
+	{
+		const float m = Magnitude();
+		x /= m;
+		y /= m;
+		z /= m;
+
+		return m;
+	}
+
+	inline Vector3 Vector3::Normalized() const noexcept
+	{
+		const float m = Magnitude();
+		return { x / m, y / m, z / m };
+	}
+
+	constexpr float Vector3::Dot(const Vector3& v1, const Vector3& v2) noexcept
+	{
+		return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+	}
+
+	constexpr Vector3 Vector3::Cross(const Vector3& v1, const Vector3& v2) noexcept
+	{
+		return Vector3{
+			v1.y * v2.z - v1.z * v2.y,
+			v1.z * v2.x - v1.x * v2.z,
+			v1.x * v2.y - v1.y * v2.x
+		};
+	}
+
+	constexpr Vector3 Vector3::Project(const Vector3& v1, const Vector3& v2) noexcept
+	{
+		return (v2 * (Dot(v1, v2) / Dot(v2, v2)));
+	}
+
+	constexpr Vector3 Vector3::Reject(const Vector3& v1, const Vector3& v2) noexcept
+	{
+		return (v1 - v2 * (Dot(v1, v2) / Dot(v2, v2)));
+	}
+
+	constexpr Vector3 Vector3::Reflect(const Vector3& v1, const Vector3& v2) noexcept
+	{
+		return v1 - (2.f * Vector3::Dot(v1, v2) * v2);
+	}
+
+	constexpr Vector2 Vector3::GetXY() const noexcept
+	{
+		return { x, y };
+	}
+
+#pragma region Operator Overloads
+	constexpr Vector3 Vector3::operator*(float scale) const noexcept
+	{
+		return { x * scale, y * scale, z * scale };
+	}
+
+	constexpr Vector3 Vector3::operator/(float scale) const noexcept
+	{
+		return { x / scale, y / scale, z / scale };
+	}
+
+	constexpr Vector3 Vector3::operator+(const Vector3& v) const noexcept
+	{
+		return { x + v.x, y + v.y, z + v.z };
+	}
+
+	constexpr Vector3 Vector3::operator-(const Vector3& v) const noexcept
+	{
+		return { x - v.x, y - v.y, z - v.z };
+	}
+
+	constexpr Vector3 Vector3::operator-() const noexcept
+	{
+		return { -x ,-y,-z };
+	}
+
+	constexpr Vector3& Vector3::operator*=(float scale) noexcept
+	{
+		x *= scale;
+		y *= scale;
+		z *= scale;
+		return *this;
+	}
+
+	constexpr Vector3& Vector3::operator/=(float scale) noexcept
+	{
+		x /= scale;
+		y /= scale;
+		z /= scale;
+		return *this;
+	}
+
+	constexpr Vector3& Vector3::operator-=(const Vector3& v) noexcept
+	{
+		x -= v.x;
+		y -= v.y;
+		z -= v.z;
+		return *this;
+	}
+
+	constexpr Vector3& Vector3::operator+=(const Vector3& v) noexcept
+	{
+		x += v.x;
+		y += v.y;
+		z += v.z;
+		return *this;
+	}
+
+	constexpr float& Vector3::operator[](int index) noexcept
+	{
+		assert(index <= 2 && index >= 0);
+
+		if (index == 0) return x;
+		if (index == 1) return y;
+		return z;
+	}
+
+	constexpr float Vector3::operator[](int index) const noexcept
+	{
+		assert(index <= 2 && index >= 0);
+
+		if (index == 0) return x;
+		if (index == 1) return y;
+		return z;
+	}
+
+	constexpr bool Vector3::operator==(const Vector3& v) const noexcept
+	{
+		return AreEqual(x, v.x) && AreEqual(y, v.y) && AreEqual(z, v.z);
+	}
+#pragma endregion
+
+	inline constexpr Vector3 Vector3::UnitX{ 1, 0, 0 };
+	inline constexpr Vector3 Vector3::UnitY{ 0, 1, 0 };
+	inline constexpr Vector3 Vector3::UnitZ{ 0, 0, 1 };
+	inline constexpr Vector3 Vector3::Zero{ 0, 0, 0 };
 }
+
+//The conversions to and from Vector4 need both types complete, they are defined in Vector4.h
+#include "Vector4.h"
@@ -1,9 +1,11 @@
 #pragma once
+#include <cassert>
+#include <cmath>
+#include "Vector2.h"
+#include "Vector3.h"
 
 namespace dae
 {
-	struct Vector2;
-	struct Vector3;
 	struct Vector4
 	{
 		float x;
@@ -11,26 +13,130 @@ namespace dae
 		float z;
 		float w;
 
-		Vector4() = default;
-		Vector4(float _x, float _y, float _z, float _w);
-		Vector4(const Vector3& v, float _w);
+		constexpr Vector4() noexcept = default;
+		constexpr Vector4(float _x, float _y, float _z, float _w) noexcept;
+		constexpr Vector4(const Vector3& v, float _w) noexcept;
 
-		float Magnitude() const;
-		float SqrMagnitude() const;
-		float Normalize();
-		Vector4 Normalized() const;
+		float Magnitude() const noexcept;
+		constexpr float SqrMagnitude() const noexcept;
+		float Normalize() noexcept;
+		Vector4 Normalized() const noexcept;
 
-		Vector2 GetXY() const;
-		Vector3 GetXYZ() const;
+		constexpr Vector2 GetXY() const noexcept;
+		constexpr Vector3 GetXYZ() const noexcept;
 
-		static float Dot(const Vector4& v1, const Vector4& v2);
+		static constexpr float Dot(const Vector4& v1, const Vector4& v2) noexcept;
 
 		// operator overloading
-		Vector4 operator*(float scale) const;
-		Vector4 operator+(const Vector4& v) const;
-		Vector4 operator-(const Vector4& v) const;
-		Vector4& operator+=(const Vector4& v);
-		float& operator[](int index);
-		float operator[](int index) const;
+		constexpr Vector4 operator*(float scale) const noexcept;
+		constexpr Vector4 operator+(const Vector4& v) const noexcept;
+		constexpr Vector4 operator-(const Vector4& v) const noexcept;
+		constexpr Vector4& operator+=(const Vector4& v) noexcept;
+		constexpr float& operator[](int index) noexcept;
+		constexpr float operator[](int index) const noexcept;
 	};
+
+	constexpr Vector4::Vector4(float _x, float _y, float _z, float _w) noexcept : x(_x), y(_y), z(_z), w(_w) {}
+	constexpr Vector4::Vector4(const Vector3& v, float _w) noexcept : x(v.x), y(v.y), z(v.z), w(_w) {}
+
+	inline float Vector4::Magnitude() const noexcept
+	{
+		return sqrtf(x * x + y * y + z * z + w * w);
+	}
+
+	constexpr float Vector4::SqrMagnitude() const noexcept
+	{
+		return x * x + y * y + z * z + w * w;
+	}
+
+	inline float Vector4::Normalize() noexcept
+	{
+		const float m = Magnitude();
+		x /= m;
+		y /= m;
+		z /= m;
+		w /= m;
+
+		return m;
+	}
+
+	inline Vector4 Vector4::Normalized() const noexcept
+	{
+		const float m = Magnitude();
+		return { x / m, y / m, z / m, w / m };
+	}
+
+	constexpr Vector2 Vector4::GetXY() const noexcept
+	{
+		return { x, y };
+	}
+
+	constexpr Vector3 Vector4::GetXYZ() const noexcept
+	{
+		return { x,y,z };
+	}
+
+	constexpr float Vector4::Dot(const Vector4& v1, const Vector4& v2) noexcept
+	{
+		return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z + v1.w * v2.w;
+	}
+
+#pragma region Operator Overloads
+	constexpr Vector4 Vector4::operator*(float scale) const noexcept
+	{
+		return { x * scale, y * scale, z * scale, w * scale };
+	}
+
+	constexpr Vector4 Vector4::operator+(const Vector4& v) const noexcept
+	{
+		return { x + v.x, y + v.y, z + v.z, w + v.w };
+	}
+
+	constexpr Vector4 Vector4::operator-(const Vector4& v) const noexcept
+	{
+		return { x - v.x, y - v.y, z - v.z, w - v.w };
+	}
+
+	constexpr Vector4& Vector4::operator+=(const Vector4& v) noexcept
+	{
+		x += v.x;
+		y += v.y;
+		z += v.z;
+		w += v.w;
+		return *this;
+	}
+
+	constexpr float& Vector4::operator[](int index) noexcept
+	{
+		assert(index <= 3 && index >= 0);
+
+		if (index == 0)return x;
+		if (index == 1)return y;
+		if (index == 2)return z;
+		return w;
+	}
+
+	constexpr float Vector4::operator[](int index) const noexcept
+	{
+		assert(index <= 3 && index >= 0);
+
+		if (index == 0)return x;
+		if (index == 1)return y;
+		if (index == 2)return z;
+		return w;
+	}
+#pragma endregion
+
+	//Vector3 members that need the complete Vector4
+	constexpr Vector3::Vector3(const Vector4& v) noexcept : x(v.x), y(v.y), z(v.z){}
+
+	constexpr Vector4 Vector3::ToPoint4() const noexcept
+	{
+		return { x, y, z, 1 };
+	}
+
+	constexpr Vector4 Vector3::ToVector4() const noexcept
+	{
+		return { x, y, z, 0 };
+	}
 }
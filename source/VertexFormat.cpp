@@ -0,0 +1,353 @@
+#include "pch.h"
+#include "VertexFormat.h"
+#include <cstddef>
+#include <cstring>
+
+namespace dae
+{
+	namespace VertexFormats
+	{
+		namespace
+		{
+			constexpr VertexAttribute g_FullLayout[]
+			{
+				{ "POSITION", AttributeFormat::Float3, offsetof(Vertex, position) },
+				{ "TEXCOORD", AttributeFormat::Float2, offsetof(Vertex, uv) },
+				{ "NORMAL", AttributeFormat::Float3, offsetof(Vertex, normal) },
+				{ "TANGENT", AttributeFormat::Float4, offsetof(Vertex, tangent) }
+			};
+
+			constexpr VertexAttribute g_PackedLayout[]
+			{
+				{ "POSITION", AttributeFormat::UNorm16x4, offsetof(PackedVertex, position) },
+				{ "TEXCOORD", AttributeFormat::Half2, offsetof(PackedVertex, uv) },
+				{ "NORMAL", AttributeFormat::SNorm16x2, offsetof(PackedVertex, normal) },
+				{ "TANGENT", AttributeFormat::SNorm16x2, offsetof(PackedVertex, tangent) }
+			};
+
+			static_assert(sizeof(PackedVertex) == 20, "PackedVertex has to stay tightly packed");
+
+			//Octahedral precision: a 16-bit snorm step is 1/32767, which is below 1.5e-4 radians anywhere on the octahedron
+			constexpr float g_MaxDirectionError{ 1.5e-4f };
+
+			uint16_t FloatToHalf(float value)
+			{
+				uint32_t bits{};
+				std::memcpy(&bits, &value, sizeof(float));
+
+				const uint32_t sign{ (bits >> 16) & 0x8000u };
+				const int32_t exponent{ static_cast<int32_t>((bits >> 23) & 0xFFu) - 127 + 15 };
+				uint32_t mantissa{ bits & 0x007FFFFFu };
+
+				//NaN and infinity
+				if (exponent - 15 + 127 == 255)
+					return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+
+				if (exponent >= 31)
+					return static_cast<uint16_t>(sign | 0x7C00u);
+
+				//Denormals and underflow, the implicit leading bit becomes explicit
+				if (exponent <= 0)
+				{
+					if (exponent < -10)
+						return static_cast<uint16_t>(sign);
+
+					mantissa |= 0x00800000u;
+					const uint32_t shift{ static_cast<uint32_t>(14 - exponent) };
+					const uint32_t halfMantissa{ mantissa >> shift };
+					const uint32_t remainder{ mantissa & ((1u << shift) - 1) };
+					const uint32_t halfway{ 1u << (shift - 1) };
+
+					//Round to nearest even
+					const uint32_t rounded{ halfMantissa + ((remainder > halfway || (remainder == halfway && (halfMantissa & 1u))) ? 1u : 0u) };
+					return static_cast<uint16_t>(sign | rounded);
+				}
+
+				const uint32_t half{ (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13) };
+				const uint32_t remainder{ mantissa & 0x1FFFu };
+
+				//A carry out of the mantissa correctly bumps the exponent, up to infinity
+				const uint32_t rounded{ half + ((remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) ? 1u : 0u) };
+				return static_cast<uint16_t>(sign | rounded);
+			}
+
+			float HalfToFloat(uint16_t half)
+			{
+				const uint32_t sign{ (uint32_t(half) & 0x8000u) << 16 };
+				const uint32_t exponent{ (uint32_t(half) >> 10) & 0x1Fu };
+				const uint32_t mantissa{ uint32_t(half) & 0x3FFu };
+
+				float value{};
+				if (exponent == 0)
+				{
+					value = std::ldexp(static_cast<float>(mantissa), -24);
+				}
+				else if (exponent == 31)
+				{
+					value = mantissa ? std::numeric_limits<float>::quiet_NaN() : std::numeric_limits<float>::infinity();
+				}
+				else
+				{
+					const uint32_t bits{ ((exponent - 15 + 127) << 23) | (mantissa << 13) };
+					std::memcpy(&value, &bits, sizeof(float));
+				}
+
+				return sign ? -value : value;
+			}
+
+			//Stores the first component count values in the given format, rounding to nearest like the input assembler's inverse
+			void EncodeAttribute(AttributeFormat format, const float* pValues, uint8_t* pDestination)
+			{
+				switch (format)
+				{
+				case AttributeFormat::Float2:
+					std::memcpy(pDestination, pValues, 2 * sizeof(float));
+					break;
+
+				case AttributeFormat::Float3:
+					std::memcpy(pDestination, pValues, 3 * sizeof(float));
+					break;
+
+				case AttributeFormat::Float4:
+					std::memcpy(pDestination, pValues, 4 * sizeof(float));
+					break;
+
+				case AttributeFormat::UNorm16x4:
+					for (int i{ 0 }; i < 4; ++i)
+					{
+						const uint16_t value{ static_cast<uint16_t>(std::lround(std::clamp(pValues[i], 0.f, 1.f) * 65535.f)) };
+						std::memcpy(pDestination + i * sizeof(uint16_t), &value, sizeof(uint16_t));
+					}
+					break;
+
+				case AttributeFormat::Half2:
+					for (int i{ 0 }; i < 2; ++i)
+					{
+						const uint16_t value{ FloatToHalf(pValues[i]) };
+						std::memcpy(pDestination + i * sizeof(uint16_t), &value, sizeof(uint16_t));
+					}
+					break;
+
+				case AttributeFormat::SNorm16x2:
+					for (int i{ 0 }; i < 2; ++i)
+					{
+						const int16_t value{ static_cast<int16_t>(std::lround(std::clamp(pValues[i], -1.f, 1.f) * 32767.f)) };
+						std::memcpy(pDestination + i * sizeof(int16_t), &value, sizeof(int16_t));
+					}
+					break;
+				}
+			}
+
+			//Reads the attribute back the way the input assembler converts it for the vertex shader
+			void DecodeAttribute(AttributeFormat format, const uint8_t* pSource, float* pValues)
+			{
+				switch (format)
+				{
+				case AttributeFormat::Float2:
+					std::memcpy(pValues, pSource, 2 * sizeof(float));
+					break;
+
+				case AttributeFormat::Float3:
+					std::memcpy(pValues, pSource, 3 * sizeof(float));
+					break;
+
+				case AttributeFormat::Float4:
+					std::memcpy(pValues, pSource, 4 * sizeof(float));
+					break;
+
+				case AttributeFormat::UNorm16x4:
+					for (int i{ 0 }; i < 4; ++i)
+					{
+						uint16_t value{};
+						std::memcpy(&value, pSource + i * sizeof(uint16_t), sizeof(uint16_t));
+						pValues[i] = value / 65535.f;
+					}
+					break;
+
+				case AttributeFormat::Half2:
+					for (int i{ 0 }; i < 2; ++i)
+					{
+						uint16_t value{};
+						std::memcpy(&value, pSource + i * sizeof(uint16_t), sizeof(uint16_t));
+						pValues[i] = HalfToFloat(value);
+					}
+					break;
+
+				case AttributeFormat::SNorm16x2:
+					for (int i{ 0 }; i < 2; ++i)
+					{
+						int16_t value{};
+						std::memcpy(&value, pSource + i * sizeof(int16_t), sizeof(int16_t));
+						pValues[i] = std::max(value / 32767.f, -1.f);
+					}
+					break;
+				}
+			}
+
+			inline float SignNotZero(float value)
+			{
+				return value >= 0.f ? 1.f : -1.f;
+			}
+
+			//Unit vector to the [-1, 1] square, the lower hemisphere folded over the diagonals
+			Vector2 EncodeOctahedral(const Vector3& direction)
+			{
+				const float length{ std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z) };
+				if (length <= FLT_MIN)
+					return { 0.f, 0.f };
+
+				Vector2 encoded{ direction.x / length, direction.y / length };
+				if (direction.z < 0.f)
+				{
+					encoded = { (1.f - std::abs(encoded.y)) * SignNotZero(encoded.x), (1.f - std::abs(encoded.x)) * SignNotZero(encoded.y) };
+				}
+
+				return encoded;
+			}
+
+			//Mirrors DecodeOctahedral in PosCol3D.fx
+			Vector3 DecodeOctahedral(const Vector2& encoded)
+			{
+				Vector3 direction{ encoded.x, encoded.y, 1.f - std::abs(encoded.x) - std::abs(encoded.y) };
+				const float fold{ std::clamp(-direction.z, 0.f, 1.f) };
+				direction.x += direction.x >= 0.f ? -fold : fold;
+				direction.y += direction.y >= 0.f ? -fold : fold;
+
+				return direction.Normalized();
+			}
+
+			float AngleBetween(const Vector3& a, const Vector3& b)
+			{
+				const float lengths{ a.Magnitude() * b.Magnitude() };
+				if (lengths <= FLT_MIN)
+					return 0.f;
+
+				//atan2 of the cross and dot stays accurate for tiny angles, unlike acos
+				return atan2f(Vector3::Cross(a, b).Magnitude(), Vector3::Dot(a, b));
+			}
+		}
+
+		std::span<const VertexAttribute> GetLayout(VertexFormat format)
+		{
+			if (format == VertexFormat::Packed)
+				return g_PackedLayout;
+
+			return g_FullLayout;
+		}
+
+		uint32_t GetStride(VertexFormat format)
+		{
+			return format == VertexFormat::Packed ? sizeof(PackedVertex) : sizeof(Vertex);
+		}
+
+		Quantization GetQuantization(const BoundingBox& bounds)
+		{
+			Quantization quantization{};
+			quantization.offset = bounds.min;
+
+			//Flat axes keep a scale of 1, every position then encodes as 0
+			for (int axis{ 0 }; axis < 3; ++axis)
+			{
+				const float extent{ bounds.max[axis] - bounds.min[axis] };
+				quantization.scale[axis] = extent > 0.f ? extent : 1.f;
+			}
+
+			return quantization;
+		}
+
+		void Pack(const Vertex* pVertices, size_t vertexCount, const Quantization& quantization, PackedVertex* pPackedVertices)
+		{
+			const std::span<const VertexAttribute> layout{ g_PackedLayout };
+
+			for (size_t i{ 0 }; i < vertexCount; ++i)
+			{
+				const Vertex& vertex{ pVertices[i] };
+				const Vector2 normal{ EncodeOctahedral(vertex.normal) };
+				const Vector2 tangent{ EncodeOctahedral(vertex.tangent.GetXYZ()) };
+
+				const float values[4][4]
+				{
+					{
+						(vertex.position.x - quantization.offset.x) / quantization.scale.x,
+						(vertex.position.y - quantization.offset.y) / quantization.scale.y,
+						(vertex.position.z - quantization.offset.z) / quantization.scale.z,
+						vertex.tangent.w < 0.f ? 0.f : 1.f
+					},
+					{ vertex.uv.x, vertex.uv.y },
+					{ normal.x, normal.y },
+					{ tangent.x, tangent.y }
+				};
+
+				uint8_t* pDestination{ reinterpret_cast<uint8_t*>(pPackedVertices + i) };
+				for (size_t iAttribute{ 0 }; iAttribute < layout.size(); ++iAttribute)
+					EncodeAttribute(layout[iAttribute].format, values[iAttribute], pDestination + layout[iAttribute].offset);
+			}
+		}
+
+		Vertex Unpack(const PackedVertex& packedVertex, const Quantization& quantization)
+		{
+			const std::span<const VertexAttribute> layout{ g_PackedLayout };
+			const uint8_t* pSource{ reinterpret_cast<const uint8_t*>(&packedVertex) };
+
+			float values[4][4]{};
+			for (size_t iAttribute{ 0 }; iAttribute < layout.size(); ++iAttribute)
+				DecodeAttribute(layout[iAttribute].format, pSource + layout[iAttribute].offset, values[iAttribute]);
+
+			Vertex vertex{};
+			vertex.position = {
+				quantization.offset.x + values[0][0] * quantization.scale.x,
+				quantization.offset.y + values[0][1] * quantization.scale.y,
+				quantization.offset.z + values[0][2] * quantization.scale.z };
+			vertex.uv = { values[1][0], values[1][1] };
+			vertex.normal = DecodeOctahedral({ values[2][0], values[2][1] });
+			vertex.tangent = Vector4{ DecodeOctahedral({ values[3][0], values[3][1] }), values[0][3] * 2.f - 1.f };
+
+			return vertex;
+		}
+
+		bool ValidatePacking(const Vertex* pVertices, const PackedVertex* pPackedVertices, size_t vertexCount, const Quantization& quantization, PackingError* pMaxError)
+		{
+			PackingError maxError{};
+			bool isValid{ true };
+
+			for (size_t i{ 0 }; i < vertexCount; ++i)
+			{
+				const Vertex& vertex{ pVertices[i] };
+				const Vertex unpacked{ Unpack(pPackedVertices[i], quantization) };
+
+				for (int axis{ 0 }; axis < 3; ++axis)
+				{
+					//Half a quantization step, plus float rounding of the offset
+					const float error{ std::abs(unpacked.position[axis] - vertex.position[axis]) };
+					const float bound{ quantization.scale[axis] / 65535.f * 0.5f + (std::abs(vertex.position[axis]) + quantization.scale[axis]) * FLT_EPSILON * 2.f };
+
+					maxError.position = std::max(maxError.position, error);
+					isValid &= error <= bound;
+				}
+
+				for (int axis{ 0 }; axis < 2; ++axis)
+				{
+					//Half an ulp of an 11-bit mantissa, or of the smallest denormal
+					const float error{ std::abs(unpacked.uv[axis] - vertex.uv[axis]) };
+					const float bound{ std::max(std::abs(vertex.uv[axis]) * std::ldexp(1.f, -11), std::ldexp(1.f, -25)) };
+
+					maxError.uv = std::max(maxError.uv, error);
+					isValid &= error <= bound || std::abs(vertex.uv[axis]) >= 65504.f;
+				}
+
+				const float normalError{ AngleBetween(unpacked.normal, vertex.normal) };
+				const float tangentError{ AngleBetween(unpacked.tangent.GetXYZ(), vertex.tangent.GetXYZ()) };
+				maxError.normalAngle = std::max(maxError.normalAngle, normalError);
+				maxError.tangentAngle = std::max(maxError.tangentAngle, tangentError);
+
+				isValid &= normalError <= g_MaxDirectionError && tangentError <= g_MaxDirectionError;
+				isValid &= (unpacked.tangent.w < 0.f) == (vertex.tangent.w < 0.f);
+			}
+
+			if (pMaxError)
+				*pMaxError = maxError;
+
+			return isValid;
+		}
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include "DataTypes.h"
+
+namespace dae
+{
+	enum class VertexFormat
+	{
+		Full,	//Vertex, 48 bytes of floats
+		Packed	//PackedVertex, 20 bytes
+	};
+
+	//Storage of one vertex attribute, as the input assembler sees it
+	enum class AttributeFormat
+	{
+		Float2,
+		Float3,
+		Float4,
+		UNorm16x4,
+		Half2,
+		SNorm16x2
+	};
+
+	struct VertexAttribute
+	{
+		const char* semanticName;
+		AttributeFormat format;
+		uint32_t offset;
+	};
+
+	namespace VertexFormats
+	{
+		//Maps the unorm positions of a packed mesh back to its bounds: position = offset + unorm * scale
+		struct Quantization
+		{
+			Vector3 offset{};
+			Vector3 scale{ 1.f, 1.f, 1.f };
+		};
+
+		//Largest difference between the packed and the float vertices, over all vertices
+		struct PackingError
+		{
+			float position{};	//Per axis
+			float uv{};
+			float normalAngle{};	//Radians
+			float tangentAngle{};	//Radians
+		};
+
+		//The attributes are listed in POSITION, TEXCOORD, NORMAL, TANGENT order for every format.
+		//The input layout of Mesh and the CPU encode/decode below are both built from these tables.
+		std::span<const VertexAttribute> GetLayout(VertexFormat format);
+		uint32_t GetStride(VertexFormat format);
+
+		Quantization GetQuantization(const BoundingBox& bounds);
+
+		void Pack(const Vertex* pVertices, size_t vertexCount, const Quantization& quantization, PackedVertex* pPackedVertices);
+		Vertex Unpack(const PackedVertex& packedVertex, const Quantization& quantization);
+
+		//Compares every vertex to its packed version, returns false when any error exceeds what the formats guarantee:
+		//half a quantization step for positions, half a half-float ulp for uvs, and 16-bit octahedral precision for directions
+		bool ValidatePacking(const Vertex* pVertices, const PackedVertex* pPackedVertices, size_t vertexCount, const Quantization& quantization, PackingError* pMaxError = nullptr);
+	}
+}
@@ -6,6 +6,8 @@
 
 #undef main
 #include "Renderer.h"
+#include "Camera.h"
+#include "SoftwareRender.h"
 
 using namespace dae;
 
@@ -17,9 +19,9 @@ void ShutDown(SDL_Window* pWindow)
 
 int main(int argc, char* args[])
 {
-	//Unreferenced parameters
-	(void)argc;
-	(void)args;
+	//--software [output.png|output.ppm] [width] [height] [threads] [forward|prepass|visibility] renders on the CPU without opening a window
+	if (argc > 1 && std::string{ args[1] } == "--software")
+		return RenderSoftware(argc, args, 2);
 
 	//Create window + surfaces
 	SDL_Init(SDL_INIT_VIDEO);
@@ -77,6 +79,9 @@ int main(int argc, char* args[])
 				case SDL_SCANCODE_F6:
 					pRenderer->ToggleNormalMap();
 					break;
+				case SDL_SCANCODE_F7:
+					pRenderer->ToggleMeshletCulling();
+					break;
 				}
 
 				break;
@@ -97,6 +102,7 @@ int main(int argc, char* args[])
 		{
 			printTimer = 0.f;
 			std::cout << "dFPS: " << pTimer->GetdFPS() << std::endl;
+			pRenderer->PrintDrawStatistics();
 		}
 	}
 	pTimer->Stop();
@@ -5,6 +5,10 @@
 #include <algorithm>
 #include <sstream>
 #include <memory>
+
+// DAE_HEADLESS builds the parts that run without a window or a GPU (the software rasterizer, the OBJ loader and the math),
+// see CMakeLists.txt, so none of the headers below are needed there
+#ifndef DAE_HEADLESS
 #define NOMINMAX  //for directx
 
 // SDL Headers
@@ -18,6 +22,7 @@
 #include <d3d11.h>
 #include <d3dcompiler.h>
 #include <d3dx11effect.h>
+#endif
 
 // Framework Headers
 #include "Timer.h"
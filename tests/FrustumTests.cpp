@@ -0,0 +1,140 @@
+#include "pch.h"
+#include "Test.h"
+#include "Camera.h"
+#include "DataTypes.h"
+#include "Frustum.h"
+#include <random>
+
+using namespace dae;
+
+namespace
+{
+	//Sizes around the SSE and AVX widths, so every path gets blocks followed by a scalar remainder
+	constexpr size_t g_BoundsCounts[]{ 0, 1, 3, 4, 5, 7, 8, 9, 12, 13, 15, 16, 17, 31, 33, 1003 };
+
+	//Marks the slots after the visible ones, which the culling must not write to
+	constexpr uint32_t g_Untouched{ UINT32_MAX };
+
+	//A camera at (3, 2, -40) turned a little left and down, Camera builds its view matrix from the yaw and pitch
+	Frustum CreateFrustum()
+	{
+		Camera camera{};
+		camera.Initialize(45.f, { 3.f, 2.f, -40.f }, 16.f / 9.f);
+		camera.totalYaw = -0.1f;
+		camera.totalPitch = -0.05f;
+		camera.CalculateViewMatrix();
+		return Frustum::FromMatrix(camera.viewMatrix * camera.projectionMatrix);
+	}
+
+	//Spheres and boxes all around the frustum, about half of them inside, with their BoundingBox and BoundingSphere kept for the single tests
+	void CreateRandomBounds(size_t count, std::mt19937& random, CullingBounds& bounds, std::vector<BoundingSphere>& spheres, std::vector<BoundingBox>& boxes)
+	{
+		std::uniform_real_distribution<float> position{ -40.f, 40.f };
+		std::uniform_real_distribution<float> size{ 0.f, 8.f };
+
+		bounds.Resize(count);
+		spheres.resize(count);
+		boxes.resize(count);
+		for (size_t i{ 0 }; i < count; ++i)
+		{
+			spheres[i] = { { position(random), position(random), position(random) + 20.f }, size(random) };
+			const Vector3 center{ position(random), position(random), position(random) + 20.f };
+			const Vector3 extent{ size(random), size(random), size(random) };
+			boxes[i] = { center - extent, center + extent };
+
+			bounds.SetSphere(i, spheres[i]);
+			bounds.SetBox(i, boxes[i]);
+		}
+	}
+
+	//Compares the list of the vectorized culling with the indices the single tests keep, in increasing order
+	template<typename IsOutside>
+	void CheckVisibleList(const std::vector<uint32_t>& visibleIndices, size_t visibleCount, size_t count, const char* name, IsOutside isOutside)
+	{
+		std::vector<uint32_t> expectedIndices{};
+		for (uint32_t i{ 0 }; i < count; ++i)
+		{
+			if (!isOutside(i))
+				expectedIndices.push_back(i);
+		}
+
+		DAE_CHECK_MESSAGE(visibleCount == expectedIndices.size(), name << " of " << count << ": " << visibleCount << " visible instead of " << expectedIndices.size());
+		DAE_CHECK_MESSAGE(std::equal(expectedIndices.begin(), expectedIndices.end(), visibleIndices.begin()), name << " of " << count << " keeps other bounds");
+		DAE_CHECK_MESSAGE(std::all_of(visibleIndices.begin() + count, visibleIndices.end(), [](uint32_t index) { return index == g_Untouched; }),
+			name << " of " << count << " writes past its bounds");
+	}
+}
+
+DAE_TEST(FrustumCullingMatchesTheSingleTests)
+{
+	const Frustum frustum{ CreateFrustum() };
+	DAE_CHECK(!frustum.IsSphereOutside({ 0.f, 0.f, 0.f }, 0.f));
+	DAE_CHECK(frustum.IsSphereOutside({ 3.f, 2.f, -60.f }, 1.f));
+
+	std::mt19937 random{ 19 };
+
+	size_t totalCount{ 0 };
+	size_t totalVisibleCount{ 0 };
+	for (const size_t count : g_BoundsCounts)
+	{
+		for (int repetition{ 0 }; repetition < 8; ++repetition)
+		{
+			CullingBounds bounds{};
+			std::vector<BoundingSphere> spheres{};
+			std::vector<BoundingBox> boxes{};
+			CreateRandomBounds(count, random, bounds, spheres, boxes);
+
+			std::vector<uint32_t> visibleIndices(count + 8, g_Untouched);
+			size_t visibleCount{ frustum.CullSpheres(bounds, visibleIndices.data()) };
+			CheckVisibleList(visibleIndices, visibleCount, count, "CullSpheres", [&](uint32_t i) { return frustum.IsSphereOutside(spheres[i].center, spheres[i].radius); });
+
+			std::fill(visibleIndices.begin(), visibleIndices.end(), g_Untouched);
+			visibleCount = frustum.CullBoxes(bounds, visibleIndices.data());
+			CheckVisibleList(visibleIndices, visibleCount, count, "CullBoxes", [&](uint32_t i) { return frustum.IsBoxOutside(boxes[i]); });
+
+			std::fill(visibleIndices.begin(), visibleIndices.end(), g_Untouched);
+			visibleCount = frustum.Cull(bounds, visibleIndices.data());
+			CheckVisibleList(visibleIndices, visibleCount, count, "Cull", [&](uint32_t i)
+				{
+					return frustum.IsSphereOutside(spheres[i].center, spheres[i].radius) || frustum.IsBoxOutside(boxes[i]);
+				});
+
+			totalCount += count;
+			totalVisibleCount += visibleCount;
+		}
+	}
+
+	//Otherwise the lists above would agree trivially
+	DAE_CHECK_MESSAGE(totalVisibleCount > totalCount / 10 && totalVisibleCount < totalCount * 9 / 10, totalVisibleCount << " of " << totalCount << " visible");
+}
+
+DAE_TEST(FrustumCullingOnThePlanes)
+{
+	//Bounds that touch a plane from outside are kept, the ones a float further out are culled, in the blocks and in the remainder alike
+	Frustum frustum{};
+	for (int plane{ 0 }; plane < Frustum::PlaneCount; ++plane)
+		frustum.planes[plane] = { 0.f, 0.f, 0.f, 1.f };
+	frustum.planes[Frustum::Left] = { 1.f, 0.f, 0.f, 0.f };
+
+	constexpr size_t count{ 11 };
+	CullingBounds bounds{};
+	bounds.Resize(count);
+	for (size_t i{ 0 }; i < count; ++i)
+	{
+		const float radius{ static_cast<float>(i + 1) };
+		const bool isOutside{ i % 2 == 1 };
+		bounds.SetSphere(i, { { isOutside ? std::nextafter(-radius, -FLT_MAX) : -radius, 0.f, 0.f }, radius });
+
+		//Moved out by a step both the center and the extent can represent
+		const float maxX{ isOutside ? -std::ldexp(radius, -20) : 0.f };
+		bounds.SetBox(i, { { -2.f * radius, -1.f, -1.f }, { maxX, 1.f, 1.f } });
+	}
+
+	std::vector<uint32_t> visibleIndices(count, g_Untouched);
+	const std::vector<uint32_t> expectedIndices{ 0, 2, 4, 6, 8, 10 };
+
+	DAE_CHECK(frustum.CullSpheres(bounds, visibleIndices.data()) == expectedIndices.size());
+	DAE_CHECK(std::equal(expectedIndices.begin(), expectedIndices.end(), visibleIndices.begin()));
+	DAE_CHECK(frustum.CullBoxes(bounds, visibleIndices.data()) == expectedIndices.size());
+	DAE_CHECK(std::equal(expectedIndices.begin(), expectedIndices.end(), visibleIndices.begin()));
+}
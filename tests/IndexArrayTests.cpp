@@ -0,0 +1,76 @@
+#include "pch.h"
+#include "Test.h"
+#include "DataTypes.h"
+#include "IndexArray.h"
+
+using namespace dae;
+
+namespace
+{
+	std::vector<Vertex> CreateVertices(size_t count)
+	{
+		std::vector<Vertex> vertices(count);
+		for (size_t i{ 0 }; i < count; ++i)
+			vertices[i].position = { static_cast<float>(i % 1024), static_cast<float>(i / 1024), 0.f };
+
+		return vertices;
+	}
+
+	//Every index of the compacted mesh, plus its section's base vertex, has to reach the position the original index did
+	bool DrawsTheSamePositions(const std::vector<Vertex>& originalVertices, const std::vector<uint32_t>& originalIndices,
+		const std::vector<Vertex>& vertices, const IndexArray& indices, const std::vector<MeshSection>& sections)
+	{
+		return std::visit([&](const auto& array)
+			{
+				for (const MeshSection& section : sections)
+				{
+					for (uint32_t i{ section.firstIndex }; i < section.firstIndex + section.indexCount; ++i)
+					{
+						const size_t vertex{ section.baseVertex + size_t{ array[i] } };
+						if (vertex >= vertices.size() || !(vertices[vertex].position == originalVertices[originalIndices[i]].position))
+							return false;
+					}
+				}
+
+				return true;
+			}, indices);
+	}
+}
+
+DAE_TEST(IndexArrayUnusedVerticesDoNotCountAsCopies)
+{
+	//More vertices than 16-bit indices reach, but the triangles only use a few of them, so one section holds them all
+	const std::vector<Vertex> originalVertices{ CreateVertices(IndexArrays::MaxSectionVertexCount + 5000) };
+	std::vector<uint32_t> indices{};
+	for (uint32_t i{ 0 }; i < 300; ++i)
+		indices.insert(indices.end(), { i * 3, i * 3 + 1, i * 3 + 2 });
+	indices.insert(indices.end(), { 70'000, 70'001, 70'002 });
+
+	std::vector<Vertex> vertices{ originalVertices };
+	std::vector<MeshSection> sections{};
+	const IndexArray compactIndices{ IndexArrays::Compact(vertices, indices, sections) };
+
+	DAE_CHECK_MESSAGE(IndexArrays::GetIndexSize(compactIndices) == sizeof(uint16_t), IndexArrays::GetIndexSize(compactIndices) << " byte indices");
+	DAE_CHECK_MESSAGE(sections.size() == 1, sections.size() << " sections");
+	DAE_CHECK_MESSAGE(vertices.size() == 903, vertices.size() << " vertices");
+	DAE_CHECK(IndexArrays::GetIndexCount(compactIndices) == indices.size());
+	DAE_CHECK(DrawsTheSamePositions(originalVertices, indices, vertices, compactIndices, sections));
+}
+
+DAE_TEST(IndexArraySplitsLargeMeshesIntoSections)
+{
+	//A strip of triangles over every vertex, neighbouring triangles share two, so a split copies only a couple
+	const std::vector<Vertex> originalVertices{ CreateVertices(IndexArrays::MaxSectionVertexCount * 2 + 100) };
+	std::vector<uint32_t> indices{};
+	for (uint32_t i{ 0 }; i + 2 < originalVertices.size(); ++i)
+		indices.insert(indices.end(), { i, i + 1, i + 2 });
+
+	std::vector<Vertex> vertices{ originalVertices };
+	std::vector<MeshSection> sections{};
+	const IndexArray compactIndices{ IndexArrays::Compact(vertices, indices, sections) };
+
+	DAE_CHECK_MESSAGE(IndexArrays::GetIndexSize(compactIndices) == sizeof(uint16_t), IndexArrays::GetIndexSize(compactIndices) << " byte indices");
+	DAE_CHECK_MESSAGE(sections.size() == 3, sections.size() << " sections");
+	DAE_CHECK_MESSAGE(vertices.size() - originalVertices.size() == 4, vertices.size() - originalVertices.size() << " copied vertices");
+	DAE_CHECK(DrawsTheSamePositions(originalVertices, indices, vertices, compactIndices, sections));
+}
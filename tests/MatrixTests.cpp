@@ -0,0 +1,374 @@
+#include "pch.h"
+#include "Test.h"
+#include <cstring>
+#include <random>
+
+using namespace dae;
+
+namespace
+{
+	//Error bounds in units in the last place. Elements that cancel out have no meaningful relative error, so the products and transforms
+	//are measured against the ulp of the sum of the absolute terms, the scale float rounding works at. Inverses are measured against the
+	//ulp of the exact inverse's norm times the condition number, since that is how far any float inversion can be off.
+	constexpr double g_MaxProductUlps{ 2.0 };
+	constexpr double g_MaxInverseUlps{ 4.0 };
+
+	constexpr int g_MatrixCount{ 2000 };
+
+	using MatrixD = double[4][4];
+
+	void ToDouble(const Matrix& m, MatrixD& out)
+	{
+		for (int r{ 0 }; r < 4; ++r)
+			for (int c{ 0 }; c < 4; ++c)
+				out[r][c] = m[r][c];
+	}
+
+	//Ulps of x in float, relative to a scale instead of x itself
+	double GetScaledUlps(double error, double scale)
+	{
+		if (scale == 0.0)
+			return error == 0.0 ? 0.0 : DBL_MAX;
+
+		int exponent{};
+		std::frexp(scale, &exponent);
+		return error / std::ldexp(1.0, exponent - 24);
+	}
+
+	bool AreEqual(const Matrix& a, const Matrix& b)
+	{
+		return std::memcmp(&a, &b, sizeof(Matrix)) == 0;
+	}
+
+	//Rotation, non uniform scale and translation: the matrices Transform builds
+	Matrix CreateAffine(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> angle{ -3.f, 3.f };
+		std::uniform_real_distribution<float> scale{ 0.5f, 2.f };
+		std::uniform_real_distribution<float> translation{ -100.f, 100.f };
+		return Matrix::CreateScale(scale(random), scale(random), scale(random)) * Matrix::CreateRotation(angle(random), angle(random), angle(random))
+			* Matrix::CreateTranslation(translation(random), translation(random), translation(random));
+	}
+
+	Matrix CreateRigid(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> angle{ -3.f, 3.f };
+		std::uniform_real_distribution<float> translation{ -100.f, 100.f };
+		return Matrix::CreateRotation(angle(random), angle(random), angle(random)) * Matrix::CreateTranslation(translation(random), translation(random), translation(random));
+	}
+
+	//Every element random, the worst case for cancellation
+	Matrix CreateGeneral(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> element{ -4.f, 4.f };
+		Matrix m{};
+		for (int r{ 0 }; r < 4; ++r)
+			m[r] = { element(random), element(random), element(random), element(random) };
+
+		return m;
+	}
+
+	//A world * view * projection like the renderer's
+	Matrix CreateProjected(std::mt19937& random)
+	{
+		return CreateAffine(random) * Matrix::CreatePerspectiveFovLH(0.8f, 1.33f, 0.1f, 100.f);
+	}
+
+	std::vector<Matrix> CreateMatrices()
+	{
+		std::mt19937 random{ 7 };
+		std::vector<Matrix> matrices{};
+		for (int i{ 0 }; i < g_MatrixCount; ++i)
+		{
+			switch (i % 3)
+			{
+			case 0: matrices.push_back(CreateAffine(random)); break;
+			case 1: matrices.push_back(CreateGeneral(random)); break;
+			case 2: matrices.push_back(CreateProjected(random)); break;
+			}
+		}
+
+		return matrices;
+	}
+
+	//Largest error of a product of floats against the exact one in doubles
+	double GetProductUlps(const Matrix& a, const Matrix& b, const Matrix& product)
+	{
+		double maxUlps{ 0.0 };
+		for (int r{ 0 }; r < 4; ++r)
+		{
+			for (int c{ 0 }; c < 4; ++c)
+			{
+				double exact{ 0.0 };
+				double scale{ 0.0 };
+				for (int k{ 0 }; k < 4; ++k)
+				{
+					const double term{ static_cast<double>(a[r][k]) * b[k][c] };
+					exact += term;
+					scale += std::abs(term);
+				}
+
+				maxUlps = std::max(maxUlps, GetScaledUlps(std::abs(product[r][c] - exact), scale));
+			}
+		}
+
+		return maxUlps;
+	}
+
+	//Same for v * m, of which only the first componentCount components are compared
+	double GetTransformUlps(const Vector4& v, const Matrix& m, const Vector4& transformed, int componentCount)
+	{
+		const float row[4]{ v.x, v.y, v.z, v.w };
+		const float result[4]{ transformed.x, transformed.y, transformed.z, transformed.w };
+
+		double maxUlps{ 0.0 };
+		for (int c{ 0 }; c < componentCount; ++c)
+		{
+			double exact{ 0.0 };
+			double scale{ 0.0 };
+			for (int k{ 0 }; k < 4; ++k)
+			{
+				const double term{ static_cast<double>(row[k]) * m[k][c] };
+				exact += term;
+				scale += std::abs(term);
+			}
+
+			maxUlps = std::max(maxUlps, GetScaledUlps(std::abs(result[c] - exact), scale));
+		}
+
+		return maxUlps;
+	}
+
+	//Inverts in doubles with Gauss-Jordan elimination and partial pivoting
+	bool InvertDouble(const Matrix& m, MatrixD& inverse)
+	{
+		MatrixD a{};
+		ToDouble(m, a);
+		for (int r{ 0 }; r < 4; ++r)
+			for (int c{ 0 }; c < 4; ++c)
+				inverse[r][c] = r == c ? 1.0 : 0.0;
+
+		for (int c{ 0 }; c < 4; ++c)
+		{
+			int pivot{ c };
+			for (int r{ c + 1 }; r < 4; ++r)
+				if (std::abs(a[r][c]) > std::abs(a[pivot][c]))
+					pivot = r;
+
+			if (a[pivot][c] == 0.0)
+				return false;
+
+			std::swap(a[c], a[pivot]);
+			std::swap(inverse[c], inverse[pivot]);
+
+			const double invPivot{ 1.0 / a[c][c] };
+			for (int k{ 0 }; k < 4; ++k)
+			{
+				a[c][k] *= invPivot;
+				inverse[c][k] *= invPivot;
+			}
+
+			for (int r{ 0 }; r < 4; ++r)
+			{
+				if (r == c)
+					continue;
+
+				const double factor{ a[r][c] };
+				for (int k{ 0 }; k < 4; ++k)
+				{
+					a[r][k] -= factor * a[c][k];
+					inverse[r][k] -= factor * inverse[c][k];
+				}
+			}
+		}
+
+		return true;
+	}
+
+	double GetInverseUlps(const Matrix& m, const Matrix& inverse)
+	{
+		MatrixD exact{};
+		if (!InvertDouble(m, exact))
+			return 0.0;
+
+		//Condition number in the infinity norm. Translations do not make affine matrices any harder to invert, so those only count their 3x3 part.
+		const int size{ m.IsAffine() ? 3 : 4 };
+		double normM{ 0.0 };
+		double normInverse{ 0.0 };
+		for (int r{ 0 }; r < size; ++r)
+		{
+			double rowM{ 0.0 };
+			double rowInverse{ 0.0 };
+			for (int c{ 0 }; c < size; ++c)
+			{
+				rowM += std::abs(m[r][c]);
+				rowInverse += std::abs(exact[r][c]);
+			}
+
+			normM = std::max(normM, rowM);
+			normInverse = std::max(normInverse, rowInverse);
+		}
+
+		const double condition{ normM * normInverse };
+
+		double maxUlps{ 0.0 };
+		for (int r{ 0 }; r < 4; ++r)
+		{
+			double rowScale{ 0.0 };
+			for (int c{ 0 }; c < 4; ++c)
+				rowScale += std::abs(exact[r][c]);
+
+			for (int c{ 0 }; c < 4; ++c)
+				maxUlps = std::max(maxUlps, GetScaledUlps(std::abs(inverse[r][c] - exact[r][c]), rowScale) / condition);
+		}
+
+		return maxUlps;
+	}
+}
+
+DAE_TEST(MatrixMultiplyIsWithinUlps)
+{
+	const std::vector<Matrix> matrices{ CreateMatrices() };
+
+	double maxUlps{ 0.0 };
+	for (size_t i{ 0 }; i < matrices.size(); ++i)
+	{
+		const Matrix& a{ matrices[i] };
+		const Matrix& b{ matrices[(i * 7 + 1) % matrices.size()] };
+		maxUlps = std::max(maxUlps, GetProductUlps(a, b, a * b));
+	}
+
+	std::cout << "  max error " << maxUlps << " ulps\n";
+	DAE_CHECK_MESSAGE(maxUlps <= g_MaxProductUlps, maxUlps << " ulps");
+}
+
+DAE_TEST(MatrixMultiplyAssignMatchesMultiply)
+{
+	const std::vector<Matrix> matrices{ CreateMatrices() };
+
+	for (size_t i{ 0 }; i < matrices.size(); ++i)
+	{
+		const Matrix& a{ matrices[i] };
+		const Matrix& b{ matrices[(i * 7 + 1) % matrices.size()] };
+
+		Matrix product{ a };
+		product *= b;
+		DAE_CHECK_MESSAGE(AreEqual(product, a * b), "matrix " << i);
+
+		//Multiplying by itself reads the rows it is overwriting
+		Matrix square{ a };
+		square *= square;
+		DAE_CHECK_MESSAGE(AreEqual(square, a * a), "matrix " << i);
+	}
+}
+
+DAE_TEST(MatrixMatchesConstantEvaluation)
+{
+	//Constant evaluation always takes the scalar path, so this compares it with the one the build uses
+	constexpr Matrix a{ Vector4{ 1.5f, -2.25f, 0.1f, 0.f }, Vector4{ 0.3f, 4.f, -1.7f, 0.f }, Vector4{ -0.6f, 0.7f, 2.9f, 0.f }, Vector4{ 12.f, -7.5f, 33.3f, 1.f } };
+	constexpr Matrix b{ Vector4{ 0.9f, 0.2f, -0.4f, 0.1f }, Vector4{ -1.1f, 3.3f, 0.5f, -0.2f }, Vector4{ 0.25f, -0.75f, 1.25f, 0.3f }, Vector4{ 5.f, 6.f, -7.f, 1.f } };
+	constexpr Matrix constantProduct{ a * b };
+	constexpr Matrix constantInverse{ Matrix::Inverse(b) };
+	constexpr Matrix constantAffineInverse{ Matrix::InverseAffine(a) };
+
+	const Matrix runtimeA{ a };
+	const Matrix runtimeB{ b };
+	DAE_CHECK(AreEqual(runtimeA * runtimeB, constantProduct));
+	DAE_CHECK(AreEqual(Matrix::Inverse(runtimeB), constantInverse));
+	DAE_CHECK(AreEqual(Matrix::InverseAffine(runtimeA), constantAffineInverse));
+}
+
+DAE_TEST(MatrixTransformIsWithinUlps)
+{
+	const std::vector<Matrix> matrices{ CreateMatrices() };
+	std::mt19937 random{ 11 };
+	std::uniform_real_distribution<float> coordinate{ -50.f, 50.f };
+
+	double maxUlps{ 0.0 };
+	for (const Matrix& m : matrices)
+	{
+		const Vector4 p{ coordinate(random), coordinate(random), coordinate(random), 1.f };
+		const Vector3 point{ m.TransformPoint(Vector3{ p.x, p.y, p.z }) };
+		const Vector3 vector{ m.TransformVector(Vector3{ p.x, p.y, p.z }) };
+
+		maxUlps = std::max(maxUlps, GetTransformUlps(p, m, Vector4{ point.x, point.y, point.z, 0.f }, 3));
+		maxUlps = std::max(maxUlps, GetTransformUlps(Vector4{ p.x, p.y, p.z, 0.f }, m, Vector4{ vector.x, vector.y, vector.z, 0.f }, 3));
+		maxUlps = std::max(maxUlps, GetTransformUlps(p, m, m.TransformPoint(p), 4));
+	}
+
+	std::cout << "  max error " << maxUlps << " ulps\n";
+	DAE_CHECK_MESSAGE(maxUlps <= g_MaxProductUlps, maxUlps << " ulps");
+}
+
+DAE_TEST(MatrixTransposeIsExact)
+{
+	for (const Matrix& m : CreateMatrices())
+	{
+		const Matrix transposed{ Matrix::Transpose(m) };
+		for (int r{ 0 }; r < 4; ++r)
+			for (int c{ 0 }; c < 4; ++c)
+				DAE_CHECK(transposed[r][c] == m[c][r]);
+
+		DAE_CHECK(AreEqual(Matrix::Transpose(transposed), m));
+	}
+}
+
+DAE_TEST(MatrixInverseIsWithinUlps)
+{
+	std::mt19937 random{ 13 };
+
+	double maxUlps{ 0.0 };
+	double maxAffineUlps{ 0.0 };
+	double maxRigidUlps{ 0.0 };
+	for (const Matrix& m : CreateMatrices())
+		maxUlps = std::max(maxUlps, GetInverseUlps(m, Matrix::Inverse(m)));
+
+	for (int i{ 0 }; i < g_MatrixCount; ++i)
+	{
+		const Matrix affine{ CreateAffine(random) };
+		maxAffineUlps = std::max(maxAffineUlps, GetInverseUlps(affine, Matrix::InverseAffine(affine)));
+		maxUlps = std::max(maxUlps, GetInverseUlps(affine, Matrix::Inverse(affine)));
+
+		const Matrix rigid{ CreateRigid(random) };
+		maxRigidUlps = std::max(maxRigidUlps, GetInverseUlps(rigid, Matrix::InverseRigid(rigid)));
+	}
+
+	std::cout << "  max error " << maxUlps << " ulps, affine " << maxAffineUlps << ", rigid " << maxRigidUlps << "\n";
+	DAE_CHECK_MESSAGE(maxUlps <= g_MaxInverseUlps, maxUlps << " ulps");
+	DAE_CHECK_MESSAGE(maxAffineUlps <= g_MaxInverseUlps, maxAffineUlps << " ulps");
+	DAE_CHECK_MESSAGE(maxRigidUlps <= g_MaxInverseUlps, maxRigidUlps << " ulps");
+}
+
+DAE_TEST(MatrixInverseRigidNeedsARigidMatrix)
+{
+	std::mt19937 random{ 17 };
+
+	//Scaled, mirrored or barely scaled, none of these has only a rotation to transpose
+	const Vector3 scales[]{ { 2.f, 2.f, 2.f }, { 1.5f, 0.7f, 2.f }, { -1.f, 1.f, 1.f }, { 1.01f, 1.f, 1.f } };
+
+	for (int i{ 0 }; i < g_MatrixCount; ++i)
+	{
+		const Matrix rigid{ CreateRigid(random) };
+		DAE_CHECK(rigid.IsRigid());
+		DAE_CHECK((rigid * CreateRigid(random)).IsRigid());
+
+		for (const Vector3& scale : scales)
+		{
+			const Matrix scaled{ Matrix::CreateScale(scale) * rigid };
+			DAE_CHECK_MESSAGE(!scaled.IsRigid(), "scale " << scale.x << ", " << scale.y << ", " << scale.z);
+
+#ifdef NDEBUG
+			//Without asserts it still transposes, so the rotation is undone but the scale is applied twice
+			const Matrix product{ scaled * Matrix::InverseRigid(scaled) };
+			for (int r{ 0 }; r < 3; ++r)
+			{
+				for (int c{ 0 }; c < 3; ++c)
+				{
+					const float expected{ r == c ? scale[r] * scale[r] : 0.f };
+					DAE_CHECK_MESSAGE(std::abs(product[r][c] - expected) <= 1e-5f * 4.f, "scale " << scale[r] << ": " << product[r][c] << " instead of " << expected);
+				}
+			}
+#endif
+		}
+	}
+}
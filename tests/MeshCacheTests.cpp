@@ -0,0 +1,169 @@
+#include "pch.h"
+#include "Test.h"
+#include "DataTypes.h"
+#include "MeshCache.h"
+#include "MeshSimplifier.h"
+#include <cstring>
+#include <fstream>
+
+using namespace dae;
+
+namespace
+{
+	constexpr uint64_t g_SourceHash{ 0x1234'5678'9ABC'DEF0ull };
+	constexpr uint32_t g_SettingsKey{ 7 };
+
+	//Everything Mesh writes to its cache, for a wavy grid of gridSize x gridSize quads
+	struct CachedMesh
+	{
+		std::vector<Vertex> vertices{};
+		IndexArray indices{};
+		std::vector<MeshSection> sections{};
+		std::vector<MeshLod> lods{};
+		std::vector<Meshlet> meshlets{};
+		BoundingBox bounds{};
+	};
+
+	CachedMesh CreateMesh(uint32_t gridSize)
+	{
+		CachedMesh mesh{};
+		for (uint32_t row{ 0 }; row <= gridSize; ++row)
+		{
+			for (uint32_t column{ 0 }; column <= gridSize; ++column)
+			{
+				Vertex vertex{};
+				vertex.position = { static_cast<float>(column), static_cast<float>(row), std::sin(column * 0.7f) * std::cos(row * 0.4f) };
+				vertex.uv = { static_cast<float>(column) / gridSize, static_cast<float>(row) / gridSize };
+				mesh.vertices.push_back(vertex);
+			}
+		}
+
+		std::vector<uint32_t> indices{};
+		for (uint32_t row{ 0 }; row < gridSize; ++row)
+		{
+			for (uint32_t column{ 0 }; column < gridSize; ++column)
+			{
+				const uint32_t i0{ row * (gridSize + 1) + column };
+				const uint32_t i2{ i0 + gridSize + 1 };
+				indices.insert(indices.end(), { i0, i2, i0 + 1, i0 + 1, i2, i2 + 1 });
+			}
+		}
+
+		//The same steps as Mesh before it writes the cache
+		MeshSimplifier::GenerateLodChain(mesh.vertices, indices, mesh.lods);
+		mesh.indices = IndexArrays::Compact(mesh.vertices, indices, mesh.sections);
+		mesh.bounds = BoundingBox::FromVertices(mesh.vertices.data(), mesh.vertices.size());
+
+		MeshletData meshletData{};
+		Meshlets::Build(mesh.vertices.data(), mesh.vertices.size(), mesh.indices, mesh.sections, mesh.lods, meshletData);
+		mesh.meshlets = std::move(meshletData.meshlets);
+		return mesh;
+	}
+
+	bool Write(const Tests::TemporaryFile& file, const CachedMesh& mesh)
+	{
+		return MeshCache::Write(file.path.string(), g_SourceHash, g_SettingsKey, mesh.vertices, mesh.indices, mesh.sections, mesh.lods, mesh.meshlets, mesh.bounds);
+	}
+
+	bool Load(const Tests::TemporaryFile& file)
+	{
+		MeshCache cache{};
+		return cache.Load(file.path.string(), g_SourceHash, g_SettingsKey);
+	}
+
+	std::string ReadBytes(const Tests::TemporaryFile& file)
+	{
+		std::ifstream stream(file.path, std::ios::binary);
+		return { std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+	}
+
+	void WriteBytes(const Tests::TemporaryFile& file, const std::string& bytes)
+	{
+		std::ofstream stream(file.path, std::ios::binary | std::ios::trunc);
+		stream.write(bytes.data(), bytes.size());
+	}
+}
+
+DAE_TEST(MeshCacheRoundTrip)
+{
+	const Tests::TemporaryFile file{ "dae_mesh_cache_round_trip.meshcache" };
+	const CachedMesh mesh{ CreateMesh(16) };
+	DAE_CHECK(mesh.lods.size() > 1 && !mesh.meshlets.empty());
+	DAE_CHECK(Write(file, mesh));
+
+	MeshCache cache{};
+	DAE_CHECK(cache.Load(file.path.string(), g_SourceHash, g_SettingsKey));
+	DAE_CHECK(cache.GetVertexCount() == mesh.vertices.size());
+	DAE_CHECK(cache.GetIndexCount() == IndexArrays::GetIndexCount(mesh.indices));
+	DAE_CHECK(cache.GetIndexSize() == IndexArrays::GetIndexSize(mesh.indices));
+	DAE_CHECK(cache.GetSectionCount() == mesh.sections.size());
+	DAE_CHECK(cache.GetLodCount() == mesh.lods.size());
+	DAE_CHECK(cache.GetMeshletCount() == mesh.meshlets.size());
+	if (cache.GetVertexCount() != mesh.vertices.size() || cache.GetIndexCount() != IndexArrays::GetIndexCount(mesh.indices))
+		return;
+
+	DAE_CHECK(std::memcmp(cache.GetVertices(), mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex)) == 0);
+	DAE_CHECK(std::memcmp(cache.GetIndices(), IndexArrays::GetData(mesh.indices), cache.GetIndexCount() * cache.GetIndexSize()) == 0);
+
+	//Another source or other settings need a new cache
+	MeshCache otherCache{};
+	DAE_CHECK(!otherCache.Load(file.path.string(), g_SourceHash + 1, g_SettingsKey));
+	DAE_CHECK(!otherCache.Load(file.path.string(), g_SourceHash, g_SettingsKey + 1));
+}
+
+DAE_TEST(MeshCacheRejectsACorruptPayload)
+{
+	const Tests::TemporaryFile file{ "dae_mesh_cache_corrupt.meshcache" };
+	DAE_CHECK(Write(file, CreateMesh(16)));
+	const std::string bytes{ ReadBytes(file) };
+
+	//One flipped bit anywhere after the header, in the vertices, the indices or the meshlets at the end
+	for (const size_t position : { size_t{ 256 }, bytes.size() / 2, bytes.size() - 1 })
+	{
+		std::string corruptBytes{ bytes };
+		corruptBytes[position] ^= 0x10;
+		WriteBytes(file, corruptBytes);
+		DAE_CHECK_MESSAGE(!Load(file), "byte " << position << " of " << bytes.size() << " flipped");
+	}
+
+	//Cut short and with bytes after the meshlets
+	WriteBytes(file, bytes.substr(0, bytes.size() - 1));
+	DAE_CHECK(!Load(file));
+	WriteBytes(file, bytes + std::string(16, '\0'));
+	DAE_CHECK(!Load(file));
+
+	WriteBytes(file, bytes);
+	DAE_CHECK(Load(file));
+}
+
+DAE_TEST(MeshCacheRejectsRangesPastTheBuffers)
+{
+	const Tests::TemporaryFile file{ "dae_mesh_cache_ranges.meshcache" };
+	const CachedMesh mesh{ CreateMesh(16) };
+	const uint32_t indexCount{ static_cast<uint32_t>(IndexArrays::GetIndexCount(mesh.indices)) };
+	const int32_t vertexCount{ static_cast<int32_t>(mesh.vertices.size()) };
+
+	//Write stores whatever it is given with a matching hash, so only the range checks can catch these
+	const auto isRejected = [&](auto&& corrupt)
+		{
+			CachedMesh corruptMesh{ mesh };
+			corrupt(corruptMesh);
+			return Write(file, corruptMesh) && !Load(file);
+		};
+
+	DAE_CHECK(isRejected([&](CachedMesh& corruptMesh) { corruptMesh.sections[0].indexCount = indexCount + 3; }));
+	DAE_CHECK(isRejected([&](CachedMesh& corruptMesh) { corruptMesh.sections[0].firstIndex = indexCount; }));
+	DAE_CHECK(isRejected([&](CachedMesh& corruptMesh) { corruptMesh.sections[0].baseVertex = -1; }));
+	DAE_CHECK(isRejected([&](CachedMesh& corruptMesh) { corruptMesh.sections[0].baseVertex = vertexCount; }));
+	DAE_CHECK(isRejected([&](CachedMesh& corruptMesh) { corruptMesh.lods.back().firstIndex = indexCount - 3; }));
+	DAE_CHECK(isRejected([&](CachedMesh& corruptMesh) { corruptMesh.meshlets.back().triangleCount += 1; }));
+	DAE_CHECK(isRejected([&](CachedMesh& corruptMesh) { std::swap(corruptMesh.meshlets.front(), corruptMesh.meshlets.back()); }));
+
+	//An index past the last vertex
+	DAE_CHECK(isRejected([&](CachedMesh& corruptMesh)
+		{
+			std::visit([vertexCount](auto& indices) { indices[indices.size() / 2] = static_cast<std::decay_t<decltype(indices[0])>>(vertexCount); }, corruptMesh.indices);
+		}));
+
+	DAE_CHECK(Write(file, mesh) && Load(file));
+}
@@ -0,0 +1,75 @@
+#include "pch.h"
+#include "Test.h"
+#include "DataTypes.h"
+#include "MeshSimplifier.h"
+
+using namespace dae;
+
+namespace
+{
+	//A grid of gridSize x gridSize quads in the xy plane, with z from height
+	template<typename Height>
+	void CreateGrid(uint32_t gridSize, Height&& height, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		for (uint32_t row{ 0 }; row <= gridSize; ++row)
+		{
+			for (uint32_t column{ 0 }; column <= gridSize; ++column)
+			{
+				Vertex vertex{};
+				const float x{ static_cast<float>(column) };
+				const float y{ static_cast<float>(row) };
+				vertex.position = { x, y, height(x, y) };
+				vertex.uv = { x / gridSize, y / gridSize };
+				vertices.push_back(vertex);
+			}
+		}
+
+		for (uint32_t row{ 0 }; row < gridSize; ++row)
+		{
+			for (uint32_t column{ 0 }; column < gridSize; ++column)
+			{
+				const uint32_t i0{ row * (gridSize + 1) + column };
+				const uint32_t i2{ i0 + gridSize + 1 };
+				indices.insert(indices.end(), { i0, i2, i0 + 1, i0 + 1, i2, i2 + 1 });
+			}
+		}
+	}
+}
+
+DAE_TEST(MeshSimplifierFlatGridHasNoError)
+{
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+	CreateGrid(16, [](float, float) { return 0.f; }, vertices, indices);
+
+	//Every interior vertex lies on the planes around it, so collapsing it costs nothing
+	std::vector<uint32_t> destination(indices.size());
+	float error{ -1.f };
+	const size_t indexCount{ MeshSimplifier::Simplify(destination.data(), indices.data(), indices.size(), vertices.data(), vertices.size(), indices.size() / 4, &error) };
+	DAE_CHECK_MESSAGE(indexCount > 0 && indexCount <= indices.size() / 2, indexCount << " of " << indices.size() << " indices");
+	DAE_CHECK_MESSAGE(error >= 0.f && error < 1e-3f, "error " << error);
+}
+
+DAE_TEST(MeshSimplifierLodErrorsGrowWithTheSimplification)
+{
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+	CreateGrid(32, [](float x, float y) { return std::sin(x * 0.6f) * std::cos(y * 0.45f); }, vertices, indices);
+	const size_t fullIndexCount{ indices.size() };
+
+	std::vector<MeshLod> lods{};
+	MeshSimplifier::GenerateLodChain(vertices, indices, lods);
+	DAE_CHECK_MESSAGE(lods.size() > 2, lods.size() << " levels");
+	if (lods.empty())
+		return;
+
+	DAE_CHECK(lods[0].firstIndex == 0 && lods[0].indexCount == fullIndexCount && lods[0].error == 0.f);
+	for (size_t i{ 1 }; i < lods.size(); ++i)
+	{
+		DAE_CHECK_MESSAGE(lods[i].indexCount < lods[i - 1].indexCount, "level " << i << ": " << lods[i].indexCount << " indices");
+		DAE_CHECK_MESSAGE(lods[i].error > 0.f && lods[i].error >= lods[i - 1].error, "level " << i << ": error " << lods[i].error);
+
+		//A root mean square distance from planes through the surface, so it stays within the height of the waves
+		DAE_CHECK_MESSAGE(lods[i].error < 2.f, "level " << i << ": error " << lods[i].error);
+	}
+}
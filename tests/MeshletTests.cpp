@@ -0,0 +1,113 @@
+#include "pch.h"
+#include "Test.h"
+#include "Camera.h"
+#include "DataTypes.h"
+#include "Frustum.h"
+#include "Meshlet.h"
+
+using namespace dae;
+
+namespace
+{
+	//A gently curved patch of gridSize x gridSize quads in the xy plane, clockwise seen from -z so its front faces that side
+	void CreatePatch(uint32_t gridSize, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		for (uint32_t row{ 0 }; row <= gridSize; ++row)
+		{
+			for (uint32_t column{ 0 }; column <= gridSize; ++column)
+			{
+				Vertex vertex{};
+				const float x{ static_cast<float>(column) };
+				const float y{ static_cast<float>(row) };
+				vertex.position = { x, y, 0.05f * ((x - gridSize * 0.5f) * (x - gridSize * 0.5f) + (y - gridSize * 0.5f) * (y - gridSize * 0.5f)) };
+				vertices.push_back(vertex);
+			}
+		}
+
+		for (uint32_t row{ 0 }; row < gridSize; ++row)
+		{
+			for (uint32_t column{ 0 }; column < gridSize; ++column)
+			{
+				const uint32_t i0{ row * (gridSize + 1) + column };
+				const uint32_t i1{ i0 + 1 };
+				const uint32_t i2{ i0 + gridSize + 1 };
+				const uint32_t i3{ i2 + 1 };
+				indices.insert(indices.end(), { i0, i2, i1, i1, i2, i3 });
+			}
+		}
+	}
+
+	//The frustum of a camera at position turned towards target, in the space of the vertices like Mesh culls them
+	Frustum CreateFrustum(const Vector3& position, const Vector3& target)
+	{
+		const Vector3 forward{ target - position };
+		Camera camera{};
+		camera.Initialize(45.f, position, 1.f);
+		camera.totalYaw = std::atan2(forward.x, forward.z);
+		camera.totalPitch = std::atan2(forward.y, std::sqrt(forward.x * forward.x + forward.z * forward.z));
+		camera.CalculateViewMatrix();
+		return Frustum::FromMatrix(camera.viewMatrix * camera.projectionMatrix);
+	}
+}
+
+DAE_TEST(MeshletBackFacingClusterIsCulled)
+{
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+	CreatePatch(4, vertices, indices);
+
+	MeshletData meshletData{};
+	Meshlets::Build(vertices.data(), vertices.size(), indices.data(), indices.size(), meshletData);
+	DAE_CHECK_MESSAGE(meshletData.meshlets.size() == 1, meshletData.meshlets.size() << " meshlets");
+	if (meshletData.meshlets.empty())
+		return;
+
+	const Meshlet& meshlet{ meshletData.meshlets.front() };
+	DAE_CHECK_MESSAGE(meshlet.coneCutoff < 1.f, "the cone of a nearly flat patch is open beyond 90 degrees: " << meshlet.coneCutoff);
+
+	const Vector3 center{ 2.f, 2.f, 0.f };
+	const Vector3 front{ 2.f, 2.f, -20.f };
+	const Vector3 back{ 2.f, 2.f, 20.f };
+	const Frustum frontFrustum{ CreateFrustum(front, center) };
+	const Frustum backFrustum{ CreateFrustum(back, center) };
+
+	//In view either way, so only the cone test can cull it
+	DAE_CHECK(!frontFrustum.IsSphereOutside(meshlet.center, meshlet.radius));
+	DAE_CHECK(!backFrustum.IsSphereOutside(meshlet.center, meshlet.radius));
+	DAE_CHECK(Meshlets::IsBackFacing(meshlet, back));
+	DAE_CHECK(Meshlets::IsCulled(meshlet, backFrustum, back, true));
+	DAE_CHECK(!Meshlets::IsCulled(meshlet, backFrustum, back, false));
+
+	DAE_CHECK(!Meshlets::IsBackFacing(meshlet, front));
+	DAE_CHECK(!Meshlets::IsCulled(meshlet, frontFrustum, front, true));
+
+	//Seen edge on some triangles face the camera, and close behind it the sphere reaches in front of the surface
+	const Vector3 side{ 40.f, 2.f, 0.f };
+	DAE_CHECK(!Meshlets::IsCulled(meshlet, CreateFrustum(side, center), side, true));
+	const Vector3 closeBehind{ 2.f, 2.f, 0.5f };
+	DAE_CHECK(!Meshlets::IsBackFacing(meshlet, closeBehind));
+}
+
+DAE_TEST(MeshletFlippedClusterIsCulledFromTheFront)
+{
+	//Flipping the winding turns the front around, so the cone has to follow the winding and not the position of the triangles
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+	CreatePatch(4, vertices, indices);
+	for (size_t i{ 0 }; i < indices.size(); i += 3)
+		std::swap(indices[i + 1], indices[i + 2]);
+
+	MeshletData meshletData{};
+	Meshlets::Build(vertices.data(), vertices.size(), indices.data(), indices.size(), meshletData);
+	if (meshletData.meshlets.empty())
+	{
+		DAE_CHECK(!meshletData.meshlets.empty());
+		return;
+	}
+
+	const Meshlet& meshlet{ meshletData.meshlets.front() };
+	const Vector3 front{ 2.f, 2.f, -20.f };
+	const Vector3 back{ 2.f, 2.f, 20.f };
+	DAE_CHECK(Meshlets::IsCulled(meshlet, CreateFrustum(front, { 2.f, 2.f, 0.f }), front, true));
+	DAE_CHECK(!Meshlets::IsCulled(meshlet, CreateFrustum(back, { 2.f, 2.f, 0.f }), back, true));
+}
@@ -0,0 +1,270 @@
+#include "pch.h"
+#include "Test.h"
+#include "Utils.h"
+#include <cstring>
+#include <fstream>
+
+using namespace dae;
+
+namespace
+{
+	//An OBJ file with the given text, removed again at the end of the test
+	struct TemporaryOBJ : Tests::TemporaryFile
+	{
+		TemporaryOBJ(const char* name, const std::string& text)
+			: TemporaryFile{ name }
+		{
+			std::ofstream{ path, std::ios::binary } << text;
+		}
+	};
+
+	//One vertex per corner in file order and no flips, so the triangles can be compared with the faces in the file
+	Utils::OBJParseSettings GetFileOrderSettings()
+	{
+		Utils::OBJParseSettings settings{};
+		settings.flipAxisAndWinding = false;
+		settings.weldVertices = false;
+		settings.optimizeVertexCache = false;
+		settings.optimizeOverdraw = false;
+		return settings;
+	}
+
+	//Twice the signed area in the xy plane, positive for counterclockwise
+	float GetSignedArea(const Vector3& a, const Vector3& b, const Vector3& c)
+	{
+		return (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y);
+	}
+
+	bool AreBytesEqual(const std::vector<Vertex>& a, const std::vector<Vertex>& b)
+	{
+		return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(Vertex)) == 0;
+	}
+
+	//Rows of a wavy grid, each followed by the faces to the row above it: quads with absolute indices, triangles with relative ones
+	//and every third row without uvs. Large enough that ParseOBJ splits it into several chunks, whose relative indices cross the borders.
+	std::string CreateGridOBJ(uint32_t rowCount, uint32_t columnCount)
+	{
+		std::ostringstream text{};
+		for (uint32_t row{ 0 }; row < rowCount; ++row)
+		{
+			for (uint32_t column{ 0 }; column < columnCount; ++column)
+			{
+				const float x{ static_cast<float>(column) };
+				const float z{ static_cast<float>(row) };
+				text << "v " << x << " " << std::sin(x * 0.3f) * std::cos(z * 0.2f) << " " << z << "\n";
+				text << "vt " << x / columnCount << " " << z / rowCount << "\n";
+				text << "vn " << std::sin(x) * 0.2f << " 1 " << std::cos(z) * 0.2f << "\n";
+			}
+
+			if (row == 0)
+				continue;
+
+			const bool hasUVs{ row % 3 != 0 };
+			const int64_t firstVertex{ static_cast<int64_t>(row) * columnCount + 1 };
+			for (uint32_t column{ 0 }; column + 1 < columnCount; ++column)
+			{
+				const auto writeCorner = [&](int64_t index)
+					{
+						text << " " << index << (hasUVs ? "/" + std::to_string(index) + "/" : "//") << index;
+					};
+
+				const int64_t quad[4]{ firstVertex - columnCount + column, firstVertex + column, firstVertex + column + 1, firstVertex - columnCount + column + 1 };
+				if (column % 2 == 0)
+				{
+					text << "f";
+					for (const int64_t index : quad)
+						writeCorner(index);
+				}
+				else
+				{
+					//Relative to the last vertex written, which is the end of this row
+					const int64_t vertexCount{ static_cast<int64_t>(row + 1) * columnCount };
+					text << "f";
+					for (const int corner : { 0, 1, 2 })
+						writeCorner(quad[corner] - vertexCount - 1);
+					text << "\nf";
+					for (const int corner : { 0, 2, 3 })
+						writeCorner(quad[corner] - vertexCount - 1);
+				}
+				text << "\n";
+			}
+		}
+
+		return text.str();
+	}
+}
+
+DAE_TEST(ObjParserThreadCountDoesNotChangeTheOutput)
+{
+	const TemporaryOBJ file{ "dae_obj_parser_grid.obj", CreateGridOBJ(320, 64) };
+	DAE_CHECK_MESSAGE(std::filesystem::file_size(file.path) > 4 * 256 * 1024, "too small to be split over 4 threads: " << std::filesystem::file_size(file.path));
+
+	for (const bool isWelded : { false, true })
+	{
+		Utils::OBJParseSettings settings{};
+		settings.weldVertices = isWelded;
+		settings.optimizeVertexCache = isWelded;
+		settings.optimizeOverdraw = isWelded;
+
+		std::vector<Vertex> expectedVertices{};
+		std::vector<uint32_t> expectedIndices{};
+		DAE_CHECK(Utils::ParseOBJ(file.path.string(), expectedVertices, expectedIndices, settings));
+		DAE_CHECK_MESSAGE(expectedIndices.size() == 319 * 63 * 6, expectedIndices.size() << " indices");
+
+		for (const uint32_t threadCount : { 2u, 3u, 4u, 8u })
+		{
+			settings.threadCount = threadCount;
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			DAE_CHECK(Utils::ParseOBJ(file.path.string(), vertices, indices, settings));
+			DAE_CHECK_MESSAGE(AreBytesEqual(vertices, expectedVertices), threadCount << " threads, welded " << isWelded);
+			DAE_CHECK_MESSAGE(indices == expectedIndices, threadCount << " threads, welded " << isWelded);
+		}
+	}
+}
+
+DAE_TEST(ObjParserLegacyOverloadKeepsEveryCorner)
+{
+	const TemporaryOBJ file{ "dae_obj_parser_legacy.obj",
+		"v 0 0 0\nv 1 0 0.5\nv 1 1 0\nv 0 1 0\nvt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\nvn 0 0 1\nvn 0 0.6 0.8\n"
+		"f 1/1/1 2/2/2 3/3/1\nf 1/1/1 3/3/1 4/4/1\n" };
+
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+	DAE_CHECK(Utils::ParseOBJ(file.path.string(), vertices, indices));
+
+	//What the std::ifstream loop built: a vertex per corner, v flipped to 1 - v, then the z flip, the winding flip and the tangents
+	const Vector3 positions[]{ { 0.f, 0.f, 0.f }, { 1.f, 0.f, 0.5f }, { 1.f, 1.f, 0.f }, { 0.f, 1.f, 0.f } };
+	const Vector2 UVs[]{ { 0.f, 1.f }, { 1.f, 1.f }, { 1.f, 0.f }, { 0.f, 0.f } };
+	const Vector3 normals[]{ { 0.f, 0.f, 1.f }, { 0.f, 0.6f, 0.8f } };
+	const int corners[][2]{ { 0, 0 }, { 1, 1 }, { 2, 0 }, { 0, 0 }, { 2, 0 }, { 3, 0 } };
+
+	std::vector<Vertex> expectedVertices{};
+	for (const auto& [position, normal] : corners)
+	{
+		Vertex vertex{};
+		vertex.position = positions[position];
+		vertex.uv = UVs[position];
+		vertex.normal = normals[normal];
+		expectedVertices.push_back(vertex);
+	}
+
+	const std::vector<uint32_t> expectedIndices{ 0, 2, 1, 3, 5, 4 };
+	Utils::CalculateTangents(expectedVertices, expectedIndices, true, 1);
+
+	DAE_CHECK(AreBytesEqual(vertices, expectedVertices));
+	DAE_CHECK(indices == expectedIndices);
+}
+
+DAE_TEST(ObjParserSeamsDoNotWeld)
+{
+	//Two triangles of a quad share corners 1 and 3. The seam file gives corner 1 another uv and corner 3 another normal in the second triangle.
+	const std::string header{ "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nvt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\nvt 0.5 0.5\nvn 0 0 1\nvn 0 0 -1\nf 1/1/1 2/2/1 3/3/1\n" };
+	const TemporaryOBJ sharedFile{ "dae_obj_parser_shared.obj", header + "f 1/1/1 3/3/1 4/4/1\n" };
+	const TemporaryOBJ seamFile{ "dae_obj_parser_seams.obj", header + "f 1/5/1 3/3/2 4/4/1\n" };
+
+	Utils::OBJParseSettings settings{};
+	settings.flipAxisAndWinding = false;
+
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+	DAE_CHECK(Utils::ParseOBJ(sharedFile.path.string(), vertices, indices, settings));
+	DAE_CHECK_MESSAGE(vertices.size() == 4, vertices.size() << " vertices");
+
+	DAE_CHECK(Utils::ParseOBJ(seamFile.path.string(), vertices, indices, settings));
+	DAE_CHECK_MESSAGE(vertices.size() == 6, vertices.size() << " vertices");
+
+	//Whatever order the optimizations left the triangles in, each corner has to keep its own uv and normal
+	size_t seamUVCount{ 0 };
+	size_t seamNormalCount{ 0 };
+	for (const uint32_t index : indices)
+	{
+		const Vertex& vertex{ vertices[index] };
+		if (vertex.position == Vector3{ 0.f, 0.f, 0.f } && vertex.uv.x == 0.5f && vertex.uv.y == 0.5f)
+			++seamUVCount;
+		if (vertex.position == Vector3{ 1.f, 1.f, 0.f } && vertex.normal == Vector3{ 0.f, 0.f, -1.f })
+			++seamNormalCount;
+	}
+
+	DAE_CHECK_MESSAGE(seamUVCount == 1, seamUVCount << " corners with the seam uv");
+	DAE_CHECK_MESSAGE(seamNormalCount == 1, seamNormalCount << " corners with the seam normal");
+}
+
+DAE_TEST(ObjParserQuadBecomesTwoTriangles)
+{
+	const TemporaryOBJ file{ "dae_obj_parser_quad.obj", "v 0 0 0\nv 2 0 0\nv 2 1 0\nv 0 1 0\nvn 0 0 1\nf 1//1 2//1 3//1 4//1\n" };
+
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+	DAE_CHECK(Utils::ParseOBJ(file.path.string(), vertices, indices, GetFileOrderSettings()));
+	DAE_CHECK_MESSAGE(indices.size() == 6, indices.size() << " indices");
+	if (indices.size() != 6)
+		return;
+
+	//Both keep the winding of the quad and together cover it once
+	float area{ 0.f };
+	for (size_t i{ 0 }; i < indices.size(); i += 3)
+	{
+		const float triangleArea{ GetSignedArea(vertices[indices[i]].position, vertices[indices[i + 1]].position, vertices[indices[i + 2]].position) };
+		DAE_CHECK_MESSAGE(triangleArea > 0.f, "triangle " << i / 3 << " is flipped or degenerate: " << triangleArea);
+		area += triangleArea;
+	}
+
+	DAE_CHECK_MESSAGE(area == 4.f, area);
+	DAE_CHECK(std::all_of(vertices.begin(), vertices.end(), [](const Vertex& vertex) { return vertex.normal == Vector3::UnitZ; }));
+}
+
+DAE_TEST(ObjParserConcavePentagonIsEarClipped)
+{
+	//A square with a notch cut down to (2, 1), starting at a corner next to the notch, so a fan from the first corner would fill the notch
+	const TemporaryOBJ file{ "dae_obj_parser_pentagon.obj", "v 4 4 0\nv 2 1 0\nv 0 4 0\nv 0 0 0\nv 4 0 0\nf 1 2 3 4 5\n" };
+
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+	DAE_CHECK(Utils::ParseOBJ(file.path.string(), vertices, indices, GetFileOrderSettings()));
+	DAE_CHECK_MESSAGE(indices.size() == 9, indices.size() << " indices");
+
+	//The pentagon is counterclockwise, so every triangle has to be as well, and their areas add up to the square minus the notch
+	float area{ 0.f };
+	for (size_t i{ 0 }; i + 2 < indices.size(); i += 3)
+	{
+		const float triangleArea{ GetSignedArea(vertices[indices[i]].position, vertices[indices[i + 1]].position, vertices[indices[i + 2]].position) };
+		DAE_CHECK_MESSAGE(triangleArea > 0.f, "triangle " << i / 3 << " is flipped or degenerate: " << triangleArea);
+		area += triangleArea;
+	}
+
+	DAE_CHECK_MESSAGE(area == 2.f * (16.f - 6.f), area);
+}
+
+DAE_TEST(ObjParserRelativeIndicesMatchAbsoluteOnes)
+{
+	//The second face refers to the vertices written after the first one, with relative indices that count back from the last of them
+	const std::string vertices1{ "v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvt 1 0\nvt 0 1\nvn 0 0 1\n" };
+	const std::string vertices2{ "v 0 0 1\nv 1 0 1\nv 1 1 1\nv 0 1 1\nvt 0.5 0\nvt 1 0.5\nvt 0.5 1\nvt 0 0.5\nvn 0 1 0\n" };
+	const TemporaryOBJ absoluteFile{ "dae_obj_parser_absolute.obj", vertices1 + "f 1/1/1 2/2/1 3/3/1\n" + vertices2 + "f 4/4/2 5/5/2 6/6/2 7/7/2\nf 1//1 2//1 3//1\n" };
+	const TemporaryOBJ relativeFile{ "dae_obj_parser_relative.obj", vertices1 + "f -3/-3/-1 -2/-2/-1 -1/-1/-1\n" + vertices2 + "f -4/-4/-1 -3/-3/-1 -2/-2/-1 -1/-1/-1\nf -7//-2 -6//-2 -5//-2\n" };
+
+	for (const Utils::OBJParseSettings& settings : { GetFileOrderSettings(), Utils::OBJParseSettings{} })
+	{
+		std::vector<Vertex> absoluteVertices{};
+		std::vector<uint32_t> absoluteIndices{};
+		std::vector<Vertex> relativeVertices{};
+		std::vector<uint32_t> relativeIndices{};
+		DAE_CHECK(Utils::ParseOBJ(absoluteFile.path.string(), absoluteVertices, absoluteIndices, settings));
+		DAE_CHECK(Utils::ParseOBJ(relativeFile.path.string(), relativeVertices, relativeIndices, settings));
+
+		DAE_CHECK_MESSAGE(absoluteIndices.size() == 12, absoluteIndices.size() << " indices");
+		DAE_CHECK(AreBytesEqual(relativeVertices, absoluteVertices));
+		DAE_CHECK(relativeIndices == absoluteIndices);
+	}
+
+	//Before the first vertex, 0, which is neither absolute nor relative, and 2^64 + 1 and -(2^64 - 1), which wrap around to 1 and -1 in 64 bits
+	for (const char* pText : { "v 0 0 0\nv 1 0 0\nv 0 1 0\nf -4 -2 -1\n", "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 0 1 2\n",
+		"v 0 0 0\nv 1 0 0\nv 0 1 0\nf 18446744073709551617 2 3\n", "v 0 0 0\nv 1 0 0\nv 0 1 0\nf -3 -2 -18446744073709551615\n" })
+	{
+		const TemporaryOBJ invalidFile{ "dae_obj_parser_invalid.obj", pText };
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+		DAE_CHECK_MESSAGE(!Utils::ParseOBJ(invalidFile.path.string(), vertices, indices, GetFileOrderSettings()), pText);
+	}
+}
@@ -0,0 +1,230 @@
+#include "pch.h"
+#include "Test.h"
+#include "ObjStream.h"
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace dae;
+
+namespace
+{
+	//The generated mesh is a grid of g_GridWidth vertices per row, with rows added until the file reaches this size
+	constexpr uint64_t g_LargeFileSize{ 2ull * 1024 * 1024 * 1024 };
+	constexpr uint32_t g_GridWidth{ 1024 };
+	constexpr int g_QuadTriangles[2][3]{ { 0, 1, 2 }, { 0, 2, 3 } };
+
+	//What the process allocates besides the loader: the runtime, the spill file streams and the callback
+	constexpr size_t g_ProcessMemorySlack{ 16 * 1024 * 1024 };
+
+	//Highest resident set size of the process so far
+	size_t GetPeakResidentMemory()
+	{
+#ifdef _WIN32
+		PROCESS_MEMORY_COUNTERS counters{};
+		GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+		return counters.PeakWorkingSetSize;
+#else
+		rusage usage{};
+		getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+		return static_cast<size_t>(usage.ru_maxrss);
+#else
+		return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+	}
+
+	//Appends text and numbers to a buffer that is written out in large blocks, so generating the file stays fast and small in memory
+	class ObjWriter final
+	{
+	public:
+		explicit ObjWriter(const std::filesystem::path& path)
+			: m_File{ path, std::ios::binary }
+		{
+			m_Buffer.reserve(BufferSize + 256);
+		}
+
+		~ObjWriter()
+		{
+			Flush();
+		}
+
+		inline uint64_t GetSize() const { return m_Size + m_Buffer.size(); }
+
+		ObjWriter& operator<<(const char* pText)
+		{
+			m_Buffer.append(pText);
+			return FlushIfFull();
+		}
+
+		ObjWriter& operator<<(float value)
+		{
+			char text[32];
+			const auto result{ std::to_chars(text, text + sizeof(text), value) };
+			m_Buffer.append(text, result.ptr);
+			return FlushIfFull();
+		}
+
+		ObjWriter& operator<<(uint64_t value)
+		{
+			char text[32];
+			const auto result{ std::to_chars(text, text + sizeof(text), value) };
+			m_Buffer.append(text, result.ptr);
+			return FlushIfFull();
+		}
+
+		void Flush()
+		{
+			m_File.write(m_Buffer.data(), m_Buffer.size());
+			m_Size += m_Buffer.size();
+			m_Buffer.clear();
+		}
+
+	private:
+		static constexpr size_t BufferSize{ 1024 * 1024 };
+
+		std::ofstream m_File;
+		std::string m_Buffer{};
+		uint64_t m_Size{};
+
+		ObjWriter& FlushIfFull()
+		{
+			if (m_Buffer.size() >= BufferSize)
+				Flush();
+
+			return *this;
+		}
+	};
+
+	//Rows of a height field with a uv and normal per vertex, two triangles per quad between a row and the one above it.
+	//Faces only reference the last two rows, like the locality of a real scan, so the spilled arrays are read through their cache.
+	uint64_t WriteGrid(const std::filesystem::path& path, uint64_t minFileSize)
+	{
+		ObjWriter writer{ path };
+		uint64_t triangleCount{ 0 };
+
+		for (uint64_t row{ 0 }; writer.GetSize() < minFileSize; ++row)
+		{
+			for (uint32_t column{ 0 }; column < g_GridWidth; ++column)
+			{
+				const float x{ static_cast<float>(column) };
+				const float z{ static_cast<float>(row) };
+				writer << "v " << x << " " << std::sin(x * 0.1f) * std::cos(z * 0.1f) << " " << z << "\n";
+				writer << "vt " << x / g_GridWidth << " " << static_cast<float>(row % 1024) / 1024.f << "\n";
+				writer << "vn 0 1 0\n";
+			}
+
+			if (row == 0)
+				continue;
+
+			//1-based, the row above starts one row before this one
+			const uint64_t firstVertex{ row * g_GridWidth + 1 };
+			const uint64_t firstVertexAbove{ firstVertex - g_GridWidth };
+			for (uint32_t column{ 0 }; column + 1 < g_GridWidth; ++column)
+			{
+				const uint64_t quad[4]{ firstVertexAbove + column, firstVertexAbove + column + 1, firstVertex + column + 1, firstVertex + column };
+				for (const auto& triangle : g_QuadTriangles)
+				{
+					writer << "f";
+					for (const int corner : triangle)
+					{
+						const uint64_t index{ quad[corner] };
+						writer << " " << index << "/" << index << "/" << index;
+					}
+					writer << "\n";
+				}
+
+				triangleCount += 2;
+			}
+		}
+
+		return triangleCount;
+	}
+
+	//A comment line of lineSize bytes followed by a single triangle
+	void WriteLongLine(const std::filesystem::path& path, size_t lineSize)
+	{
+		ObjWriter writer{ path };
+		writer << "#";
+		for (size_t i{ 1 }; i < lineSize; ++i)
+			writer << "x";
+
+		writer << "\nv 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+	}
+}
+
+DAE_TEST(ObjStreamLargeFileStaysUnderTheLimit)
+{
+	//The attribute arrays of the generated file are several times the limit, so they have to spill.
+	//First in the file, so the peak resident memory of the process is not already raised by the other tests.
+	const Tests::TemporaryFile file{ "dae_obj_stream_large.obj" };
+	const uint64_t expectedTriangleCount{ WriteGrid(file.path, g_LargeFileSize) };
+
+	Utils::OBJStreamSettings settings{};
+	settings.memoryLimit = 64 * 1024 * 1024;
+
+	uint64_t triangleCount{ 0 };
+	Utils::OBJStreamStatistics statistics{};
+	const size_t peakResidentMemoryBefore{ GetPeakResidentMemory() };
+	const bool isLoaded{ Utils::StreamOBJ(file.path.string(), settings, [&triangleCount](const Utils::OBJBatch& batch) { triangleCount += batch.indexCount / 3; }, &statistics) };
+	const size_t peakResidentMemory{ GetPeakResidentMemory() };
+
+	DAE_CHECK(isLoaded);
+	DAE_CHECK(statistics.hasSpilled);
+	DAE_CHECK_MESSAGE(triangleCount == expectedTriangleCount, triangleCount << " of " << expectedTriangleCount);
+	DAE_CHECK_MESSAGE(statistics.triangleCount == expectedTriangleCount, statistics.triangleCount << " of " << expectedTriangleCount);
+	DAE_CHECK_MESSAGE(statistics.peakMemoryUsage <= settings.memoryLimit, statistics.peakMemoryUsage << " > " << settings.memoryLimit);
+	DAE_CHECK_MESSAGE(peakResidentMemory <= peakResidentMemoryBefore + settings.memoryLimit + g_ProcessMemorySlack,
+		"peak resident memory " << peakResidentMemory << " from " << peakResidentMemoryBefore);
+}
+
+DAE_TEST(ObjStreamLongLineGrowsTheBuffer)
+{
+	//Longer than the 4 MB read buffer, so it has to double once. The batch is tiny, so the grown buffer is most of the peak.
+	const Tests::TemporaryFile file{ "dae_obj_stream_long_line.obj" };
+	WriteLongLine(file.path, 6 * 1024 * 1024);
+
+	Utils::OBJStreamSettings settings{};
+	settings.batchTriangleCount = 16;
+
+	uint64_t triangleCount{ 0 };
+	Utils::OBJStreamStatistics statistics{};
+	const bool isLoaded{ Utils::StreamOBJ(file.path.string(), settings, [&triangleCount](const Utils::OBJBatch& batch) { triangleCount += batch.indexCount / 3; }, &statistics) };
+
+	DAE_CHECK(isLoaded);
+	DAE_CHECK(!statistics.isLineTooLong);
+	DAE_CHECK_MESSAGE(triangleCount == 1, triangleCount);
+	DAE_CHECK_MESSAGE(statistics.peakMemoryUsage >= 8 * 1024 * 1024, "the grown buffer is not counted: " << statistics.peakMemoryUsage);
+}
+
+DAE_TEST(ObjStreamLineOverTheLimitFails)
+{
+	const Tests::TemporaryFile file{ "dae_obj_stream_line_over_limit.obj" };
+	WriteLongLine(file.path, 64 * 1024 * 1024);
+
+	Utils::OBJStreamSettings settings{};
+	settings.memoryLimit = 32 * 1024 * 1024;
+
+	Utils::OBJStreamStatistics statistics{};
+	const size_t peakResidentMemoryBefore{ GetPeakResidentMemory() };
+	const bool isLoaded{ Utils::StreamOBJ(file.path.string(), settings, [](const Utils::OBJBatch&) {}, &statistics) };
+
+	DAE_CHECK(!isLoaded);
+	DAE_CHECK(statistics.isLineTooLong);
+	DAE_CHECK_MESSAGE(statistics.peakMemoryUsage <= settings.memoryLimit, statistics.peakMemoryUsage << " > " << settings.memoryLimit);
+	DAE_CHECK_MESSAGE(GetPeakResidentMemory() <= peakResidentMemoryBefore + settings.memoryLimit + g_ProcessMemorySlack,
+		"peak resident memory " << GetPeakResidentMemory() << " from " << peakResidentMemoryBefore);
+}
@@ -0,0 +1,51 @@
+#include "pch.h"
+#include "Test.h"
+#include "Parallel.h"
+
+using namespace dae;
+
+DAE_TEST(ParallelForRunsEveryJobOnce)
+{
+	//Many short loops in a row with changing thread counts, like a frame per Flush, reuse the same workers
+	for (uint32_t iteration{ 0 }; iteration < 2000; ++iteration)
+	{
+		const uint32_t jobCount{ iteration % 97 };
+		const uint32_t threadCount{ 1 + iteration % 8 };
+
+		std::vector<std::atomic<uint32_t>> runCounts(jobCount);
+		Parallel::For(jobCount, threadCount, [&runCounts](uint32_t i) { ++runCounts[i]; });
+
+		for (uint32_t i{ 0 }; i < jobCount; ++i)
+			DAE_CHECK_MESSAGE(runCounts[i] == 1, "iteration " << iteration << ", job " << i << " ran " << runCounts[i] << " times");
+	}
+}
+
+DAE_TEST(ParallelForNestedAndConcurrent)
+{
+	//A job that starts a loop of its own runs it inline instead of waiting on the busy pool
+	constexpr uint32_t outerJobCount{ 16 };
+	constexpr uint32_t innerJobCount{ 64 };
+	std::vector<std::atomic<uint32_t>> runCounts(outerJobCount * innerJobCount);
+	Parallel::For(outerJobCount, 4, [&runCounts](uint32_t outer)
+		{
+			Parallel::For(innerJobCount, 4, [&runCounts, outer](uint32_t inner) { ++runCounts[outer * innerJobCount + inner]; });
+		});
+
+	for (size_t i{ 0 }; i < runCounts.size(); ++i)
+		DAE_CHECK_MESSAGE(runCounts[i] == 1, "job " << i << " ran " << runCounts[i] << " times");
+
+	//Two threads sharing the pool take turns
+	std::vector<std::atomic<uint32_t>> sums(2);
+	const auto run = [&sums](uint32_t caller)
+		{
+			for (uint32_t iteration{ 0 }; iteration < 200; ++iteration)
+				Parallel::For(100, 3, [&sums, caller](uint32_t i) { sums[caller] += i; });
+		};
+
+	std::thread other{ run, 1u };
+	run(0);
+	other.join();
+
+	for (uint32_t caller{ 0 }; caller < 2; ++caller)
+		DAE_CHECK_MESSAGE(sums[caller] == 200 * 4950, "caller " << caller << ": " << sums[caller]);
+}
@@ -0,0 +1,149 @@
+#include "pch.h"
+#include "Test.h"
+#include "PhongShader.h"
+#include "SoftwareTexture.h"
+#include <random>
+
+using namespace dae;
+
+namespace
+{
+	//ShadeBlock raises to the glossiness with the Cephes log and exp polynomials where ShadePixel calls std::pow,
+	//everything else is the same float math. Far below the 1/255 step of the framebuffer either way.
+	constexpr float g_MaxColorDifference{ 1e-5f };
+
+	constexpr uint32_t g_BlockCount{ 50'000 };
+
+	//Shader inputs like the rasterizer interpolates them: unit normals, tangents perpendicular to them and uvs that wrap
+	void FillBlock(std::mt19937& random, PhongShader::PixelBlock& pixels)
+	{
+		std::uniform_real_distribution<float> position{ -20.f, 20.f };
+		std::uniform_real_distribution<float> uv{ -3.f, 3.f };
+		std::uniform_real_distribution<float> component{ -1.f, 1.f };
+
+		for (uint32_t lane{ 0 }; lane < PhongShader::BlockWidth; ++lane)
+		{
+			Vector3 normal{};
+			Vector3 tangent{};
+			do
+			{
+				normal = Vector3{ component(random), component(random), component(random) };
+				tangent = Vector3{ component(random), component(random), component(random) };
+			} while (normal.SqrMagnitude() < 1e-4f || Vector3::Reject(tangent, normal.Normalized()).SqrMagnitude() < 1e-4f);
+
+			normal.Normalize();
+			tangent = Vector3::Reject(tangent, normal).Normalized();
+
+			const float values[PhongShader::AttributeCount]{ position(random), position(random), position(random), uv(random), uv(random),
+				normal.x, normal.y, normal.z, tangent.x, tangent.y, tangent.z, random() % 2 ? 1.f : -1.f };
+
+			for (int attribute{ 0 }; attribute < PhongShader::AttributeCount; ++attribute)
+				pixels.attributes[attribute][lane] = values[attribute];
+		}
+	}
+
+	Vertex_Out GetPixel(const PhongShader::PixelBlock& pixels, uint32_t lane)
+	{
+		const auto& attributes{ pixels.attributes };
+
+		Vertex_Out pixel{};
+		pixel.worldPosition = { attributes[PhongShader::WorldPositionX][lane], attributes[PhongShader::WorldPositionY][lane], attributes[PhongShader::WorldPositionZ][lane] };
+		pixel.uv = { attributes[PhongShader::U][lane], attributes[PhongShader::V][lane] };
+		pixel.normal = { attributes[PhongShader::NormalX][lane], attributes[PhongShader::NormalY][lane], attributes[PhongShader::NormalZ][lane] };
+		pixel.tangent = { attributes[PhongShader::TangentX][lane], attributes[PhongShader::TangentY][lane], attributes[PhongShader::TangentZ][lane],
+			attributes[PhongShader::TangentW][lane] };
+
+		return pixel;
+	}
+
+	float GetMaxDifference(const ColorRGB& a, const ColorRGB& b)
+	{
+		return std::max({ std::abs(a.r - b.r), std::abs(a.g - b.g), std::abs(a.b - b.b) });
+	}
+
+	//Compares every lane of ShadeBlock with ShadePixel. Partial blocks get NaN in the lanes past count, which must neither leak into
+	//the shaded lanes nor be written out.
+	float CompareWithShadePixel(const PhongShader::Material& material, uint32_t seed)
+	{
+		std::mt19937 random{ seed };
+		const Vector3 cameraPosition{ 0.f, 0.f, -50.f };
+		const ColorRGB untouched{ -1.f, -2.f, -3.f };
+
+		float maxDifference{ 0.f };
+		for (uint32_t block{ 0 }; block < g_BlockCount; ++block)
+		{
+			PhongShader::PixelBlock pixels{};
+			FillBlock(random, pixels);
+
+			const uint32_t count{ block % PhongShader::BlockWidth + 1 };
+			for (uint32_t lane{ count }; lane < PhongShader::BlockWidth; ++lane)
+				for (int attribute{ 0 }; attribute < PhongShader::AttributeCount; ++attribute)
+					pixels.attributes[attribute][lane] = std::numeric_limits<float>::quiet_NaN();
+
+			ColorRGB colors[PhongShader::BlockWidth]{};
+			std::fill(std::begin(colors), std::end(colors), untouched);
+			PhongShader::ShadeBlock(pixels, count, cameraPosition, material, colors);
+
+			for (uint32_t lane{ 0 }; lane < count; ++lane)
+			{
+				const ColorRGB expected{ PhongShader::ShadePixel(GetPixel(pixels, lane), cameraPosition, material) };
+				const float difference{ GetMaxDifference(colors[lane], expected) };
+				maxDifference = std::max(maxDifference, std::isnan(difference) ? INFINITY : difference);
+			}
+
+			for (uint32_t lane{ count }; lane < PhongShader::BlockWidth; ++lane)
+				DAE_CHECK_MESSAGE(GetMaxDifference(colors[lane], untouched) == 0.f, "lane " << lane << " of " << count << " was written");
+		}
+
+		return maxDifference;
+	}
+
+	struct Maps
+	{
+		SoftwareTexture diffuseMap{ "Resources/vehicle_diffuse.png" };
+		SoftwareTexture normalMap{ "Resources/vehicle_normal.png" };
+		SoftwareTexture specularMap{ "Resources/vehicle_specular.png" };
+		SoftwareTexture glossinessMap{ "Resources/vehicle_gloss.png" };
+
+		bool IsValid() const
+		{
+			return diffuseMap.IsValid() && normalMap.IsValid() && specularMap.IsValid() && glossinessMap.IsValid();
+		}
+	};
+}
+
+DAE_TEST(PhongShaderBlockMatchesPixel)
+{
+	const Maps maps{};
+	DAE_CHECK_MESSAGE(maps.IsValid(), "run from the source directory, the vehicle maps are in Resources");
+	if (!maps.IsValid())
+		return;
+
+	const PhongShader::Material material{ &maps.diffuseMap, &maps.normalMap, &maps.specularMap, &maps.glossinessMap, true };
+	const float maxDifference{ CompareWithShadePixel(material, 3) };
+
+	std::cout << "  max difference " << maxDifference << "\n";
+	DAE_CHECK_MESSAGE(maxDifference <= g_MaxColorDifference, maxDifference);
+}
+
+DAE_TEST(PhongShaderBlockMatchesPixelWithoutNormalMap)
+{
+	const Maps maps{};
+	if (!maps.IsValid())
+		return;
+
+	const PhongShader::Material material{ &maps.diffuseMap, &maps.normalMap, &maps.specularMap, &maps.glossinessMap, false };
+	const float maxDifference{ CompareWithShadePixel(material, 4) };
+
+	std::cout << "  max difference " << maxDifference << "\n";
+	DAE_CHECK_MESSAGE(maxDifference <= g_MaxColorDifference, maxDifference);
+}
+
+DAE_TEST(PhongShaderBlockMatchesPixelWithoutMaps)
+{
+	//Every map samples as white
+	const float maxDifference{ CompareWithShadePixel(PhongShader::Material{}, 5) };
+
+	std::cout << "  max difference " << maxDifference << "\n";
+	DAE_CHECK_MESSAGE(maxDifference <= g_MaxColorDifference, maxDifference);
+}
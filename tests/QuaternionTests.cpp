@@ -0,0 +1,124 @@
+#include "pch.h"
+#include "Test.h"
+#include "Transform.h"
+#include <random>
+
+using namespace dae;
+
+namespace
+{
+	//Transform renormalizes every 64 rotations, so the drift can never build up past what 64 products add
+	constexpr float g_MaxUnitLengthError{ 1e-6f };
+	constexpr float g_MaxOrthonormalityError{ 2e-6f };
+	//The error of the angle does build up: every product rounds, about 1e-7 rad each, in a random direction
+	constexpr double g_MaxAngleError{ 1e-3 };
+
+	constexpr uint32_t g_RotationCount{ 10'000'000 };
+
+	//Largest deviation of the axes from unit length and from being perpendicular
+	float GetOrthonormalityError(const Matrix& m)
+	{
+		const Vector3 x{ m.GetAxisX() };
+		const Vector3 y{ m.GetAxisY() };
+		const Vector3 z{ m.GetAxisZ() };
+		return std::max({ std::abs(x.Magnitude() - 1.f), std::abs(y.Magnitude() - 1.f), std::abs(z.Magnitude() - 1.f),
+			std::abs(Vector3::Dot(x, y)), std::abs(Vector3::Dot(y, z)), std::abs(Vector3::Dot(z, x)) });
+	}
+
+	float GetMaxDifference(const Matrix& a, const Matrix& b)
+	{
+		float maxDifference{ 0.f };
+		for (int r{ 0 }; r < 4; ++r)
+			for (int c{ 0 }; c < 4; ++c)
+				maxDifference = std::max(maxDifference, std::abs(a[r][c] - b[r][c]));
+
+		return maxDifference;
+	}
+}
+
+DAE_TEST(QuaternionMatchesMatrixRotations)
+{
+	std::mt19937 random{ 1 };
+	std::uniform_real_distribution<float> angle{ -3.f, 3.f };
+
+	float maxDifference{ 0.f };
+	for (int i{ 0 }; i < 1000; ++i)
+	{
+		const Vector3 angles{ angle(random), angle(random), angle(random) };
+		maxDifference = std::max({ maxDifference,
+			GetMaxDifference(Quaternion::CreateRotationX(angles.x).ToMatrix(), Matrix::CreateRotationX(angles.x)),
+			GetMaxDifference(Quaternion::CreateRotationY(angles.y).ToMatrix(), Matrix::CreateRotationY(angles.y)),
+			GetMaxDifference(Quaternion::CreateRotationZ(angles.z).ToMatrix(), Matrix::CreateRotationZ(angles.z)),
+			GetMaxDifference(Quaternion::CreateRotation(angles).ToMatrix(), Matrix::CreateRotation(angles)),
+			GetMaxDifference((Quaternion::CreateRotationY(angles.y) * Quaternion::CreateRotationX(angles.x)).ToMatrix(),
+				Matrix::CreateRotationY(angles.y) * Matrix::CreateRotationX(angles.x)) });
+	}
+
+	DAE_CHECK_MESSAGE(maxDifference <= 1e-5f, maxDifference);
+}
+
+DAE_TEST(QuaternionDriftStaysBounded)
+{
+	//The renderer's case: one small rotation per frame, here 10^7 frames
+	constexpr float step{ 0.0001234f };
+	Transform transform{};
+	float maxUnitLengthError{ 0.f };
+	float maxOrthonormalityError{ 0.f };
+
+	for (uint32_t i{ 0 }; i < g_RotationCount; ++i)
+	{
+		transform.Rotate(Quaternion::CreateRotationY(step));
+
+		//Measuring costs more than rotating, so only now and then
+		if (i % 4096 == 0)
+		{
+			maxUnitLengthError = std::max(maxUnitLengthError, std::abs(transform.GetRotation().Magnitude() - 1.f));
+			maxOrthonormalityError = std::max(maxOrthonormalityError, GetOrthonormalityError(transform.GetWorldMatrix()));
+		}
+	}
+
+	maxUnitLengthError = std::max(maxUnitLengthError, std::abs(transform.GetRotation().Magnitude() - 1.f));
+	maxOrthonormalityError = std::max(maxOrthonormalityError, GetOrthonormalityError(transform.GetWorldMatrix()));
+
+	//Rotations about one axis only add up their angles
+	const Quaternion& rotation{ transform.GetRotation() };
+	const double angle{ 2.0 * std::atan2(static_cast<double>(rotation.y), static_cast<double>(rotation.w)) };
+	const double expectedAngle{ static_cast<double>(step) * g_RotationCount };
+	constexpr double twoPi{ 6.283185307179586 };
+	const double angleError{ std::abs(std::remainder(angle - expectedAngle, twoPi)) };
+
+	std::cout << "  |q| - 1 " << maxUnitLengthError << ", orthonormality " << maxOrthonormalityError << ", angle " << angleError << " rad\n";
+	DAE_CHECK_MESSAGE(maxUnitLengthError <= g_MaxUnitLengthError, maxUnitLengthError);
+	DAE_CHECK_MESSAGE(maxOrthonormalityError <= g_MaxOrthonormalityError, maxOrthonormalityError);
+	DAE_CHECK_MESSAGE(angleError <= g_MaxAngleError, angleError << " rad");
+}
+
+DAE_TEST(QuaternionDriftStaysBoundedOnEveryAxis)
+{
+	//Random small rotations about every axis, where there is no closed form to compare with but the length and axes must hold
+	std::mt19937 random{ 3 };
+	std::uniform_real_distribution<float> angle{ -0.01f, 0.01f };
+
+	std::vector<Quaternion> rotations(1024);
+	for (Quaternion& rotation : rotations)
+		rotation = Quaternion::CreateRotation(Vector3{ angle(random), angle(random), angle(random) });
+
+	Transform transform{};
+	float maxUnitLengthError{ 0.f };
+	float maxOrthonormalityError{ 0.f };
+
+	for (uint32_t i{ 0 }; i < g_RotationCount; ++i)
+	{
+		transform.Rotate(rotations[i % rotations.size()]);
+
+		if (i % 4096 == 0)
+		{
+			maxUnitLengthError = std::max(maxUnitLengthError, std::abs(transform.GetRotation().Magnitude() - 1.f));
+			maxOrthonormalityError = std::max(maxOrthonormalityError, GetOrthonormalityError(transform.GetWorldMatrix()));
+		}
+	}
+
+	std::cout << "  |q| - 1 " << maxUnitLengthError << ", orthonormality " << maxOrthonormalityError << "\n";
+	DAE_CHECK_MESSAGE(maxUnitLengthError <= g_MaxUnitLengthError, maxUnitLengthError);
+	DAE_CHECK_MESSAGE(maxOrthonormalityError <= g_MaxOrthonormalityError, maxOrthonormalityError);
+}
@@ -0,0 +1,377 @@
+#include "pch.h"
+#include "Test.h"
+#include "Camera.h"
+#include "SoftwareRasterizer.h"
+#include "SoftwareTexture.h"
+#include "Utils.h"
+#include <bit>
+#include <numbers>
+#include <random>
+
+using namespace dae;
+
+namespace
+{
+	constexpr SoftwareRasterizer::ShadingMode g_ShadingModes[]{ SoftwareRasterizer::ShadingMode::Forward,
+		SoftwareRasterizer::ShadingMode::DepthPrePass, SoftwareRasterizer::ShadingMode::VisibilityBuffer };
+
+	const char* GetName(SoftwareRasterizer::ShadingMode shadingMode)
+	{
+		switch (shadingMode)
+		{
+		case SoftwareRasterizer::ShadingMode::DepthPrePass: return "DepthPrePass";
+		case SoftwareRasterizer::ShadingMode::VisibilityBuffer: return "VisibilityBuffer";
+		default: return "Forward";
+		}
+	}
+
+	//Triangles given in pixels and depth, drawn with identity matrices so the pixels map straight to clip space
+	struct PixelMesh
+	{
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+
+		void AddTriangle(const Vector3& p0, const Vector3& p1, const Vector3& p2, uint32_t width, uint32_t height, const Vector3& normal = -Vector3::UnitZ)
+		{
+			for (const Vector3* pPoint : { &p0, &p1, &p2 })
+			{
+				Vertex vertex{};
+				vertex.position = { pPoint->x / width * 2.f - 1.f, 1.f - pPoint->y / height * 2.f, pPoint->z };
+				vertex.uv = { pPoint->x / width, pPoint->y / height };
+				vertex.normal = normal;
+				vertex.tangent = Vector4{ Vector3::UnitX, 1.f };
+				indices.push_back(static_cast<uint32_t>(vertices.size()));
+				vertices.push_back(vertex);
+			}
+		}
+
+		void Draw(SoftwareRasterizer& rasterizer) const
+		{
+			rasterizer.Draw(vertices.data(), vertices.size(), indices.data(), indices.size(), PrimitiveTopology::TriangleList, Matrix::Identity, Matrix::Identity);
+		}
+	};
+
+	//Grid points at the corners of cells of about cellSize pixels, the inner ones moved up to 0.2 of a cell in x and y, which keeps every
+	//cell convex so either diagonal splits it into two triangles that do not overlap. The points on the border of the screen stay on it,
+	//so the triangles cover every pixel between them.
+	std::vector<Vector2> CreateJitteredGrid(uint32_t width, uint32_t height, float cellSize, std::mt19937& random, uint32_t& columnCount, uint32_t& rowCount)
+	{
+		columnCount = std::max(1u, static_cast<uint32_t>(width / cellSize));
+		rowCount = std::max(1u, static_cast<uint32_t>(height / cellSize));
+		const float cellWidth{ static_cast<float>(width) / columnCount };
+		const float cellHeight{ static_cast<float>(height) / rowCount };
+		std::uniform_real_distribution<float> jitter{ -0.2f, 0.2f };
+
+		std::vector<Vector2> points{};
+		for (uint32_t row{ 0 }; row <= rowCount; ++row)
+		{
+			for (uint32_t column{ 0 }; column <= columnCount; ++column)
+			{
+				Vector2 point{ column * cellWidth, row * cellHeight };
+				if (column > 0 && column < columnCount)
+					point.x += jitter(random) * cellWidth;
+				if (row > 0 && row < rowCount)
+					point.y += jitter(random) * cellHeight;
+
+				points.push_back(point);
+			}
+		}
+
+		return points;
+	}
+
+	//Two triangles per cell with a random diagonal and winding. depth(triangleIndex, point) gives the depth of every corner.
+	template<typename Depth>
+	PixelMesh TriangulateGrid(const std::vector<Vector2>& points, uint32_t columnCount, uint32_t rowCount, uint32_t width, uint32_t height,
+		std::mt19937& random, const Depth& depth, const Vector3& normal = -Vector3::UnitZ)
+	{
+		PixelMesh mesh{};
+		for (uint32_t row{ 0 }; row < rowCount; ++row)
+		{
+			for (uint32_t column{ 0 }; column < columnCount; ++column)
+			{
+				const uint32_t i0{ row * (columnCount + 1) + column };
+				const uint32_t quad[4]{ i0, i0 + 1, i0 + columnCount + 2, i0 + columnCount + 1 };
+				const bool isOtherDiagonal{ random() % 2 == 0 };
+				const uint32_t triangles[2][3]{
+					{ quad[0], quad[1], quad[isOtherDiagonal ? 3 : 2] },
+					{ quad[isOtherDiagonal ? 1 : 0], quad[2], quad[3] } };
+
+				for (const auto& triangle : triangles)
+				{
+					const uint32_t triangleIndex{ static_cast<uint32_t>(mesh.indices.size() / 3) };
+					Vector3 corners[3]{};
+					for (int i{ 0 }; i < 3; ++i)
+					{
+						const Vector2& point{ points[triangle[i]] };
+						corners[i] = { point.x, point.y, depth(triangleIndex, point) };
+					}
+
+					if (random() % 2 == 0)
+						std::swap(corners[1], corners[2]);
+
+					mesh.AddTriangle(corners[0], corners[1], corners[2], width, height, normal);
+				}
+			}
+		}
+
+		return mesh;
+	}
+
+	uint32_t CountCoveredPixels(const Framebuffer& framebuffer)
+	{
+		return static_cast<uint32_t>(std::count_if(framebuffer.depths.begin(), framebuffer.depths.end(), [](float depth) { return depth < 1.f; }));
+	}
+
+	void Render(SoftwareRasterizer& rasterizer, SoftwareRasterizer::ShadingMode shadingMode, const std::vector<const PixelMesh*>& meshes)
+	{
+		rasterizer.SetShadingMode(shadingMode);
+		rasterizer.Clear({ 0.1f, 0.2f, 0.3f });
+		for (const PixelMesh* pMesh : meshes)
+			pMesh->Draw(rasterizer);
+
+		rasterizer.Flush();
+	}
+
+	void CheckEqual(const Framebuffer& expected, const Framebuffer& actual, const char* name)
+	{
+		size_t colorMismatchCount{ 0 };
+		size_t depthMismatchCount{ 0 };
+		for (size_t i{ 0 }; i < expected.colors.size(); ++i)
+		{
+			colorMismatchCount += expected.colors[i] != actual.colors[i];
+			depthMismatchCount += std::bit_cast<uint32_t>(expected.depths[i]) != std::bit_cast<uint32_t>(actual.depths[i]);
+		}
+
+		DAE_CHECK_MESSAGE(colorMismatchCount == 0 && depthMismatchCount == 0, name << ": " << colorMismatchCount << " colors and " << depthMismatchCount << " depths differ");
+	}
+}
+
+DAE_TEST(SoftwareRasterizerJitteredGridCoversEveryPixelOnce)
+{
+	//Every triangle is nearer than the ones drawn before it, so a forward pass shades each of its pixels even when another triangle
+	//already covered it. Shading exactly width * height pixels with none left at the cleared depth means no pixel is covered twice or missed.
+	//Sizes that are not a multiple of a block or a tile, cells from a few pixels to several tiles.
+	const uint32_t sizes[][2]{ { 203, 141 }, { 64, 64 }, { 333, 257 } };
+	const float cellSizes[]{ 3.7f, 11.f, 45.f, 150.f };
+
+	std::mt19937 random{ 22 };
+	for (const auto& size : sizes)
+	{
+		const uint32_t width{ size[0] };
+		const uint32_t height{ size[1] };
+		for (float cellSize : cellSizes)
+		{
+			uint32_t columnCount{}, rowCount{};
+			const std::vector<Vector2> points{ CreateJitteredGrid(width, height, cellSize, random, columnCount, rowCount) };
+			const PixelMesh mesh{ TriangulateGrid(points, columnCount, rowCount, width, height, random,
+				[](uint32_t triangleIndex, const Vector2&) { return 0.9f - triangleIndex * 1e-5f; }) };
+
+			for (uint32_t threadCount : { 1u, 3u })
+			{
+				SoftwareRasterizer rasterizer{ width, height, threadCount };
+				Render(rasterizer, SoftwareRasterizer::ShadingMode::Forward, { &mesh });
+
+				const SoftwareRasterizer::Statistics& statistics{ rasterizer.GetStatistics() };
+				const uint32_t coveredPixelCount{ CountCoveredPixels(rasterizer.GetFramebuffer()) };
+				DAE_CHECK_MESSAGE(coveredPixelCount == width * height, width << "x" << height << ", cells of " << cellSize << ": "
+					<< width * height - coveredPixelCount << " pixels missed");
+				DAE_CHECK_MESSAGE(statistics.shadedPixelCount == width * height, width << "x" << height << ", cells of " << cellSize << ": "
+					<< statistics.shadedPixelCount << " pixels shaded of " << width * height);
+			}
+		}
+	}
+}
+
+DAE_TEST(SoftwareRasterizerFanIsWatertight)
+{
+	//Hundreds of thin triangles around a center at arbitrary angles, inside a convex polygon. Without cracks every row of the polygon
+	//is one run of covered pixels, without overlaps every covered pixel is shaded once.
+	constexpr uint32_t width{ 256 };
+	constexpr uint32_t height{ 200 };
+	constexpr uint32_t triangleCount{ 500 };
+
+	std::mt19937 random{ 3 };
+	std::uniform_real_distribution<float> offset{ -0.5f, 0.5f };
+
+	std::vector<float> angles(triangleCount);
+	for (uint32_t i{ 0 }; i < triangleCount; ++i)
+		angles[i] = (i + 0.5f * offset(random)) * 2.f * std::numbers::pi_v<float> / triangleCount;
+
+	const Vector2 center{ 121.3f + offset(random), 97.8f + offset(random) };
+	PixelMesh mesh{};
+	for (uint32_t i{ 0 }; i < triangleCount; ++i)
+	{
+		const float angle0{ angles[i] };
+		const float angle1{ angles[(i + 1) % triangleCount] };
+		const float depth{ 0.9f - i * 1e-4f };
+		mesh.AddTriangle({ center.x, center.y, depth },
+			{ center.x + std::cos(angle0) * 90.f, center.y + std::sin(angle0) * 90.f, depth },
+			{ center.x + std::cos(angle1) * 90.f, center.y + std::sin(angle1) * 90.f, depth }, width, height);
+	}
+
+	SoftwareRasterizer rasterizer{ width, height, 1 };
+	Render(rasterizer, SoftwareRasterizer::ShadingMode::Forward, { &mesh });
+
+	const Framebuffer& framebuffer{ rasterizer.GetFramebuffer() };
+	const uint32_t coveredPixelCount{ CountCoveredPixels(framebuffer) };
+	DAE_CHECK_MESSAGE(rasterizer.GetStatistics().shadedPixelCount == coveredPixelCount,
+		rasterizer.GetStatistics().shadedPixelCount << " pixels shaded for " << coveredPixelCount << " covered");
+
+	//Close to the area of the polygon, which is a little less than the circle
+	const float circleArea{ std::numbers::pi_v<float> * 90.f * 90.f };
+	DAE_CHECK_MESSAGE(coveredPixelCount > circleArea * 0.99f && coveredPixelCount < circleArea * 1.01f, coveredPixelCount << " pixels for " << circleArea);
+
+	for (uint32_t y{ 0 }; y < height; ++y)
+	{
+		uint32_t runCount{ 0 };
+		bool isInRun{ false };
+		for (uint32_t x{ 0 }; x < width; ++x)
+		{
+			const bool isCovered{ framebuffer.depths[y * width + x] < 1.f };
+			runCount += isCovered && !isInRun;
+			isInRun = isCovered;
+		}
+
+		DAE_CHECK_MESSAGE(runCount <= 1, "row " << y << " has " << runCount << " runs of covered pixels");
+	}
+}
+
+DAE_TEST(SoftwareRasterizerHiZKeepsNearerTriangles)
+{
+	//Two slanted layers of the same grid, one 2e-6 in front of the other. That is below g_DepthBoundMargin, so the depth bounds
+	//of the tiles and blocks must not reject the nearer one when it comes second, and the farther one may never show.
+	constexpr uint32_t width{ 203 };
+	constexpr uint32_t height{ 141 };
+	constexpr float layerDistance{ 2e-6f };
+
+	std::mt19937 random{ 24 };
+	uint32_t columnCount{}, rowCount{};
+	const std::vector<Vector2> points{ CreateJitteredGrid(width, height, 9.f, random, columnCount, rowCount) };
+	const auto depth = [](const Vector2& point) { return 0.3f + point.x * 0.001f + point.y * 0.0015f; };
+
+	std::mt19937 farRandom{ 1 };
+	std::mt19937 nearRandom{ 1 };
+	const PixelMesh farLayer{ TriangulateGrid(points, columnCount, rowCount, width, height, farRandom,
+		[&depth](uint32_t, const Vector2& point) { return depth(point); }, -Vector3::UnitZ) };
+	const PixelMesh nearLayer{ TriangulateGrid(points, columnCount, rowCount, width, height, nearRandom,
+		[&depth](uint32_t, const Vector2& point) { return depth(point) - layerDistance; }, Vector3{ 0.6f, 0.f, -0.8f }) };
+
+	for (SoftwareRasterizer::ShadingMode shadingMode : g_ShadingModes)
+	{
+		SoftwareRasterizer nearOnly{ width, height, 1 };
+		Render(nearOnly, shadingMode, { &nearLayer });
+
+		SoftwareRasterizer farFirst{ width, height, 1 };
+		Render(farFirst, shadingMode, { &farLayer, &nearLayer });
+		CheckEqual(nearOnly.GetFramebuffer(), farFirst.GetFramebuffer(), GetName(shadingMode));
+
+		SoftwareRasterizer nearFirst{ width, height, 1 };
+		Render(nearFirst, shadingMode, { &nearLayer, &farLayer });
+		CheckEqual(nearOnly.GetFramebuffer(), nearFirst.GetFramebuffer(), GetName(shadingMode));
+
+		if (shadingMode == SoftwareRasterizer::ShadingMode::Forward)
+		{
+			DAE_CHECK_MESSAGE(farFirst.GetStatistics().shadedPixelCount == 2 * width * height, farFirst.GetStatistics().shadedPixelCount);
+			DAE_CHECK_MESSAGE(nearFirst.GetStatistics().shadedPixelCount == width * height, nearFirst.GetStatistics().shadedPixelCount);
+		}
+	}
+
+	//Far enough behind, whole triangles and blocks of the second layer are dropped before their pixels are tested
+	std::mt19937 hiddenRandom{ 1 };
+	const PixelMesh hiddenLayer{ TriangulateGrid(points, columnCount, rowCount, width, height, hiddenRandom,
+		[&depth](uint32_t, const Vector2& point) { return depth(point) + 0.1f; }) };
+
+	SoftwareRasterizer rasterizer{ width, height, 1 };
+	Render(rasterizer, SoftwareRasterizer::ShadingMode::Forward, { &nearLayer, &hiddenLayer });
+	DAE_CHECK(rasterizer.GetStatistics().hiZRejectedTriangleCount + rasterizer.GetStatistics().hiZRejectedBlockCount > 0);
+	DAE_CHECK_MESSAGE(rasterizer.GetStatistics().shadedPixelCount == width * height, rasterizer.GetStatistics().shadedPixelCount);
+}
+
+DAE_TEST(SoftwareRasterizerShadingModesMatch)
+{
+	//The depth pre-pass and the visibility buffer only change how often pixels are shaded, never the image. Overlapping layers with
+	//random depths and equal depths, where the first triangle drawn has to win in every mode.
+	constexpr uint32_t width{ 203 };
+	constexpr uint32_t height{ 141 };
+
+	std::mt19937 random{ 25 };
+	std::uniform_real_distribution<float> randomDepth{ 0.1f, 0.9f };
+	std::vector<PixelMesh> layers{};
+	for (int layer{ 0 }; layer < 4; ++layer)
+	{
+		uint32_t columnCount{}, rowCount{};
+		const std::vector<Vector2> points{ CreateJitteredGrid(width, height, 17.f + layer * 6.f, random, columnCount, rowCount) };
+		const Vector3 normal{ Vector3{ 0.3f * layer - 0.4f, 0.2f, -1.f }.Normalized() };
+		if (layer < 2)
+			layers.push_back(TriangulateGrid(points, columnCount, rowCount, width, height, random, [](uint32_t, const Vector2&) { return 0.5f; }, normal));
+		else
+			layers.push_back(TriangulateGrid(points, columnCount, rowCount, width, height, random, [&](uint32_t, const Vector2&) { return randomDepth(random); }, normal));
+	}
+
+	std::vector<const PixelMesh*> meshes{};
+	for (const PixelMesh& layer : layers)
+		meshes.push_back(&layer);
+
+	SoftwareRasterizer forward{ width, height, 1 };
+	Render(forward, SoftwareRasterizer::ShadingMode::Forward, meshes);
+
+	for (SoftwareRasterizer::ShadingMode shadingMode : g_ShadingModes)
+	{
+		for (uint32_t threadCount : { 1u, 4u })
+		{
+			SoftwareRasterizer rasterizer{ width, height, threadCount };
+			Render(rasterizer, shadingMode, meshes);
+			CheckEqual(forward.GetFramebuffer(), rasterizer.GetFramebuffer(), GetName(shadingMode));
+		}
+	}
+}
+
+DAE_TEST(SoftwareRasterizerShadingModesMatchOnVehicle)
+{
+	//The textured vehicle like RenderSoftware draws it, at a size that leaves partial tiles and blocks
+	Utils::OBJParseSettings parseSettings{};
+	parseSettings.threadCount = 0;
+
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+	DAE_CHECK(Utils::ParseOBJ("Resources/vehicle.obj", vertices, indices, parseSettings));
+	if (vertices.empty())
+		return;
+
+	constexpr uint32_t width{ 333 };
+	constexpr uint32_t height{ 257 };
+	Camera camera{ Vector3(0.0f, 0.0f, -50.0f), 45.0f };
+	camera.Initialize(45.0f, Vector3(0.0f, 0.0f, -50.0f), float(width) / float(height));
+	camera.CalculateViewMatrix();
+	const Matrix viewProjectionMatrix{ camera.viewMatrix * camera.projectionMatrix };
+
+	const SoftwareTexture diffuseMap{ "Resources/vehicle_diffuse.png" };
+	const SoftwareTexture normalMap{ "Resources/vehicle_normal.png" };
+	const SoftwareTexture specularMap{ "Resources/vehicle_specular.png" };
+	const SoftwareTexture glossinessMap{ "Resources/vehicle_gloss.png" };
+	DAE_CHECK(diffuseMap.IsValid() && normalMap.IsValid() && specularMap.IsValid() && glossinessMap.IsValid());
+
+	PhongShader::Material material{};
+	material.pDiffuseMap = diffuseMap.IsValid() ? &diffuseMap : nullptr;
+	material.pNormalMap = normalMap.IsValid() ? &normalMap : nullptr;
+	material.pSpecularMap = specularMap.IsValid() ? &specularMap : nullptr;
+	material.pGlossinessMap = glossinessMap.IsValid() ? &glossinessMap : nullptr;
+
+	const auto render = [&](SoftwareRasterizer::ShadingMode shadingMode, uint32_t threadCount)
+		{
+			SoftwareRasterizer rasterizer{ width, height, threadCount };
+			rasterizer.SetShadingMode(shadingMode);
+			rasterizer.SetMaterial(material);
+			rasterizer.SetCameraPosition(camera.origin);
+			rasterizer.Clear({ 0.39f, 0.59f, 0.93f });
+			rasterizer.Draw(vertices.data(), vertices.size(), indices.data(), indices.size(), PrimitiveTopology::TriangleList, Matrix::Identity, viewProjectionMatrix);
+			rasterizer.Flush();
+			return rasterizer.GetFramebuffer();
+		};
+
+	const Framebuffer forward{ render(SoftwareRasterizer::ShadingMode::Forward, 1) };
+	DAE_CHECK(CountCoveredPixels(forward) > width * height / 20);
+	for (SoftwareRasterizer::ShadingMode shadingMode : g_ShadingModes)
+		CheckEqual(forward, render(shadingMode, 3), GetName(shadingMode));
+}
@@ -0,0 +1,159 @@
+#include "pch.h"
+#include "Test.h"
+#include "DataTypes.h"
+#include "TangentSpace.h"
+#include <random>
+
+using namespace dae;
+
+namespace
+{
+	constexpr float g_MaxError{ 1e-5f };
+
+	//A bumpy grid of gridSize x gridSize quads in the xz plane, with normals only when hasNormals is set
+	void CreateGrid(uint32_t gridSize, bool hasNormals, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+	{
+		vertices.clear();
+		indices.clear();
+
+		for (uint32_t z{ 0 }; z <= gridSize; ++z)
+		{
+			for (uint32_t x{ 0 }; x <= gridSize; ++x)
+			{
+				Vertex vertex{};
+				vertex.position = { static_cast<float>(x), std::sin(x * 0.7f) * std::cos(z * 0.5f) * 0.3f, static_cast<float>(z) };
+				vertex.uv = { static_cast<float>(x) / gridSize, static_cast<float>(z) / gridSize };
+				if (hasNormals)
+					vertex.normal = Vector3::UnitY;
+
+				vertices.push_back(vertex);
+			}
+		}
+
+		for (uint32_t z{ 0 }; z < gridSize; ++z)
+		{
+			for (uint32_t x{ 0 }; x < gridSize; ++x)
+			{
+				const uint32_t i0{ z * (gridSize + 1) + x };
+				const uint32_t i1{ i0 + 1 };
+				const uint32_t i2{ i0 + gridSize + 1 };
+				const uint32_t i3{ i2 + 1 };
+				indices.insert(indices.end(), { i0, i2, i1, i1, i2, i3 });
+			}
+		}
+	}
+
+	bool IsFinite(const Vector4& v)
+	{
+		return std::isfinite(v.x) && std::isfinite(v.y) && std::isfinite(v.z) && std::isfinite(v.w);
+	}
+
+	//Unit length, a handedness of exactly +-1 and perpendicular to the given normal
+	void CheckTangent(const Vertex& vertex, const Vector3& normal, size_t vertexIndex)
+	{
+		const Vector3 tangent{ vertex.tangent.x, vertex.tangent.y, vertex.tangent.z };
+		DAE_CHECK_MESSAGE(IsFinite(vertex.tangent), "vertex " << vertexIndex);
+		DAE_CHECK_MESSAGE(std::abs(tangent.Magnitude() - 1.f) <= g_MaxError, "vertex " << vertexIndex << ": length " << tangent.Magnitude());
+		DAE_CHECK_MESSAGE(vertex.tangent.w == 1.f || vertex.tangent.w == -1.f, "vertex " << vertexIndex << ": w " << vertex.tangent.w);
+		DAE_CHECK_MESSAGE(std::abs(Vector3::Dot(tangent, normal)) <= g_MaxError, "vertex " << vertexIndex << ": dot with normal " << Vector3::Dot(tangent, normal));
+	}
+
+	//The normalized sum of the area weighted normals of the triangles around every vertex
+	std::vector<Vector3> GetFaceNormals(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+	{
+		std::vector<Vector3> normals(vertices.size());
+		for (size_t i{ 0 }; i < indices.size(); i += 3)
+		{
+			const Vector3 faceNormal{ Vector3::Cross(vertices[indices[i + 1]].position - vertices[indices[i]].position,
+				vertices[indices[i + 2]].position - vertices[indices[i]].position) };
+
+			for (size_t corner{ 0 }; corner < 3; ++corner)
+				normals[indices[i + corner]] += faceNormal;
+		}
+
+		for (Vector3& normal : normals)
+			normal.Normalize();
+
+		return normals;
+	}
+}
+
+DAE_TEST(TangentSpaceFollowsTheUVs)
+{
+	//u runs along x, so on a flat grid every tangent is +x
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+	CreateGrid(8, true, vertices, indices);
+	for (Vertex& vertex : vertices)
+		vertex.position.y = 0.f;
+
+	TangentSpace::Generate(vertices.data(), vertices.size(), indices.data(), indices.size(), 1);
+
+	for (size_t i{ 0 }; i < vertices.size(); ++i)
+	{
+		CheckTangent(vertices[i], vertices[i].normal, i);
+		DAE_CHECK_MESSAGE(std::abs(vertices[i].tangent.x - 1.f) <= g_MaxError, "vertex " << i << ": x " << vertices[i].tangent.x);
+	}
+}
+
+DAE_TEST(TangentSpaceWithoutNormals)
+{
+	//Like an OBJ with only v, vt and f lines: the frame comes from the faces, so the tangents still follow u and stay in the surface
+	std::vector<Vertex> vertices{};
+	std::vector<uint32_t> indices{};
+	CreateGrid(16, false, vertices, indices);
+
+	TangentSpace::Generate(vertices.data(), vertices.size(), indices.data(), indices.size(), 1);
+
+	const std::vector<Vector3> faceNormals{ GetFaceNormals(vertices, indices) };
+	for (size_t i{ 0 }; i < vertices.size(); ++i)
+	{
+		CheckTangent(vertices[i], faceNormals[i], i);
+		DAE_CHECK_MESSAGE(vertices[i].tangent.x > 0.5f, "vertex " << i << ": x " << vertices[i].tangent.x);
+		DAE_CHECK_MESSAGE(vertices[i].normal == Vector3::Zero, "vertex " << i << ": the normal changed");
+	}
+
+	//Without any area there is no plane either, the tangent still has to be usable
+	std::vector<Vertex> degenerateVertices(3);
+	const std::vector<uint32_t> degenerateIndices{ 0, 1, 2 };
+	TangentSpace::Generate(degenerateVertices.data(), degenerateVertices.size(), degenerateIndices.data(), degenerateIndices.size(), 1);
+	for (size_t i{ 0 }; i < degenerateVertices.size(); ++i)
+		CheckTangent(degenerateVertices[i], Vector3::Zero, i);
+}
+
+DAE_TEST(TangentSpaceWithDegenerateUVs)
+{
+	//Every uv the same, or all on one line, leaves no gradient: any unit tangent in the normal's plane is fine, NaN is not
+	std::mt19937 random{ 11 };
+	std::uniform_real_distribution<float> component{ -1.f, 1.f };
+
+	for (bool hasNormals : { true, false })
+	{
+		for (int uvCase{ 0 }; uvCase < 2; ++uvCase)
+		{
+			std::vector<Vertex> vertices{};
+			std::vector<uint32_t> indices{};
+			CreateGrid(8, hasNormals, vertices, indices);
+
+			for (Vertex& vertex : vertices)
+			{
+				vertex.uv = uvCase == 0 ? Vector2{ 0.25f, 0.75f } : Vector2{ vertex.position.x * 0.1f, 0.5f };
+				if (hasNormals)
+				{
+					do
+					{
+						vertex.normal = { component(random), component(random), component(random) };
+					} while (vertex.normal.SqrMagnitude() < 1e-3f);
+
+					vertex.normal.Normalize();
+				}
+			}
+
+			TangentSpace::Generate(vertices.data(), vertices.size(), indices.data(), indices.size(), 1);
+
+			const std::vector<Vector3> faceNormals{ GetFaceNormals(vertices, indices) };
+			for (size_t i{ 0 }; i < vertices.size(); ++i)
+				CheckTangent(vertices[i], hasNormals ? vertices[i].normal : faceNormals[i], i);
+		}
+	}
+}
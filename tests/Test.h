@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace dae
+{
+	//Just enough of a test framework for DirectXTests: every DAE_TEST registers itself, TestMain runs the ones whose name starts with the first argument.
+	//A failed check reports itself and the test goes on, so one run shows every broken bound.
+	namespace Tests
+	{
+		struct TestCase
+		{
+			const char* name{};
+			void (*pFunction)() {};
+		};
+
+		std::vector<TestCase>& GetTestCases();
+		void ReportFailure(const char* file, int line, const std::string& message);
+
+		struct Registrar
+		{
+			Registrar(const char* name, void (*pFunction)())
+			{
+				GetTestCases().push_back({ name, pFunction });
+			}
+		};
+
+		//Distance in representable floats, 0 for equal values and for +0 and -0
+		uint32_t GetUlpDistance(float a, float b);
+
+		//A path in the temporary directory, the file is removed when the test is done with it, also when a check failed
+		struct TemporaryFile
+		{
+			std::filesystem::path path{};
+
+			explicit TemporaryFile(const char* name)
+				: path{ std::filesystem::temp_directory_path() / name }
+			{
+			}
+
+			~TemporaryFile()
+			{
+				std::error_code error{};
+				std::filesystem::remove(path, error);
+			}
+		};
+	}
+}
+
+#define DAE_TEST(name) \
+	static void name(); \
+	static const dae::Tests::Registrar g_##name##Registrar{ #name, name }; \
+	static void name()
+
+//The message is streamed, so DAE_CHECK_MESSAGE(error < bound, "error " << error) shows the values that broke it
+#define DAE_CHECK_MESSAGE(condition, message) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			std::ostringstream failureStream{}; \
+			failureStream << #condition << ": " << message; \
+			dae::Tests::ReportFailure(__FILE__, __LINE__, failureStream.str()); \
+		} \
+	} while (false)
+
+#define DAE_CHECK(condition) DAE_CHECK_MESSAGE(condition, "")
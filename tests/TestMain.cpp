@@ -0,0 +1,79 @@
+#include "pch.h"
+#include "Test.h"
+#include <bit>
+#include <cstring>
+
+namespace dae
+{
+	namespace Tests
+	{
+		namespace
+		{
+			uint32_t g_FailureCount{ 0 };
+		}
+
+		std::vector<TestCase>& GetTestCases()
+		{
+			static std::vector<TestCase> testCases{};
+			return testCases;
+		}
+
+		void ReportFailure(const char* file, int line, const std::string& message)
+		{
+			std::cout << RED_TEXT("  FAILED ") << file << "(" << line << "): " << message << "\n";
+			++g_FailureCount;
+		}
+
+		uint32_t GetUlpDistance(float a, float b)
+		{
+			//Maps the floats onto a line of integers that counts up through -0 = +0
+			const auto toOrdered = [](float value)
+				{
+					const int32_t bits{ std::bit_cast<int32_t>(value) };
+					return bits < 0 ? -static_cast<int64_t>(bits & INT32_MAX) : static_cast<int64_t>(bits);
+				};
+
+			const int64_t distance{ toOrdered(a) - toOrdered(b) };
+			return static_cast<uint32_t>(std::min<int64_t>(distance < 0 ? -distance : distance, UINT32_MAX));
+		}
+	}
+}
+
+using namespace dae;
+
+//DirectXTests [prefix]: runs every test, or the ones whose name starts with prefix
+int main(int argc, char* args[])
+{
+	const std::string prefix{ argc > 1 ? args[1] : "" };
+
+	uint32_t testCount{ 0 };
+	uint32_t failedTestCount{ 0 };
+	for (const Tests::TestCase& testCase : Tests::GetTestCases())
+	{
+		if (std::strncmp(testCase.name, prefix.c_str(), prefix.size()) != 0)
+			continue;
+
+		std::cout << testCase.name << "\n";
+
+		const uint32_t failureCount{ Tests::g_FailureCount };
+		testCase.pFunction();
+		++testCount;
+		if (Tests::g_FailureCount != failureCount)
+			++failedTestCount;
+	}
+
+	if (testCount == 0)
+	{
+		std::cout << RED_TEXT("No tests start with ") << prefix << "\n";
+		return 1;
+	}
+
+	if (failedTestCount > 0)
+	{
+		std::cout << RED_TEXT("Failed ") << failedTestCount << " of " << testCount << " tests\n";
+		return 1;
+	}
+
+	std::cout << GREEN_TEXT("Passed ") << testCount << " tests\n";
+	return 0;
+}
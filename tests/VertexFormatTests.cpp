@@ -0,0 +1,233 @@
+#include "pch.h"
+#include "Test.h"
+#include "VertexFormat.h"
+#include <random>
+
+using namespace dae;
+
+namespace
+{
+	//The bounds VertexFormat.h documents, checked here without going through ValidatePacking
+	constexpr float g_MaxDirectionError{ 1.5e-4f };
+	constexpr float g_MaxHalf{ 65504.f };
+
+	Vector3 RandomDirection(std::mt19937& random)
+	{
+		std::normal_distribution<float> component{};
+		Vector3 direction{};
+		do
+		{
+			direction = { component(random), component(random), component(random) };
+		} while (direction.SqrMagnitude() < 1e-6f);
+
+		return direction.Normalized();
+	}
+
+	float AngleBetween(const Vector3& a, const Vector3& b)
+	{
+		return std::atan2(Vector3::Cross(a, b).Magnitude(), Vector3::Dot(a, b));
+	}
+
+	//Packs and unpacks the vertices with the quantization of their own bounds, then checks every attribute against its bound
+	void CheckRoundTrip(const std::vector<Vertex>& vertices, VertexFormats::PackingError& maxError)
+	{
+		const VertexFormats::Quantization quantization{ VertexFormats::GetQuantization(BoundingBox::FromVertices(vertices.data(), vertices.size())) };
+
+		std::vector<PackedVertex> packedVertices(vertices.size());
+		VertexFormats::Pack(vertices.data(), vertices.size(), quantization, packedVertices.data());
+		DAE_CHECK(VertexFormats::ValidatePacking(vertices.data(), packedVertices.data(), vertices.size(), quantization));
+
+		for (size_t i{ 0 }; i < vertices.size(); ++i)
+		{
+			const Vertex& vertex{ vertices[i] };
+			const Vertex unpacked{ VertexFormats::Unpack(packedVertices[i], quantization) };
+
+			for (int axis{ 0 }; axis < 3; ++axis)
+			{
+				//Half a step of 16 bits over the bounds, plus the float rounding of offset + unorm * scale
+				const float error{ std::abs(unpacked.position[axis] - vertex.position[axis]) };
+				const float bound{ quantization.scale[axis] / 65535.f * 0.5f + (std::abs(vertex.position[axis]) + quantization.scale[axis]) * FLT_EPSILON * 2.f };
+				maxError.position = std::max(maxError.position, error);
+				DAE_CHECK_MESSAGE(error <= bound, "vertex " << i << " axis " << axis << ": " << error << " > " << bound);
+			}
+
+			for (int axis{ 0 }; axis < 2; ++axis)
+			{
+				//Half an ulp of the 11 bit mantissa, or half the smallest denormal
+				const float uv{ vertex.uv[axis] };
+				const float error{ std::abs(unpacked.uv[axis] - uv) };
+				const float bound{ std::max(std::abs(uv) * std::ldexp(1.f, -11), std::ldexp(1.f, -25)) };
+				maxError.uv = std::max(maxError.uv, error);
+				DAE_CHECK_MESSAGE(error <= bound, "vertex " << i << " uv " << uv << ": " << error << " > " << bound);
+			}
+
+			const float normalError{ AngleBetween(unpacked.normal, vertex.normal) };
+			const float tangentError{ AngleBetween(unpacked.tangent.GetXYZ(), vertex.tangent.GetXYZ()) };
+			maxError.normalAngle = std::max(maxError.normalAngle, normalError);
+			maxError.tangentAngle = std::max(maxError.tangentAngle, tangentError);
+			DAE_CHECK_MESSAGE(normalError <= g_MaxDirectionError, "vertex " << i << ": " << normalError << " rad");
+			DAE_CHECK_MESSAGE(tangentError <= g_MaxDirectionError, "vertex " << i << ": " << tangentError << " rad");
+			DAE_CHECK_MESSAGE(std::abs(unpacked.normal.Magnitude() - 1.f) <= 1e-5f, "vertex " << i);
+			DAE_CHECK_MESSAGE(unpacked.tangent.w == (vertex.tangent.w < 0.f ? -1.f : 1.f), "vertex " << i);
+		}
+	}
+
+	void Report(const VertexFormats::PackingError& maxError)
+	{
+		std::cout << "  position " << maxError.position << ", uv " << maxError.uv << ", normal " << maxError.normalAngle << " rad, tangent "
+			<< maxError.tangentAngle << " rad\n";
+	}
+}
+
+DAE_TEST(VertexFormatRandomVerticesAreWithinBounds)
+{
+	std::mt19937 random{ 5 };
+	std::uniform_real_distribution<float> position{ -250.f, 250.f };
+	std::uniform_real_distribution<float> uv{ -4.f, 4.f };
+	std::uniform_real_distribution<float> handedness{ -1.f, 1.f };
+
+	std::vector<Vertex> vertices(100'000);
+	for (Vertex& vertex : vertices)
+	{
+		vertex.position = { position(random), position(random) * 0.01f, position(random) * 10.f };
+		vertex.uv = { uv(random), uv(random) };
+		vertex.normal = RandomDirection(random);
+		vertex.tangent = { RandomDirection(random), handedness(random) < 0.f ? -1.f : 1.f };
+	}
+
+	VertexFormats::PackingError maxError{};
+	CheckRoundTrip(vertices, maxError);
+	Report(maxError);
+}
+
+DAE_TEST(VertexFormatOctahedralFoldsAreWithinBounds)
+{
+	//The poles, the equator and the fold lines of the lower hemisphere, with both signs of zero, and directions just off them
+	const float tiny{ 1e-6f };
+	const std::vector<Vector3> directions{
+		{ 0.f, 0.f, 1.f }, { 0.f, 0.f, -1.f }, { -0.f, -0.f, -1.f }, { -0.f, 0.f, -1.f }, { 0.f, -0.f, -1.f },
+		{ tiny, tiny, -1.f }, { -tiny, tiny, -1.f }, { tiny, -tiny, -1.f }, { -tiny, -tiny, -1.f }, { tiny, 0.f, 1.f }, { -tiny, -0.f, 1.f },
+		{ 1.f, 0.f, 0.f }, { -1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f }, { 0.f, -1.f, 0.f }, { 1.f, 1.f, 0.f }, { -1.f, 1.f, -0.f }, { 1.f, -1.f, -tiny },
+		{ 1.f, 0.f, -1.f }, { -1.f, 0.f, -1.f }, { 0.f, 1.f, -1.f }, { 0.f, -1.f, -1.f }, { -0.f, 1.f, -1.f }, { 1.f, -0.f, -1.f },
+		{ 1.f, 1.f, -1.f }, { -1.f, 1.f, -1.f }, { 1.f, -1.f, -1.f }, { -1.f, -1.f, -1.f }, { 1.f, 1.f, -tiny }, { -1.f, -1.f, -tiny } };
+
+	std::vector<Vertex> vertices{};
+	for (const Vector3& direction : directions)
+	{
+		Vertex vertex{};
+		vertex.normal = direction.Normalized();
+		vertex.tangent = { direction.Normalized(), -1.f };
+		vertices.push_back(vertex);
+
+		//The neighbourhood of every fold, where the encoding snaps across the square's edges
+		std::mt19937 random{ static_cast<uint32_t>(vertices.size()) };
+		std::uniform_real_distribution<float> offset{ -1e-3f, 1e-3f };
+		for (int i{ 0 }; i < 64; ++i)
+		{
+			const Vector3 nearby{ (direction.Normalized() + Vector3{ offset(random), offset(random), offset(random) }).Normalized() };
+			vertex.normal = nearby;
+			vertex.tangent = { nearby, 1.f };
+			vertices.push_back(vertex);
+		}
+	}
+
+	VertexFormats::PackingError maxError{};
+	CheckRoundTrip(vertices, maxError);
+	Report(maxError);
+}
+
+DAE_TEST(VertexFormatFlatBoundsAreExact)
+{
+	//A quad in the xz plane, a line along z and a single point: flat axes get a scale of 1 and must come back exactly
+	const std::vector<std::vector<Vector3>> shapes{
+		{ { -1.f, 2.5f, -1.f }, { 1.f, 2.5f, -1.f }, { 1.f, 2.5f, 1.f }, { -1.f, 2.5f, 1.f } },
+		{ { 3.f, -7.f, 0.f }, { 3.f, -7.f, 0.25f }, { 3.f, -7.f, 100.f } },
+		{ { 1e5f, -1e-5f, 0.f }, { 1e5f, -1e-5f, 0.f } } };
+
+	VertexFormats::PackingError maxError{};
+	for (const std::vector<Vector3>& positions : shapes)
+	{
+		std::vector<Vertex> vertices{};
+		for (const Vector3& position : positions)
+		{
+			Vertex vertex{};
+			vertex.position = position;
+			vertex.normal = { 0.f, 1.f, 0.f };
+			vertex.tangent = { 1.f, 0.f, 0.f, 1.f };
+			vertices.push_back(vertex);
+		}
+
+		const BoundingBox bounds{ BoundingBox::FromVertices(vertices.data(), vertices.size()) };
+		const VertexFormats::Quantization quantization{ VertexFormats::GetQuantization(bounds) };
+		for (int axis{ 0 }; axis < 3; ++axis)
+		{
+			if (bounds.max[axis] > bounds.min[axis])
+				continue;
+
+			DAE_CHECK(quantization.scale[axis] == 1.f);
+
+			std::vector<PackedVertex> packedVertices(vertices.size());
+			VertexFormats::Pack(vertices.data(), vertices.size(), quantization, packedVertices.data());
+			for (size_t i{ 0 }; i < vertices.size(); ++i)
+			{
+				DAE_CHECK(packedVertices[i].position[axis] == 0);
+				DAE_CHECK(VertexFormats::Unpack(packedVertices[i], quantization).position[axis] == vertices[i].position[axis]);
+			}
+		}
+
+		CheckRoundTrip(vertices, maxError);
+	}
+
+	Report(maxError);
+}
+
+DAE_TEST(VertexFormatHalfFloatUVsAreWithinBounds)
+{
+	//Around 1 and 2, where the ulp changes, down through the denormals, and up to the largest finite half
+	std::vector<float> uvs{ 0.f, -0.f, 1.f, -1.f, 0.99999f, 1.00049f, 1.0005f, 2.0009f, 2.001f, 1e-4f, 6.1e-5f, 6.0e-5f, 3e-6f, 5.96e-8f, 2.9e-8f, 1e-9f,
+		-6.0e-5f, 1024.5f, 2047.9f, 4095.f, 32767.f, 65503.f, g_MaxHalf, -g_MaxHalf };
+
+	std::mt19937 random{ 9 };
+	std::uniform_real_distribution<float> exponent{ -24.f, 15.9f };
+	for (int i{ 0 }; i < 10'000; ++i)
+		uvs.push_back(std::exp2(exponent(random)) * (i % 2 ? -1.f : 1.f));
+
+	std::vector<Vertex> vertices{};
+	for (size_t i{ 0 }; i + 1 < uvs.size(); ++i)
+	{
+		Vertex vertex{};
+		vertex.uv = { uvs[i], uvs[i + 1] };
+		vertex.normal = { 0.f, 0.f, 1.f };
+		vertex.tangent = { 1.f, 0.f, 0.f, 1.f };
+		vertices.push_back(vertex);
+	}
+
+	VertexFormats::PackingError maxError{};
+	CheckRoundTrip(vertices, maxError);
+	Report(maxError);
+}
+
+DAE_TEST(VertexFormatHalfFloatOverflowUVs)
+{
+	//Past the largest half, uvs within half an ulp (16) still round down to 65504 and anything larger becomes infinity with its sign.
+	//ValidatePacking lets uvs from 65504 on through, since no half can hold them.
+	const float uvs[]{ 65519.f, -65519.f, 65520.f, -65520.f, 1e6f, -1e6f, FLT_MAX, std::numeric_limits<float>::infinity() };
+	const float expected[]{ g_MaxHalf, -g_MaxHalf, INFINITY, -INFINITY, INFINITY, -INFINITY, INFINITY, INFINITY };
+
+	const VertexFormats::Quantization quantization{};
+	for (size_t i{ 0 }; i < std::size(uvs); ++i)
+	{
+		Vertex vertex{};
+		vertex.uv = { uvs[i], 0.5f };
+		vertex.normal = { 0.f, 0.f, 1.f };
+		vertex.tangent = { 1.f, 0.f, 0.f, 1.f };
+
+		PackedVertex packedVertex{};
+		VertexFormats::Pack(&vertex, 1, quantization, &packedVertex);
+		const Vertex unpacked{ VertexFormats::Unpack(packedVertex, quantization) };
+
+		DAE_CHECK_MESSAGE(unpacked.uv.x == expected[i], uvs[i] << " became " << unpacked.uv.x);
+		DAE_CHECK(unpacked.uv.y == 0.5f);
+		DAE_CHECK(VertexFormats::ValidatePacking(&vertex, &packedVertex, 1, quantization));
+	}
+}